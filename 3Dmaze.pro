@@ -11,25 +11,82 @@ RESOURCES = application.qrc
 
 DEFINES += NOMINMAX
 
+# run qmake with CONFIG+=single_precision to store the maze's geometry as floats instead of doubles
+single_precision {
+	DEFINES += MAZE_SINGLE_PRECISION
+}
+
 TARGET = 3Dmaze
 TEMPLATE = app
 INCLUDEPATH += Library/2DStructures/ \
 	Library/3DStructures/ \
 	Library/IOControl/ \
 	Library/UserInteraction/ \
+	Library/Textures/ \
+	Library/Generation/ \
+	Library/Navigation/ \
 	LIbrary/Util/
 
 SOURCES +=\
     Library/2DStructures/Vector2D.cpp \
     Library/2DStructures/Point2D.cpp \
     Library/2DStructures/Maze2D.cpp \
+    Library/2DStructures/MazeNormalizer.cpp \
+    Library/2DStructures/MappedMaze2D.cpp \
+    Library/2DStructures/MazeFileConverter.cpp \
+    Library/2DStructures/MazeTextReader.cpp \
+    Library/2DStructures/MazeReadBenchmark.cpp \
+    Library/2DStructures/TiledMazeFormat.cpp \
+    Library/2DStructures/TiledMazeWriter.cpp \
+    Library/2DStructures/BinaryMazeWriter.cpp \
+    Library/2DStructures/TiledMaze2DProvider.cpp \
+    Library/2DStructures/MazeJournal.cpp \
     Library/2DStructures/LineSegment2D.cpp \
+    Library/2DStructures/Polygon2D.cpp \
+    Library/2DStructures/WallFootprintUnion.cpp \
     Library/3DStructures/Wall.cpp \
+    Library/3DStructures/WallMesh.cpp \
+    Library/3DStructures/MazeChunk.cpp \
+    Library/3DStructures/ViewFrustum.cpp \
+    Library/3DStructures/ChunkBufferCache.cpp \
+    Library/3DStructures/MazeImpostor.cpp \
+    Library/3DStructures/Maze3DExporter.cpp \
+    Library/3DStructures/Maze3DTextReader.cpp \
+    Library/3DStructures/Maze3DReadBenchmark.cpp \
+    Library/Util/DisjointSets.cpp \
+    Library/Generation/RandomNumbers.cpp \
+    Library/Generation/WallTracer.cpp \
+    Library/Generation/MazeGrid.cpp \
+    Library/Generation/MazeGenerator.cpp \
+    Library/Generation/BacktrackerGenerator.cpp \
+    Library/Generation/KruskalGenerator.cpp \
+    Library/Generation/PrimGenerator.cpp \
+    Library/Generation/WilsonGenerator.cpp \
+    Library/Generation/EllerGenerator.cpp \
+    Library/Generation/ParallelTiledGenerator.cpp \
+    Library/Generation/MazeGenerationBenchmark.cpp \
+    Library/Generation/MazeAnalyzer.cpp \
+    Library/Navigation/NavigationGraph.cpp \
+    Library/Navigation/OccupancyGrid.cpp \
+    Library/Navigation/PathSearch.cpp \
+    Library/Navigation/HierarchicalPathGraph.cpp \
+    Library/Navigation/HierarchicalPathSearch.cpp \
+    Library/Navigation/PathQueryBatch.cpp \
+    Library/Navigation/FlowField.cpp \
+    Library/Navigation/WallDistanceField.cpp \
+    Library/Navigation/ReachabilityMap.cpp \
+    Library/3DStructures/Maze3DBuilder.cpp \
+    Library/Textures/TextureImage.cpp \
+    Library/Textures/PPMDecoder.cpp \
+    Library/Textures/TextureCache.cpp \
+    Library/3DStructures/TiledMaze3DProvider.cpp \
     Library/3DStructures/TexturedQuad.cpp \
     Library/3DStructures/Quad.cpp \
     Library/3DStructures/Point3D.cpp \
     Library/3DStructures/Maze3D.cpp \
     Library/IOControl/FileHandler.cpp \
+    Library/IOControl/MappedFile.cpp \
+    Library/IOControl/DurableFile.cpp \
     Library/UserInteraction/UserInteractionStateFP.cpp \
     Library/UserInteraction/UserInteractionState.cpp \
     Library/UserInteraction/TransformationStateFP.cpp \
@@ -42,14 +99,65 @@ SOURCES +=\
 	View/view3DMaze.cpp \
     main.cpp \
     Explore/explore3DMaze.cpp \
-    MainWindow/MainWindow.cpp
+    MainWindow/MainWindow.cpp \
+    MainWindow/MazeBuildTask.cpp \
+    MainWindow/MazeFileTask.cpp \
+    MainWindow/TextureLoadTask.cpp
 
 HEADERS  += \
     Library/2DStructures/Vector2D.h \
     Library/2DStructures/Point2D.h \
     Library/2DStructures/Maze2D.h \
+    Library/2DStructures/MazeNormalizer.h \
+    Library/2DStructures/MappedMaze2D.h \
+    Library/2DStructures/MazeFileConverter.h \
+    Library/2DStructures/MazeTextReader.h \
+    Library/2DStructures/MazeReadBenchmark.h \
+    Library/2DStructures/TiledMazeFormat.h \
+    Library/2DStructures/TiledMazeWriter.h \
+    Library/2DStructures/BinaryMazeWriter.h \
+    Library/2DStructures/MazeLineSink.h \
+    Library/2DStructures/TiledMaze2DProvider.h \
+    Library/2DStructures/MazeJournal.h \
     Library/2DStructures/LineSegment2D.h \
+    Library/2DStructures/Polygon2D.h \
+    Library/2DStructures/WallFootprintUnion.h \
     Library/3DStructures/Wall.h \
+    Library/3DStructures/WallMesh.h \
+    Library/3DStructures/MazeChunk.h \
+    Library/3DStructures/ViewFrustum.h \
+    Library/3DStructures/ChunkBufferCache.h \
+    Library/3DStructures/MazeImpostor.h \
+    Library/3DStructures/Maze3DExporter.h \
+    Library/3DStructures/Maze3DTextReader.h \
+    Library/3DStructures/Maze3DReadBenchmark.h \
+    Library/Util/DisjointSets.h \
+    Library/Generation/RandomNumbers.h \
+    Library/Generation/WallTracer.h \
+    Library/Generation/MazeGrid.h \
+    Library/Generation/MazeGenerator.h \
+    Library/Generation/BacktrackerGenerator.h \
+    Library/Generation/KruskalGenerator.h \
+    Library/Generation/PrimGenerator.h \
+    Library/Generation/WilsonGenerator.h \
+    Library/Generation/EllerGenerator.h \
+    Library/Generation/ParallelTiledGenerator.h \
+    Library/Generation/MazeGenerationBenchmark.h \
+    Library/Generation/MazeAnalyzer.h \
+    Library/Navigation/NavigationGraph.h \
+    Library/Navigation/OccupancyGrid.h \
+    Library/Navigation/PathSearch.h \
+    Library/Navigation/HierarchicalPathGraph.h \
+    Library/Navigation/HierarchicalPathSearch.h \
+    Library/Navigation/PathQueryBatch.h \
+    Library/Navigation/FlowField.h \
+    Library/Navigation/WallDistanceField.h \
+    Library/Navigation/ReachabilityMap.h \
+    Library/3DStructures/Maze3DBuilder.h \
+    Library/Textures/TextureImage.h \
+    Library/Textures/PPMDecoder.h \
+    Library/Textures/TextureCache.h \
+    Library/3DStructures/TiledMaze3DProvider.h \
     Library/3DStructures/TexturedQuad.h \
     Library/3DStructures/Quad.h \
     Library/3DStructures/Point3D.h \
@@ -57,6 +165,10 @@ HEADERS  += \
     Library/IOControl/Serializable.h \
     Library/IOControl/IOError.h \
     Library/IOControl/FileHandler.h \
+    Library/IOControl/MappedFile.h \
+    Library/IOControl/DurableFile.h \
+    Library/IOControl/ProgressMonitor.h \
+    Library/IOControl/OperationCanceled.h \
     Library/UserInteraction/UserInteractionStateFP.h \
     Library/UserInteraction/UserInteractionState.h \
     Library/UserInteraction/TransformationStateFP.h \
@@ -65,8 +177,12 @@ HEADERS  += \
     Library/UserInteraction/ProjectionState.h \
     Library/Util/FramesPerSecondController.h \
     Library/Util/ConversionFunctions.h \
+    Library/Util/GeometryScalar.h \
 	Library/Util/BoundsCheckingContainer.h \
     Edit/edit2DMaze.h \
 	View/view3DMaze.h \
     Explore/explore3DMaze.h \
-    MainWindow/MainWindow.h
+    MainWindow/MainWindow.h \
+    MainWindow/MazeBuildTask.h \
+    MainWindow/MazeFileTask.h \
+    MainWindow/TextureLoadTask.h
@@ -8,6 +8,8 @@
 */
 
 #include <assert.h>
+#include <algorithm>
+#include <cmath>
 #include "edit2DMaze.h"
 #include "Maze3D.h"
 
@@ -15,18 +17,32 @@ const QColor EditWidget::walls_color( 26, 26, 26 );
 const QColor EditWidget::bkgrd_color( 102, 102, 102 );
 const QColor EditWidget::inside_maze_color( 205, 205, 205 );
 const QColor EditWidget::figure_color( 178, 77, 77 );
+const QColor EditWidget::path_color( 51, 128, 204 );
+const QColor EditWidget::unreachable_color( 230, 170, 150 );
+
+const double EditWidget::path_cell_size = 1.5;
+const int EditWidget::max_path_cells = 1 << 23;
 
 const float EditWidget::maxMazeToAllScreenRatio = 0.75f;
 
 const int exit_success = 0;
 const Qt::Key lift_up_pen_button = Qt::Key_Space;
+const Qt::Key find_path_button = Qt::Key_P;
 
 EditWidget::EditWidget( QWidget * parent /* = NULL */ ) :
 	QGLWidget( QGLFormat( QGL::DoubleBuffer | QGL::Rgba ), parent ),
 	maze( 450, 450 ),
 	drawLineToCursor( false ),
-	lineWidth( 1.0 )
+	lineWidth( 1.0 ),
+	pathClearance( 0.0 ),
+	pathGrid(),
+	pathSearch(),
+	pathGoal(),
+	showingPath( false ),
+	path(),
+	reachability()
 {
+	buildPathGrid( maze, pathClearance, pathGrid, reachability );
 	setMouseTracking( true );	// so the widget can listen to mouse movement when a mouse button isn't down
 	setFocusPolicy( Qt::ClickFocus );	// so the widget can accept keyboard input
 	setContextMenuPolicy( Qt::ActionsContextMenu );	// so the widget can respond to context menu requests with it list of actions
@@ -106,6 +122,40 @@ void EditWidget::paintGL()
 		glEnd();
 	}
 
+	/* shade the parts of the maze the player can't get to from where they start, straight from the reachability map's
+	 * clusters, so an edit never has to collect them all again ( clusters that can be reached all over are skipped )
+	 */
+	if( reachability.startIsOpen() )
+	{
+		qglColor( unreachable_color );
+		glBegin( GL_QUADS );
+
+		double halfCell = pathGrid.getCellSize() / 2;
+		for( int cluster = 0; cluster < reachability.numberOfClusters(); cluster++ )
+		{
+			if( reachability.clusterIsReachable( cluster ) )
+			{
+				continue;
+			}
+			const std::vector<ReachabilityMap::Run> & runs = reachability.runsIn( cluster );
+			for( unsigned int i = 0; i < runs.size(); i++ )
+			{
+				if( reachability.runIsReachable( cluster, runs[ i ] ) )
+				{
+					continue;
+				}
+				Point2D first = pathGrid.centerOf( runs[ i ].firstColumn, runs[ i ].row );
+				Point2D last = pathGrid.centerOf( runs[ i ].lastColumn, runs[ i ].row );
+				glVertex2f( first.getX() - halfCell, first.getY() - halfCell );
+				glVertex2f( last.getX() + halfCell, last.getY() - halfCell );
+				glVertex2f( last.getX() + halfCell, last.getY() + halfCell );
+				glVertex2f( first.getX() - halfCell, first.getY() + halfCell );
+			}
+		}
+
+		glEnd();
+	}
+
 	qglColor( walls_color );
 
 	//draw the walls of the maze
@@ -120,6 +170,25 @@ void EditWidget::paintGL()
 	}
 	glEnd();
 
+	// draw the path from where the player starts to the goal, and mark the goal
+	if( showingPath )
+	{
+		qglColor( path_color );
+		glBegin( GL_LINE_STRIP );
+		for( unsigned int i = 0; i < path.size(); i++ )
+		{
+			glVertex2f( path[ i ].getX(), path[ i ].getY() );
+		}
+		glEnd();
+
+		glBegin( GL_LINES );
+		glVertex2f( pathGoal.getX() - 4, pathGoal.getY() - 4 );
+		glVertex2f( pathGoal.getX() + 4, pathGoal.getY() + 4 );
+		glVertex2f( pathGoal.getX() - 4, pathGoal.getY() + 4 );
+		glVertex2f( pathGoal.getX() + 4, pathGoal.getY() - 4 );
+		glEnd();
+	}
+
 	/* draw an icon which represents the user's placement if and when
 	 * the user wishes to explore this maze in First Person
 	 */
@@ -134,6 +203,13 @@ void EditWidget::paintGL()
 		glEnd();
 	}
 
+	// without anywhere open for the player to start, everything would be shaded, so say why nothing can be reached instead
+	if( !reachability.startIsOpen() )
+	{
+		qglColor( walls_color );
+		renderText( 10, 20, tr( "The walls leave the player nowhere to start from, so nothing can be reached" ) );
+	}
+
 	glFlush();
 }
 
@@ -152,6 +228,15 @@ void EditWidget::mousePressEvent( QMouseEvent * event )
 			//then you know to create a new line for this maze
 			LineSegment2D line( lastPointClicked, mouseCursor );
 			maze.addALine( line );
+			pathGrid.addALine( line );
+			reachability.lineAdded( pathGrid, line );
+
+			// blocking cells can't make the path any shorter, so it only has to be found again if the line got in its way
+			if( showingPath && !pathSearch.pathStillOpen( pathGrid, path ) )
+			{
+				updatePath();
+			}
+			emit lineAdded( line );
 			emit mazeEdited( maze );
 		}
 
@@ -177,7 +262,8 @@ void EditWidget::mouseMoveEvent( QMouseEvent * event )
 
 
 /* keyboard input handler....
- * allows the user to lift up their drawing pen
+ * allows the user to lift up their drawing pen,
+ * or to pick the spot under the cursor as the goal of the path shown
  */
 void EditWidget::keyPressEvent( QKeyEvent * event )
 {
@@ -189,6 +275,13 @@ void EditWidget::keyPressEvent( QKeyEvent * event )
 			updateGL();
 			break;
 
+		case find_path_button:
+			pathGoal = mouseCursor;
+			showingPath = true;
+			updatePath();
+			updateGL();
+			break;
+
 		default:
 			QGLWidget::keyPressEvent( event );
 			break;
@@ -196,53 +289,44 @@ void EditWidget::keyPressEvent( QKeyEvent * event )
 }
 
 
-/* open a maze file
- * return true if the open was succeessful
+/* put a maze that's been opened somewhere else in place of the one being edited,
+ * along with the path grid and reachability built for it by buildPathGrid,
+ * each one given gets the one that was being used in return
+ * ( if the path clearance has changed since they were built, set it again afterwards )
+ * ( this isn't an edit, so mazeEdited isn't emitted )
  */
-bool EditWidget::openMaze( const QString & fileName )
+void EditWidget::replaceMaze( Maze2D & newMaze, OccupancyGrid & newPathGrid, ReachabilityMap & newReachability )
 {
-	bool openWasSuccessful = true;
-	try
-	{
-		FileHandler File( fileName.toStdString() );
-		File.ReadFromFile( maze );
-		drawLineToCursor = false;
-		updateGL();
-	}
-	catch ( IOError & ioe )
-	{
-		QMessageBox::warning( this, tr( "3DMaze" ),
-									tr( "An error occured while trying to open '%1'" ).arg( fileName ),
-									QMessageBox::Ok );
-
-		openWasSuccessful = false;
-	}
-
-	return openWasSuccessful;
+	maze.swap( newMaze );
+	drawLineToCursor = false;
+	pathGrid.swap( newPathGrid );
+	reachability.swap( newReachability );
+	updatePath();
+	updateGL();
 }
 
 
-/* save the 2D maze out to a file
- * return true if the save was succeessful
+/* rasterizes the maze into the grid paths are found on, and works out which parts of it can be reached from where the player starts,
+ * big mazes get wider cells so the grid never has more than max_path_cells of them
+ * ( no widget is touched, so this can be done on another thread, and it throws an OperationCanceled if the progress monitor cancels it )
  */
-bool EditWidget::saveMaze( const QString & fileName )
+void EditWidget::buildPathGrid( const Maze2D & maze, double clearance, OccupancyGrid & grid, ReachabilityMap & reachability,
+								ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
 {
-	bool saveWasSuccessful = true;
-	try
-	{
-		FileHandler File( fileName.toStdString() );
-		File.WriteToFile( maze );
-	}
-	catch ( IOError & ioe )
-	{
-		QMessageBox::warning( this, tr( "3DMaze" ),
-									tr( "An error occured while trying to save '%1'" ).arg( fileName ),
-									QMessageBox::Ok );
+	double area = ( double ) maze.getWidth() * maze.getHeight();
+	double cellSize = std::max( path_cell_size, sqrt( area / max_path_cells ) );
 
-		saveWasSuccessful = false;
-	}
+	/* a cell is blocked if any of it comes within the clearance, so wider cells would close off passages the usual ones leave open,
+	 * the clearance is cut back by however much further from their centers they reach ( paths in big mazes can come that much closer to the walls )
+	 */
+	double reachedFurther = ( cellSize - path_cell_size ) * sqrt( 2.0 ) / 2.0;
 
-	return saveWasSuccessful;
+	ProgressRange rasterizing( progress, 0.0, 0.5 );
+	grid.rasterize( maze, cellSize, std::max( 0.0, clearance - reachedFurther ), &rasterizing );
+
+	// the player always starts out in the middle of the maze ( or as near it as the walls allow )
+	ProgressRange reaching( progress, 0.5, 1.0 );
+	reachability.rebuild( grid, Point2D( 0.0, 0.0 ), &reaching );
 }
 
 
@@ -252,11 +336,47 @@ void EditWidget::setMazeToDefault()
 {
 	maze.clear();
 	drawLineToCursor = false;
+	buildPathGrid( maze, pathClearance, pathGrid, reachability );
+	updatePath();
+	emit mazeCleared();
 	emit mazeEdited( maze );
 	updateGL();
 }
 
 
+/* paths keep at least this far from the walls
+ */
+void EditWidget::setPathClearance( double clearance )
+{
+	pathClearance = clearance;
+	buildPathGrid( maze, pathClearance, pathGrid, reachability );
+	updatePath();
+	updateGL();
+}
+
+
+/* find the path again, after the maze or the goal has changed
+ */
+void EditWidget::updatePath()
+{
+	if( showingPath )
+	{
+		/* from the same open cell reachability starts from, since the middle of the maze can be on a wall,
+		 * and only if the goal can be reached, since otherwise the search would go through every cell it can reach before giving up
+		 */
+		int column, row, goalColumn, goalRow;
+		if( reachability.startCell( column, row ) && pathGrid.cellAt( pathGoal, goalColumn, goalRow ) && reachability.isReachable( goalColumn, goalRow ) )
+		{
+			pathSearch.findPath( pathGrid, pathGrid.centerOf( column, row ), pathGoal, path );
+		}
+		else
+		{
+			path.clear();
+		}
+	}
+}
+
+
 /* map a window coordinate point (relative to the top left of the screen)
  * to world coordinates
  */ 
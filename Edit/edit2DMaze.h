@@ -13,11 +13,16 @@
 #include <QtOpenGL>
 
 #include <iostream>
+#include <vector>
 
 #include "Point2D.h"
 #include "LineSegment2D.h"
 #include "Maze2D.h"
 #include "FileHandler.h"
+#include "OccupancyGrid.h"
+#include "PathSearch.h"
+#include "ReachabilityMap.h"
+#include "ProgressMonitor.h"
 
 class EditWidget : public QGLWidget
 {
@@ -27,6 +32,26 @@ class EditWidget : public QGLWidget
 		EditWidget( QWidget * parent = NULL );
 		const Maze2D & getMaze() { return maze; }
 
+		// put a maze that's been opened somewhere else in place of the one being edited,
+		// along with the path grid and reachability built for it by buildPathGrid,
+		// each one given gets the one that was being used in return
+		// ( if the path clearance has changed since they were built, set it again afterwards )
+		// ( this isn't an edit, so mazeEdited isn't emitted )
+		void replaceMaze( Maze2D & newMaze, OccupancyGrid & newPathGrid, ReachabilityMap & newReachability );
+
+		// rasterizes the maze into the grid paths are found on, and works out which parts of it can be reached from where the player starts,
+		// big mazes get wider cells so the grid never has more than max_path_cells of them
+		// ( no widget is touched, so this can be done on another thread, and it throws an OperationCanceled if the progress monitor cancels it )
+		static void buildPathGrid( const Maze2D & maze, double clearance, OccupancyGrid & grid, ReachabilityMap & reachability,
+								   ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		// the path shown from where the player starts to the goal the user picked,
+		// empty if there's no goal or no way to reach it
+		const std::vector<Point2D> & getPath() const { return path; }
+
+		// paths keep at least this far from the walls
+		void setPathClearance( double clearance );
+
 	protected:
 		virtual void initializeGL();
 
@@ -35,7 +60,7 @@ class EditWidget : public QGLWidget
 		virtual void resizeGL( int width, int height );
 
 		// color in the background, draw and color the 2-D maze,
-		// and draw a small "you will be here" triangle
+		// shade the parts of it that can't be reached, and draw a small "you will be here" triangle
 		virtual void paintGL();
 
 		// consecutive mouse presses allow the user to add walls to the maze
@@ -45,18 +70,11 @@ class EditWidget : public QGLWidget
 		// and if the redraw the window if the user is creating a wall
 		virtual void mouseMoveEvent( QMouseEvent * event );
 
-		// allows the user to lift up their drawing pen
+		// allows the user to lift up their drawing pen,
+		// or to pick the spot under the cursor as the goal of the path shown
 		virtual void keyPressEvent( QKeyEvent * event );
 
 	public slots:
-		// open a maze file
-		// return true if the open was succeessful
-		bool openMaze( const QString & fileName );
-
-		// save the 2D maze out to a file
-		// return true if the save was succeessful
-		bool saveMaze( const QString & fileName );
-
 		// erase all walls in the maze except the bounding walls
 		void setMazeToDefault();
 
@@ -64,21 +82,45 @@ class EditWidget : public QGLWidget
 		// emitted whenever the user makes an edit to the maze (e.g. adding a wall or removing all walls)
 		void mazeEdited( const Maze2D & maze );
 
+		// emitted just before mazeEdited, saying what the edit was
+		void lineAdded( const LineSegment2D & line );
+		void mazeCleared();
+
 	private:
 		// map a window coordinate point (relative to the top left of the screen)
 		// to world coordinates
 		Point2D convertPointToCoordinatesSystem( int x, int y );
 
+		// find the path again, after the maze or the goal has changed
+		void updatePath();
+
 		Maze2D maze;
 		Point2D lastPointClicked;
 		Point2D mouseCursor;
 		bool drawLineToCursor;
 		double lineWidth;
 
+		double pathClearance;	// how far paths keep from the walls
+		OccupancyGrid pathGrid;
+		PathSearch pathSearch;
+		Point2D pathGoal;
+		bool showingPath;
+		std::vector<Point2D> path;
+
+		// which cells of the path grid can be reached from where the player starts
+		ReachabilityMap reachability;
+
 		static const QColor walls_color;
 		static const QColor bkgrd_color;
 		static const QColor inside_maze_color;
 		static const QColor figure_color;
+		static const QColor path_color;
+		static const QColor unreachable_color;
+
+		// the size of the cells walls are rasterized into when finding paths,
+		// unless the maze is so big it would take more than max_path_cells of them
+		static const double path_cell_size;
+		static const int max_path_cells;
 
 		static const float maxMazeToAllScreenRatio;
 };
@@ -41,15 +41,17 @@ const Qt::Key ExploreWidget::strafe_left_button = Qt::Key_A;
 const Qt::Key ExploreWidget::jump_button = Qt::Key_Space;
 const Qt::Key ExploreWidget::zoom_in_button = Qt::Key_C;
 const Qt::Key ExploreWidget::zoom_out_button = Qt::Key_R;
+const Qt::Key ExploreWidget::follow_path_button = Qt::Key_F;
 
 
-ExploreWidget::ExploreWidget( const Maze3D & maze_, const QImage & floorTexture_, const QImage & wallsTexture_, QWidget * parent /*= NULL*/ ) :
+ExploreWidget::ExploreWidget( const Maze3D & maze_, const TextureImage & floorTexture_, const TextureImage & wallsTexture_, QWidget * parent /*= NULL*/ ) :
 	QGLWidget( QGLFormat( QGL::DoubleBuffer | QGL::Rgba | QGL::DepthBuffer ), parent ),
 	maze( maze_ ),
 	floorTexture( floorTexture_ ),
 	wallsTexture( wallsTexture_ ),
 	floorTextureNumber( 0 ),
 	wallsTextureNumber( 0 ),
+	chunkBuffers(),
 	stateOfProjection(	initial_fovy_angle,
 						initial_z_coord_of_camera,
 						z_value_of_far_clipping_plane,
@@ -61,18 +63,46 @@ ExploreWidget::ExploreWidget( const Maze3D & maze_, const QImage & floorTexture_
 								incremental_position_change,
 								jump_velocity,
 								buffer_distance ),
-	timesCursorHidden( 0 )
+	timesCursorHidden( 0 ),
+	pathToFollow(),
+	nextPointOnPath( 0 ),
+	followingPath( false )
 {
 	setMouseTracking( true );	// so the widget can listen to mouse movement when a mouse button isn't down
 	setFocusPolicy( Qt::ClickFocus );	// so the widget can accept keyboard input
 }
 
 
-/* make sure the cursor is no longer hidden when this widget is detroyed
+/* make sure the cursor is no longer hidden when this widget is detroyed,
+ * and free the chunk buffers and textures while this widget's context is still around
  */
 ExploreWidget::~ExploreWidget()
 {
 	stopHidingCursor();
+
+	makeCurrent();
+	chunkBuffers.releaseAllBuffers();
+	glDeleteTextures( 1, &floorTextureNumber );
+	glDeleteTextures( 1, &wallsTextureNumber );
+}
+
+
+/* a path through the maze, in the floor's coordinates, that the player can be walked along
+ */
+void ExploreWidget::setPathToFollow( const std::vector<Point2D> & path )
+{
+	pathToFollow = path;
+	nextPointOnPath = 0;
+	followingPath = false;
+}
+
+
+/* how far the maze's walls are, so the player is only checked against them when close to one,
+ * the field has to outlast this widget
+ */
+void ExploreWidget::setWallDistanceField( const WallDistanceField * wallDistances )
+{
+	stateOfTransformationFP.setWallDistanceField( wallDistances );
 }
 
 
@@ -80,11 +110,11 @@ void ExploreWidget::initializeGL()
 {
 	glEnable( GL_DEPTH_TEST );
 
-	//register the floor texture
-	floorTextureNumber = bindTexture( floorTexture, GL_TEXTURE_2D );
+	//upload the floor texture
+	floorTextureNumber = floorTexture.upload();
 
-	//register the wall texture
-	wallsTextureNumber = bindTexture( wallsTexture, GL_TEXTURE_2D );
+	//upload the wall texture
+	wallsTextureNumber = wallsTexture.upload();
 
 	// set up a timer to control the frame rate
 	QTimer * redrawTimer = new QTimer( this );
@@ -98,7 +128,11 @@ void ExploreWidget::initializeGL()
  */
 void ExploreWidget::paintGL()
 {
-	//update the players position
+	//update the players position, walking them along the path if they're following it
+	if( followingPath )
+	{
+		followPath();
+	}
 	stateOfTransformationFP.updatePosition( maze, stateOfUserInteractionFP );
 	
 	//set up the drawing environment
@@ -118,7 +152,7 @@ void ExploreWidget::paintGL()
     glRotatef( global_x_tilt, 1.0, 0.0, 0.0 );
     
     //draw the maze
-	maze.Draw( floorTextureNumber, wallsTextureNumber );
+	maze.Draw( floorTextureNumber, wallsTextureNumber, &chunkBuffers );
     
     //if the user is changing their perspective
 	if( stateOfUserInteractionFP.isZoomingIn() )
@@ -148,6 +182,12 @@ void ExploreWidget::paintGL()
 		int padding = 4;
 		renderText( padding, padding + instructionsRect.height(), quitInstructions, font );
 		renderText( padding, 2 * ( padding + instructionsRect.height() ), releaseMouseInstructions, font );
+		if( !pathToFollow.empty() )
+		{
+			QKeySequence followPathSequence( follow_path_button );
+			QString followPathInstructions = QString( "Press %1 to %2 following the path" ).arg( followPathSequence.toString() ).arg( followingPath ? "stop" : "start" );
+			renderText( padding, 3 * ( padding + instructionsRect.height() ), followPathInstructions, font );
+		}
 	}
 
 	glFlush();
@@ -187,6 +227,15 @@ void ExploreWidget::keyPressEvent( QKeyEvent * event )
 									
 		case jump_button:			stateOfTransformationFP.jump();
 									break;
+
+		case follow_path_button:	if( !pathToFollow.empty() )
+									{
+										// the player heads back to the start of the path, then along it
+										followingPath = !followingPath;
+										nextPointOnPath = 0;
+										stateOfUserInteractionFP.setMovingForward( false );
+									}
+									break;
 									
 		default:					QGLWidget::keyPressEvent( event );
 									break;
@@ -283,6 +332,30 @@ void ExploreWidget::focusInEvent( QFocusEvent * event )
 }
 
 
+/* turn the player toward the next point on the path and walk them forward,
+ * stopping once they reach the end of the path
+ */
+void ExploreWidget::followPath()
+{
+	//a point counts as reached once the player is within a step of it
+	Point2D position = stateOfTransformationFP.getPositionOnFloor();
+	while( ( nextPointOnPath < pathToFollow.size() ) && ( position.distanceTo( pathToFollow[ nextPointOnPath ] ) <= incremental_position_change ) )
+	{
+		nextPointOnPath++;
+	}
+
+	if( nextPointOnPath >= pathToFollow.size() )
+	{
+		followingPath = false;
+		stateOfUserInteractionFP.setMovingForward( false );
+		return;
+	}
+
+	stateOfTransformationFP.faceToward( pathToFollow[ nextPointOnPath ] );
+	stateOfUserInteractionFP.setMovingForward( true );
+}
+
+
 /* computes the viewing frustum
  * given the current state of affairs
  */
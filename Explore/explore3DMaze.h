@@ -19,10 +19,15 @@
 #include <string.h>
 #include <math.h>
 #include <ctime>
+#include <vector>
 
 #include "Maze3D.h"
+#include "Point2D.h"
+#include "ChunkBufferCache.h"
+#include "TextureImage.h"
 #include "ProjectionState.h"
 #include "TransformationStateFP.h"
+#include "WallDistanceField.h"
 #include "UserInteractionStateFP.h"
 #include "FramesPerSecondController.h"
 
@@ -31,9 +36,19 @@ class ExploreWidget : public QGLWidget
 	Q_OBJECT
 
 	public:
-		ExploreWidget( const Maze3D & maze, const QImage & floorTexture_, const QImage & wallsTexture_, QWidget * parent = NULL );
+		ExploreWidget( const Maze3D & maze, const TextureImage & floorTexture_, const TextureImage & wallsTexture_, QWidget * parent = NULL );
 		virtual ~ExploreWidget();
 
+		// a path through the maze, in the floor's coordinates, that the player can be walked along
+		void setPathToFollow( const std::vector<Point2D> & path );
+
+		// how far the maze's walls are, so the player is only checked against them when close to one,
+		// the field has to outlast this widget
+		void setWallDistanceField( const WallDistanceField * wallDistances );
+
+		// buffer between player and walls, a path the player can follow keeps at least this far from them
+		static double getBufferDistance() { return buffer_distance; }
+
 	signals:
 		void stealMyFocus();
 
@@ -75,20 +90,30 @@ class ExploreWidget : public QGLWidget
 		// undo all the times we've hid the cursor
 		void stopHidingCursor();
 
+		// turn the player toward the next point on the path and walk them forward,
+		// stopping once they reach the end of the path
+		void followPath();
+
 		const Maze3D & maze;
 
-		const QImage & floorTexture;
-		const QImage & wallsTexture;
+		const TextureImage & floorTexture;
+		const TextureImage & wallsTexture;
 
 		GLuint floorTextureNumber;
 		GLuint wallsTextureNumber;
 
+		ChunkBufferCache chunkBuffers;
+
 		ProjectionState stateOfProjection;
 		TransformationStateFP stateOfTransformationFP;
 		UserInteractionStateFP stateOfUserInteractionFP;
 
 		int timesCursorHidden;
 
+		std::vector<Point2D> pathToFollow;
+		unsigned int nextPointOnPath;
+		bool followingPath;
+
 		static const int initial_window_width = 900;
 		static const int initial_window_height = 900;
 		static const int initial_window_x_position = 300;
@@ -126,6 +151,7 @@ class ExploreWidget : public QGLWidget
 		static const Qt::Key jump_button;
 		static const Qt::Key zoom_in_button;
 		static const Qt::Key zoom_out_button;
+		static const Qt::Key follow_path_button;
 };
 
 #endif /*EXPLOREDMAZE_H_*/
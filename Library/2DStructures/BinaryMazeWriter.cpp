@@ -0,0 +1,103 @@
+/*
+   Project     : 3DMaze
+   File        : BinaryMazeWriter.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Writes a 2D maze in binary form out of lines handed to it
+   				 one at a time, straight to the file as they come in. The
+   				 number of lines in the header is filled in once they're
+   				 all written
+*/
+
+
+#include "BinaryMazeWriter.h"
+
+#include <limits>
+#include <cstdio>
+
+using namespace std;
+
+BinaryMazeWriter::BinaryMazeWriter( const string & m_fileName, int m_width, int m_height ) throw( IOError & ) :
+	fileName( m_fileName ),
+	out( m_fileName.c_str(), ios::out | ios::binary | ios::trunc ),
+	header( MappedMaze2D::headerFor( m_width, m_height, 0 ) ),
+	batch(),
+	finished( false )
+{
+	//the header goes first, and is written again once the lines are counted
+	out.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+	if( !out )
+	{
+		throw IOError();
+	}
+	batch.reserve( lines_per_batch * BinaryMazeHeader::floats_per_line );
+}
+
+
+/* throws away the file, which is only complete if finish was called
+ */
+BinaryMazeWriter::~BinaryMazeWriter()
+{
+	if( !finished )
+	{
+		out.close();
+		remove( fileName.c_str() );
+	}
+}
+
+
+/* throws an IOError once the maze has as many lines as its header can count
+ */
+void BinaryMazeWriter::addALine( const LineSegment2D & line ) throw( IOError & )
+{
+	if( finished || ( header.numberOfLines == numeric_limits<uint32_t>::max() ) )
+	{
+		throw IOError();
+	}
+
+	batch.push_back( line.getP1().getX() );
+	batch.push_back( line.getP1().getY() );
+	batch.push_back( line.getP2().getX() );
+	batch.push_back( line.getP2().getY() );
+	header.numberOfLines++;
+	if( batch.size() == batch.capacity() )
+	{
+		writeBatch();
+	}
+}
+
+
+/* writes out the last of the lines and fills in the header, no more lines can be added afterwards
+ */
+void BinaryMazeWriter::finish() throw( IOError & )
+{
+	if( finished )
+	{
+		throw IOError();
+	}
+	writeBatch();
+	finished = true;
+
+	out.seekp( 0 );
+	out.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+	out.close();
+	if( !out )
+	{
+		throw IOError();
+	}
+}
+
+
+void BinaryMazeWriter::writeBatch() throw( IOError & )
+{
+	if( batch.empty() )
+	{
+		return;
+	}
+	out.write( reinterpret_cast<const char *>( &batch[ 0 ] ), batch.size() * sizeof( float ) );
+	batch.clear();
+	if( !out )
+	{
+		throw IOError();
+	}
+}
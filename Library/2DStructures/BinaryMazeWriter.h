@@ -0,0 +1,60 @@
+/*
+   Project     : 3DMaze
+   File        : BinaryMazeWriter.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Writes a 2D maze in binary form out of lines handed to it
+   				 one at a time, straight to the file as they come in. The
+   				 number of lines in the header is filled in once they're
+   				 all written
+*/
+
+
+#ifndef BINARYMAZEWRITER_H_
+#define BINARYMAZEWRITER_H_
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "MappedMaze2D.h"
+#include "MazeLineSink.h"
+#include "LineSegment2D.h"
+#include "IOError.h"
+
+class BinaryMazeWriter : public MazeLineSink
+{
+	public:
+		BinaryMazeWriter( const std::string & m_fileName, int m_width, int m_height ) throw( IOError & );
+
+		/* throws away the file, which is only complete if finish was called
+		 */
+		~BinaryMazeWriter();
+
+		/* throws an IOError once the maze has as many lines as its header can count
+		 */
+		void addALine( const LineSegment2D & line ) throw( IOError & );
+		uint32_t numberOfLinesAdded() const { return header.numberOfLines; }
+
+		/* writes out the last of the lines and fills in the header, no more lines can be added afterwards
+		 */
+		void finish() throw( IOError & );
+
+	private:
+		std::string fileName;
+		std::ofstream out;
+		BinaryMazeHeader header;
+		std::vector<float> batch;
+		bool finished;
+
+		void writeBatch() throw( IOError & );
+
+		// endpoints are written out this many lines at a time
+		static const unsigned int lines_per_batch = 4096;
+
+		// disable copying, there's only one file
+		BinaryMazeWriter( const BinaryMazeWriter & );
+		const BinaryMazeWriter & operator=( const BinaryMazeWriter & );
+};
+
+#endif /*BINARYMAZEWRITER_H_*/
@@ -0,0 +1,146 @@
+/*
+   Project     : 3DMaze
+   File        : MappedMaze2D.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A read only view of a 2D maze in binary form, used right
+   				 where it lies in memory without being parsed or copied.
+   				 The binary form is a header followed by the endpoints of
+   				 every line, packed as floats ( x1, y1, x2, y2 for each line )
+*/
+
+
+#include "MappedMaze2D.h"
+
+#include <string.h>
+
+#include "FileHandler.h"
+
+using namespace std;
+
+/* maps the file into memory and uses it from there
+ */
+MappedMaze2D::MappedMaze2D( const string & fileName ) throw( IOError & ) :
+	file( new MappedFile( fileName ) ),
+	header( NULL ),
+	endpoints( NULL )
+{
+	try
+	{
+		useMemory( file->getData(), file->getSize() );
+	}
+	catch( IOError & ioe )
+	{
+		delete file;
+		throw;
+	}
+}
+
+
+/* uses memory that's already holding a maze in binary form,
+ * which has to stay around for as long as this view does
+ */
+MappedMaze2D::MappedMaze2D( const char * data, size_t size ) throw( IOError & ) :
+	file( NULL ),
+	header( NULL ),
+	endpoints( NULL )
+{
+	useMemory( data, size );
+}
+
+MappedMaze2D::~MappedMaze2D()
+{
+	delete file;
+}
+
+
+/* builds the line out of its endpoints
+ */
+LineSegment2D MappedMaze2D::getALine( int index ) const
+{
+	const float * line = endpoints + ( index * BinaryMazeHeader::floats_per_line );
+	return LineSegment2D( Point2D( line[ 0 ], line[ 1 ] ), Point2D( line[ 2 ], line[ 3 ] ) );
+}
+
+
+/* writes out a maze with the given size and lines in binary form,
+ * marked as normalized if the caller knows its lines are
+ */
+void MappedMaze2D::writeOut( ostream & out, int width, int height, const vector<LineSegment2D> & lines,
+							 ProgressMonitor * progress /* = NULL */, bool normalized /* = false */ ) throw( IOError & )
+{
+	BinaryMazeHeader header = headerFor( width, height, lines.size(), normalized );
+	out.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+
+	//write the endpoints out a batch at a time
+	const unsigned int lines_per_batch = 4096;
+	vector<float> batch;
+	batch.reserve( lines_per_batch * BinaryMazeHeader::floats_per_line );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		batch.push_back( lines[ i ].getP1().getX() );
+		batch.push_back( lines[ i ].getP1().getY() );
+		batch.push_back( lines[ i ].getP2().getX() );
+		batch.push_back( lines[ i ].getP2().getY() );
+		if( ( batch.size() == batch.capacity() ) || ( ( i + 1 ) == lines.size() ) )
+		{
+			out.write( reinterpret_cast<const char *>( &batch[ 0 ] ), batch.size() * sizeof( float ) );
+			batch.clear();
+			ProgressMonitor::checkIn( progress, ( double ) ( i + 1 ) / lines.size() );
+		}
+	}
+
+	if( !out )
+	{
+		throw IOError();
+	}
+}
+
+
+/* the header of a maze with the given size and number of lines in binary form
+ */
+BinaryMazeHeader MappedMaze2D::headerFor( int width, int height, uint32_t numberOfLines, bool normalized /* = false */ )
+{
+	BinaryMazeHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magicNumber, FileHandler::binary_magic_number, sizeof( header.magicNumber ) );
+	header.byteOrderMark = BinaryMazeHeader::byte_order_mark;
+	header.version = BinaryMazeHeader::current_version;
+	header.width = width;
+	header.height = height;
+	header.numberOfLines = numberOfLines;
+	header.offsetOfEndpoints = sizeof( header );
+	header.flags = normalized ? BinaryMazeHeader::normalized_flag : 0;
+	return header;
+}
+
+
+/* checks that the memory really holds a maze in binary form that this version understands
+ */
+void MappedMaze2D::useMemory( const char * data, size_t size ) throw( IOError & )
+{
+	if( ( data == NULL ) || ( size < sizeof( BinaryMazeHeader ) ) )
+	{
+		throw IOError();
+	}
+
+	header = reinterpret_cast<const BinaryMazeHeader *>( data );
+	if( ( memcmp( header->magicNumber, FileHandler::binary_magic_number, sizeof( header->magicNumber ) ) != 0 ) ||
+		( header->byteOrderMark != BinaryMazeHeader::byte_order_mark ) ||
+		( header->version != BinaryMazeHeader::current_version ) ||
+		( ( header->offsetOfEndpoints % sizeof( float ) ) != 0 ) ||
+		( header->offsetOfEndpoints < sizeof( BinaryMazeHeader ) ) ||
+		( header->offsetOfEndpoints > size ) )
+	{
+		throw IOError();
+	}
+
+	//make sure all the endpoints are really there
+	size_t sizeOfEndpoints = size - header->offsetOfEndpoints;
+	if( ( sizeOfEndpoints / ( BinaryMazeHeader::floats_per_line * sizeof( float ) ) ) < header->numberOfLines )
+	{
+		throw IOError();
+	}
+
+	endpoints = reinterpret_cast<const float *>( data + header->offsetOfEndpoints );
+}
@@ -0,0 +1,103 @@
+/*
+   Project     : 3DMaze
+   File        : MappedMaze2D.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A read only view of a 2D maze in binary form, used right
+   				 where it lies in memory without being parsed or copied.
+   				 The binary form is a header followed by the endpoints of
+   				 every line, packed as floats ( x1, y1, x2, y2 for each line )
+*/
+
+
+#ifndef MAPPEDMAZE2D_H_
+#define MAPPEDMAZE2D_H_
+
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstddef>
+#include <stdint.h>
+
+#include "LineSegment2D.h"
+#include "MappedFile.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+/* the start of every 2D maze in binary form, padded out so the endpoints after it are aligned
+ */
+class BinaryMazeHeader
+{
+	public:
+		char magicNumber[ 8 ];
+		uint32_t byteOrderMark;		// written as byte_order_mark, so files from machines with a different byte order are recognized
+		uint32_t version;
+		int32_t width;
+		int32_t height;
+		uint32_t numberOfLines;
+		uint32_t offsetOfEndpoints;	// from the start of the header
+		uint32_t flags;				// normalized_flag if the lines were already normalized when they were written
+		char padding[ 28 ];
+
+		static const uint32_t byte_order_mark = 0x01020304;
+		static const uint32_t current_version = 1;
+		static const uint32_t normalized_flag = 1;
+		static const int floats_per_line = 4;
+};
+
+class MappedMaze2D
+{
+	public:
+		/* maps the file into memory and uses it from there
+		 */
+		MappedMaze2D( const std::string & fileName ) throw( IOError & );
+
+		/* uses memory that's already holding a maze in binary form,
+		 * which has to stay around for as long as this view does
+		 */
+		MappedMaze2D( const char * data, std::size_t size ) throw( IOError & );
+
+		~MappedMaze2D();
+
+		int getWidth() const { return header->width; }
+		int getHeight() const { return header->height; }
+		int numberOfLines() const { return header->numberOfLines; }
+
+		/* true if the lines were already normalized when they were written, so reading them
+		 * back in doesn't need to normalize them again ( files without the flag always need it )
+		 */
+		bool isNormalized() const { return ( header->flags & BinaryMazeHeader::normalized_flag ) != 0; }
+
+		/* builds the line out of its endpoints
+		 */
+		LineSegment2D getALine( int index ) const;
+
+		/* x1, y1, x2, y2 of every line, one after another
+		 */
+		const float * getEndpoints() const { return endpoints; }
+
+		/* writes out a maze with the given size and lines in binary form,
+		 * marked as normalized if the caller knows its lines are
+		 */
+		static void writeOut( std::ostream & out, int width, int height, const std::vector<LineSegment2D> & lines,
+							  ProgressMonitor * progress = NULL, bool normalized = false ) throw( IOError & );
+
+		/* the header of a maze with the given size and number of lines in binary form
+		 */
+		static BinaryMazeHeader headerFor( int width, int height, uint32_t numberOfLines, bool normalized = false );
+
+	private:
+		MappedFile * file;
+		const BinaryMazeHeader * header;
+		const float * endpoints;
+
+		/* checks that the memory really holds a maze in binary form that this version understands
+		 */
+		void useMemory( const char * data, std::size_t size ) throw( IOError & );
+
+		// disable copying, the file can only be unmapped once
+		MappedMaze2D( const MappedMaze2D & );
+		const MappedMaze2D & operator=( const MappedMaze2D & );
+};
+
+#endif /*MAPPEDMAZE2D_H_*/
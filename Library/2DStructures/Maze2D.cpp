@@ -9,12 +9,19 @@
 
 #include "Maze2D.h"
 
+#include "MappedMaze2D.h"
+#include "MazeTextReader.h"
+
+#include <algorithm>
+
 using namespace std;
 
 Maze2D::Maze2D( int m_width /* = 0 */, int m_height /* = 0 */ ) : 
 	lines(), 
 	width( m_width ), 
-	height( m_height ) { addOuterWalls(); }
+	height( m_height ),
+	lastNormalization(),
+	normalized( false ) { addOuterWalls(); }
 
 
 /* erases all lines except the 4 outer walls
@@ -22,6 +29,7 @@ Maze2D::Maze2D( int m_width /* = 0 */, int m_height /* = 0 */ ) :
 void Maze2D::clear()
 {
 	lines.clear();
+	normalized = false;
 	addOuterWalls();
 }
 
@@ -47,6 +55,7 @@ void Maze2D::Draw() const
 void Maze2D::readIn( istream & in /* = cin */ ) throw( IOError & )
 {
 	lines.clear();
+	normalized = false;
 	
 	in >> width >> height;
 	
@@ -59,9 +68,16 @@ void Maze2D::readIn( istream & in /* = cin */ ) throw( IOError & )
 		line.readIn( in );
 		addALine( line );
 	}
+
+	normalize();
 }
 
 void Maze2D::writeOut( ostream & out /* = cout */ ) const throw( IOError & )
+{
+	writeOutText( out );
+}
+
+void Maze2D::writeOutText( ostream & out, ProgressMonitor * progress /* = NULL */ ) const throw( IOError & )
 {
 	//should we just get an iterator of the vector of lines??
 	out << width << " " << height << '\n';
@@ -69,15 +85,133 @@ void Maze2D::writeOut( ostream & out /* = cout */ ) const throw( IOError & )
 	out << numberOfLinesToWrite << '\n';
 	for( int i = 0; i < numberOfLinesToWrite; i++ )
 	{
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) i / numberOfLinesToWrite );
+		}
+
 		const LineSegment2D & line = getALine( i );
 		line.writeOut( out );
 		out << '\n';
 	}
 }
 
+
+/* reads the same text readIn does, but picks the numbers out of memory by hand
+ */
+void Maze2D::readInText( const char * data, size_t size, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	// picking the numbers out goes quickly, it's normalizing the lines that takes most of the time
+	ProgressRange readProgress( progress, 0.0, 0.25 );
+	ProgressRange normalizeProgress( progress, 0.25, 1.0 );
+	normalized = false;
+	MazeTextReader reader( data, size );
+	reader.read( width, height, lines, &readProgress );
+
+	normalize( &normalizeProgress );
+}
+
+
+/* the binary form is read straight out of memory, and normalized just like the text form
+ * unless its header says the lines were already normalized when they were written
+ */
+void Maze2D::readInBinary( const char * data, size_t size, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	ProgressRange readProgress( progress, 0.0, 0.1 );
+	ProgressRange normalizeProgress( progress, 0.1, 1.0 );
+	MappedMaze2D view( data, size );
+
+	lines.clear();
+	normalized = false;
+	lines.reserve( view.numberOfLines() );
+	width = view.getWidth();
+	height = view.getHeight();
+	for( int i = 0; i < view.numberOfLines(); i++ )
+	{
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( &readProgress, ( double ) i / view.numberOfLines() );
+		}
+		lines.push_back( view.getALine( i ) );
+	}
+
+	if( view.isNormalized() )
+	{
+		lastNormalization = NormalizationReport();
+		normalized = true;
+	}
+	else
+	{
+		normalize( &normalizeProgress );
+	}
+}
+
+
+/* marks the file as normalized if nothing was added since the maze was last normalized,
+ * and every endpoint survives being stored as a float
+ */
+void Maze2D::writeOutBinary( ostream & out, ProgressMonitor * progress /* = NULL */ ) const throw( IOError & )
+{
+	MappedMaze2D::writeOut( out, width, height, lines, progress, normalized && fitsInFloats() );
+}
+
+
+/* true if every endpoint is stored exactly when written out as a float
+ */
+bool Maze2D::fitsInFloats() const
+{
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		const Point2D & p1 = lines[ i ].getP1();
+		const Point2D & p2 = lines[ i ].getP2();
+		if( ( ( float ) p1.getX() != p1.getX() ) || ( ( float ) p1.getY() != p1.getY() ) ||
+			( ( float ) p2.getX() != p2.getX() ) || ( ( float ) p2.getY() != p2.getY() ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* trades contents with the other maze, without copying any lines
+ */
+void Maze2D::swap( Maze2D & other )
+{
+	lines.swap( other.lines );
+	std::swap( width, other.width );
+	std::swap( height, other.height );
+	std::swap( lastNormalization, other.lastNormalization );
+	std::swap( normalized, other.normalized );
+}
+
 void Maze2D::addALine( const LineSegment2D & lineToAdd )
 {
 	lines.push_back( lineToAdd );
+	normalized = false;
+}
+
+
+/* adds many lines at once and then normalizes the maze
+ */
+void Maze2D::addLines( const vector<LineSegment2D> & linesToAdd )
+{
+	lines.insert( lines.end(), linesToAdd.begin(), linesToAdd.end() );
+	normalize();
+}
+
+
+/* drops lines with no length, merges lines that continue along the same
+ * straight line and splits lines where they cross
+ * ( throws an OperationCanceled if the progress monitor asks for it to stop )
+ */
+NormalizationReport Maze2D::normalize( ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	MazeNormalizer normalizer;
+	normalized = false;
+	lastNormalization = normalizer.normalize( lines, progress );
+	normalized = true;
+	return lastNormalization;
 }
 
 const LineSegment2D & Maze2D::getALine( int index ) const
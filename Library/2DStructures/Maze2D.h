@@ -14,7 +14,9 @@
 #include <QtOpenGL>
 
 #include "LineSegment2D.h"
+#include "MazeNormalizer.h"
 #include "Serializable.h"
+#include "ProgressMonitor.h"
 #include "IOError.h"
 
 class Maze2D : public Serializable
@@ -23,6 +25,10 @@ class Maze2D : public Serializable
 		Maze2D( int m_width = 0, int m_height = 0 );
 		
 		void addALine( const LineSegment2D & line );
+
+		/* adds many lines at once and then normalizes the maze
+		 */
+		void addLines( const std::vector<LineSegment2D> & linesToAdd );
 		const LineSegment2D & getALine( int index ) const;
 		int numberOfLines() const { return lines.size(); }
 		int getWidth() const { return width; }
@@ -31,6 +37,17 @@ class Maze2D : public Serializable
 		/* erases all lines except the 4 outer walls
 		 */
 		void clear();
+
+		/* drops lines with no length, merges lines that continue along the same
+		 * straight line and splits lines where they cross, this is done automatically
+		 * whenever a maze is read in or lines are added in bulk
+		 * ( throws an OperationCanceled if the progress monitor asks for it to stop )
+		 */
+		NormalizationReport normalize( ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		/* describes what the most recent normalization changed
+		 */
+		const NormalizationReport & getLastNormalization() const { return lastNormalization; }
 		
 		/* Draws the maze using openGL calls
 		 */
@@ -40,11 +57,36 @@ class Maze2D : public Serializable
 		void readIn( std::istream & in = std::cin ) throw( IOError & );
 		void writeOut( std::ostream & out = std::cout ) const throw( IOError & );
 		std::string type() const { return "2D Maze";}
+
+		/* reads the same text readIn does, but picks the numbers out of memory by hand
+		 */
+		void readInText( const char * data, std::size_t size, ProgressMonitor * progress = NULL ) throw( IOError & );
+		void writeOutText( std::ostream & out, ProgressMonitor * progress = NULL ) const throw( IOError & );
+
+		/* the binary form is read straight out of memory, and normalized just like the text form
+		 * unless its header says the lines were already normalized when they were written
+		 */
+		void readInBinary( const char * data, std::size_t size, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		/* marks the file as normalized if nothing was added since the maze was last normalized,
+		 * and every endpoint survives being stored as a float
+		 */
+		void writeOutBinary( std::ostream & out, ProgressMonitor * progress = NULL ) const throw( IOError & );
+
+		/* trades contents with the other maze, without copying any lines
+		 */
+		void swap( Maze2D & other );
 	
 	private:
 		std::vector<LineSegment2D> lines;
 		int width, height;
+		NormalizationReport lastNormalization;
+		bool normalized;	// no lines were added since the last normalization
 		
+		/* true if every endpoint is stored exactly when written out as a float
+		 */
+		bool fitsInFloats() const;
+
 		/* adds the 4 bounding walls
 		 */
 		void addOuterWalls();
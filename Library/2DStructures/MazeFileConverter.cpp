@@ -0,0 +1,75 @@
+/*
+   Project     : 3DMaze
+   File        : MazeFileConverter.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Converts 2D maze files between the text form
+   				 and the binary form, or into tiles
+*/
+
+
+#include "MazeFileConverter.h"
+
+#include "Maze2D.h"
+#include "MappedMaze2D.h"
+#include "FileHandler.h"
+
+using namespace std;
+
+/* reads the maze in the input file, whichever form it's in,
+ * and writes it to the output file in the other form
+ */
+void MazeFileConverter::convert( const string & inputFileName, const string & outputFileName ) throw( IOError & )
+{
+	if( FileHandler( inputFileName ).IsBinary() )
+	{
+		convertToText( inputFileName, outputFileName );
+	}
+	else
+	{
+		convertToBinary( inputFileName, outputFileName );
+	}
+}
+
+void MazeFileConverter::convertToBinary( const string & inputFileName, const string & outputFileName ) throw( IOError & )
+{
+	Maze2D maze;
+	FileHandler( inputFileName ).ReadFromFile( maze );
+	FileHandler( outputFileName ).WriteToFile( maze, true );
+}
+
+void MazeFileConverter::convertToText( const string & inputFileName, const string & outputFileName ) throw( IOError & )
+{
+	Maze2D maze;
+	FileHandler( inputFileName ).ReadFromFile( maze );
+	FileHandler( outputFileName ).WriteToFile( maze, false );
+}
+
+
+/* writes the maze in the input file out as a tiled maze, a maze in binary
+ * form is streamed into the tiles without ever being read in whole
+ */
+void MazeFileConverter::convertToTiled( const string & inputFileName, const string & outputFileName, double tileSize /* = TiledMazeWriter::default_tile_size */ ) throw( IOError & )
+{
+	if( FileHandler( inputFileName ).IsBinary() )
+	{
+		MappedMaze2D maze( inputFileName );
+		TiledMazeWriter writer( outputFileName, maze.getWidth(), maze.getHeight(), tileSize );
+		for( int i = 0; i < maze.numberOfLines(); i++ )
+		{
+			writer.addALine( maze.getALine( i ) );
+		}
+		writer.finish();
+	}
+	else
+	{
+		Maze2D maze;
+		FileHandler( inputFileName ).ReadFromFile( maze );
+		TiledMazeWriter writer( outputFileName, maze.getWidth(), maze.getHeight(), tileSize );
+		for( int i = 0; i < maze.numberOfLines(); i++ )
+		{
+			writer.addALine( maze.getALine( i ) );
+		}
+		writer.finish();
+	}
+}
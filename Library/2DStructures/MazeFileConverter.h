@@ -0,0 +1,37 @@
+/*
+   Project     : 3DMaze
+   File        : MazeFileConverter.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Converts 2D maze files between the text form
+   				 and the binary form, or into tiles
+*/
+
+
+#ifndef MAZEFILECONVERTER_H_
+#define MAZEFILECONVERTER_H_
+
+#include <string>
+
+#include "TiledMazeWriter.h"
+#include "IOError.h"
+
+class MazeFileConverter
+{
+	public:
+		/* reads the maze in the input file, whichever form it's in,
+		 * and writes it to the output file in the other form
+		 */
+		static void convert( const std::string & inputFileName, const std::string & outputFileName ) throw( IOError & );
+
+		static void convertToBinary( const std::string & inputFileName, const std::string & outputFileName ) throw( IOError & );
+		static void convertToText( const std::string & inputFileName, const std::string & outputFileName ) throw( IOError & );
+
+		/* writes the maze in the input file out as a tiled maze, a maze in binary
+		 * form is streamed into the tiles without ever being read in whole
+		 */
+		static void convertToTiled( const std::string & inputFileName, const std::string & outputFileName,
+									double tileSize = TiledMazeWriter::default_tile_size ) throw( IOError & );
+};
+
+#endif /*MAZEFILECONVERTER_H_*/
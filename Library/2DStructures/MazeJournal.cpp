@@ -0,0 +1,322 @@
+/*
+   Project     : 3DMaze
+   File        : MazeJournal.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A record of the edits made to a 2D maze since its file was
+   				 last written in full, kept in a file next to the maze file.
+   				 Edits are added to the end of the journal as they're made, so
+   				 saving them costs as much as the edits do instead of as much as
+   				 the whole maze. Opening the maze file replays the journal on top
+   				 of it, and once the journal gets too big compared to the maze
+   				 the maze file is written out in full and the journal started over
+*/
+
+
+#include "MazeJournal.h"
+
+#include <algorithm>
+#include <string.h>
+
+#include "MappedFile.h"
+
+using namespace std;
+
+const char MazeJournal::magic_number[ MazeJournal::magic_number_length ] = { '3', 'D', 'J', 'r', 'n', 'l', '\x1a', '\0' };
+const long long MazeJournal::min_size_to_compact;
+
+namespace
+{
+	// starting value and multiplier of the checksum
+	const uint32_t checksum_seed = 2166136261u;
+	const uint32_t checksum_multiplier = 16777619u;
+}
+
+MazeJournal::MazeJournal() :
+	file( NULL ),
+	mazeFileName(),
+	sizeOfMazeFile( 0 ),
+	committedSize( 0 ),
+	editsReplayed( 0 ),
+	uncommittedEdits( 0 ) {}
+
+MazeJournal::~MazeJournal()
+{
+	close();
+}
+
+
+/* applies the edits in the journal kept next to the maze file to the maze, which must have just
+ * been read from that file, and gets ready to record more edits, a journal that was left by
+ * a different version of the maze file ( or that doesn't exist ) is started over
+ */
+void MazeJournal::open( const string & m_mazeFileName, Maze2D & maze, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	close();
+
+	MazeJournalHeader header = headerFor( m_mazeFileName );
+	string journalFileName = journalFileNameFor( m_mazeFileName );
+	long long sizeOfWholeRecords = replay( journalFileName, header, maze, progress );
+
+	file = new DurableFile( journalFileName );
+	try
+	{
+		if( sizeOfWholeRecords == 0 )
+		{
+			file->truncate( 0 );
+			file->append( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+			file->flushToDisk();
+			committedSize = file->getSize();
+		}
+		else
+		{
+			//drop whatever was left of a record that was being written when something crashed
+			file->truncate( sizeOfWholeRecords );
+		}
+	}
+	catch( IOError & ioe )
+	{
+		close();
+		throw;
+	}
+
+	mazeFileName = m_mazeFileName;
+	sizeOfMazeFile = header.sizeOfMazeFile;
+}
+
+
+/* starts over with an empty journal, for a maze file that was just written in full
+ */
+void MazeJournal::restart( const string & m_mazeFileName ) throw( IOError & )
+{
+	close();
+
+	MazeJournalHeader header = headerFor( m_mazeFileName );
+	file = new DurableFile( journalFileNameFor( m_mazeFileName ) );
+	try
+	{
+		file->truncate( 0 );
+		file->append( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+		file->flushToDisk();
+	}
+	catch( IOError & ioe )
+	{
+		close();
+		throw;
+	}
+
+	mazeFileName = m_mazeFileName;
+	sizeOfMazeFile = header.sizeOfMazeFile;
+	committedSize = file->getSize();
+	editsReplayed = 0;
+	uncommittedEdits = 0;
+}
+
+
+/* stops recording edits, leaving the journal file as it is
+ */
+void MazeJournal::close()
+{
+	delete file;
+	file = NULL;
+	mazeFileName.clear();
+	sizeOfMazeFile = 0;
+	committedSize = 0;
+	editsReplayed = 0;
+	uncommittedEdits = 0;
+}
+
+
+void MazeJournal::recordAddedLine( const LineSegment2D & line ) throw( IOError & )
+{
+	MazeJournalRecord record;
+	memset( &record, 0, sizeof( record ) );
+	record.type = MazeJournalRecord::added_line;
+	record.endpoints[ 0 ] = line.getP1().getX();
+	record.endpoints[ 1 ] = line.getP1().getY();
+	record.endpoints[ 2 ] = line.getP2().getX();
+	record.endpoints[ 3 ] = line.getP2().getY();
+	append( record );
+	uncommittedEdits++;
+}
+
+void MazeJournal::recordClear() throw( IOError & )
+{
+	MazeJournalRecord record;
+	memset( &record, 0, sizeof( record ) );
+	record.type = MazeJournalRecord::cleared;
+	append( record );
+	uncommittedEdits++;
+}
+
+
+/* marks every edit recorded so far as saved, making sure they've all reached the disk
+ */
+void MazeJournal::commit() throw( IOError & )
+{
+	MazeJournalRecord record;
+	memset( &record, 0, sizeof( record ) );
+	record.type = MazeJournalRecord::saved;
+	append( record );
+	file->flushToDisk();
+	committedSize = file->getSize();
+	uncommittedEdits = 0;
+}
+
+
+/* forgets the edits recorded since the last commit
+ */
+void MazeJournal::discardUncommitted() throw( IOError & )
+{
+	if( ( file != NULL ) && ( file->getSize() != committedSize ) )
+	{
+		file->truncate( committedSize );
+	}
+	uncommittedEdits = 0;
+}
+
+
+/* true once the journal is big enough compared to the maze file that
+ * the maze file should be written in full instead of committing the journal
+ */
+bool MazeJournal::needsCompaction() const
+{
+	long long sizeOfJournal = ( file != NULL ) ? file->getSize() : 0;
+	return sizeOfJournal > max( min_size_to_compact, sizeOfMazeFile / maze_file_to_journal_ratio );
+}
+
+
+/* trades journals with the other one
+ */
+void MazeJournal::swap( MazeJournal & other )
+{
+	std::swap( file, other.file );
+	mazeFileName.swap( other.mazeFileName );
+	std::swap( sizeOfMazeFile, other.sizeOfMazeFile );
+	std::swap( committedSize, other.committedSize );
+	std::swap( editsReplayed, other.editsReplayed );
+	std::swap( uncommittedEdits, other.uncommittedEdits );
+}
+
+
+/* the name of the journal kept next to the maze file
+ */
+string MazeJournal::journalFileNameFor( const string & mazeFileName )
+{
+	return mazeFileName + ".journal";
+}
+
+
+/* applies the records in the journal file to the maze, returning the size of the journal
+ * up to the end of the last whole record, or 0 if the journal doesn't go with the maze file
+ */
+long long MazeJournal::replay( const string & journalFileName, const MazeJournalHeader & expected,
+							   Maze2D & maze, ProgressMonitor * progress ) throw( IOError & )
+{
+	editsReplayed = 0;
+	uncommittedEdits = 0;
+	committedSize = 0;
+
+	long long sizeOfJournal, modified;
+	if( !DurableFile::getStamp( journalFileName, sizeOfJournal, modified ) || ( sizeOfJournal < ( long long ) sizeof( expected ) ) )
+	{
+		return 0;
+	}
+
+	MappedFile mapping( journalFileName );
+	if( memcmp( mapping.getData(), &expected, sizeof( expected ) ) != 0 )
+	{
+		return 0;
+	}
+
+	size_t position = sizeof( expected );
+	committedSize = position;
+	int recordsRead = 0;
+	while( ( position + sizeof( MazeJournalRecord ) ) <= mapping.getSize() )
+	{
+		if( ( recordsRead % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) position / mapping.getSize() );
+		}
+		recordsRead++;
+
+		MazeJournalRecord record;
+		memcpy( &record, mapping.getData() + position, sizeof( record ) );
+		if( record.checksum != checksumOf( record ) )
+		{
+			break;
+		}
+
+		if( record.type == MazeJournalRecord::added_line )
+		{
+			maze.addALine( LineSegment2D( Point2D( record.endpoints[ 0 ], record.endpoints[ 1 ] ),
+										  Point2D( record.endpoints[ 2 ], record.endpoints[ 3 ] ) ) );
+			editsReplayed++;
+			uncommittedEdits++;
+		}
+		else if( record.type == MazeJournalRecord::cleared )
+		{
+			maze.clear();
+			editsReplayed++;
+			uncommittedEdits++;
+		}
+		else if( record.type == MazeJournalRecord::saved )
+		{
+			committedSize = position + sizeof( record );
+			uncommittedEdits = 0;
+		}
+		else
+		{
+			break;
+		}
+		position += sizeof( record );
+	}
+
+	return position;
+}
+
+
+void MazeJournal::append( MazeJournalRecord & record ) throw( IOError & )
+{
+	if( file == NULL )
+	{
+		throw IOError();
+	}
+	record.checksum = checksumOf( record );
+	file->append( reinterpret_cast<const char *>( &record ), sizeof( record ) );
+}
+
+
+/* the header a journal for the maze file as it is right now should have
+ */
+MazeJournalHeader MazeJournal::headerFor( const string & mazeFileName ) throw( IOError & )
+{
+	MazeJournalHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magicNumber, magic_number, sizeof( header.magicNumber ) );
+	header.byteOrderMark = MazeJournalHeader::byte_order_mark;
+	header.version = MazeJournalHeader::current_version;
+
+	long long sizeOfMazeFile, modified;
+	if( !DurableFile::getStamp( mazeFileName, sizeOfMazeFile, modified ) )
+	{
+		throw IOError();
+	}
+	header.sizeOfMazeFile = sizeOfMazeFile;
+	header.mazeFileModified = modified;
+	return header;
+}
+
+
+uint32_t MazeJournal::checksumOf( const MazeJournalRecord & record )
+{
+	MazeJournalRecord withoutChecksum = record;
+	withoutChecksum.checksum = 0;
+	const unsigned char * bytes = reinterpret_cast<const unsigned char *>( &withoutChecksum );
+	uint32_t checksum = checksum_seed;
+	for( unsigned int i = 0; i < sizeof( withoutChecksum ); i++ )
+	{
+		checksum = ( checksum ^ bytes[ i ] ) * checksum_multiplier;
+	}
+	return checksum;
+}
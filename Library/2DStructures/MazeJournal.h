@@ -0,0 +1,144 @@
+/*
+   Project     : 3DMaze
+   File        : MazeJournal.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A record of the edits made to a 2D maze since its file was
+   				 last written in full, kept in a file next to the maze file.
+   				 Edits are added to the end of the journal as they're made, so
+   				 saving them costs as much as the edits do instead of as much as
+   				 the whole maze. Opening the maze file replays the journal on top
+   				 of it, and once the journal gets too big compared to the maze
+   				 the maze file is written out in full and the journal started over
+*/
+
+
+#ifndef MAZEJOURNAL_H_
+#define MAZEJOURNAL_H_
+
+#include <string>
+#include <stdint.h>
+
+#include "Maze2D.h"
+#include "LineSegment2D.h"
+#include "DurableFile.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+/* the start of every journal, naming the version of the maze file it goes on top of
+ */
+class MazeJournalHeader
+{
+	public:
+		char magicNumber[ 8 ];
+		uint32_t byteOrderMark;		// written as byte_order_mark, so files from machines with a different byte order are recognized
+		uint32_t version;
+		int64_t sizeOfMazeFile;
+		int64_t mazeFileModified;
+
+		static const uint32_t byte_order_mark = 0x01020304;
+		static const uint32_t current_version = 1;
+};
+
+/* one edit, or the mark left when the edits before it were saved,
+ * the checksum catches a record that was only partly written when something crashed
+ */
+class MazeJournalRecord
+{
+	public:
+		uint32_t type;
+		uint32_t checksum;
+		double endpoints[ 4 ];		// x1, y1, x2, y2 of an added line
+
+		enum Type { added_line = 1, cleared = 2, saved = 3 };
+};
+
+class MazeJournal
+{
+	public:
+		MazeJournal();
+		~MazeJournal();
+
+		/* applies the edits in the journal kept next to the maze file to the maze, which must have just
+		 * been read from that file, and gets ready to record more edits, a journal that was left by
+		 * a different version of the maze file ( or that doesn't exist ) is started over
+		 */
+		void open( const std::string & mazeFileName, Maze2D & maze, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		/* starts over with an empty journal, for a maze file that was just written in full
+		 */
+		void restart( const std::string & mazeFileName ) throw( IOError & );
+
+		/* stops recording edits, leaving the journal file as it is
+		 */
+		void close();
+		bool isOpen() const { return file != NULL; }
+		const std::string & getMazeFileName() const { return mazeFileName; }
+
+		void recordAddedLine( const LineSegment2D & line ) throw( IOError & );
+		void recordClear() throw( IOError & );
+
+		/* marks every edit recorded so far as saved, making sure they've all reached the disk
+		 */
+		void commit() throw( IOError & );
+
+		/* forgets the edits recorded since the last commit
+		 */
+		void discardUncommitted() throw( IOError & );
+
+		/* how many edits opening the journal applied, and how many of those were never saved
+		 * ( they were left by a run of the program that didn't finish normally )
+		 */
+		int numberOfEditsReplayed() const { return editsReplayed; }
+		int numberOfUncommittedEdits() const { return uncommittedEdits; }
+
+		/* true once the journal is big enough compared to the maze file that
+		 * the maze file should be written in full instead of committing the journal
+		 */
+		bool needsCompaction() const;
+
+		/* trades journals with the other one
+		 */
+		void swap( MazeJournal & other );
+
+		/* the name of the journal kept next to the maze file
+		 */
+		static std::string journalFileNameFor( const std::string & mazeFileName );
+
+		// every journal file starts with these bytes
+		static const int magic_number_length = 8;
+		static const char magic_number[ magic_number_length ];
+
+		// journals smaller than this are never worth compacting
+		static const long long min_size_to_compact = 1 << 20;
+		// otherwise a journal is compacted once it's this many times smaller than the maze file
+		static const int maze_file_to_journal_ratio = 4;
+
+	private:
+		DurableFile * file;
+		std::string mazeFileName;
+		long long sizeOfMazeFile;
+		long long committedSize;		// the size of the journal as of the last commit
+		int editsReplayed;
+		int uncommittedEdits;
+
+		/* applies the records in the journal file to the maze, returning the size of the journal
+		 * up to the end of the last whole record, or 0 if the journal doesn't go with the maze file
+		 */
+		long long replay( const std::string & journalFileName, const MazeJournalHeader & expected,
+						  Maze2D & maze, ProgressMonitor * progress ) throw( IOError & );
+
+		void append( MazeJournalRecord & record ) throw( IOError & );
+
+		/* the header a journal for the maze file as it is right now should have
+		 */
+		static MazeJournalHeader headerFor( const std::string & mazeFileName ) throw( IOError & );
+
+		static uint32_t checksumOf( const MazeJournalRecord & record );
+
+		// disable copying, a journal file can only be closed once
+		MazeJournal( const MazeJournal & );
+		const MazeJournal & operator=( const MazeJournal & );
+};
+
+#endif /*MAZEJOURNAL_H_*/
@@ -0,0 +1,45 @@
+/*
+   Project     : 3DMaze
+   File        : MazeLineSink.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Somewhere the walls of a generated maze can be sent as
+   				 they're made, so a maze doesn't have to be held all at
+   				 once before it's written anywhere
+*/
+
+
+#ifndef MAZELINESINK_H_
+#define MAZELINESINK_H_
+
+#include "LineSegment2D.h"
+#include "Maze2D.h"
+#include "IOError.h"
+
+class MazeLineSink
+{
+	public:
+		virtual ~MazeLineSink() {}
+
+		virtual void addALine( const LineSegment2D & line ) throw( IOError & ) = 0;
+
+		/* a promise that no line whose middle is below y will be added after this,
+		 * a sink that writes its lines out in order can write out everything below y
+		 */
+		virtual void linesFinishedBelow( double ) throw( IOError & ) {}
+};
+
+/* adds the lines straight to a 2D maze, without normalizing it
+ */
+class Maze2DLineSink : public MazeLineSink
+{
+	public:
+		Maze2DLineSink( Maze2D & m_maze ) : maze( m_maze ) {}
+
+		void addALine( const LineSegment2D & line ) throw( IOError & ) { maze.addALine( line ); }
+
+	private:
+		Maze2D & maze;
+};
+
+#endif /*MAZELINESINK_H_*/
@@ -0,0 +1,691 @@
+/*
+   Project     : 3DMaze
+   File        : MazeNormalizer.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Cleans up the set of lines that make up a 2D maze,
+   				 dropping lines with no length, merging lines that
+   				 continue along the same straight line, and splitting
+   				 lines where they cross each other
+*/
+
+
+#include "MazeNormalizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include "Vector2D.h"
+
+using namespace std;
+
+namespace
+{
+	// lines whose directions differ by less than this ( in radians ) might lie along the same straight line
+	const double angle_tolerance = 0.0001;
+
+	// how many times the welding tolerance a point may stray from a line and still be considered on it
+	const double collinear_tolerance_factor = 10.0;
+
+	const double pi = 3.141592653589793;
+
+	typedef pair<long long, long long> CellKey;
+
+	CellKey cellFor( const Point2D & point, double cellSize, int xOffset = 0, int yOffset = 0 )
+	{
+		return CellKey( ( long long ) floor( point.getX() / cellSize ) + xOffset,
+						( long long ) floor( point.getY() / cellSize ) + yOffset );
+	}
+
+	/* which of the given power of 2 number of buckets the cell is hashed into
+	 */
+	size_t bucketFor( const CellKey & cell, size_t numberOfBuckets )
+	{
+		unsigned long long hash = ( ( unsigned long long ) cell.first * 0x9E3779B97F4A7C15ULL ) ^
+								  ( ( unsigned long long ) cell.second * 0xC2B2AE3D27D4EB4FULL );
+		return ( size_t ) ( hash ^ ( hash >> 29 ) ) & ( numberOfBuckets - 1 );
+	}
+
+	double crossProduct( const Vector2D & a, const Vector2D & b )
+	{
+		return ( a.getX() * b.getY() ) - ( a.getY() * b.getX() );
+	}
+
+	bool samePoint( const Point2D & a, const Point2D & b )
+	{
+		return ( a.getX() == b.getX() ) && ( a.getY() == b.getY() );
+	}
+
+	/* returns the distance from the point to the infinite line through the given line segment
+	 */
+	double distanceToLine( const Point2D & point, const LineSegment2D & line )
+	{
+		Vector2D lineVector( line );
+		Vector2D startToPoint( point.getX() - line.getP1().getX(), point.getY() - line.getP1().getY() );
+		return fabs( crossProduct( lineVector, startToPoint ) ) / lineVector.length();
+	}
+
+	/* returns the direction of the line as an angle in [ -angle_tolerance, pi - angle_tolerance ),
+	 * so lines pointing in opposite directions get the same angle
+	 */
+	double undirectedAngle( const LineSegment2D & line )
+	{
+		double angle = atan2( line.getP2().getY() - line.getP1().getY(), line.getP2().getX() - line.getP1().getX() );
+		if( angle < 0.0 )
+		{
+			angle += pi;
+		}
+		if( angle >= ( pi - angle_tolerance ) )
+		{
+			angle -= pi;
+		}
+		return angle;
+	}
+
+	/* how many of the endpoints, which are in order, are at the point
+	 */
+	int linesEndingAt( const vector< pair<double, double> > & endpoints, const Point2D & point )
+	{
+		pair< vector< pair<double, double> >::const_iterator, vector< pair<double, double> >::const_iterator > atPoint;
+		atPoint = equal_range( endpoints.begin(), endpoints.end(), make_pair( ( double ) point.getX(), ( double ) point.getY() ) );
+		return atPoint.second - atPoint.first;
+	}
+
+	/* a uniform grid of square buckets over a rectangle, lines are put into the buckets that come within reach of them
+	 */
+	class BucketGrid
+	{
+		public:
+			BucketGrid( double m_left, double m_bottom, double m_bucketSize, long long m_columns, long long m_rows, double m_reach ) :
+				left( m_left ), bottom( m_bottom ), bucketSize( m_bucketSize ), columns( m_columns ), rows( m_rows ), reach( m_reach ) {}
+
+			size_t numberOfBuckets() const { return ( size_t ) ( columns * rows ); }
+
+			/* replaces buckets with the buckets within reach of the line, a row of buckets at a time
+			 */
+			void bucketsNear( const LineSegment2D & line, vector<size_t> & buckets ) const
+			{
+				buckets.clear();
+				double lineBottom = min( line.getP1().getY(), line.getP2().getY() );
+				double lineTop = max( line.getP1().getY(), line.getP2().getY() );
+				double lineLeft = min( line.getP1().getX(), line.getP2().getX() );
+				double lineRight = max( line.getP1().getX(), line.getP2().getX() );
+				double run = line.getP2().getX() - line.getP1().getX();
+				double rise = line.getP2().getY() - line.getP1().getY();
+
+				long long firstRow = max( 0LL, ( long long ) ( ( lineBottom - reach - bottom ) / bucketSize ) );
+				long long lastRow = min( rows - 1, ( long long ) ( ( lineTop + reach - bottom ) / bucketSize ) );
+				for( long long row = firstRow; row <= lastRow; row++ )
+				{
+					// only the part of a slanted line within reach of the row of buckets
+					double xFrom = lineLeft, xTo = lineRight;
+					if( rise != 0.0 )
+					{
+						double yFrom = min( max( bottom + ( row * bucketSize ) - reach, lineBottom ), lineTop );
+						double yTo = min( max( bottom + ( ( row + 1 ) * bucketSize ) + reach, lineBottom ), lineTop );
+						double xAtFrom = line.getP1().getX() + ( ( yFrom - line.getP1().getY() ) * run / rise );
+						double xAtTo = line.getP1().getX() + ( ( yTo - line.getP1().getY() ) * run / rise );
+						xFrom = max( lineLeft, min( xAtFrom, xAtTo ) );
+						xTo = min( lineRight, max( xAtFrom, xAtTo ) );
+					}
+
+					long long firstColumn = max( 0LL, ( long long ) ( ( xFrom - reach - left ) / bucketSize ) );
+					long long lastColumn = min( columns - 1, ( long long ) ( ( xTo + reach - left ) / bucketSize ) );
+					for( long long column = firstColumn; column <= lastColumn; column++ )
+					{
+						buckets.push_back( ( size_t ) ( ( row * columns ) + column ) );
+					}
+				}
+			}
+
+		private:
+			double left, bottom;
+			double bucketSize;
+			long long columns, rows;
+			double reach;
+	};
+}
+
+
+NormalizationReport::NormalizationReport() :
+	endpointsWelded( 0 ),
+	degenerateLinesRemoved( 0 ),
+	collinearLinesMerged( 0 ),
+	linesAddedBySplitting( 0 ) {}
+
+bool NormalizationReport::changedAnything() const
+{
+	return ( endpointsWelded > 0 ) || ( degenerateLinesRemoved > 0 ) || ( collinearLinesMerged > 0 ) || ( linesAddedBySplitting > 0 );
+}
+
+
+/* returns a sentence describing the changes, suitable for showing to the user
+ */
+std::string NormalizationReport::describe() const
+{
+	if( !changedAnything() )
+	{
+		return "The maze needed no clean up.";
+	}
+
+	vector<string> changes;
+	ostringstream change;
+	if( endpointsWelded > 0 )
+	{
+		change.str( "" );
+		change << "joined " << endpointsWelded << " nearly touching endpoint(s)";
+		changes.push_back( change.str() );
+	}
+	if( degenerateLinesRemoved > 0 )
+	{
+		change.str( "" );
+		change << "removed " << degenerateLinesRemoved << " line(s) with no length";
+		changes.push_back( change.str() );
+	}
+	if( collinearLinesMerged > 0 )
+	{
+		change.str( "" );
+		change << "merged away " << collinearLinesMerged << " line(s) continuing along the same straight line";
+		changes.push_back( change.str() );
+	}
+	if( linesAddedBySplitting > 0 )
+	{
+		change.str( "" );
+		change << "added " << linesAddedBySplitting << " line(s) by splitting lines where they cross";
+		changes.push_back( change.str() );
+	}
+
+	ostringstream description;
+	description << "Cleaned up the maze: ";
+	for( unsigned int i = 0; i < changes.size(); i++ )
+	{
+		if( i > 0 )
+		{
+			description << ( ( ( i + 1 ) == changes.size() ) ? " and " : ", " );
+		}
+		description << changes[ i ];
+	}
+	description << ".";
+	return description.str();
+}
+
+
+MazeNormalizer::MazeNormalizer( double m_tolerance /* = 0.001 */ ) :
+	tolerance( m_tolerance ) {}
+
+/* cleans up the lines in place, throws an OperationCanceled if the progress monitor asks for it to stop
+ */
+NormalizationReport MazeNormalizer::normalize( vector<LineSegment2D> & lines, ProgressMonitor * progress /* = NULL */ ) const throw( IOError & )
+{
+	ProgressRange weldProgress( progress, 0.0, 0.2 );
+	ProgressRange mergeProgress( progress, 0.2, 0.5 );
+	ProgressRange splitProgress( progress, 0.5, 1.0 );
+
+	NormalizationReport report;
+	report.setEndpointsWelded( weldEndpoints( lines, &weldProgress ) );
+	report.setDegenerateLinesRemoved( removeDegenerateLines( lines ) );
+	//merge before splitting, otherwise the pieces of a split line would just be merged back together
+	report.setCollinearLinesMerged( mergeCollinearRuns( lines, &mergeProgress ) );
+	report.setLinesAddedBySplitting( splitAtCrossings( lines, &splitProgress ) );
+	return report;
+}
+
+
+/* moves endpoints that are within the tolerance of each other onto the same point
+ * returns the number of endpoints that were moved
+ */
+int MazeNormalizer::weldEndpoints( vector<LineSegment2D> & lines, ProgressMonitor * progress ) const throw( IOError & )
+{
+	/* the first endpoint seen near a spot represents every endpoint that comes after it,
+	 * and the representatives are put into cells twice as wide as the tolerance, which are hashed into buckets,
+	 * the representatives hashed into the same bucket are chained together through nextInBucket
+	 */
+	const double cellSize = tolerance * 2.0;
+	size_t numberOfBuckets = 1;
+	while( numberOfBuckets < ( lines.size() * 2 ) )
+	{
+		numberOfBuckets *= 2;
+	}
+	vector<int> firstInBucket( numberOfBuckets, -1 );
+	vector<int> nextInBucket;
+	vector<Point2D> representatives;
+	vector<CellKey> cellsOfRepresentatives;
+	int endpointsWelded = 0;
+
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) i / lines.size() );
+		}
+
+		Point2D endpoints[ 2 ] = { lines[ i ].getP1(), lines[ i ].getP2() };
+		for( int j = 0; j < 2; j++ )
+		{
+			/* the earliest representative close enough, which can only be in the endpoint's cell
+			 * or the ones beside it on the sides of the cell the endpoint is nearer to
+			 */
+			CellKey endpointCell = cellFor( endpoints[ j ], cellSize );
+			int nearerX = ( ( endpoints[ j ].getX() / cellSize ) - endpointCell.first < 0.5 ) ? -1 : 1;
+			int nearerY = ( ( endpoints[ j ].getY() / cellSize ) - endpointCell.second < 0.5 ) ? -1 : 1;
+			int representative = -1;
+			for( int x = 0; x < 2; x++ )
+			{
+				for( int y = 0; y < 2; y++ )
+				{
+					CellKey cell = cellFor( endpoints[ j ], cellSize, x * nearerX, y * nearerY );
+					for( int candidate = firstInBucket[ bucketFor( cell, numberOfBuckets ) ]; candidate >= 0; candidate = nextInBucket[ candidate ] )
+					{
+						if( ( cellsOfRepresentatives[ candidate ] == cell ) &&
+							( representatives[ candidate ].distanceTo( endpoints[ j ] ) <= tolerance ) &&
+							( ( representative < 0 ) || ( candidate < representative ) ) )
+						{
+							representative = candidate;
+						}
+					}
+				}
+			}
+
+			if( representative < 0 )
+			{
+				size_t bucket = bucketFor( endpointCell, numberOfBuckets );
+				nextInBucket.push_back( firstInBucket[ bucket ] );
+				firstInBucket[ bucket ] = representatives.size();
+				representatives.push_back( endpoints[ j ] );
+				cellsOfRepresentatives.push_back( endpointCell );
+			}
+			else if( !samePoint( representatives[ representative ], endpoints[ j ] ) )
+			{
+				endpoints[ j ] = representatives[ representative ];
+				endpointsWelded++;
+			}
+		}
+		lines[ i ] = LineSegment2D( endpoints[ 0 ], endpoints[ 1 ] );
+	}
+
+	return endpointsWelded;
+}
+
+
+/* removes lines whose endpoints are the same point
+ * returns the number of lines removed
+ */
+int MazeNormalizer::removeDegenerateLines( vector<LineSegment2D> & lines ) const
+{
+	vector<LineSegment2D> keptLines;
+	keptLines.reserve( lines.size() );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		if( lines[ i ].getP1().distanceTo( lines[ i ].getP2() ) > tolerance )
+		{
+			keptLines.push_back( lines[ i ] );
+		}
+	}
+
+	int linesRemoved = lines.size() - keptLines.size();
+	lines.swap( keptLines );
+	return linesRemoved;
+}
+
+
+/* replaces runs of overlapping or touching lines that lie along the same
+ * straight line with a single line, returns the number of lines removed
+ */
+int MazeNormalizer::mergeCollinearRuns( vector<LineSegment2D> & lines, ProgressMonitor * progress ) const throw( IOError & )
+{
+	const double collinearTolerance = tolerance * collinear_tolerance_factor;
+
+	// group the lines first by direction...
+	vector< pair<double, int> > byAngle;
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		byAngle.push_back( make_pair( undirectedAngle( lines[ i ] ), ( int ) i ) );
+	}
+	sort( byAngle.begin(), byAngle.end() );
+
+	// every line's endpoints in order, to count the lines ending at a point, lines that just touch end to end aren't merged where a third line meets them
+	vector< pair<double, double> > endpoints;
+	endpoints.reserve( lines.size() * 2 );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		endpoints.push_back( make_pair( lines[ i ].getP1().getX(), lines[ i ].getP1().getY() ) );
+		endpoints.push_back( make_pair( lines[ i ].getP2().getX(), lines[ i ].getP2().getY() ) );
+	}
+	sort( endpoints.begin(), endpoints.end() );
+
+	vector<bool> consumed( lines.size(), false );
+	map<int, LineSegment2D> mergedLines;	// first line of a run -> the line replacing the whole run
+
+	unsigned int linesLookedAt = 0;
+	unsigned int angleGroupStart = 0;
+	while( angleGroupStart < byAngle.size() )
+	{
+		unsigned int angleGroupEnd = angleGroupStart + 1;
+		while( ( angleGroupEnd < byAngle.size() ) && ( ( byAngle[ angleGroupEnd ].first - byAngle[ angleGroupEnd - 1 ].first ) <= angle_tolerance ) )
+		{
+			angleGroupEnd++;
+		}
+
+		// ...then by how far their straight line passes from the origin
+		double angle = byAngle[ angleGroupStart ].first;
+		Vector2D along( cos( angle ), sin( angle ) );
+		Vector2D across( -sin( angle ), cos( angle ) );
+		vector< pair<double, int> > byOffset;
+		for( unsigned int i = angleGroupStart; i < angleGroupEnd; i++ )
+		{
+			const LineSegment2D & line = lines[ byAngle[ i ].second ];
+			Vector2D middle( ( line.getP1().getX() + line.getP2().getX() ) / 2.0, ( line.getP1().getY() + line.getP2().getY() ) / 2.0 );
+			byOffset.push_back( make_pair( across.dotProduct( middle ), byAngle[ i ].second ) );
+		}
+		sort( byOffset.begin(), byOffset.end() );
+
+		unsigned int lineGroupStart = 0;
+		while( lineGroupStart < byOffset.size() )
+		{
+			unsigned int lineGroupEnd = lineGroupStart + 1;
+			while( ( lineGroupEnd < byOffset.size() ) && ( ( byOffset[ lineGroupEnd ].first - byOffset[ lineGroupEnd - 1 ].first ) <= collinearTolerance ) )
+			{
+				lineGroupEnd++;
+			}
+
+			if( ( linesLookedAt / ProgressMonitor::steps_between_check_ins ) !=
+				( ( linesLookedAt + lineGroupEnd - lineGroupStart ) / ProgressMonitor::steps_between_check_ins ) )
+			{
+				ProgressMonitor::checkIn( progress, ( double ) linesLookedAt / lines.size() );
+			}
+			linesLookedAt += lineGroupEnd - lineGroupStart;
+
+			// these lines all lie along ( nearly ) the same straight line, so order them by where they start along it
+			vector< pair<double, int> > byStart;
+			for( unsigned int i = lineGroupStart; i < lineGroupEnd; i++ )
+			{
+				const LineSegment2D & line = lines[ byOffset[ i ].second ];
+				double start = min( along.dotProduct( Vector2D( line.getP1().getX(), line.getP1().getY() ) ),
+									along.dotProduct( Vector2D( line.getP2().getX(), line.getP2().getY() ) ) );
+				byStart.push_back( make_pair( start, byOffset[ i ].second ) );
+			}
+			sort( byStart.begin(), byStart.end() );
+
+			unsigned int runStart = 0;
+			while( runStart < byStart.size() )
+			{
+				// extend the run for as long as the next line starts before the run ends
+				Point2D runFirstPoint, runLastPoint;
+				double runEnd = -numeric_limits<double>::max();
+				unsigned int runEndIndex = runStart;
+				while( runEndIndex < byStart.size() )
+				{
+					const LineSegment2D & line = lines[ byStart[ runEndIndex ].second ];
+					double p1Along = along.dotProduct( Vector2D( line.getP1().getX(), line.getP1().getY() ) );
+					double p2Along = along.dotProduct( Vector2D( line.getP2().getX(), line.getP2().getY() ) );
+					if( runEndIndex > runStart )
+					{
+						if( byStart[ runEndIndex ].first > ( runEnd + tolerance ) )
+						{
+							break;
+						}
+						bool justTouching = ( byStart[ runEndIndex ].first >= ( runEnd - tolerance ) );
+						if( justTouching && ( linesEndingAt( endpoints, runLastPoint ) > 2 ) )
+						{
+							break;
+						}
+					}
+					if( runEndIndex == runStart )
+					{
+						runFirstPoint = ( p1Along <= p2Along ) ? line.getP1() : line.getP2();
+					}
+					if( max( p1Along, p2Along ) > runEnd )
+					{
+						runEnd = max( p1Along, p2Along );
+						runLastPoint = ( p1Along <= p2Along ) ? line.getP2() : line.getP1();
+					}
+					runEndIndex++;
+				}
+
+				if( ( runEndIndex - runStart ) > 1 )
+				{
+					// only merge if every line of the run really lies along the merged line
+					LineSegment2D merged( runFirstPoint, runLastPoint );
+					bool allAlongMergedLine = true;
+					for( unsigned int i = runStart; allAlongMergedLine && ( i < runEndIndex ); i++ )
+					{
+						const LineSegment2D & line = lines[ byStart[ i ].second ];
+						allAlongMergedLine = ( distanceToLine( line.getP1(), merged ) <= collinearTolerance ) &&
+											 ( distanceToLine( line.getP2(), merged ) <= collinearTolerance );
+					}
+
+					if( allAlongMergedLine )
+					{
+						int firstLineOfRun = byStart[ runStart ].second;
+						for( unsigned int i = runStart; i < runEndIndex; i++ )
+						{
+							consumed[ byStart[ i ].second ] = true;
+							firstLineOfRun = min( firstLineOfRun, byStart[ i ].second );
+						}
+						mergedLines[ firstLineOfRun ] = merged;
+					}
+				}
+
+				runStart = runEndIndex;
+			}
+
+			lineGroupStart = lineGroupEnd;
+		}
+
+		angleGroupStart = angleGroupEnd;
+	}
+
+	// keep the lines in their original order, a merged line takes the place of the first line in its run
+	vector<LineSegment2D> keptLines;
+	keptLines.reserve( lines.size() );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		map<int, LineSegment2D>::const_iterator merged = mergedLines.find( i );
+		if( merged != mergedLines.end() )
+		{
+			keptLines.push_back( merged->second );
+		}
+		else if( !consumed[ i ] )
+		{
+			keptLines.push_back( lines[ i ] );
+		}
+	}
+
+	int linesRemoved = lines.size() - keptLines.size();
+	lines.swap( keptLines );
+	return linesRemoved;
+}
+
+
+/* splits lines at every point where another line crosses or touches them,
+ * returns the number of lines added
+ */
+int MazeNormalizer::splitAtCrossings( vector<LineSegment2D> & lines, ProgressMonitor * progress ) const throw( IOError & )
+{
+	if( lines.size() < 2 )
+	{
+		return 0;
+	}
+
+	/* every line is put into the buckets of a uniform grid that come within reach of it, and is only checked
+	 * against the lines sharing a bucket with it, the buckets are about as wide as a typical line so
+	 * each line is only in a few of them, and only lines that are close together are ever checked
+	 */
+	double left = numeric_limits<double>::max(), bottom = numeric_limits<double>::max();
+	double right = -numeric_limits<double>::max(), top = -numeric_limits<double>::max();
+	vector<double> extents( lines.size() );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		const LineSegment2D & line = lines[ i ];
+		left = min<double>( left, min( line.getP1().getX(), line.getP2().getX() ) );
+		right = max<double>( right, max( line.getP1().getX(), line.getP2().getX() ) );
+		bottom = min<double>( bottom, min( line.getP1().getY(), line.getP2().getY() ) );
+		top = max<double>( top, max( line.getP1().getY(), line.getP2().getY() ) );
+		extents[ i ] = max( fabs( line.getP2().getX() - line.getP1().getX() ), fabs( line.getP2().getY() - line.getP1().getY() ) );
+	}
+	nth_element( extents.begin(), extents.begin() + ( extents.size() / 2 ), extents.end() );
+
+	// lines further apart than this can't meet, it's a little more than the tolerance so rounding can't leave anything out
+	const double reach = tolerance * 2.0;
+	left -= reach;
+	bottom -= reach;
+	right += reach;
+	top += reach;
+
+	long long maxBuckets = min( ( long long ) max_crossing_buckets, ( long long ) lines.size() * crossing_buckets_per_line );
+	double bucketSize = max( extents[ extents.size() / 2 ], reach * 2.0 );
+	bucketSize = max( bucketSize, sqrt( ( ( right - left ) * ( top - bottom ) ) / maxBuckets ) );
+	if( bucketSize <= 0.0 )
+	{
+		bucketSize = 1.0;	//every line is a point, and there's no tolerance to size the buckets by
+	}
+	long long bucketColumns = ( long long ) ( ( right - left ) / bucketSize ) + 1;
+	long long bucketRows = ( long long ) ( ( top - bottom ) / bucketSize ) + 1;
+	while( ( bucketColumns * bucketRows ) > maxBuckets )
+	{
+		bucketSize *= 1.5;
+		bucketColumns = ( long long ) ( ( right - left ) / bucketSize ) + 1;
+		bucketRows = ( long long ) ( ( top - bottom ) / bucketSize ) + 1;
+	}
+
+	BucketGrid grid( left, bottom, bucketSize, bucketColumns, bucketRows, reach );
+
+	/* counts the lines in each bucket, then fills the buckets,
+	 * the lines in each bucket come one after another in linesInBuckets, from bucketStarts onward
+	 */
+	vector<size_t> bucketStarts( grid.numberOfBuckets() + 1, 0 );
+	vector<size_t> buckets;
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		grid.bucketsNear( lines[ i ], buckets );
+		for( unsigned int j = 0; j < buckets.size(); j++ )
+		{
+			bucketStarts[ buckets[ j ] + 1 ]++;
+		}
+	}
+	for( size_t bucket = 1; bucket < bucketStarts.size(); bucket++ )
+	{
+		bucketStarts[ bucket ] += bucketStarts[ bucket - 1 ];
+	}
+
+	vector<int> linesInBuckets( bucketStarts.back() );
+	vector<size_t> filled( bucketStarts.begin(), bucketStarts.end() - 1 );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		grid.bucketsNear( lines[ i ], buckets );
+		for( unsigned int j = 0; j < buckets.size(); j++ )
+		{
+			linesInBuckets[ filled[ buckets[ j ] ]++ ] = i;
+		}
+	}
+
+	vector<Point2D> splitPoints;
+	vector< vector< pair<double, int> > > splitsOfLine( lines.size() );	// ( distance along line, split point ) for each line
+
+	// each line is checked against the lines after it in the buckets it's in, once even if they share several buckets
+	vector<int> lastCheckedAgainst( lines.size(), -1 );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) i / lines.size() );
+		}
+
+		grid.bucketsNear( lines[ i ], buckets );
+		for( unsigned int j = 0; j < buckets.size(); j++ )
+		{
+			for( size_t k = bucketStarts[ buckets[ j ] ]; k < bucketStarts[ buckets[ j ] + 1 ]; k++ )
+			{
+				int other = linesInBuckets[ k ];
+				if( ( other > ( int ) i ) && ( lastCheckedAgainst[ other ] != ( int ) i ) )
+				{
+					lastCheckedAgainst[ other ] = i;
+					findCrossing( lines, other, i, splitPoints, splitsOfLine );
+				}
+			}
+		}
+	}
+
+	vector<LineSegment2D> splitLines;
+	splitLines.reserve( lines.size() + splitPoints.size() );
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		vector< pair<double, int> > & splits = splitsOfLine[ i ];
+		sort( splits.begin(), splits.end() );
+
+		Point2D pieceStart = lines[ i ].getP1();
+		for( unsigned int j = 0; j < splits.size(); j++ )
+		{
+			const Point2D & split = splitPoints[ splits[ j ].second ];
+			if( pieceStart.distanceTo( split ) > tolerance )
+			{
+				splitLines.push_back( LineSegment2D( pieceStart, split ) );
+				pieceStart = split;
+			}
+		}
+		if( pieceStart.distanceTo( lines[ i ].getP2() ) > tolerance )
+		{
+			splitLines.push_back( LineSegment2D( pieceStart, lines[ i ].getP2() ) );
+		}
+	}
+
+	int linesAdded = splitLines.size() - lines.size();
+	lines.swap( splitLines );
+	return linesAdded;
+}
+
+
+/* checks whether the two lines cross or touch, and if either is split by it,
+ * adds the point they meet at to splitPoints and to the splits of the line it splits
+ */
+void MazeNormalizer::findCrossing( const vector<LineSegment2D> & lines, int first, int second, vector<Point2D> & splitPoints,
+								   vector< vector< pair<double, int> > > & splitsOfLine ) const
+{
+	const LineSegment2D & line = lines[ first ];
+	const LineSegment2D & otherLine = lines[ second ];
+	if( ( max( otherLine.getP1().getX(), otherLine.getP2().getX() ) < ( min( line.getP1().getX(), line.getP2().getX() ) - tolerance ) ) ||
+		( min( otherLine.getP1().getX(), otherLine.getP2().getX() ) > ( max( line.getP1().getX(), line.getP2().getX() ) + tolerance ) ) ||
+		( max( otherLine.getP1().getY(), otherLine.getP2().getY() ) < ( min( line.getP1().getY(), line.getP2().getY() ) - tolerance ) ) ||
+		( min( otherLine.getP1().getY(), otherLine.getP2().getY() ) > ( max( line.getP1().getY(), line.getP2().getY() ) + tolerance ) ) )
+	{
+		return;
+	}
+
+	Vector2D lineVector( line );
+	Vector2D otherVector( otherLine );
+	double denominator = crossProduct( lineVector, otherVector );
+	if( fabs( denominator ) <= ( 1e-12 * lineVector.length() * otherVector.length() ) )
+	{
+		return;	//parallel lines that overlap were already merged
+	}
+
+	Vector2D startToOtherStart( otherLine.getP1().getX() - line.getP1().getX(), otherLine.getP1().getY() - line.getP1().getY() );
+	double t = crossProduct( startToOtherStart, otherVector ) / denominator;
+	double u = crossProduct( startToOtherStart, lineVector ) / denominator;
+	double lineTolerance = tolerance / lineVector.length();
+	double otherTolerance = tolerance / otherVector.length();
+	if( ( t < -lineTolerance ) || ( t > ( 1.0 + lineTolerance ) ) || ( u < -otherTolerance ) || ( u > ( 1.0 + otherTolerance ) ) )
+	{
+		return;
+	}
+
+	// when the lines meet at an endpoint use that endpoint itself, so the pieces share it exactly
+	Point2D meeting( line.getP1().getX() + ( lineVector.getX() * t ), line.getP1().getY() + ( lineVector.getY() * t ) );
+	if( u <= otherTolerance )					meeting = otherLine.getP1();
+	else if( u >= ( 1.0 - otherTolerance ) )	meeting = otherLine.getP2();
+	else if( t <= lineTolerance )				meeting = line.getP1();
+	else if( t >= ( 1.0 - lineTolerance ) )		meeting = line.getP2();
+
+	bool splitsLine = ( t > lineTolerance ) && ( t < ( 1.0 - lineTolerance ) );
+	bool splitsOther = ( u > otherTolerance ) && ( u < ( 1.0 - otherTolerance ) );
+	if( splitsLine || splitsOther )
+	{
+		splitPoints.push_back( meeting );
+		if( splitsLine )	splitsOfLine[ first ].push_back( make_pair( t, ( int ) splitPoints.size() - 1 ) );
+		if( splitsOther )	splitsOfLine[ second ].push_back( make_pair( u, ( int ) splitPoints.size() - 1 ) );
+	}
+}
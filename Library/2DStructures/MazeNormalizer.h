@@ -0,0 +1,100 @@
+/*
+   Project     : 3DMaze
+   File        : MazeNormalizer.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Cleans up the set of lines that make up a 2D maze,
+   				 dropping lines with no length, merging lines that
+   				 continue along the same straight line, and splitting
+   				 lines where they cross each other
+*/
+
+
+#ifndef MAZENORMALIZER_H_
+#define MAZENORMALIZER_H_
+
+#include <vector>
+#include <string>
+#include <utility>
+
+#include "Point2D.h"
+#include "LineSegment2D.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+/* describes what a normalization changed
+ */
+class NormalizationReport
+{
+	public:
+		NormalizationReport();
+
+		int getEndpointsWelded() const { return endpointsWelded; }
+		int getDegenerateLinesRemoved() const { return degenerateLinesRemoved; }
+		int getCollinearLinesMerged() const { return collinearLinesMerged; }
+		int getLinesAddedBySplitting() const { return linesAddedBySplitting; }
+
+		void setEndpointsWelded( int m_endpointsWelded ) { endpointsWelded = m_endpointsWelded; }
+		void setDegenerateLinesRemoved( int m_degenerateLinesRemoved ) { degenerateLinesRemoved = m_degenerateLinesRemoved; }
+		void setCollinearLinesMerged( int m_collinearLinesMerged ) { collinearLinesMerged = m_collinearLinesMerged; }
+		void setLinesAddedBySplitting( int m_linesAddedBySplitting ) { linesAddedBySplitting = m_linesAddedBySplitting; }
+
+		bool changedAnything() const;
+
+		/* returns a sentence describing the changes, suitable for showing to the user
+		 */
+		std::string describe() const;
+
+	private:
+		int endpointsWelded;
+		int degenerateLinesRemoved;
+		int collinearLinesMerged;
+		int linesAddedBySplitting;
+};
+
+class MazeNormalizer
+{
+	public:
+		/* endpoints closer together than the tolerance are considered to be the same point
+		 */
+		MazeNormalizer( double m_tolerance = 0.001 );
+
+		/* cleans up the lines in place, throws an OperationCanceled if the progress monitor asks for it to stop
+		 */
+		NormalizationReport normalize( std::vector<LineSegment2D> & lines, ProgressMonitor * progress = NULL ) const throw( IOError & );
+
+		// there are never more buckets than this for each line when looking for crossings, nor more than max_crossing_buckets in all
+		static const int crossing_buckets_per_line = 4;
+		static const int max_crossing_buckets = 1 << 22;
+
+	private:
+		double tolerance;
+
+		/* moves endpoints that are within the tolerance of each other onto the same point
+		 * returns the number of endpoints that were moved
+		 */
+		int weldEndpoints( std::vector<LineSegment2D> & lines, ProgressMonitor * progress ) const throw( IOError & );
+
+		/* removes lines whose endpoints are the same point
+		 * returns the number of lines removed
+		 */
+		int removeDegenerateLines( std::vector<LineSegment2D> & lines ) const;
+
+		/* replaces runs of overlapping or touching lines that lie along the same
+		 * straight line with a single line, returns the number of lines removed
+		 */
+		int mergeCollinearRuns( std::vector<LineSegment2D> & lines, ProgressMonitor * progress ) const throw( IOError & );
+
+		/* splits lines at every point where another line crosses or touches them,
+		 * returns the number of lines added
+		 */
+		int splitAtCrossings( std::vector<LineSegment2D> & lines, ProgressMonitor * progress ) const throw( IOError & );
+
+		/* checks whether the two lines cross or touch, and if either is split by it,
+		 * adds the point they meet at to splitPoints and to the splits of the line it splits
+		 */
+		void findCrossing( const std::vector<LineSegment2D> & lines, int first, int second, std::vector<Point2D> & splitPoints,
+						   std::vector< std::vector< std::pair<double, int> > > & splitsOfLine ) const;
+};
+
+#endif /*MAZENORMALIZER_H_*/
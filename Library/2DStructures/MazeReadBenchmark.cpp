@@ -0,0 +1,125 @@
+/*
+   Project     : 3DMaze
+   File        : MazeReadBenchmark.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Times how long the text of a 2D maze file takes to read,
+   				 both through a file stream and with MazeTextReader
+*/
+
+
+#include "MazeReadBenchmark.h"
+
+#include <vector>
+#include <fstream>
+#include <ctime>
+
+#include "LineSegment2D.h"
+#include "MazeTextReader.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+namespace
+{
+	/* reads the file the way it was read before MazeTextReader, through
+	 * a file stream and Maze2D::readIn ( without normalizing )
+	 */
+	void readWithStream( const string & fileName, int & width, int & height, vector<LineSegment2D> & lines ) throw( IOError & )
+	{
+		ifstream in( fileName.c_str() );
+		if( !in )
+		{
+			throw IOError();
+		}
+
+		in >> width >> height;
+		int numberOfLinesToReadIn = 0;
+		in >> numberOfLinesToReadIn;
+
+		lines.clear();
+		LineSegment2D line;
+		for( int i = 0; i < numberOfLinesToReadIn; i++ )
+		{
+			line.readIn( in );
+			lines.push_back( line );
+		}
+	}
+
+	double secondsSince( clock_t start )
+	{
+		return ( double ) ( clock() - start ) / CLOCKS_PER_SEC;
+	}
+}
+
+
+/* reads the file both ways a number of times, through a file stream as it used to be read
+ * and mapped into memory for MazeTextReader, and writes the best time of each to out
+ * ( the maze isn't normalized either way ),
+ * throws an IOError if the file can't be read or the two ways disagree
+ */
+void MazeReadBenchmark::run( const string & fileName, ostream & out, int numberOfRuns /* = default_number_of_runs */ ) throw( IOError & )
+{
+	int streamWidth = 0, streamHeight = 0;
+	vector<LineSegment2D> streamLines;
+	int readerWidth = 0, readerHeight = 0;
+	vector<LineSegment2D> readerLines;
+
+	size_t fileSize = 0;
+	double bestStreamTime = -1.0;
+	double bestReaderTime = -1.0;
+	for( int run = 0; run < numberOfRuns; run++ )
+	{
+		clock_t start = clock();
+		readWithStream( fileName, streamWidth, streamHeight, streamLines );
+		double streamTime = secondsSince( start );
+
+		//mapping the file is part of the new way of reading it, so it's timed too
+		start = clock();
+		MappedFile mapping( fileName );
+		MazeTextReader reader( mapping.getData(), mapping.getSize() );
+		reader.read( readerWidth, readerHeight, readerLines );
+		double readerTime = secondsSince( start );
+		fileSize = mapping.getSize();
+
+		if( ( bestStreamTime < 0.0 ) || ( streamTime < bestStreamTime ) )
+		{
+			bestStreamTime = streamTime;
+		}
+		if( ( bestReaderTime < 0.0 ) || ( readerTime < bestReaderTime ) )
+		{
+			bestReaderTime = readerTime;
+		}
+	}
+
+	//a faster reader is no good if it reads something different
+	if( ( streamWidth != readerWidth ) || ( streamHeight != readerHeight ) || ( streamLines.size() != readerLines.size() ) )
+	{
+		throw IOError();
+	}
+	for( unsigned int i = 0; i < streamLines.size(); i++ )
+	{
+		if( ( streamLines[ i ].getP1().getX() != readerLines[ i ].getP1().getX() ) ||
+			( streamLines[ i ].getP1().getY() != readerLines[ i ].getP1().getY() ) ||
+			( streamLines[ i ].getP2().getX() != readerLines[ i ].getP2().getX() ) ||
+			( streamLines[ i ].getP2().getY() != readerLines[ i ].getP2().getY() ) )
+		{
+			throw IOError();
+		}
+	}
+
+	double megabytes = ( double ) fileSize / ( 1024.0 * 1024.0 );
+	out << fileName << ": " << readerLines.size() << " lines, " << megabytes << " MB" << endl;
+	out << "  file stream    : " << bestStreamTime << " s";
+	if( bestStreamTime > 0.0 )
+	{
+		out << " ( " << ( megabytes / bestStreamTime ) << " MB/s )";
+	}
+	out << endl;
+	out << "  MazeTextReader : " << bestReaderTime << " s";
+	if( bestReaderTime > 0.0 )
+	{
+		out << " ( " << ( megabytes / bestReaderTime ) << " MB/s, " << ( bestStreamTime / bestReaderTime ) << " times faster )";
+	}
+	out << endl;
+}
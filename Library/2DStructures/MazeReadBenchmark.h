@@ -0,0 +1,32 @@
+/*
+   Project     : 3DMaze
+   File        : MazeReadBenchmark.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Times how long the text of a 2D maze file takes to read,
+   				 both through a file stream and with MazeTextReader
+*/
+
+
+#ifndef MAZEREADBENCHMARK_H_
+#define MAZEREADBENCHMARK_H_
+
+#include <string>
+#include <iostream>
+
+#include "IOError.h"
+
+class MazeReadBenchmark
+{
+	public:
+		/* reads the file both ways a number of times, through a file stream as it used to be read
+		 * and mapped into memory for MazeTextReader, and writes the best time of each to out
+		 * ( the maze isn't normalized either way ),
+		 * throws an IOError if the file can't be read or the two ways disagree
+		 */
+		static void run( const std::string & fileName, std::ostream & out, int numberOfRuns = default_number_of_runs ) throw( IOError & );
+
+		static const int default_number_of_runs = 3;
+};
+
+#endif /*MAZEREADBENCHMARK_H_*/
@@ -0,0 +1,279 @@
+/*
+   Project     : 3DMaze
+   File        : MazeTextReader.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Reads a 2D maze in text form straight out of memory,
+   				 picking the numbers out by hand instead of going through
+   				 an input stream for every one of them
+*/
+
+
+#include "MazeTextReader.h"
+
+#include <limits>
+#include <sstream>
+#include <string>
+
+using namespace std;
+
+namespace
+{
+	// every power of ten that a double holds exactly
+	const double powers_of_ten[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+									 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	// exponents beyond this are just as out of range as any larger one
+	const int max_exponent_read = 100000;
+}
+
+/* the text has to stay around for as long as this reader does,
+ * it doesn't need to end with a null character
+ */
+MazeTextReader::MazeTextReader( const char * m_text, size_t m_size ) :
+	text( m_text ),
+	end( m_text + m_size ),
+	position( m_text ) {}
+
+
+/* reads the width and height of the maze and then all of its lines,
+ * accepting the same text Maze2D::readIn does,
+ * throws an IOError if the text ends early or holds something that isn't a number
+ * ( or an OperationCanceled if the progress monitor asks for reading to stop )
+ */
+void MazeTextReader::read( int & width, int & height, vector<LineSegment2D> & lines, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	position = text;
+
+	width = readInteger();
+	height = readInteger();
+
+	int numberOfLines = readInteger();
+	if( numberOfLines < 0 )
+	{
+		throw IOError();
+	}
+
+	lines.clear();
+	lines.reserve( numberOfLines );
+	for( int i = 0; i < numberOfLines; i++ )
+	{
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) ( position - text ) / ( end - text ) );
+		}
+
+		double x1 = readDecimal();
+		double y1 = readDecimal();
+		double x2 = readDecimal();
+		double y2 = readDecimal();
+		lines.push_back( LineSegment2D( Point2D( x1, y1 ), Point2D( x2, y2 ) ) );
+	}
+
+	//anything after the last line is ignored, just like Maze2D::readIn ignores it
+}
+
+
+void MazeTextReader::skipWhiteSpace()
+{
+	// ' ' and everything from '\t' to '\r' ( '\t', '\n', '\v', '\f' and '\r' ) is white space
+	while( ( position < end ) && ( ( *position == ' ' ) || ( ( *position >= '\t' ) && ( *position <= '\r' ) ) ) )
+	{
+		position++;
+	}
+}
+
+
+/* moves past the given symbol, which has to be the next thing in the text,
+ * throws an IOError if it isn't
+ */
+void MazeTextReader::readSymbol( char symbol ) throw( IOError & )
+{
+	skipWhiteSpace();
+	if( ( position == end ) || ( *position != symbol ) )
+	{
+		throw IOError();
+	}
+	position++;
+}
+
+
+/* read the next number in the text and move past it,
+ * throws an IOError if the text ends first or the next thing isn't a number
+ */
+int MazeTextReader::readInteger() throw( IOError & )
+{
+	skipWhiteSpace();
+
+	bool negative = false;
+	if( ( position < end ) && ( ( *position == '+' ) || ( *position == '-' ) ) )
+	{
+		negative = ( *position == '-' );
+		position++;
+	}
+
+	if( ( position == end ) || !isDigit( *position ) )
+	{
+		throw IOError();
+	}
+
+	double value = 0.0;
+	while( ( position < end ) && isDigit( *position ) )
+	{
+		value = ( value * 10.0 ) + ( *position - '0' );
+		if( value > numeric_limits<int>::max() )
+		{
+			throw IOError();
+		}
+		position++;
+	}
+
+	return ( int ) ( negative ? -value : value );
+}
+
+
+double MazeTextReader::readDecimal() throw( IOError & )
+{
+	skipWhiteSpace();
+
+	//work through a copy of the position, which the compiler can keep in a register
+	const char * start = position;
+	const char * next = position;
+
+	bool negative = false;
+	if( ( next < end ) && ( ( *next == '+' ) || ( *next == '-' ) ) )
+	{
+		negative = ( *next == '-' );
+		next++;
+	}
+
+	//add up the significant digits as a whole number, keeping track of where the decimal point goes,
+	//whole numbers add up quicker than decimals so only digits past the first few are added as decimals
+	unsigned int leadingDigits = 0;
+	double digits = 0.0;
+	int numberOfSignificantDigits = 0;
+	int exponent = 0;
+	const char * firstDigit = next;
+
+	//leading zeros aren't significant
+	while( ( next < end ) && ( *next == '0' ) )
+	{
+		next++;
+	}
+	while( ( next < end ) && isDigit( *next ) )
+	{
+		addADigit( *next - '0', leadingDigits, digits, numberOfSignificantDigits );
+		next++;
+	}
+	bool sawADigit = ( next != firstDigit );
+
+	if( ( next < end ) && ( *next == '.' ) )
+	{
+		next++;
+		const char * firstDecimalPlace = next;
+		if( numberOfSignificantDigits == 0 )
+		{
+			while( ( next < end ) && ( *next == '0' ) )
+			{
+				next++;
+			}
+		}
+		while( ( next < end ) && isDigit( *next ) )
+		{
+			addADigit( *next - '0', leadingDigits, digits, numberOfSignificantDigits );
+			next++;
+		}
+		exponent -= ( next - firstDecimalPlace );
+		sawADigit = sawADigit || ( next != firstDecimalPlace );
+	}
+
+	if( !sawADigit )
+	{
+		throw IOError();
+	}
+	if( numberOfSignificantDigits <= max_whole_number_digits )
+	{
+		digits = leadingDigits;
+	}
+
+	if( ( next < end ) && ( ( *next == 'e' ) || ( *next == 'E' ) ) )
+	{
+		next++;
+		bool negativeExponent = false;
+		if( ( next < end ) && ( ( *next == '+' ) || ( *next == '-' ) ) )
+		{
+			negativeExponent = ( *next == '-' );
+			next++;
+		}
+
+		if( ( next == end ) || !isDigit( *next ) )
+		{
+			throw IOError();
+		}
+
+		int writtenExponent = 0;
+		while( ( next < end ) && isDigit( *next ) )
+		{
+			if( writtenExponent < max_exponent_read )
+			{
+				writtenExponent = ( writtenExponent * 10 ) + ( *next - '0' );
+			}
+			next++;
+		}
+		exponent += negativeExponent ? -writtenExponent : writtenExponent;
+	}
+
+	position = next;
+
+	//with few enough digits and a small enough exponent, one multiplication or division gives the correctly rounded value
+	if( numberOfSignificantDigits > max_fast_significant_digits )
+	{
+		return readDecimalWithStream( start, position );
+	}
+
+	double value = digits;
+	if( numberOfSignificantDigits > 0 )
+	{
+		if( ( exponent < -max_fast_exponent ) || ( exponent > max_fast_exponent ) )
+		{
+			return readDecimalWithStream( start, position );
+		}
+		value = ( exponent < 0 ) ? ( digits / powers_of_ten[ -exponent ] ) : ( digits * powers_of_ten[ exponent ] );
+	}
+
+	return negative ? -value : value;
+}
+
+
+/* adds the next significant digit onto the digits read so far
+ */
+void MazeTextReader::addADigit( int digit, unsigned int & leadingDigits, double & digits, int & numberOfSignificantDigits )
+{
+	if( numberOfSignificantDigits < max_whole_number_digits )
+	{
+		leadingDigits = ( leadingDigits * 10 ) + digit;
+	}
+	else
+	{
+		if( numberOfSignificantDigits == max_whole_number_digits )
+		{
+			digits = leadingDigits;
+		}
+		digits = ( digits * 10.0 ) + digit;
+	}
+	numberOfSignificantDigits++;
+}
+
+
+/* reads a decimal the slow way, for the rare numbers with too many digits to read quickly
+ */
+double MazeTextReader::readDecimalWithStream( const char * start, const char * finish ) throw( IOError & )
+{
+	istringstream number( string( start, finish ) );
+	double value = 0.0;
+	if( !( number >> value ) )
+	{
+		throw IOError();
+	}
+	return value;
+}
@@ -0,0 +1,79 @@
+/*
+   Project     : 3DMaze
+   File        : MazeTextReader.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Reads a 2D maze in text form straight out of memory,
+   				 picking the numbers out by hand instead of going through
+   				 an input stream for every one of them
+*/
+
+
+#ifndef MAZETEXTREADER_H_
+#define MAZETEXTREADER_H_
+
+#include <vector>
+#include <cstddef>
+
+#include "LineSegment2D.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+class MazeTextReader
+{
+	public:
+		/* the text has to stay around for as long as this reader does,
+		 * it doesn't need to end with a null character
+		 */
+		MazeTextReader( const char * m_text, std::size_t m_size );
+
+		/* reads the width and height of the maze and then all of its lines,
+		 * accepting the same text Maze2D::readIn does,
+		 * throws an IOError if the text ends early or holds something that isn't a number
+		 * ( or an OperationCanceled if the progress monitor asks for reading to stop )
+		 */
+		void read( int & width, int & height, std::vector<LineSegment2D> & lines, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		/* read the next number in the text and move past it,
+		 * throws an IOError if the text ends first or the next thing isn't a number
+		 */
+		int readInteger() throw( IOError & );
+		double readDecimal() throw( IOError & );
+
+		/* moves past the given symbol, which has to be the next thing in the text,
+		 * throws an IOError if it isn't
+		 */
+		void readSymbol( char symbol ) throw( IOError & );
+
+		/* where in the text the next thing is read from, which can be moved
+		 * anywhere in the text, so parts of it can be read on their own
+		 */
+		const char * getPosition() const { return position; }
+		void moveTo( const char * m_position ) { position = m_position; }
+
+	private:
+		const char * text;
+		const char * end;
+		const char * position;
+
+		void skipWhiteSpace();
+
+		/* adds the next significant digit onto the digits read so far
+		 */
+		static void addADigit( int digit, unsigned int & leadingDigits, double & digits, int & numberOfSignificantDigits );
+
+		/* reads a decimal the slow way, for the rare numbers with too many digits to read quickly
+		 */
+		double readDecimalWithStream( const char * start, const char * finish ) throw( IOError & );
+
+		static bool isDigit( char character ) { return ( character >= '0' ) && ( character <= '9' ); }
+
+		// this many digits always fit in an unsigned int
+		static const int max_whole_number_digits = 9;
+		// more significant digits than this can't be added up exactly in a double
+		static const int max_fast_significant_digits = 15;
+		// and powers of ten larger than this can't be held exactly in a double
+		static const int max_fast_exponent = 22;
+};
+
+#endif /*MAZETEXTREADER_H_*/
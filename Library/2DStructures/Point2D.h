@@ -15,6 +15,7 @@
 
 #include "IOError.h"
 #include "Serializable.h"
+#include "GeometryScalar.h"
 
 class Point2D : public Serializable
 {
@@ -23,8 +24,8 @@ class Point2D : public Serializable
 		Point2D( const Point2D & otherPoint );
 		virtual ~Point2D() {}
 		
-		double getX() const { return x; }
-		double getY() const { return y; }
+		GeometryScalar getX() const { return x; }
+		GeometryScalar getY() const { return y; }
 		void setX( double m_x ) { x = m_x; }
 		void setY( double m_y ) { y = m_y; }
 		
@@ -40,8 +41,8 @@ class Point2D : public Serializable
 		std::string type() const { return "2D Point";}
 	
 	private:
-		double x;
-		double y;
+		GeometryScalar x;
+		GeometryScalar y;
 		
 };
 
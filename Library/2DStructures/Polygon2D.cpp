@@ -0,0 +1,125 @@
+/*
+   Project     : 3DMaze
+   File        : Polygon2D.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents a closed two dimensional polygon,
+   				 stored as the list of its corners in order
+*/
+
+
+#include "Polygon2D.h"
+
+using namespace std;
+
+Polygon2D::Polygon2D() :
+	points() {}
+
+Polygon2D::Polygon2D( const Polygon2D & rhs ) :
+	points( rhs.points ) {}
+
+const Polygon2D & Polygon2D::operator=( const Polygon2D & rhs )
+{
+	if( this != &rhs )
+	{
+		points = rhs.points;
+	}
+	return *this;
+}
+
+void Polygon2D::addAPoint( const Point2D & point )
+{
+	points.push_back( point );
+}
+
+const Point2D & Polygon2D::getAPoint( int index ) const
+{
+	return points.at( index );
+}
+
+
+/* returns the edge that starts at the given corner and ends at the next one
+ * ( the last edge wraps back around to the first corner )
+ */
+LineSegment2D Polygon2D::getAnEdge( int index ) const
+{
+	return LineSegment2D( getAPoint( index ), getAPoint( ( index + 1 ) % numberOfPoints() ) );
+}
+
+
+/* returns the area of this polygon, which is positive when
+ * the corners are listed counter-clockwise and negative otherwise
+ */
+double Polygon2D::signedArea() const
+{
+	//shoelace formula
+	double twiceArea = 0.0;
+	for( int i = 0; i < numberOfPoints(); i++ )
+	{
+		const Point2D & current = getAPoint( i );
+		const Point2D & next = getAPoint( ( i + 1 ) % numberOfPoints() );
+		twiceArea += ( current.getX() * next.getY() ) - ( next.getX() * current.getY() );
+	}
+	return twiceArea / 2.0;
+}
+
+
+/* removes corners that don't change the direction of the outline,
+ * i.e. corners that lie on the straight line between their neighbors
+ */
+void Polygon2D::removeCollinearPoints()
+{
+	const double smudgeFactor = 0.0001;
+
+	bool removedAPoint = true;
+	while( removedAPoint && ( numberOfPoints() > 3 ) )
+	{
+		removedAPoint = false;
+		vector<Point2D> keptPoints;
+		for( int i = 0; i < numberOfPoints(); i++ )
+		{
+			const Point2D & previous = keptPoints.empty() ? getAPoint( numberOfPoints() - 1 ) : keptPoints.back();
+			const Point2D & current = getAPoint( i );
+			const Point2D & next = getAPoint( ( i + 1 ) % numberOfPoints() );
+
+			// twice the area of the triangle made by the three corners, compared against the length of its base
+			double twiceArea = ( ( current.getX() - previous.getX() ) * ( next.getY() - previous.getY() ) )
+							 - ( ( current.getY() - previous.getY() ) * ( next.getX() - previous.getX() ) );
+			double baseLength = previous.distanceTo( next );
+			if( fabs( twiceArea ) <= smudgeFactor * baseLength )
+			{
+				removedAPoint = true;
+			}
+			else
+			{
+				keptPoints.push_back( current );
+			}
+		}
+		points = keptPoints;
+	}
+}
+
+void Polygon2D::readIn( istream & in /* = cin */ ) throw( IOError & )
+{
+	points.clear();
+
+	int numberOfPointsToReadIn = 0;
+	in >> numberOfPointsToReadIn;
+
+	Point2D point;
+	for( int i = 0; i < numberOfPointsToReadIn; i++ )
+	{
+		point.readIn( in );
+		addAPoint( point );
+	}
+}
+
+void Polygon2D::writeOut( ostream & out /* = cout */ ) const throw( IOError & )
+{
+	out << numberOfPoints() << '\n';
+	for( int i = 0; i < numberOfPoints(); i++ )
+	{
+		getAPoint( i ).writeOut( out );
+		out << '\n';
+	}
+}
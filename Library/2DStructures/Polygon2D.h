@@ -0,0 +1,57 @@
+/*
+   Project     : 3DMaze
+   File        : Polygon2D.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents a closed two dimensional polygon,
+   				 stored as the list of its corners in order
+*/
+
+
+#ifndef POLYGON2D_H_
+#define POLYGON2D_H_
+
+#include <vector>
+
+#include "Point2D.h"
+#include "LineSegment2D.h"
+#include "Serializable.h"
+#include "IOError.h"
+
+class Polygon2D : public Serializable
+{
+	public:
+		Polygon2D();
+		Polygon2D( const Polygon2D & rhs );
+
+		const Polygon2D & operator=( const Polygon2D & rhs );
+
+		void addAPoint( const Point2D & point );
+		const Point2D & getAPoint( int index ) const;
+		int numberOfPoints() const { return points.size(); }
+
+		/* returns the edge that starts at the given corner and ends at the next one
+		 * ( the last edge wraps back around to the first corner )
+		 */
+		LineSegment2D getAnEdge( int index ) const;
+
+		/* returns the area of this polygon, which is positive when
+		 * the corners are listed counter-clockwise and negative otherwise
+		 */
+		double signedArea() const;
+
+		/* removes corners that don't change the direction of the outline,
+		 * i.e. corners that lie on the straight line between their neighbors
+		 */
+		void removeCollinearPoints();
+
+		//inherited from Serializable
+		void readIn( std::istream & in = std::cin ) throw( IOError & );
+		void writeOut( std::ostream & out = std::cout ) const throw( IOError & );
+		std::string type() const { return "2D Polygon"; }
+
+	private:
+		std::vector<Point2D> points;
+};
+
+#endif /*POLYGON2D_H_*/
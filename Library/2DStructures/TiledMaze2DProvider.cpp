@@ -0,0 +1,182 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMaze2DProvider.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Hands out the lines of a tiled maze file a tile at a time,
+   				 decompressing tiles as they're asked for and throwing away
+   				 the ones used least recently once a memory budget is used up.
+   				 The file itself is mapped into memory, so the operating
+   				 system decides how much of it stays there
+*/
+
+
+#include "TiledMaze2DProvider.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+
+TiledMaze2DProvider::TiledMaze2DProvider( const string & fileName, size_t m_memoryBudget /* = default_memory_budget */ ) throw( IOError & ) :
+	file( fileName ),
+	header( NULL ),
+	index( NULL ),
+	loadedTiles(),
+	recentlyUsed(),
+	memoryBudget( m_memoryBudget ),
+	memoryUsed( 0 )
+{
+	//check that the file really holds a tiled maze that this version understands
+	if( ( file.getData() == NULL ) || ( file.getSize() < sizeof( TiledMazeHeader ) ) )
+	{
+		throw IOError();
+	}
+
+	header = reinterpret_cast<const TiledMazeHeader *>( file.getData() );
+	if( ( memcmp( header->magicNumber, TiledMazeFormat::magic_number, sizeof( header->magicNumber ) ) != 0 ) ||
+		( header->byteOrderMark != TiledMazeHeader::byte_order_mark ) ||
+		( header->version != TiledMazeHeader::current_version ) ||
+		( header->tileSize <= 0.0 ) ||
+		( header->numberOfColumns == 0 ) || ( header->numberOfRows == 0 ) ||
+		( ( header->offsetOfIndex % sizeof( double ) ) != 0 ) ||
+		( header->offsetOfIndex < sizeof( TiledMazeHeader ) ) ||
+		( header->offsetOfIndex > file.getSize() ) )
+	{
+		throw IOError();
+	}
+
+	uint64_t sizeOfIndex = ( uint64_t ) header->numberOfColumns * header->numberOfRows * sizeof( TileIndexEntry );
+	if( sizeOfIndex > ( file.getSize() - header->offsetOfIndex ) )
+	{
+		throw IOError();
+	}
+	index = reinterpret_cast<const TileIndexEntry *>( file.getData() + header->offsetOfIndex );
+
+	//make sure every block is really there
+	for( int tile = 0; tile < numberOfTiles(); tile++ )
+	{
+		if( ( index[ tile ].offsetOfBlock > file.getSize() ) ||
+			( index[ tile ].sizeOfBlock > ( file.getSize() - index[ tile ].offsetOfBlock ) ) )
+		{
+			throw IOError();
+		}
+	}
+}
+
+
+/* returns the lines of the tile, loading it first if it isn't loaded,
+ * the lines stay valid until another tile is loaded
+ */
+const vector<LineSegment2D> & TiledMaze2DProvider::getTile( int tileNumber ) throw( IOError & )
+{
+	if( ( tileNumber < 0 ) || ( tileNumber >= numberOfTiles() ) )
+	{
+		throw IOError();
+	}
+
+	map<int, LoadedTile>::iterator loaded = loadedTiles.find( tileNumber );
+	if( loaded != loadedTiles.end() )
+	{
+		recentlyUsed.splice( recentlyUsed.begin(), recentlyUsed, loaded->second.placeInRecentlyUsed );
+		return loaded->second.lines;
+	}
+
+	const TileIndexEntry & entry = index[ tileNumber ];
+	LoadedTile & tile = loadedTiles[ tileNumber ];
+	try
+	{
+		TiledMazeFormat::decodeLines( file.getData() + entry.offsetOfBlock, entry.sizeOfBlock, entry.numberOfLines, tile.lines );
+	}
+	catch( IOError & ioe )
+	{
+		loadedTiles.erase( tileNumber );
+		throw;
+	}
+
+	recentlyUsed.push_front( tileNumber );
+	tile.placeInRecentlyUsed = recentlyUsed.begin();
+	memoryUsed += memoryUsedBy( tile );
+	stayWithinBudget();
+
+	return tile.lines;
+}
+
+
+/* adds the numbers of all the tiles with lines that could reach into the area to tileNumbers,
+ * without loading any of them
+ */
+void TiledMaze2DProvider::findTilesIn( double minX, double minY, double maxX, double maxY, vector<int> & tileNumbers ) const
+{
+	//a line belongs to the tile holding its middle, so it can reach half its length past that tile
+	double reach = header->longestLine / 2.0;
+	int firstColumn = TiledMazeFormat::columnOf( *header, minX - reach );
+	int lastColumn = TiledMazeFormat::columnOf( *header, maxX + reach );
+	int firstRow = TiledMazeFormat::rowOf( *header, minY - reach );
+	int lastRow = TiledMazeFormat::rowOf( *header, maxY + reach );
+
+	for( int row = firstRow; row <= lastRow; row++ )
+	{
+		for( int column = firstColumn; column <= lastColumn; column++ )
+		{
+			const TileIndexEntry & entry = index[ tileNumberOf( column, row ) ];
+			if( ( entry.numberOfLines > 0 ) &&
+				( entry.minX <= maxX ) && ( entry.maxX >= minX ) && ( entry.minY <= maxY ) && ( entry.maxY >= minY ) )
+			{
+				tileNumbers.push_back( tileNumberOf( column, row ) );
+			}
+		}
+	}
+}
+
+
+/* adds a copy of every line reaching into the area to lines
+ */
+void TiledMaze2DProvider::findLinesIn( double minX, double minY, double maxX, double maxY, vector<LineSegment2D> & lines ) throw( IOError & )
+{
+	vector<int> tileNumbers;
+	findTilesIn( minX, minY, maxX, maxY, tileNumbers );
+
+	for( unsigned int i = 0; i < tileNumbers.size(); i++ )
+	{
+		const vector<LineSegment2D> & tile = getTile( tileNumbers[ i ] );
+		for( unsigned int j = 0; j < tile.size(); j++ )
+		{
+			const LineSegment2D & line = tile[ j ];
+			if( ( min( line.getP1().getX(), line.getP2().getX() ) <= maxX ) && ( max( line.getP1().getX(), line.getP2().getX() ) >= minX ) &&
+				( min( line.getP1().getY(), line.getP2().getY() ) <= maxY ) && ( max( line.getP1().getY(), line.getP2().getY() ) >= minY ) )
+			{
+				lines.push_back( line );
+			}
+		}
+	}
+}
+
+
+/* loaded tiles are thrown away, least recently used first, to stay within the
+ * memory budget ( the tile used most recently is always kept )
+ */
+void TiledMaze2DProvider::setMemoryBudget( size_t m_memoryBudget )
+{
+	memoryBudget = m_memoryBudget;
+	stayWithinBudget();
+}
+
+
+/* throws away the least recently used tiles until the memory used is within budget
+ */
+void TiledMaze2DProvider::stayWithinBudget()
+{
+	while( ( memoryUsed > memoryBudget ) && ( recentlyUsed.size() > 1 ) )
+	{
+		map<int, LoadedTile>::iterator leastRecentlyUsed = loadedTiles.find( recentlyUsed.back() );
+		memoryUsed -= memoryUsedBy( leastRecentlyUsed->second );
+		loadedTiles.erase( leastRecentlyUsed );
+		recentlyUsed.pop_back();
+	}
+}
+
+size_t TiledMaze2DProvider::memoryUsedBy( const LoadedTile & tile )
+{
+	return sizeof( LoadedTile ) + ( tile.lines.capacity() * sizeof( LineSegment2D ) );
+}
@@ -0,0 +1,102 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMaze2DProvider.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Hands out the lines of a tiled maze file a tile at a time,
+   				 decompressing tiles as they're asked for and throwing away
+   				 the ones used least recently once a memory budget is used up.
+   				 The file itself is mapped into memory, so the operating
+   				 system decides how much of it stays there
+*/
+
+
+#ifndef TILEDMAZE2DPROVIDER_H_
+#define TILEDMAZE2DPROVIDER_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <cstddef>
+
+#include "TiledMazeFormat.h"
+#include "LineSegment2D.h"
+#include "MappedFile.h"
+#include "IOError.h"
+
+class TiledMaze2DProvider
+{
+	public:
+		TiledMaze2DProvider( const std::string & fileName, std::size_t m_memoryBudget = default_memory_budget ) throw( IOError & );
+
+		int getWidth() const { return header->width; }
+		int getHeight() const { return header->height; }
+		int numberOfLines() const { return header->numberOfLines; }
+
+		/* tiles are numbered row by row, starting in the corner with the smallest x and y
+		 */
+		int numberOfColumns() const { return header->numberOfColumns; }
+		int numberOfRows() const { return header->numberOfRows; }
+		int numberOfTiles() const { return numberOfColumns() * numberOfRows(); }
+		int tileNumberOf( int column, int row ) const { return ( row * numberOfColumns() ) + column; }
+		double getTileSize() const { return header->tileSize; }
+
+		/* the area covered by the lines of a tile ( which can reach past the tile itself ),
+		 * known without loading the tile
+		 */
+		const TileIndexEntry & getTileEntry( int tileNumber ) const { return index[ tileNumber ]; }
+
+		/* returns the lines of the tile, loading it first if it isn't loaded,
+		 * the lines stay valid until another tile is loaded
+		 */
+		const std::vector<LineSegment2D> & getTile( int tileNumber ) throw( IOError & );
+
+		/* adds the numbers of all the tiles with lines that could reach into the area to tileNumbers,
+		 * without loading any of them
+		 */
+		void findTilesIn( double minX, double minY, double maxX, double maxY, std::vector<int> & tileNumbers ) const;
+
+		/* adds a copy of every line reaching into the area to lines
+		 */
+		void findLinesIn( double minX, double minY, double maxX, double maxY, std::vector<LineSegment2D> & lines ) throw( IOError & );
+
+		/* loaded tiles are thrown away, least recently used first, to stay within the
+		 * memory budget ( the tile used most recently is always kept )
+		 */
+		std::size_t getMemoryBudget() const { return memoryBudget; }
+		void setMemoryBudget( std::size_t m_memoryBudget );
+		std::size_t getMemoryUsed() const { return memoryUsed; }
+		int numberOfTilesLoaded() const { return loadedTiles.size(); }
+
+		static const std::size_t default_memory_budget = 256 << 20;
+
+	private:
+		class LoadedTile
+		{
+			public:
+				std::vector<LineSegment2D> lines;
+				std::list<int>::iterator placeInRecentlyUsed;
+		};
+
+		MappedFile file;
+		const TiledMazeHeader * header;
+		const TileIndexEntry * index;
+
+		std::map<int, LoadedTile> loadedTiles;
+		std::list<int> recentlyUsed;	// most recently used first
+		std::size_t memoryBudget;
+		std::size_t memoryUsed;
+
+		/* throws away the least recently used tiles until the memory used is within budget
+		 */
+		void stayWithinBudget();
+
+		static std::size_t memoryUsedBy( const LoadedTile & tile );
+
+		// disable copying, the file can only be unmapped once
+		TiledMaze2DProvider( const TiledMaze2DProvider & );
+		const TiledMaze2DProvider & operator=( const TiledMaze2DProvider & );
+};
+
+#endif /*TILEDMAZE2DPROVIDER_H_*/
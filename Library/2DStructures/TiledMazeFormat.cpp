@@ -0,0 +1,199 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMazeFormat.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : The layout of a 2D maze stored in tiles, for mazes too big
+   				 to hold in memory all at once. The maze is cut into a grid
+   				 of square tiles, each line belonging to the tile holding its
+   				 middle. A file starts with a header, then an index with an entry
+   				 for every tile ( row by row ), then a compressed block of lines
+   				 for each tile that has any
+*/
+
+
+#include "TiledMazeFormat.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cmath>
+#include <string.h>
+
+using namespace std;
+
+const char TiledMazeFormat::magic_number[ TiledMazeFormat::magic_number_length ] = { '3', 'D', 'T', 'i', 'l', 'e', '\x1a', '\0' };
+
+namespace
+{
+	/* each endpoint coordinate is stored as the bits that differ from a coordinate
+	 * stored just before it ( the same coordinate of the line before, or the first
+	 * endpoint's for the second endpoint ), nearby coordinates share their sign,
+	 * exponent and leading digits, and round numbers end in zero bits, so the
+	 * difference is mostly zeros. Its bytes are reversed to bring the zeros from
+	 * its end to its front, then it's written 7 bits at a time, leaving off the zeros
+	 */
+	unsigned long long bitsOf( double value )
+	{
+		unsigned long long bits;
+		memcpy( &bits, &value, sizeof( bits ) );
+		return bits;
+	}
+
+	double valueOf( unsigned long long bits )
+	{
+		double value;
+		memcpy( &value, &bits, sizeof( value ) );
+		return value;
+	}
+
+	unsigned long long reverseBytes( unsigned long long bits )
+	{
+		unsigned long long reversed = 0;
+		for( int i = 0; i < 8; i++ )
+		{
+			reversed = ( reversed << 8 ) | ( bits & 0xFF );
+			bits >>= 8;
+		}
+		return reversed;
+	}
+
+	void encodeCoordinate( double value, double previous, vector<char> & block )
+	{
+		unsigned long long difference = reverseBytes( bitsOf( value ) ^ bitsOf( previous ) );
+		do
+		{
+			unsigned char byte = difference & 0x7F;
+			difference >>= 7;
+			if( difference != 0 )
+			{
+				byte |= 0x80;	// more bytes follow
+			}
+			block.push_back( byte );
+		} while( difference != 0 );
+	}
+
+	double decodeCoordinate( const unsigned char * & next, const unsigned char * end, double previous ) throw( IOError & )
+	{
+		unsigned long long difference = 0;
+		int shift = 0;
+		while( true )
+		{
+			if( ( next == end ) || ( shift >= 64 ) )
+			{
+				throw IOError();
+			}
+			unsigned char byte = *next++;
+			difference |= ( unsigned long long ) ( byte & 0x7F ) << shift;
+			shift += 7;
+			if( ( byte & 0x80 ) == 0 )
+			{
+				break;
+			}
+		}
+		return valueOf( reverseBytes( difference ) ^ bitsOf( previous ) );
+	}
+}
+
+
+/* returns the column or row of the tile holding the point,
+ * points outside the maze belong to the nearest tile
+ */
+int TiledMazeFormat::columnOf( const TiledMazeHeader & header, double x )
+{
+	double column = ::floor( ( x + ( header.width / 2.0 ) ) / header.tileSize );
+	return ( int ) max( 0.0, min( column, ( double ) header.numberOfColumns - 1 ) );
+}
+
+int TiledMazeFormat::rowOf( const TiledMazeHeader & header, double y )
+{
+	double row = ::floor( ( y + ( header.height / 2.0 ) ) / header.tileSize );
+	return ( int ) max( 0.0, min( row, ( double ) header.numberOfRows - 1 ) );
+}
+
+
+/* the tile a line belongs to, the one holding its middle
+ */
+int TiledMazeFormat::tileNumberOf( const TiledMazeHeader & header, const LineSegment2D & line )
+{
+	double middleX = ( line.getP1().getX() + line.getP2().getX() ) / 2.0;
+	double middleY = ( line.getP1().getY() + line.getP2().getY() ) / 2.0;
+	return ( rowOf( header, middleY ) * header.numberOfColumns ) + columnOf( header, middleX );
+}
+
+
+/* fills in everything but the line counts and offsets for a maze
+ * of the given size cut into tiles of the given size
+ */
+TiledMazeHeader TiledMazeFormat::headerFor( int width, int height, double tileSize )
+{
+	TiledMazeHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magicNumber, magic_number, sizeof( header.magicNumber ) );
+	header.byteOrderMark = TiledMazeHeader::byte_order_mark;
+	header.version = TiledMazeHeader::current_version;
+	header.width = width;
+	header.height = height;
+	header.tileSize = tileSize;
+	header.numberOfColumns = max( 1, ( int ) ceil( width / tileSize ) );
+	header.numberOfRows = max( 1, ( int ) ceil( height / tileSize ) );
+	header.offsetOfIndex = sizeof( header );
+	return header;
+}
+
+
+/* compresses the lines into a block, appending it to the end of block
+ */
+void TiledMazeFormat::encodeLines( const vector<LineSegment2D> & lines, vector<char> & block )
+{
+	double previousX = 0.0;
+	double previousY = 0.0;
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		double x1 = lines[ i ].getP1().getX();
+		double y1 = lines[ i ].getP1().getY();
+		encodeCoordinate( x1, previousX, block );
+		encodeCoordinate( y1, previousY, block );
+		encodeCoordinate( lines[ i ].getP2().getX(), x1, block );
+		encodeCoordinate( lines[ i ].getP2().getY(), y1, block );
+		previousX = x1;
+		previousY = y1;
+	}
+}
+
+
+/* reads the given number of lines out of a block, appending them to lines,
+ * throws an IOError if the block doesn't hold that many lines
+ */
+void TiledMazeFormat::decodeLines( const char * block, size_t sizeOfBlock, int numberOfLines, vector<LineSegment2D> & lines ) throw( IOError & )
+{
+	const unsigned char * next = reinterpret_cast<const unsigned char *>( block );
+	const unsigned char * end = next + sizeOfBlock;
+
+	lines.reserve( lines.size() + numberOfLines );
+	double previousX = 0.0;
+	double previousY = 0.0;
+	for( int i = 0; i < numberOfLines; i++ )
+	{
+		double x1 = decodeCoordinate( next, end, previousX );
+		double y1 = decodeCoordinate( next, end, previousY );
+		double x2 = decodeCoordinate( next, end, x1 );
+		double y2 = decodeCoordinate( next, end, y1 );
+		lines.push_back( LineSegment2D( Point2D( x1, y1 ), Point2D( x2, y2 ) ) );
+		previousX = x1;
+		previousY = y1;
+	}
+}
+
+
+/* returns true if the file exists and starts with the tiled maze magic number
+ */
+bool TiledMazeFormat::isTiled( const string & fileName )
+{
+	ifstream inFile( fileName.c_str(), ios::in | ios::binary );
+	char start[ magic_number_length ];
+	if( !inFile.read( start, magic_number_length ) )
+	{
+		return false;
+	}
+	return memcmp( start, magic_number, magic_number_length ) == 0;
+}
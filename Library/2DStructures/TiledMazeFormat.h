@@ -0,0 +1,94 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMazeFormat.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : The layout of a 2D maze stored in tiles, for mazes too big
+   				 to hold in memory all at once. The maze is cut into a grid
+   				 of square tiles, each line belonging to the tile holding its
+   				 middle. A file starts with a header, then an index with an entry
+   				 for every tile ( row by row ), then a compressed block of lines
+   				 for each tile that has any
+*/
+
+
+#ifndef TILEDMAZEFORMAT_H_
+#define TILEDMAZEFORMAT_H_
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+#include "LineSegment2D.h"
+#include "IOError.h"
+
+/* the start of every tiled maze file
+ */
+class TiledMazeHeader
+{
+	public:
+		char magicNumber[ 8 ];
+		uint32_t byteOrderMark;		// written as byte_order_mark, so files from machines with a different byte order are recognized
+		uint32_t version;
+		int32_t width;
+		int32_t height;
+		uint32_t numberOfColumns;
+		uint32_t numberOfRows;
+		double tileSize;
+		double longestLine;			// lines reach at most half this far out of their tiles
+		uint64_t numberOfLines;
+		uint64_t offsetOfIndex;		// from the start of the header
+
+		static const uint32_t byte_order_mark = 0x01020304;
+		static const uint32_t current_version = 1;
+};
+
+/* where a tile's block of lines is and what area its lines cover
+ */
+class TileIndexEntry
+{
+	public:
+		uint64_t offsetOfBlock;		// from the start of the header
+		uint32_t sizeOfBlock;
+		uint32_t numberOfLines;
+		double minX, minY, maxX, maxY;
+};
+
+class TiledMazeFormat
+{
+	public:
+		/* returns the column or row of the tile holding the point,
+		 * points outside the maze belong to the nearest tile
+		 */
+		static int columnOf( const TiledMazeHeader & header, double x );
+		static int rowOf( const TiledMazeHeader & header, double y );
+
+		/* the tile a line belongs to, the one holding its middle
+		 */
+		static int tileNumberOf( const TiledMazeHeader & header, const LineSegment2D & line );
+
+		/* fills in everything but the line counts and offsets for a maze
+		 * of the given size cut into tiles of the given size
+		 */
+		static TiledMazeHeader headerFor( int width, int height, double tileSize );
+
+		/* compresses the lines into a block, appending it to the end of block
+		 */
+		static void encodeLines( const std::vector<LineSegment2D> & lines, std::vector<char> & block );
+
+		/* reads the given number of lines out of a block, appending them to lines,
+		 * throws an IOError if the block doesn't hold that many lines
+		 */
+		static void decodeLines( const char * block, std::size_t sizeOfBlock, int numberOfLines, std::vector<LineSegment2D> & lines ) throw( IOError & );
+
+		/* returns true if the file exists and starts with the tiled maze magic number
+		 */
+		static bool isTiled( const std::string & fileName );
+
+		// every tiled maze file starts with these bytes
+		static const int magic_number_length = 8;
+		static const char magic_number[ magic_number_length ];
+};
+
+#endif /*TILEDMAZEFORMAT_H_*/
@@ -0,0 +1,373 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMazeWriter.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Writes a tiled maze file out of lines handed to it one at
+   				 a time, without ever holding all of them in memory. Lines
+   				 are set aside in a scratch file as they come in, then sorted
+   				 into their tiles a batch of tiles at a time. Lines that come
+   				 in from the bottom of the maze up skip the scratch file, each
+   				 row of tiles is written out as soon as it's finished
+*/
+
+
+#include "TiledMazeWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include <string.h>
+
+using namespace std;
+
+const double TiledMazeWriter::default_tile_size = 256.0;
+
+namespace
+{
+	/* how a line is kept in the scratch file
+	 */
+	class ScratchLine
+	{
+		public:
+			uint32_t tileNumber;
+			uint32_t unused;
+			double endpoints[ 4 ];	// x1, y1, x2, y2
+	};
+
+	// scratch lines are read back this many at a time
+	const int scratch_lines_per_batch = 4096;
+
+	// every tile has an entry in the index, and a line count held while the file is written
+	const double max_tiles = 1 << 24;
+
+	/* hands back the tile size if the maze can be cut into a sensible number of tiles that size,
+	 * it's checked before the header is worked out from it, so it can't divide by zero or overflow
+	 */
+	double checkedTileSize( int width, int height, double tileSize ) throw( IOError & )
+	{
+		//written this way round so a tile size that isn't a number fails too
+		if( !( tileSize > 0.0 ) || ( ( ceil( max( width, 1 ) / tileSize ) * ceil( max( height, 1 ) / tileSize ) ) > max_tiles ) )
+		{
+			throw IOError();
+		}
+		return tileSize;
+	}
+
+	/* orders lines by where they start, row by row, so lines next to each other
+	 * in a block start near each other and compress better
+	 */
+	bool startsBefore( const LineSegment2D & a, const LineSegment2D & b )
+	{
+		if( a.getP1().getY() != b.getP1().getY() )
+		{
+			return a.getP1().getY() < b.getP1().getY();
+		}
+		return a.getP1().getX() < b.getP1().getX();
+	}
+}
+
+/* the memory budget limits how many lines are held at once while they're sorted into tiles,
+ * lines added from the bottom up are held until their row of tiles is finished instead
+ */
+TiledMazeWriter::TiledMazeWriter( const string & m_fileName, int m_width, int m_height,
+								  double m_tileSize /* = default_tile_size */, size_t m_memoryBudget /* = default_memory_budget */,
+								  LineOrder m_order /* = any_order */ ) throw( IOError & ) :
+	fileName( m_fileName ),
+	scratchFileName( m_fileName + ".lines" ),
+	scratchFile(),
+	memoryBudget( m_memoryBudget ),
+	order( m_order ),
+	header( TiledMazeFormat::headerFor( m_width, m_height, checkedTileSize( m_width, m_height, m_tileSize ) ) ),
+	linesInTile( header.numberOfColumns * header.numberOfRows, 0 ),
+	finished( false ),
+	out(),
+	index(),
+	block(),
+	pendingTiles(),
+	firstPendingRow( 0 )
+{
+	if( order == bottom_to_top )
+	{
+		//nothing is set aside, the blocks are written as they're finished
+		startFile();
+		return;
+	}
+
+	scratchFile.open( scratchFileName.c_str(), ios::out | ios::binary | ios::trunc );
+	if( !scratchFile )
+	{
+		throw IOError();
+	}
+}
+
+
+/* throws away the scratch file, the tiled file is only complete if finish was called
+ */
+TiledMazeWriter::~TiledMazeWriter()
+{
+	if( order == bottom_to_top )
+	{
+		//a file whose blocks were written as they came is only half written if it wasn't finished
+		if( !finished )
+		{
+			out.close();
+			remove( fileName.c_str() );
+		}
+		return;
+	}
+
+	if( scratchFile.is_open() )
+	{
+		scratchFile.close();
+	}
+	remove( scratchFileName.c_str() );
+}
+
+
+/* throws an IOError if the line is added from the bottom up
+ * but belongs in a row of tiles that's already been written
+ */
+void TiledMazeWriter::addALine( const LineSegment2D & line ) throw( IOError & )
+{
+	if( finished )
+	{
+		throw IOError();
+	}
+
+	int tileNumber = TiledMazeFormat::tileNumberOf( header, line );
+	if( order == bottom_to_top )
+	{
+		int row = tileNumber / header.numberOfColumns;
+		if( row < firstPendingRow )
+		{
+			throw IOError();
+		}
+
+		unsigned int pendingTile = tileNumber - ( firstPendingRow * header.numberOfColumns );
+		if( pendingTile >= pendingTiles.size() )
+		{
+			pendingTiles.resize( pendingTile + 1 );
+		}
+		pendingTiles[ pendingTile ].push_back( line );
+	}
+	else
+	{
+		ScratchLine scratchLine;
+		memset( &scratchLine, 0, sizeof( scratchLine ) );
+		scratchLine.tileNumber = tileNumber;
+		scratchLine.endpoints[ 0 ] = line.getP1().getX();
+		scratchLine.endpoints[ 1 ] = line.getP1().getY();
+		scratchLine.endpoints[ 2 ] = line.getP2().getX();
+		scratchLine.endpoints[ 3 ] = line.getP2().getY();
+		scratchFile.write( reinterpret_cast<const char *>( &scratchLine ), sizeof( scratchLine ) );
+		if( !scratchFile )
+		{
+			throw IOError();
+		}
+	}
+
+	linesInTile[ tileNumber ]++;
+	header.numberOfLines++;
+	header.longestLine = max( header.longestLine, line.getP1().distanceTo( line.getP2() ) );
+}
+
+
+/* writes out every row of tiles that lies entirely below y,
+ * when lines are added from the bottom up
+ */
+void TiledMazeWriter::linesFinishedBelow( double y ) throw( IOError & )
+{
+	if( ( order != bottom_to_top ) || finished )
+	{
+		return;
+	}
+
+	//a line in the middle of the top edge of a row belongs to the row above it
+	while( ( firstPendingRow < ( int ) header.numberOfRows ) &&
+		   ( ( ( ( firstPendingRow + 1 ) * header.tileSize ) - ( header.height / 2.0 ) ) <= y ) )
+	{
+		writePendingRow();
+	}
+}
+
+
+/* writes the tiled maze file, no more lines can be added afterwards
+ */
+void TiledMazeWriter::finish() throw( IOError & )
+{
+	if( finished )
+	{
+		throw IOError();
+	}
+
+	if( order == bottom_to_top )
+	{
+		while( firstPendingRow < ( int ) header.numberOfRows )
+		{
+			writePendingRow();
+		}
+	}
+	else
+	{
+		scratchFile.close();
+		if( !scratchFile )
+		{
+			throw IOError();
+		}
+
+		startFile();
+
+		//sort the lines into as many tiles at a time as fit in the memory budget ( at least one tile, however big it is )
+		int numberOfTiles = linesInTile.size();
+		int firstTile = 0;
+		while( firstTile < numberOfTiles )
+		{
+			size_t memoryNeeded = 0;
+			int endTile = firstTile;
+			while( ( endTile < numberOfTiles ) &&
+				   ( ( endTile == firstTile ) || ( ( memoryNeeded + ( linesInTile[ endTile ] * sizeof( LineSegment2D ) ) ) <= memoryBudget ) ) )
+			{
+				memoryNeeded += linesInTile[ endTile ] * sizeof( LineSegment2D );
+				endTile++;
+			}
+
+			writeTiles( firstTile, endTile );
+			firstTile = endTile;
+		}
+	}
+	finished = true;
+
+	out.seekp( 0 );
+	out.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+	out.write( reinterpret_cast<const char *>( &index[ 0 ] ), index.size() * sizeof( TileIndexEntry ) );
+	out.close();
+	if( !out )
+	{
+		throw IOError();
+	}
+}
+
+
+/* writes the header and an empty index, leaving room for the blocks to follow
+ */
+void TiledMazeWriter::startFile() throw( IOError & )
+{
+	out.open( fileName.c_str(), ios::out | ios::binary | ios::trunc );
+	if( !out )
+	{
+		throw IOError();
+	}
+
+	//the header and index go first, but they're only known once all the blocks are written,
+	//so leave room for them and come back
+	index.resize( linesInTile.size() );
+	memset( &index[ 0 ], 0, index.size() * sizeof( TileIndexEntry ) );
+	out.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+	out.write( reinterpret_cast<const char *>( &index[ 0 ] ), index.size() * sizeof( TileIndexEntry ) );
+	if( !out )
+	{
+		throw IOError();
+	}
+}
+
+
+/* reads the scratch file, keeping only the lines of tiles from firstTile up to
+ * ( but not including ) endTile, and writes a block for each of those tiles
+ */
+void TiledMazeWriter::writeTiles( int firstTile, int endTile ) throw( IOError & )
+{
+	vector< vector<LineSegment2D> > tiles( endTile - firstTile );
+	for( int tile = firstTile; tile < endTile; tile++ )
+	{
+		tiles[ tile - firstTile ].reserve( linesInTile[ tile ] );
+	}
+
+	ifstream scratch( scratchFileName.c_str(), ios::in | ios::binary );
+	if( !scratch )
+	{
+		throw IOError();
+	}
+
+	vector<ScratchLine> batch( scratch_lines_per_batch );
+	uint64_t linesLeft = header.numberOfLines;
+	while( linesLeft > 0 )
+	{
+		int linesInBatch = ( int ) min( ( uint64_t ) scratch_lines_per_batch, linesLeft );
+		if( !scratch.read( reinterpret_cast<char *>( &batch[ 0 ] ), linesInBatch * sizeof( ScratchLine ) ) )
+		{
+			throw IOError();
+		}
+		linesLeft -= linesInBatch;
+
+		for( int i = 0; i < linesInBatch; i++ )
+		{
+			int tile = batch[ i ].tileNumber;
+			if( ( tile >= firstTile ) && ( tile < endTile ) )
+			{
+				const double * endpoints = batch[ i ].endpoints;
+				tiles[ tile - firstTile ].push_back( LineSegment2D( Point2D( endpoints[ 0 ], endpoints[ 1 ] ), Point2D( endpoints[ 2 ], endpoints[ 3 ] ) ) );
+			}
+		}
+	}
+
+	for( int tile = firstTile; tile < endTile; tile++ )
+	{
+		writeBlock( tile, tiles[ tile - firstTile ] );
+
+		//free the tile's lines as soon as they're written
+		vector<LineSegment2D>().swap( tiles[ tile - firstTile ] );
+	}
+}
+
+
+/* writes out the lowest row of tiles that's still held
+ */
+void TiledMazeWriter::writePendingRow() throw( IOError & )
+{
+	int firstTile = firstPendingRow * header.numberOfColumns;
+	for( unsigned int column = 0; column < header.numberOfColumns; column++ )
+	{
+		if( pendingTiles.empty() )
+		{
+			break;
+		}
+		writeBlock( firstTile + column, pendingTiles.front() );
+		pendingTiles.pop_front();
+	}
+	firstPendingRow++;
+}
+
+
+/* sorts and writes out a tile's block of lines, and fills in its index entry
+ */
+void TiledMazeWriter::writeBlock( int tile, vector<LineSegment2D> & lines ) throw( IOError & )
+{
+	if( lines.empty() )
+	{
+		return;
+	}
+	sort( lines.begin(), lines.end(), startsBefore );
+
+	TileIndexEntry & entry = index[ tile ];
+	entry.offsetOfBlock = out.tellp();
+	entry.numberOfLines = lines.size();
+	entry.minX = entry.maxX = lines[ 0 ].getP1().getX();
+	entry.minY = entry.maxY = lines[ 0 ].getP1().getY();
+	for( unsigned int i = 0; i < lines.size(); i++ )
+	{
+		entry.minX = min<double>( entry.minX, min( lines[ i ].getP1().getX(), lines[ i ].getP2().getX() ) );
+		entry.maxX = max<double>( entry.maxX, max( lines[ i ].getP1().getX(), lines[ i ].getP2().getX() ) );
+		entry.minY = min<double>( entry.minY, min( lines[ i ].getP1().getY(), lines[ i ].getP2().getY() ) );
+		entry.maxY = max<double>( entry.maxY, max( lines[ i ].getP1().getY(), lines[ i ].getP2().getY() ) );
+	}
+
+	block.clear();
+	TiledMazeFormat::encodeLines( lines, block );
+	entry.sizeOfBlock = block.size();
+	out.write( &block[ 0 ], block.size() );
+	if( !out )
+	{
+		throw IOError();
+	}
+}
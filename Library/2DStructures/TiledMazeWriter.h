@@ -0,0 +1,107 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMazeWriter.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Writes a tiled maze file out of lines handed to it one at
+   				 a time, without ever holding all of them in memory. Lines
+   				 are set aside in a scratch file as they come in, then sorted
+   				 into their tiles a batch of tiles at a time. Lines that come
+   				 in from the bottom of the maze up skip the scratch file, each
+   				 row of tiles is written out as soon as it's finished
+*/
+
+
+#ifndef TILEDMAZEWRITER_H_
+#define TILEDMAZEWRITER_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <cstddef>
+#include <stdint.h>
+
+#include "TiledMazeFormat.h"
+#include "LineSegment2D.h"
+#include "MazeLineSink.h"
+#include "IOError.h"
+
+class TiledMazeWriter : public MazeLineSink
+{
+	public:
+		/* the order lines are added in, in any order at all, or from the bottom up, meaning
+		 * the writer is told with linesFinishedBelow when each part of the maze is finished
+		 */
+		enum LineOrder { any_order, bottom_to_top };
+
+		/* the memory budget limits how many lines are held at once while they're sorted into tiles,
+		 * lines added from the bottom up are held until their row of tiles is finished instead
+		 */
+		TiledMazeWriter( const std::string & m_fileName, int m_width, int m_height,
+						 double m_tileSize = default_tile_size, std::size_t m_memoryBudget = default_memory_budget,
+						 LineOrder m_order = any_order ) throw( IOError & );
+
+		/* throws away the scratch file, the tiled file is only complete if finish was called
+		 */
+		~TiledMazeWriter();
+
+		/* throws an IOError if the line is added from the bottom up
+		 * but belongs in a row of tiles that's already been written
+		 */
+		void addALine( const LineSegment2D & line ) throw( IOError & );
+		uint64_t numberOfLinesAdded() const { return header.numberOfLines; }
+
+		/* writes out every row of tiles that lies entirely below y,
+		 * when lines are added from the bottom up
+		 */
+		void linesFinishedBelow( double y ) throw( IOError & );
+
+		/* writes the tiled maze file, no more lines can be added afterwards
+		 */
+		void finish() throw( IOError & );
+
+		static const double default_tile_size;
+		static const std::size_t default_memory_budget = 64 << 20;
+
+	private:
+		std::string fileName;
+		std::string scratchFileName;
+		std::ofstream scratchFile;
+		std::size_t memoryBudget;
+		LineOrder order;
+		TiledMazeHeader header;
+		std::vector<uint32_t> linesInTile;
+		bool finished;
+
+		std::ofstream out;
+		std::vector<TileIndexEntry> index;
+		std::vector<char> block;
+
+		// the tiles of the rows not yet written when lines are added from the bottom up, row by row
+		std::deque< std::vector<LineSegment2D> > pendingTiles;
+		int firstPendingRow;
+
+		/* writes the header and an empty index, leaving room for the blocks to follow
+		 */
+		void startFile() throw( IOError & );
+
+		/* reads the scratch file, keeping only the lines of tiles from firstTile up to
+		 * ( but not including ) endTile, and writes a block for each of those tiles
+		 */
+		void writeTiles( int firstTile, int endTile ) throw( IOError & );
+
+		/* writes out the lowest row of tiles that's still held
+		 */
+		void writePendingRow() throw( IOError & );
+
+		/* sorts and writes out a tile's block of lines, and fills in its index entry
+		 */
+		void writeBlock( int tile, std::vector<LineSegment2D> & lines ) throw( IOError & );
+
+		// disable copying, there's only one scratch file
+		TiledMazeWriter( const TiledMazeWriter & );
+		const TiledMazeWriter & operator=( const TiledMazeWriter & );
+};
+
+#endif /*TILEDMAZEWRITER_H_*/
@@ -12,6 +12,7 @@
 
 #include <math.h>
 #include "LineSegment2D.h"
+#include "GeometryScalar.h"
 
 class Vector2D
 {
@@ -25,8 +26,8 @@ class Vector2D
 		const Vector2D & operator+=( const Vector2D & rhs );
 		const Vector2D operator*( double scalar ) const;
 		
-		double getX() const { return x; }
-		double getY() const { return y; }
+		GeometryScalar getX() const { return x; }
+		GeometryScalar getY() const { return y; }
 		
 		void setX( double newX ) { x = newX; }
 		void setY( double newY ) { y = newY; }
@@ -44,8 +45,8 @@ class Vector2D
 		
 		
 	private:
-		double x;
-		double y;
+		GeometryScalar x;
+		GeometryScalar y;
 };
 
 #endif /*VECTOR2D_H_*/
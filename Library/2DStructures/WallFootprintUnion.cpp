@@ -0,0 +1,529 @@
+/*
+   Project     : 3DMaze
+   File        : WallFootprintUnion.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Merges the footprints of all the walls in a 2D maze
+   				 ( each line inflated by half the width of a wall on both sides )
+   				 into the small set of outlines that bound their union
+*/
+
+
+#include "WallFootprintUnion.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "Vector2D.h"
+
+using namespace std;
+
+namespace
+{
+	// distances smaller than this are considered to be rounding error
+	const double smudgeFactor = 0.001;
+
+	double crossProduct( const Vector2D & a, const Vector2D & b )
+	{
+		return ( a.getX() * b.getY() ) - ( a.getY() * b.getX() );
+	}
+
+	/* key used to find the pieces that start near a given point
+	 */
+	typedef pair<long long, long long> PointKey;
+
+	PointKey keyFor( const Point2D & point, int xOffset = 0, int yOffset = 0 )
+	{
+		return PointKey( ( long long ) floor( point.getX() / smudgeFactor ) + xOffset,
+						 ( long long ) floor( point.getY() / smudgeFactor ) + yOffset );
+	}
+}
+
+
+/* the rectangle covered by one wall, corners listed counter-clockwise,
+ * reaching the extension past both ends of its line
+ */
+WallFootprintUnion::Footprint::Footprint( const LineSegment2D & line, double widthOfWall, double extension /* = 0.0 */ )
+{
+	// same corners Wall::fitToLine uses for the base of a wall, but ordered counter-clockwise
+	Vector2D lineVector( line );
+	Vector2D toTheRight( lineVector.getY(), -lineVector.getX() );
+	toTheRight.normalize();
+	toTheRight = toTheRight * ( widthOfWall / 2.0 );
+
+	Vector2D along( lineVector );
+	along.normalize();
+	along = along * extension;
+	const Point2D p1( line.getP1().getX() - along.getX(), line.getP1().getY() - along.getY() );
+	const Point2D p2( line.getP2().getX() + along.getX(), line.getP2().getY() + along.getY() );
+
+	corners[ 0 ] = Point2D( p1.getX() + toTheRight.getX(), p1.getY() + toTheRight.getY() );
+	corners[ 1 ] = Point2D( p2.getX() + toTheRight.getX(), p2.getY() + toTheRight.getY() );
+	corners[ 2 ] = Point2D( p2.getX() - toTheRight.getX(), p2.getY() - toTheRight.getY() );
+	corners[ 3 ] = Point2D( p1.getX() - toTheRight.getX(), p1.getY() - toTheRight.getY() );
+
+	minX = maxX = corners[ 0 ].getX();
+	minY = maxY = corners[ 0 ].getY();
+	for( int i = 1; i < 4; i++ )
+	{
+		minX = min<double>( minX, corners[ i ].getX() );
+		maxX = max<double>( maxX, corners[ i ].getX() );
+		minY = min<double>( minY, corners[ i ].getY() );
+		maxY = max<double>( maxY, corners[ i ].getY() );
+	}
+}
+
+
+/* returns true iff the point is inside this footprint and not on its edge
+ */
+bool WallFootprintUnion::Footprint::strictlyContains( const Point2D & point ) const
+{
+	for( int i = 0; i < 4; i++ )
+	{
+		const Point2D & start = getACorner( i );
+		const Point2D & end = getACorner( i + 1 );
+		Vector2D edge( LineSegment2D( start, end ) );
+		Vector2D startToPoint( point.getX() - start.getX(), point.getY() - start.getY() );
+
+		// the inside of the footprint is always to the left of its edges
+		if( crossProduct( edge, startToPoint ) <= 0.0 )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* each footprint reaches the given extension past both ends of its line, as well as half the width of a wall to either side
+ */
+WallFootprintUnion::WallFootprintUnion( const Maze2D & maze, double widthOfWall, double extension /* = 0.0 */ ) :
+	outlines()
+{
+	vector<Footprint> footprints;
+	footprints.reserve( maze.numberOfLines() );
+	for( int i = 0; i < maze.numberOfLines(); i++ )
+	{
+		const LineSegment2D & line = maze.getALine( i );
+		//a line without any length has no footprint
+		if( line.getP1().distanceTo( line.getP2() ) > smudgeFactor )
+		{
+			footprints.push_back( Footprint( line, widthOfWall, extension ) );
+		}
+	}
+
+	vector<LineSegment2D> pieces;
+	findBoundaryPieces( footprints, pieces );
+	chainPiecesIntoOutlines( pieces );
+}
+
+const Polygon2D & WallFootprintUnion::getAnOutline( int index ) const
+{
+	return outlines.at( index );
+}
+
+
+/* splits the area covered by the walls into trapezoids whose parallel sides
+ * run along the y-axis ( triangles come out as trapezoids with a repeated corner ),
+ * each is listed as bottom left, top left, top right, bottom right
+ */
+void WallFootprintUnion::decomposeIntoTrapezoids( vector<Polygon2D> & trapezoids ) const
+{
+	// gather every edge of every outline, pointing in the positive x direction,
+	// along with every x value at which an edge starts or stops
+	vector<LineSegment2D> edges;
+	vector<double> stops;
+	for( int i = 0; i < numberOfOutlines(); i++ )
+	{
+		const Polygon2D & outline = getAnOutline( i );
+		for( int j = 0; j < outline.numberOfPoints(); j++ )
+		{
+			LineSegment2D edge( outline.getAnEdge( j ) );
+			stops.push_back( edge.getP1().getX() );
+
+			//edges parallel to the y-axis don't bound any trapezoid from above or below
+			if( fabs( edge.getP2().getX() - edge.getP1().getX() ) > smudgeFactor )
+			{
+				if( edge.getP1().getX() > edge.getP2().getX() )
+				{
+					edge = LineSegment2D( edge.getP2(), edge.getP1() );
+				}
+				edges.push_back( edge );
+			}
+		}
+	}
+
+	sort( stops.begin(), stops.end() );
+	vector<double> distinctStops;
+	for( unsigned int i = 0; i < stops.size(); i++ )
+	{
+		if( distinctStops.empty() || ( stops[ i ] - distinctStops.back() ) > smudgeFactor )
+		{
+			distinctStops.push_back( stops[ i ] );
+		}
+	}
+
+	vector< pair<double, int> > edgesByLeftEnd;
+	for( unsigned int i = 0; i < edges.size(); i++ )
+	{
+		edgesByLeftEnd.push_back( make_pair( edges[ i ].getP1().getX(), ( int ) i ) );
+	}
+	sort( edgesByLeftEnd.begin(), edgesByLeftEnd.end() );
+
+	/* sweep across the distinct x values, between each neighboring pair the walls are covered by the
+	 * space between the 1st and 2nd edge crossing that strip, the 3rd and 4th, and so on...
+	 * a trapezoid keeps growing as long as the same pair of edges bounds it in the next strip
+	 */
+	typedef map< pair<int, int>, double > OpenTrapezoids;	// ( lower edge, upper edge ) -> left side
+	OpenTrapezoids openTrapezoids;
+	vector<int> activeEdges;
+	unsigned int nextEdge = 0;
+
+	class TrapezoidUtil
+	{
+		public:
+			static double heightAlong( const LineSegment2D & edge, double x )
+			{
+				double fraction = ( x - edge.getP1().getX() ) / ( edge.getP2().getX() - edge.getP1().getX() );
+				return edge.getP1().getY() + ( fraction * ( edge.getP2().getY() - edge.getP1().getY() ) );
+			}
+
+			static void close( const LineSegment2D & lower, const LineSegment2D & upper, double left, double right, vector<Polygon2D> & trapezoids )
+			{
+				Polygon2D trapezoid;
+				trapezoid.addAPoint( Point2D( left, heightAlong( lower, left ) ) );
+				trapezoid.addAPoint( Point2D( left, heightAlong( upper, left ) ) );
+				trapezoid.addAPoint( Point2D( right, heightAlong( upper, right ) ) );
+				trapezoid.addAPoint( Point2D( right, heightAlong( lower, right ) ) );
+				trapezoids.push_back( trapezoid );
+			}
+	};
+
+	for( unsigned int i = 0; ( i + 1 ) < distinctStops.size(); i++ )
+	{
+		double left = distinctStops[ i ];
+		double right = distinctStops[ i + 1 ];
+		double middle = ( left + right ) / 2.0;
+
+		// forget edges that ended before this strip, and pick up the ones that begin here
+		vector<int> stillActive;
+		for( unsigned int j = 0; j < activeEdges.size(); j++ )
+		{
+			if( edges[ activeEdges[ j ] ].getP2().getX() > middle )
+			{
+				stillActive.push_back( activeEdges[ j ] );
+			}
+		}
+		activeEdges.swap( stillActive );
+		while( ( nextEdge < edgesByLeftEnd.size() ) && ( edgesByLeftEnd[ nextEdge ].first < middle ) )
+		{
+			if( edges[ edgesByLeftEnd[ nextEdge ].second ].getP2().getX() > middle )
+			{
+				activeEdges.push_back( edgesByLeftEnd[ nextEdge ].second );
+			}
+			nextEdge++;
+		}
+
+		vector< pair<double, int> > crossingEdges;
+		for( unsigned int j = 0; j < activeEdges.size(); j++ )
+		{
+			crossingEdges.push_back( make_pair( TrapezoidUtil::heightAlong( edges[ activeEdges[ j ] ], middle ), activeEdges[ j ] ) );
+		}
+		sort( crossingEdges.begin(), crossingEdges.end() );
+
+		OpenTrapezoids stillOpen;
+		for( unsigned int j = 0; ( j + 1 ) < crossingEdges.size(); j += 2 )
+		{
+			pair<int, int> bounds( crossingEdges[ j ].second, crossingEdges[ j + 1 ].second );
+			OpenTrapezoids::const_iterator existing = openTrapezoids.find( bounds );
+			stillOpen[ bounds ] = ( existing != openTrapezoids.end() ) ? existing->second : left;
+		}
+
+		for( OpenTrapezoids::const_iterator it = openTrapezoids.begin(); it != openTrapezoids.end(); ++it )
+		{
+			if( stillOpen.find( it->first ) == stillOpen.end() )
+			{
+				TrapezoidUtil::close( edges[ it->first.first ], edges[ it->first.second ], it->second, left, trapezoids );
+			}
+		}
+		openTrapezoids.swap( stillOpen );
+	}
+
+	for( OpenTrapezoids::const_iterator it = openTrapezoids.begin(); it != openTrapezoids.end(); ++it )
+	{
+		TrapezoidUtil::close( edges[ it->first.first ], edges[ it->first.second ], it->second, distinctStops.back(), trapezoids );
+	}
+}
+
+
+/* collects the pieces of the footprints' edges that aren't covered by any other footprint
+ */
+void WallFootprintUnion::findBoundaryPieces( const vector<Footprint> & footprints, vector<LineSegment2D> & pieces )
+{
+	/* find which footprints have overlapping bounding boxes ( or come within the smudge factor of overlapping ),
+	 * by dropping them into a grid of buckets about as many as there are footprints, and only comparing
+	 * footprints that share a bucket. A pair is only compared in the bucket holding the bottom left corner
+	 * of where their boxes overlap, so no pair is found twice
+	 */
+	vector< vector<int> > neighbors( footprints.size() );
+	if( footprints.empty() )
+	{
+		return;
+	}
+
+	double minX = footprints[ 0 ].getMinX();
+	double maxX = footprints[ 0 ].getMaxX();
+	double minY = footprints[ 0 ].getMinY();
+	double maxY = footprints[ 0 ].getMaxY();
+	for( unsigned int i = 1; i < footprints.size(); i++ )
+	{
+		minX = min( minX, footprints[ i ].getMinX() );
+		maxX = max( maxX, footprints[ i ].getMaxX() );
+		minY = min( minY, footprints[ i ].getMinY() );
+		maxY = max( maxY, footprints[ i ].getMaxY() );
+	}
+	minX -= smudgeFactor;
+	minY -= smudgeFactor;
+	double bucketSize = max( smudgeFactor, sqrt( ( ( maxX - minX ) * ( maxY - minY ) ) / footprints.size() ) );
+	int bucketsAcross = ( int ) ( ( maxX - minX ) / bucketSize ) + 1;
+	int bucketsUp = ( int ) ( ( maxY - minY ) / bucketSize ) + 1;
+
+	class BucketUtil
+	{
+		public:
+			static int bucketOf( double value, double start, double bucketSize, int numberOfBuckets )
+			{
+				return max( 0, min( numberOfBuckets - 1, ( int ) ( ( value - start ) / bucketSize ) ) );
+			}
+	};
+
+	vector< vector<int> > buckets( bucketsAcross * bucketsUp );
+	for( unsigned int i = 0; i < footprints.size(); i++ )
+	{
+		const Footprint & footprint = footprints[ i ];
+		int firstColumn = BucketUtil::bucketOf( footprint.getMinX() - ( smudgeFactor / 2.0 ), minX, bucketSize, bucketsAcross );
+		int lastColumn = BucketUtil::bucketOf( footprint.getMaxX() + ( smudgeFactor / 2.0 ), minX, bucketSize, bucketsAcross );
+		int firstRow = BucketUtil::bucketOf( footprint.getMinY() - ( smudgeFactor / 2.0 ), minY, bucketSize, bucketsUp );
+		int lastRow = BucketUtil::bucketOf( footprint.getMaxY() + ( smudgeFactor / 2.0 ), minY, bucketSize, bucketsUp );
+		for( int row = firstRow; row <= lastRow; row++ )
+		{
+			for( int column = firstColumn; column <= lastColumn; column++ )
+			{
+				buckets[ ( row * bucketsAcross ) + column ].push_back( i );
+			}
+		}
+	}
+
+	for( unsigned int bucket = 0; bucket < buckets.size(); bucket++ )
+	{
+		const vector<int> & inBucket = buckets[ bucket ];
+		for( unsigned int i = 0; i < inBucket.size(); i++ )
+		{
+			const Footprint & current = footprints[ inBucket[ i ] ];
+			for( unsigned int j = i + 1; j < inBucket.size(); j++ )
+			{
+				const Footprint & other = footprints[ inBucket[ j ] ];
+				if( ( other.getMinX() > ( current.getMaxX() + smudgeFactor ) ) || ( current.getMinX() > ( other.getMaxX() + smudgeFactor ) ) ||
+					( other.getMinY() > ( current.getMaxY() + smudgeFactor ) ) || ( current.getMinY() > ( other.getMaxY() + smudgeFactor ) ) )
+				{
+					continue;
+				}
+
+				double overlapX = max( current.getMinX(), other.getMinX() ) - ( smudgeFactor / 2.0 );
+				double overlapY = max( current.getMinY(), other.getMinY() ) - ( smudgeFactor / 2.0 );
+				int overlapBucket = ( BucketUtil::bucketOf( overlapY, minY, bucketSize, bucketsUp ) * bucketsAcross ) +
+									BucketUtil::bucketOf( overlapX, minX, bucketSize, bucketsAcross );
+				if( overlapBucket == ( int ) bucket )
+				{
+					neighbors[ inBucket[ i ] ].push_back( inBucket[ j ] );
+					neighbors[ inBucket[ j ] ].push_back( inBucket[ i ] );
+				}
+			}
+		}
+	}
+
+	for( unsigned int i = 0; i < footprints.size(); i++ )
+	{
+		const Footprint & footprint = footprints[ i ];
+		for( int edgeIndex = 0; edgeIndex < 4; edgeIndex++ )
+		{
+			const Point2D & start = footprint.getACorner( edgeIndex );
+			const Point2D & end = footprint.getACorner( edgeIndex + 1 );
+
+			// cut this edge everywhere a neighboring footprint's edge touches it
+			vector<double> parameters;
+			parameters.push_back( 0.0 );
+			parameters.push_back( 1.0 );
+			for( unsigned int j = 0; j < neighbors[ i ].size(); j++ )
+			{
+				const Footprint & neighbor = footprints[ neighbors[ i ][ j ] ];
+				for( int k = 0; k < 4; k++ )
+				{
+					findSplitParameters( start, end, neighbor.getACorner( k ), neighbor.getACorner( k + 1 ), parameters );
+				}
+			}
+			sort( parameters.begin(), parameters.end() );
+
+			Vector2D edge( LineSegment2D( start, end ) );
+			Vector2D outward( edge.getY(), -edge.getX() );
+			outward.normalize();
+			outward = outward * smudgeFactor;
+
+			for( unsigned int j = 0; ( j + 1 ) < parameters.size(); j++ )
+			{
+				if( parameters[ j + 1 ] <= parameters[ j ] )
+				{
+					continue;
+				}
+
+				Point2D pieceStart( start.getX() + edge.getX() * parameters[ j ], start.getY() + edge.getY() * parameters[ j ] );
+				Point2D pieceEnd( start.getX() + edge.getX() * parameters[ j + 1 ], start.getY() + edge.getY() * parameters[ j + 1 ] );
+				Point2D middle( ( pieceStart.getX() + pieceEnd.getX() ) / 2.0, ( pieceStart.getY() + pieceEnd.getY() ) / 2.0 );
+				Point2D justOutside( middle.getX() + outward.getX(), middle.getY() + outward.getY() );
+				Point2D justInside( middle.getX() - outward.getX(), middle.getY() - outward.getY() );
+
+				/* a piece is on the boundary of the union only if there is nothing
+				 * right on the other side of it, and if two footprints share the same
+				 * piece of edge facing the same way only the first one keeps it
+				 */
+				bool onBoundary = true;
+				for( unsigned int k = 0; onBoundary && ( k < neighbors[ i ].size() ); k++ )
+				{
+					int neighborIndex = neighbors[ i ][ k ];
+					const Footprint & neighbor = footprints[ neighborIndex ];
+					if( neighbor.strictlyContains( justOutside ) )
+					{
+						onBoundary = false;
+					}
+					else if( ( neighborIndex < ( int ) i ) && neighbor.strictlyContains( justInside ) )
+					{
+						onBoundary = false;
+					}
+				}
+
+				if( onBoundary )
+				{
+					pieces.push_back( LineSegment2D( pieceStart, pieceEnd ) );
+				}
+			}
+		}
+	}
+}
+
+
+/* joins boundary pieces end to end into closed outlines
+ */
+void WallFootprintUnion::chainPiecesIntoOutlines( const vector<LineSegment2D> & pieces )
+{
+	multimap<PointKey, int> piecesByStart;
+	for( unsigned int i = 0; i < pieces.size(); i++ )
+	{
+		piecesByStart.insert( make_pair( keyFor( pieces[ i ].getP1() ), ( int ) i ) );
+	}
+
+	vector<bool> used( pieces.size(), false );
+	for( unsigned int first = 0; first < pieces.size(); first++ )
+	{
+		if( used[ first ] )
+		{
+			continue;
+		}
+
+		Polygon2D outline;
+		int current = first;
+		bool closed = false;
+		while( ( current >= 0 ) && !closed )
+		{
+			used[ current ] = true;
+			outline.addAPoint( pieces[ current ].getP1() );
+
+			/* look for the pieces that continue on from this one, when there is more than one
+			 * ( two outlines touching at a corner ) take the sharpest turn to the left
+			 * so that the outlines stay separate
+			 */
+			const Point2D & end = pieces[ current ].getP2();
+			Vector2D incoming( pieces[ current ] );
+			int next = -1;
+			double bestTurn = 0.0;
+			for( int xOffset = -1; xOffset <= 1; xOffset++ )
+			{
+				for( int yOffset = -1; yOffset <= 1; yOffset++ )
+				{
+					pair< multimap<PointKey, int>::const_iterator, multimap<PointKey, int>::const_iterator > candidates;
+					candidates = piecesByStart.equal_range( keyFor( end, xOffset, yOffset ) );
+					for( multimap<PointKey, int>::const_iterator it = candidates.first; it != candidates.second; ++it )
+					{
+						int candidate = it->second;
+						if( ( used[ candidate ] && ( candidate != ( int ) first ) ) || ( pieces[ candidate ].getP1().distanceTo( end ) > smudgeFactor ) )
+						{
+							continue;
+						}
+						Vector2D outgoing( pieces[ candidate ] );
+						double turn = atan2( crossProduct( incoming, outgoing ), incoming.dotProduct( outgoing ) );
+						if( ( next < 0 ) || ( turn > bestTurn ) )
+						{
+							next = candidate;
+							bestTurn = turn;
+						}
+					}
+				}
+			}
+
+			closed = ( next == ( int ) first );
+			current = next;
+		}
+
+		if( closed )
+		{
+			outline.removeCollinearPoints();
+			if( ( outline.numberOfPoints() >= 3 ) && ( fabs( outline.signedArea() ) > smudgeFactor ) )
+			{
+				outlines.push_back( outline );
+			}
+		}
+	}
+}
+
+
+/* returns the parameters ( strictly between 0 and 1 ) along the edge
+ * from "start" to "end" at which the edge from "otherStart" to "otherEnd" touches it
+ */
+void WallFootprintUnion::findSplitParameters( const Point2D & start, const Point2D & end,
+											  const Point2D & otherStart, const Point2D & otherEnd,
+											  vector<double> & parameters )
+{
+	Vector2D edge( LineSegment2D( start, end ) );
+	Vector2D otherEdge( LineSegment2D( otherStart, otherEnd ) );
+	Vector2D startToOtherStart( otherStart.getX() - start.getX(), otherStart.getY() - start.getY() );
+
+	double edgeLengthSquared = edge.lengthSquared();
+	double denominator = crossProduct( edge, otherEdge );
+	double tolerance = smudgeFactor / sqrt( edgeLengthSquared );
+
+	if( fabs( denominator ) > ( smudgeFactor * smudgeFactor ) )
+	{
+		double t = crossProduct( startToOtherStart, otherEdge ) / denominator;
+		double u = crossProduct( startToOtherStart, edge ) / denominator;
+		double otherTolerance = smudgeFactor / otherEdge.length();
+		if( ( t > 0.0 ) && ( t < 1.0 ) && ( u >= -otherTolerance ) && ( u <= ( 1.0 + otherTolerance ) ) )
+		{
+			parameters.push_back( t );
+		}
+	}
+	//the edges are parallel, so they only touch if they lie along the same line
+	else if( fabs( crossProduct( startToOtherStart, edge ) ) <= ( smudgeFactor * sqrt( edgeLengthSquared ) ) )
+	{
+		Vector2D startToOtherEnd( otherEnd.getX() - start.getX(), otherEnd.getY() - start.getY() );
+		double t1 = edge.dotProduct( startToOtherStart ) / edgeLengthSquared;
+		double t2 = edge.dotProduct( startToOtherEnd ) / edgeLengthSquared;
+		if( ( t1 > tolerance ) && ( t1 < ( 1.0 - tolerance ) ) )
+		{
+			parameters.push_back( t1 );
+		}
+		if( ( t2 > tolerance ) && ( t2 < ( 1.0 - tolerance ) ) )
+		{
+			parameters.push_back( t2 );
+		}
+	}
+}
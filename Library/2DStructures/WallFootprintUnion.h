@@ -0,0 +1,83 @@
+/*
+   Project     : 3DMaze
+   File        : WallFootprintUnion.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Merges the footprints of all the walls in a 2D maze
+   				 ( each line inflated by half the width of a wall on both sides )
+   				 into the small set of outlines that bound their union
+*/
+
+
+#ifndef WALLFOOTPRINTUNION_H_
+#define WALLFOOTPRINTUNION_H_
+
+#include <vector>
+
+#include "Point2D.h"
+#include "LineSegment2D.h"
+#include "Polygon2D.h"
+#include "Maze2D.h"
+
+class WallFootprintUnion
+{
+	public:
+		/* each footprint reaches the given extension past both ends of its line, as well as half the width of a wall to either side
+		 */
+		WallFootprintUnion( const Maze2D & maze, double widthOfWall, double extension = 0.0 );
+
+		/* each outline keeps the inside of the walls on its left,
+		 * so outer boundaries run counter-clockwise and holes run clockwise
+		 */
+		int numberOfOutlines() const { return outlines.size(); }
+		const Polygon2D & getAnOutline( int index ) const;
+
+		/* splits the area covered by the walls into trapezoids whose parallel sides
+		 * run along the y-axis ( triangles come out as trapezoids with a repeated corner ),
+		 * each is listed as bottom left, top left, top right, bottom right
+		 */
+		void decomposeIntoTrapezoids( std::vector<Polygon2D> & trapezoids ) const;
+
+		/* the rectangle covered by one wall, corners listed counter-clockwise,
+		 * reaching the extension past both ends of its line
+		 */
+		class Footprint
+		{
+			public:
+				Footprint( const LineSegment2D & line, double widthOfWall, double extension = 0.0 );
+
+				const Point2D & getACorner( int index ) const { return corners[ index % 4 ]; }
+				double getMinX() const { return minX; }
+				double getMaxX() const { return maxX; }
+				double getMinY() const { return minY; }
+				double getMaxY() const { return maxY; }
+
+				/* returns true iff the point is inside this footprint and not on its edge
+				 */
+				bool strictlyContains( const Point2D & point ) const;
+
+			private:
+				Point2D corners[ 4 ];
+				double minX, maxX, minY, maxY;
+		};
+
+	private:
+		std::vector<Polygon2D> outlines;
+
+		/* collects the pieces of the footprints' edges that aren't covered by any other footprint
+		 */
+		static void findBoundaryPieces( const std::vector<Footprint> & footprints, std::vector<LineSegment2D> & pieces );
+
+		/* joins boundary pieces end to end into closed outlines
+		 */
+		void chainPiecesIntoOutlines( const std::vector<LineSegment2D> & pieces );
+
+		/* returns the parameters ( strictly between 0 and 1 ) along the edge
+		 * from "start" to "end" at which the edge from "otherStart" to "otherEnd" touches it
+		 */
+		static void findSplitParameters( const Point2D & start, const Point2D & end,
+										 const Point2D & otherStart, const Point2D & otherEnd,
+										 std::vector<double> & parameters );
+};
+
+#endif /*WALLFOOTPRINTUNION_H_*/
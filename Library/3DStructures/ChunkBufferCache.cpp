@@ -0,0 +1,295 @@
+/*
+   Project     : 3DMaze
+   File        : ChunkBufferCache.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps a copy of each maze chunk's vertices in a buffer on
+   				 the graphics card, only uploading a chunk again when it changes.
+   				 Buffers belong to one openGL context, so each widget that draws
+   				 a maze keeps its own cache. Chunks that are small on screen can
+   				 be drawn in less detail, as plain outlines or as part of a picture
+   				 of the whole maze
+*/
+
+
+#include "ChunkBufferCache.h"
+
+#include <algorithm>
+
+#include <GL/glu.h>		// this will need to be smarter for Mac builds (possibly by including <OpenGL/glu.h> instead
+
+using namespace std;
+
+ChunkBufferCache::ChunkBufferCache() :
+	cachedBuffers(),
+	buffersSupported( true ),
+	usingLevelsOfDetail( false ),
+	impostorTexture( 0 ),
+	uploadedImpostorHash( 0 ),
+	impostorAreas()
+{
+	outlineColor[ 0 ] = outlineColor[ 1 ] = outlineColor[ 2 ] = 0.5f;
+}
+
+ChunkBufferCache::~ChunkBufferCache()
+{
+	releaseAllBuffers();
+}
+
+
+/* remembers that the chunk is still part of the maze, whether it's drawn or not
+ */
+void ChunkBufferCache::keepChunk( const MazeChunk & chunk )
+{
+	CachedBuffers::iterator cached = cachedBuffers.find( ChunkKey( chunk.getColumn(), chunk.getRow() ) );
+	if( cached != cachedBuffers.end() )
+	{
+		cached->second.stillInMaze = true;
+	}
+}
+
+
+/* draws the chunk out of its buffer on the graphics card, uploading the
+ * chunk's vertices first if they've changed since they were last uploaded
+ */
+void ChunkBufferCache::drawChunk( const MazeChunk & chunk )
+{
+	if( chunk.numberOfQuads() == 0 )
+	{
+		keepChunk( chunk );
+		return;
+	}
+
+	if( !bindBufferOf( chunk ) )
+	{
+		chunk.Draw();
+		return;
+	}
+
+	// with a buffer bound, the "pointer" given to openGL is an offset into the buffer
+	glInterleavedArrays( GL_T2F_V3F, 0, 0 );
+	glDrawArrays( GL_QUADS, 0, chunk.numberOfQuads() * 4 );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+
+	QGLBuffer::release( QGLBuffer::VertexBuffer );
+}
+
+
+/* chunks are only drawn in less detail once this has been called,
+ * the outlines are drawn in the given color ( which should look
+ * like the walls' texture from far away )
+ */
+void ChunkBufferCache::useLevelsOfDetail( GLfloat red, GLfloat green, GLfloat blue )
+{
+	usingLevelsOfDetail = true;
+	outlineColor[ 0 ] = red;
+	outlineColor[ 1 ] = green;
+	outlineColor[ 2 ] = blue;
+}
+
+
+/* draws only the shape of the chunk, untextured, out of its buffer on the graphics card
+ */
+void ChunkBufferCache::drawChunkOutline( const MazeChunk & chunk )
+{
+	if( chunk.numberOfQuads() == 0 )
+	{
+		keepChunk( chunk );
+		return;
+	}
+
+	glPushAttrib( GL_CURRENT_BIT | GL_ENABLE_BIT );
+	glDisable( GL_TEXTURE_2D );
+	glColor3fv( outlineColor );
+
+	if( bindBufferOf( chunk ) )
+	{
+		// skip past the texture coordinates at the start of each vertex
+		glEnableClientState( GL_VERTEX_ARRAY );
+		glVertexPointer( 3, GL_FLOAT, MazeChunk::floats_per_vertex * sizeof( GLfloat ), ( const GLvoid * ) ( 2 * sizeof( GLfloat ) ) );
+		glDrawArrays( GL_QUADS, 0, chunk.numberOfQuads() * 4 );
+		glDisableClientState( GL_VERTEX_ARRAY );
+
+		QGLBuffer::release( QGLBuffer::VertexBuffer );
+	}
+	else
+	{
+		chunk.DrawOutline();
+	}
+
+	glPopAttrib();
+}
+
+
+/* remembers to draw the chunk's part of the picture of the maze
+ * the next time drawImpostor is called
+ */
+void ChunkBufferCache::addChunkToImpostor( const MazeChunk & chunk )
+{
+	keepChunk( chunk );
+
+	impostorAreas.push_back( chunk.getMinX() );
+	impostorAreas.push_back( chunk.getMaxX() );
+	impostorAreas.push_back( chunk.getMinY() );
+	impostorAreas.push_back( chunk.getMaxY() );
+}
+
+
+/* draws the parts of the picture of the maze that were added since the last call,
+ * uploading the picture first if it's changed since it was last uploaded
+ */
+void ChunkBufferCache::drawImpostor( const MazeImpostor & impostor )
+{
+	if( impostorAreas.empty() )
+	{
+		return;
+	}
+
+	if( impostor.isEmpty() )
+	{
+		impostorAreas.clear();
+		return;
+	}
+
+	if( impostorTexture == 0 )
+	{
+		glGenTextures( 1, &impostorTexture );
+		uploadedImpostorHash = impostor.getContentHash() + 1;	// anything but the current hash
+	}
+
+	glBindTexture( GL_TEXTURE_2D, impostorTexture );
+
+	if( uploadedImpostorHash != impostor.getContentHash() )
+	{
+		// mipmaps keep thin walls from flickering in and out as the maze gets smaller
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+		gluBuild2DMipmaps( GL_TEXTURE_2D, GL_ALPHA, impostor.getResolution(), impostor.getResolution(),
+						   GL_ALPHA, GL_UNSIGNED_BYTE, &impostor.getCoverage()[ 0 ] );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP );
+		uploadedImpostorHash = impostor.getContentHash();
+	}
+
+	// the picture only says how much of each spot is covered, the color comes from the outlines
+	glPushAttrib( GL_CURRENT_BIT | GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_TEXTURE_BIT );
+	glEnable( GL_TEXTURE_2D );
+	glTexEnvi( GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE );
+	glEnable( GL_BLEND );
+	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+	glDepthMask( GL_FALSE );
+	glColor3fv( outlineColor );
+
+	double z = impostor.getHeightOfTop();
+	glBegin( GL_QUADS );
+	for( unsigned int i = 0; i < impostorAreas.size(); i += 4 )
+	{
+		double minX = max( impostorAreas[ i ], impostor.getMinX() );
+		double maxX = min( impostorAreas[ i + 1 ], impostor.getMaxX() );
+		double minY = max( impostorAreas[ i + 2 ], impostor.getMinY() );
+		double maxY = min( impostorAreas[ i + 3 ], impostor.getMaxY() );
+		if( ( minX >= maxX ) || ( minY >= maxY ) )
+		{
+			continue;
+		}
+
+		glTexCoord2d( impostor.textureXFor( minX ), impostor.textureYFor( minY ) );
+		glVertex3d( minX, minY, z );
+		glTexCoord2d( impostor.textureXFor( maxX ), impostor.textureYFor( minY ) );
+		glVertex3d( maxX, minY, z );
+		glTexCoord2d( impostor.textureXFor( maxX ), impostor.textureYFor( maxY ) );
+		glVertex3d( maxX, maxY, z );
+		glTexCoord2d( impostor.textureXFor( minX ), impostor.textureYFor( maxY ) );
+		glVertex3d( minX, maxY, z );
+	}
+	glEnd();
+
+	glPopAttrib();
+
+	impostorAreas.clear();
+}
+
+
+/* frees the buffers of chunks that weren't kept or drawn since the last time this was called
+ */
+void ChunkBufferCache::releaseBuffersOfMissingChunks()
+{
+	CachedBuffers::iterator it = cachedBuffers.begin();
+	while( it != cachedBuffers.end() )
+	{
+		if( !it->second.stillInMaze )
+		{
+			delete it->second.buffer;
+			cachedBuffers.erase( it++ );
+		}
+		else
+		{
+			it->second.stillInMaze = false;
+			++it;
+		}
+	}
+}
+
+
+/* frees all the buffers, and the picture of the maze
+ */
+void ChunkBufferCache::releaseAllBuffers()
+{
+	for( CachedBuffers::iterator it = cachedBuffers.begin(); it != cachedBuffers.end(); ++it )
+	{
+		delete it->second.buffer;
+	}
+	cachedBuffers.clear();
+
+	if( impostorTexture != 0 )
+	{
+		glDeleteTextures( 1, &impostorTexture );
+		impostorTexture = 0;
+	}
+	impostorAreas.clear();
+}
+
+
+/* binds the chunk's buffer, uploading the chunk's vertices first if they've changed
+ * since they were last uploaded, returns false if buffers can't be used
+ */
+bool ChunkBufferCache::bindBufferOf( const MazeChunk & chunk )
+{
+	if( !buffersSupported )
+	{
+		keepChunk( chunk );
+		return false;
+	}
+
+	CachedBuffer & cached = cachedBuffers[ ChunkKey( chunk.getColumn(), chunk.getRow() ) ];
+	cached.stillInMaze = true;
+
+	if( cached.buffer == NULL )
+	{
+		cached.buffer = new QGLBuffer( QGLBuffer::VertexBuffer );
+		cached.buffer->setUsagePattern( QGLBuffer::StaticDraw );
+		if( !cached.buffer->create() )
+		{
+			//the graphics card can't hold on to vertices for us, so stop trying
+			delete cached.buffer;
+			cached.buffer = NULL;
+			buffersSupported = false;
+			return false;
+		}
+	}
+
+	cached.buffer->bind();
+
+	if( !cached.uploaded || ( cached.uploadedContentHash != chunk.getContentHash() ) || ( cached.uploadedNumberOfQuads != chunk.numberOfQuads() ) )
+	{
+		const vector<GLfloat> & vertices = chunk.getVertices();
+		cached.buffer->allocate( &vertices[ 0 ], vertices.size() * sizeof( GLfloat ) );
+		cached.uploadedContentHash = chunk.getContentHash();
+		cached.uploadedNumberOfQuads = chunk.numberOfQuads();
+		cached.uploaded = true;
+	}
+
+	return true;
+}
@@ -0,0 +1,117 @@
+/*
+   Project     : 3DMaze
+   File        : ChunkBufferCache.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps a copy of each maze chunk's vertices in a buffer on
+   				 the graphics card, only uploading a chunk again when it changes.
+   				 Buffers belong to one openGL context, so each widget that draws
+   				 a maze keeps its own cache. Chunks that are small on screen can
+   				 be drawn in less detail, as plain outlines or as part of a picture
+   				 of the whole maze
+*/
+
+
+#ifndef CHUNKBUFFERCACHE_H_
+#define CHUNKBUFFERCACHE_H_
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <QtOpenGL>
+
+#include "MazeChunk.h"
+#include "MazeImpostor.h"
+
+class ChunkBufferCache
+{
+	public:
+		ChunkBufferCache();
+
+		/* the context the buffers were created in must be current when this is destroyed
+		 */
+		~ChunkBufferCache();
+
+		/* remembers that the chunk is still part of the maze, whether it's drawn or not
+		 */
+		void keepChunk( const MazeChunk & chunk );
+
+		/* draws the chunk out of its buffer on the graphics card, uploading the
+		 * chunk's vertices first if they've changed since they were last uploaded
+		 */
+		void drawChunk( const MazeChunk & chunk );
+
+		/* chunks are only drawn in less detail once this has been called,
+		 * the outlines are drawn in the given color ( which should look
+		 * like the walls' texture from far away )
+		 */
+		void useLevelsOfDetail( GLfloat red, GLfloat green, GLfloat blue );
+		bool isUsingLevelsOfDetail() const { return usingLevelsOfDetail; }
+
+		/* draws only the shape of the chunk, untextured, out of its buffer on the graphics card
+		 */
+		void drawChunkOutline( const MazeChunk & chunk );
+
+		/* remembers to draw the chunk's part of the picture of the maze
+		 * the next time drawImpostor is called
+		 */
+		void addChunkToImpostor( const MazeChunk & chunk );
+
+		/* draws the parts of the picture of the maze that were added since the last call,
+		 * uploading the picture first if it's changed since it was last uploaded
+		 */
+		void drawImpostor( const MazeImpostor & impostor );
+
+		/* frees the buffers of chunks that weren't kept or drawn since the last time this was called
+		 */
+		void releaseBuffersOfMissingChunks();
+
+		/* frees all the buffers, and the picture of the maze
+		 */
+		void releaseAllBuffers();
+
+	private:
+		class CachedBuffer
+		{
+			public:
+				CachedBuffer() :
+					buffer( NULL ),
+					uploadedContentHash( 0 ),
+					uploadedNumberOfQuads( 0 ),
+					uploaded( false ),
+					stillInMaze( true ) {}
+
+				QGLBuffer * buffer;
+				unsigned int uploadedContentHash;
+				int uploadedNumberOfQuads;
+				bool uploaded;
+				bool stillInMaze;
+		};
+
+		typedef std::pair<int, int> ChunkKey;	// column, row
+		typedef std::map<ChunkKey, CachedBuffer> CachedBuffers;
+
+		CachedBuffers cachedBuffers;
+
+		// false once creating a buffer has failed, after that chunks are drawn straight out of memory
+		bool buffersSupported;
+
+		bool usingLevelsOfDetail;
+		GLfloat outlineColor[ 3 ];
+
+		// the picture of the maze, and the chunks to draw it over
+		GLuint impostorTexture;
+		unsigned int uploadedImpostorHash;
+		std::vector<double> impostorAreas;	// the lowest x, highest x, lowest y, highest y of each chunk
+
+		/* binds the chunk's buffer, uploading the chunk's vertices first if they've changed
+		 * since they were last uploaded, returns false if buffers can't be used
+		 */
+		bool bindBufferOf( const MazeChunk & chunk );
+
+		// disable copying, a buffer can only be freed once
+		ChunkBufferCache( const ChunkBufferCache & );
+		const ChunkBufferCache & operator=( const ChunkBufferCache & );
+};
+
+#endif /*CHUNKBUFFERCACHE_H_*/
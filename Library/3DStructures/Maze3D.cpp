@@ -9,19 +9,81 @@
 
 #include "Maze3D.h"
 
+#include <algorithm>
+
+#include "ChunkBufferCache.h"
+#include "ViewFrustum.h"
+#include "Maze3DTextReader.h"
+
 using namespace std;
 
+const double Maze3D::chunk_size = 64.0;
+
+const double Maze3D::full_detail_screen_size = 64.0;
+const double Maze3D::outline_detail_screen_size = 12.0;
+
 Maze3D::Maze3D() : 
 	walls(), 
-	floor() {}
+	wallMesh(),
+	floor(),
+	impostor(),
+	chunks() {}
 
 Maze3D::Maze3D( TexturedQuad & m_floor ) : 
 	walls(), 
-	floor( m_floor ) {}
+	wallMesh(),
+	floor( m_floor ),
+	impostor(),
+	chunks() {}
 
 void Maze3D::addAWall( const Wall & wallToAdd )
 {
-	walls.push_back( wallToAdd );;
+	walls.push_back( wallToAdd );
+	addWallToChunks( walls.size() - 1 );
+}
+
+
+/* adds a wall the wall mesh doesn't take in yet, so its own quads are drawn alongside the mesh
+ * until a mesh that takes it in is set ( only the chunk holding the wall's quads changes )
+ */
+void Maze3D::addAWallNotInMesh( const Wall & wallToAdd )
+{
+	addAWall( wallToAdd );
+	if( !wallMesh.isEmpty() )
+	{
+		addWallQuadsToChunks( wallToAdd );
+	}
+}
+
+
+/* makes the wall at the given index part of the chunks its base overlaps
+ */
+void Maze3D::addWallToChunks( int wallIndex )
+{
+	const Wall & wallToAdd = walls[ wallIndex ];
+
+	// the wall needs to be checked for collisions in every chunk its base overlaps
+	const TexturedQuad & top = wallToAdd.getTop();
+	double minX = min( min( top.getP1().getX(), top.getP2().getX() ), min( top.getP3().getX(), top.getP4().getX() ) );
+	double maxX = max( max( top.getP1().getX(), top.getP2().getX() ), max( top.getP3().getX(), top.getP4().getX() ) );
+	double minY = min( min( top.getP1().getY(), top.getP2().getY() ), min( top.getP3().getY(), top.getP4().getY() ) );
+	double maxY = max( max( top.getP1().getY(), top.getP2().getY() ), max( top.getP3().getY(), top.getP4().getY() ) );
+
+	ChunkKey first = chunkKeyFor( minX, minY );
+	ChunkKey last = chunkKeyFor( maxX, maxY );
+	for( int column = first.first; column <= last.first; column++ )
+	{
+		for( int row = first.second; row <= last.second; row++ )
+		{
+			chunkAt( ( column + 0.5 ) * chunk_size, ( row + 0.5 ) * chunk_size ).addCollisionWall( wallIndex, wallToAdd );
+		}
+	}
+
+	// the wall's own quads are only drawn when there's no mesh drawn in its place
+	if( wallMesh.isEmpty() )
+	{
+		addWallQuadsToChunks( wallToAdd );
+	}
 }
 
 const Wall & Maze3D::getAWall( int index ) const
@@ -34,10 +96,39 @@ int Maze3D::numberOfWalls() const
 	return walls.size();
 }
 
+void Maze3D::clearWalls()
+{
+	walls.clear();
+	wallMesh.clear();
+	impostor.clear();
+	chunks.clear();
+}
+
+void Maze3D::setWallMesh( const WallMesh & m_wallMesh )
+{
+	wallMesh = m_wallMesh;
+	rebuildChunkGeometry();
+}
+
+
+/* trades everything with the other maze, without copying any walls or chunks,
+ * so a maze built somewhere else can be put in place of this one in an instant
+ */
+void Maze3D::swap( Maze3D & other )
+{
+	walls.swap( other.walls );
+	wallMesh.swap( other.wallMesh );
+	std::swap( floor, other.floor );
+	impostor.swap( other.impostor );
+	chunks.swap( other.chunks );
+}
+
 
-/* Draws the maze using openGL calls
+/* Draws the maze using openGL calls, skipping chunks that are out of view
+ * when given a cache the chunks are drawn from buffers on the graphics card,
+ * and in less detail when they're small on screen if the cache allows it
  */
-void Maze3D::Draw( int floorTextureNumber, int wallTextureNumber ) const
+void Maze3D::Draw( int floorTextureNumber, int wallTextureNumber, ChunkBufferCache * bufferCache /* = NULL */ ) const
 {
 	glEnable( GL_TEXTURE_2D );
     
@@ -45,11 +136,50 @@ void Maze3D::Draw( int floorTextureNumber, int wallTextureNumber ) const
 	glBindTexture( GL_TEXTURE_2D, floorTextureNumber );
 	getFloor().Draw();
     
-	//now do the walls
+	//now do the walls, one chunk at a time
 	glBindTexture( GL_TEXTURE_2D, wallTextureNumber );
-	for( int i = 0; i < numberOfWalls(); i++ )
+	ViewFrustum frustum;
+	for( Chunks::const_iterator it = chunks.begin(); it != chunks.end(); ++it )
 	{
-		getAWall( i ).Draw();
+		const MazeChunk & chunk = it->second;
+		if( !chunk.mightBeSeenBy( frustum ) )
+		{
+			if( bufferCache != NULL )
+			{
+				bufferCache->keepChunk( chunk );
+			}
+		}
+		else if( bufferCache == NULL )
+		{
+			chunk.Draw();
+		}
+		else if( !bufferCache->isUsingLevelsOfDetail() )
+		{
+			bufferCache->drawChunk( chunk );
+		}
+		else
+		{
+			double screenSize = chunk.screenSizeIn( frustum );
+			if( screenSize >= full_detail_screen_size )
+			{
+				bufferCache->drawChunk( chunk );
+			}
+			else if( ( screenSize >= outline_detail_screen_size ) || impostor.isEmpty() )
+			{
+				bufferCache->drawChunkOutline( chunk );
+			}
+			else
+			{
+				bufferCache->addChunkToImpostor( chunk );
+			}
+		}
+	}
+
+	if( bufferCache != NULL )
+	{
+		// the picture is see-through between the walls, so it goes on top of everything else
+		bufferCache->drawImpostor( impostor );
+		bufferCache->releaseBuffersOfMissingChunks();
 	}
     
     glDisable( GL_TEXTURE_2D );
@@ -63,12 +193,18 @@ void Maze3D::Draw( int floorTextureNumber, int wallTextureNumber ) const
  */
 const Wall & Maze3D::detectCollision( const Point2D & point ) const throw( Wall::NoCollisionDetected & )
 {
-	for( int i = 0; i < numberOfWalls(); i++ )
+	// only the walls that overlap the part of the chunk holding this point need to be checked
+	Chunks::const_iterator chunk = chunks.find( chunkKeyFor( point.getX(), point.getY() ) );
+	if( chunk != chunks.end() )
 	{
-		const Wall & wall = getAWall( i );
-		if( wall.isInsideMe( point ) )
+		const vector<int> & candidates = chunk->second.getCollisionCandidates( point );
+		for( unsigned int i = 0; i < candidates.size(); i++ )
 		{
-			return wall;
+			const Wall & wall = getAWall( candidates[ i ] );
+			if( wall.isInsideMe( point ) )
+			{
+				return wall;
+			}
 		}
 	}
 	
@@ -107,6 +243,26 @@ void Maze3D::readIn( istream & in /* = cin */ ) throw( IOError & )
 	}
 }
 
+
+/* replaces everything in the maze with what's in the text, which is read on
+ * every core at once, unlike readIn this throws an IOError if the number of
+ * vertices and quads don't agree with each other or with the text
+ */
+void Maze3D::readInText( const char * data, size_t size, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	TexturedQuad newFloor;
+	vector<Wall> newWalls;
+	Maze3DTextReader( data, size ).read( newFloor, newWalls, progress );
+
+	clearWalls();
+	floor = newFloor;
+	walls.swap( newWalls );
+	for( int i = 0; i < numberOfWalls(); i++ )
+	{
+		addWallToChunks( i );
+	}
+}
+
 void Maze3D::writeOut( ostream & out /* = cout */ ) const throw( IOError & )
 {
 	int numberOfVertices = ( numberOfWalls() * Wall::getNumberOfQuadsPerWall() + 1 ) * Quad::getNumberOfVerticesPerQuad();
@@ -135,3 +291,74 @@ void Maze3D::writeOut( ostream & out /* = cout */ ) const throw( IOError & )
 		out << '\n';
 	}
 }
+
+
+/* returns the chunk covering the given point, creating it if it doesn't exist yet
+ */
+MazeChunk & Maze3D::chunkAt( double x, double y )
+{
+	ChunkKey key = chunkKeyFor( x, y );
+	Chunks::iterator chunk = chunks.find( key );
+	if( chunk == chunks.end() )
+	{
+		chunk = chunks.insert( make_pair( key, MazeChunk( key.first, key.second, chunk_size ) ) ).first;
+	}
+	return chunk->second;
+}
+
+
+/* places the quads of the wall mesh, or of the walls if there is no mesh,
+ * in the chunks that hold their centers
+ */
+void Maze3D::rebuildChunkGeometry()
+{
+	for( Chunks::iterator it = chunks.begin(); it != chunks.end(); ++it )
+	{
+		it->second.clearQuads();
+	}
+
+	if( wallMesh.isEmpty() )
+	{
+		for( int i = 0; i < numberOfWalls(); i++ )
+		{
+			addWallQuadsToChunks( getAWall( i ) );
+		}
+	}
+	else
+	{
+		for( int i = 0; i < wallMesh.numberOfSides(); i++ )
+		{
+			addQuadToItsChunk( wallMesh.getASide( i ) );
+		}
+		for( int i = 0; i < wallMesh.numberOfTops(); i++ )
+		{
+			addQuadToItsChunk( wallMesh.getATop( i ) );
+		}
+	}
+}
+
+void Maze3D::addQuadToItsChunk( const TexturedQuad & quad )
+{
+	double centerX = ( quad.getP1().getX() + quad.getP2().getX() + quad.getP3().getX() + quad.getP4().getX() ) / 4.0;
+	double centerY = ( quad.getP1().getY() + quad.getP2().getY() + quad.getP3().getY() + quad.getP4().getY() ) / 4.0;
+	chunkAt( centerX, centerY ).addAQuad( quad );
+}
+
+void Maze3D::addWallQuadsToChunks( const Wall & wall )
+{
+	// keep all of a wall's quads together, in the chunk holding the center of its top
+	const TexturedQuad & top = wall.getTop();
+	double centerX = ( top.getP1().getX() + top.getP2().getX() + top.getP3().getX() + top.getP4().getX() ) / 4.0;
+	double centerY = ( top.getP1().getY() + top.getP2().getY() + top.getP3().getY() + top.getP4().getY() ) / 4.0;
+	MazeChunk & chunk = chunkAt( centerX, centerY );
+	chunk.addAQuad( wall.getFrontEnd() );
+	chunk.addAQuad( wall.getRightSide() );
+	chunk.addAQuad( wall.getLeftSide() );
+	chunk.addAQuad( wall.getBackEnd() );
+	chunk.addAQuad( wall.getTop() );
+}
+
+Maze3D::ChunkKey Maze3D::chunkKeyFor( double x, double y )
+{
+	return ChunkKey( ( int ) ::floor( x / chunk_size ), ( int ) ::floor( y / chunk_size ) );
+}
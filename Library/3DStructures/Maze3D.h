@@ -11,13 +11,20 @@
 #define MAZE3D_H_
 
 #include <vector>
+#include <map>
+#include <utility>
 
 #include "Wall.h"
+#include "WallMesh.h"
+#include "MazeChunk.h"
+#include "MazeImpostor.h"
 #include "TexturedQuad.h"
 #include "Point2D.h"
 #include "Serializable.h"
 #include "IOError.h"
 
+class ChunkBufferCache;
+
 class Maze3D : public Serializable
 {
 	public:
@@ -25,15 +32,44 @@ class Maze3D : public Serializable
 		Maze3D( TexturedQuad & m_floor );
 		
 		void addAWall( const Wall & wall );
+
+		/* adds a wall the wall mesh doesn't take in yet, so its own quads are drawn alongside the mesh
+		 * until a mesh that takes it in is set ( only the chunk holding the wall's quads changes )
+		 */
+		void addAWallNotInMesh( const Wall & wall );
 		const Wall & getAWall( int index ) const;
 		int numberOfWalls() const;
 		const TexturedQuad & getFloor() const	{ return floor; }
 		void setFloor( const TexturedQuad & m_floor ) {	floor = m_floor; }
-		void clearWalls() { walls.clear(); }
+		void clearWalls();
+
+		/* the mesh drawn in place of the individual walls, when there is one
+		 * ( the individual walls are still used for collisions and saving )
+		 */
+		const WallMesh & getWallMesh() const { return wallMesh; }
+		void setWallMesh( const WallMesh & m_wallMesh );
+
+		/* a picture of the tops of the walls, drawn in place of chunks that
+		 * are tiny on screen when the cache drawing the maze allows it
+		 */
+		const MazeImpostor & getImpostor() const { return impostor; }
+		void setImpostor( const MazeImpostor & m_impostor ) { impostor = m_impostor; }
+
+		/* trades everything with the other maze, without copying any walls or chunks,
+		 * so a maze built somewhere else can be put in place of this one in an instant
+		 */
+		void swap( Maze3D & other );
 
-		/* Draws the maze using openGL calls
+		/* the maze is split up into square chunks, only the chunks that
+		 * something has been placed in exist
 		 */
-		void Draw( int floorTextureNumber, int wallTextureNumber ) const;
+		int numberOfChunks() const { return chunks.size(); }
+
+		/* Draws the maze using openGL calls, skipping chunks that are out of view
+		 * when given a cache the chunks are drawn from buffers on the graphics card,
+		 * and in less detail when they're small on screen if the cache allows it
+		 */
+		void Draw( int floorTextureNumber, int wallTextureNumber, ChunkBufferCache * bufferCache = NULL ) const;
 		
 		/* takes in a two dimensional point and returns the first Wall
 		 * in this maze that this point is "inside"  (defined by the Wall class)
@@ -45,10 +81,46 @@ class Maze3D : public Serializable
 		void readIn( std::istream & in = std::cin ) throw( IOError & );
 		void writeOut( std::ostream & out = std::cout ) const throw( IOError & );
 		std::string type() const { return "3D Maze";}
+
+		/* replaces everything in the maze with what's in the text, which is read on
+		 * every core at once, unlike readIn this throws an IOError if the number of
+		 * vertices and quads don't agree with each other or with the text
+		 */
+		void readInText( const char * data, std::size_t size, ProgressMonitor * progress = NULL ) throw( IOError & );
 		
+		static const double chunk_size;
+
+		// how many pixels across a chunk must appear to be drawn textured, or as an outline
+		static const double full_detail_screen_size;
+		static const double outline_detail_screen_size;
+
 	private:
+		typedef std::pair<int, int> ChunkKey;	// column, row
+		typedef std::map<ChunkKey, MazeChunk> Chunks;
+
 		std::vector<Wall> walls;
+		WallMesh wallMesh;
 		TexturedQuad floor;
+		MazeImpostor impostor;
+		Chunks chunks;
+
+		/* returns the chunk covering the given point, creating it if it doesn't exist yet
+		 */
+		MazeChunk & chunkAt( double x, double y );
+
+		/* places the quads of the wall mesh, or of the walls if there is no mesh,
+		 * in the chunks that hold their centers
+		 */
+		void rebuildChunkGeometry();
+
+		/* makes the wall at the given index part of the chunks its base overlaps
+		 */
+		void addWallToChunks( int wallIndex );
+
+		void addQuadToItsChunk( const TexturedQuad & quad );
+		void addWallQuadsToChunks( const Wall & wall );
+
+		static ChunkKey chunkKeyFor( double x, double y );
 };
 
 /*
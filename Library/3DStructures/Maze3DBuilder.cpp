@@ -0,0 +1,104 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DBuilder.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Builds the walls, wall mesh, impostor and floor of a 3D maze
+   				 out of a 2D maze. Building touches nothing but the mazes it's
+   				 given, so it can be done on any thread
+*/
+
+
+#include "Maze3DBuilder.h"
+
+#include "WallFootprintUnion.h"
+#include "WallMesh.h"
+#include "MazeImpostor.h"
+#include "Wall.h"
+
+using namespace std;
+
+/* the texture sizes are in world units
+ */
+Maze3DBuilder::Maze3DBuilder( int m_wallWidth, int m_wallHeight, int m_wallsTextureWidth, int m_wallsTextureHeight,
+							  int m_floorTextureWidth, int m_floorTextureHeight ) :
+	wallWidth( m_wallWidth ),
+	wallHeight( m_wallHeight ),
+	wallsTextureWidth( m_wallsTextureWidth ),
+	wallsTextureHeight( m_wallsTextureHeight ),
+	floorTextureWidth( m_floorTextureWidth ),
+	floorTextureHeight( m_floorTextureHeight ) {}
+
+
+/* replaces everything in maze3D with walls standing on the lines of maze2D and a floor under all of it,
+ * throws an OperationCanceled if the progress monitor asks for building to stop,
+ * which leaves maze3D half built
+ */
+void Maze3DBuilder::build( const Maze2D & maze2D, Maze3D & maze3D, ProgressMonitor * progress /* = NULL */ ) const throw( IOError & )
+{
+	maze3D.clearWalls();
+
+	//merge the footprints of all the walls into one mesh, so where walls meet nothing is drawn twice
+	//( the mesh is set first so the walls added after it are only used for collisions, not drawn )
+	ProgressMonitor::checkIn( progress, 0.0 );
+	WallFootprintUnion footprints( maze2D, wallWidth );
+	ProgressMonitor::checkIn( progress, 0.4 );
+	WallMesh wallMesh;
+	wallMesh.fitToOutlines( footprints, wallHeight, wallsTextureWidth, wallsTextureHeight );
+	maze3D.setWallMesh( wallMesh );
+
+	//and take a picture of the tops of the walls to show when the maze is tiny on screen
+	ProgressMonitor::checkIn( progress, 0.6 );
+	MazeImpostor impostor;
+	impostor.fitToOutlines( footprints, wallHeight );
+	maze3D.setImpostor( impostor );
+
+	//iterate through the lines in the 2D maze and create 3D walls out of them
+	//and add these walls to the 3D maze;
+	ProgressMonitor::checkIn( progress, 0.7 );
+	ProgressRange addingWalls( progress, 0.7, 1.0 );
+	Wall wall;
+	for( int i = 0; i < maze2D.numberOfLines(); i++ )
+	{
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( &addingWalls, ( double ) i / maze2D.numberOfLines() );
+		}
+		wall.fitToLine( maze2D.getALine( i ), wallWidth, wallHeight, wallsTextureWidth, wallsTextureHeight );
+		maze3D.addAWall( wall );
+	}
+
+	//add the floor
+	Point3D bottomLeft( -( maze2D.getWidth() / 2.0 ), -( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
+	Point3D topLeft( -( maze2D.getWidth() / 2.0 ), ( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
+	Point3D topRight( ( maze2D.getWidth() / 2.0 ), ( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
+	Point3D bottomRight( ( maze2D.getWidth() / 2.0 ), -( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
+
+	Quad floor( bottomLeft, topLeft, topRight, bottomRight );
+	TexturedQuad tFloor( floor, floorTextureWidth, floorTextureHeight );
+
+	maze3D.setFloor( tFloor );
+	ProgressMonitor::checkIn( progress, 1.0 );
+}
+
+
+/* adds the wall standing on a line just added to the 2D maze that maze3D was built out of,
+ * without building anything else again, the wall mesh and impostor only take the wall in
+ * the next time the maze is built
+ */
+void Maze3DBuilder::addALine( const LineSegment2D & line, Maze3D & maze3D ) const
+{
+	Wall wall;
+	wall.fitToLine( line, wallWidth, wallHeight, wallsTextureWidth, wallsTextureHeight );
+	maze3D.addAWallNotInMesh( wall );
+}
+
+
+/* true if both builders build the same 3D maze out of the same 2D maze
+ */
+bool Maze3DBuilder::operator==( const Maze3DBuilder & other ) const
+{
+	return ( wallWidth == other.wallWidth ) && ( wallHeight == other.wallHeight ) &&
+		   ( wallsTextureWidth == other.wallsTextureWidth ) && ( wallsTextureHeight == other.wallsTextureHeight ) &&
+		   ( floorTextureWidth == other.floorTextureWidth ) && ( floorTextureHeight == other.floorTextureHeight );
+}
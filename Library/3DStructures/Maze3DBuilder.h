@@ -0,0 +1,51 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DBuilder.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Builds the walls, wall mesh, impostor and floor of a 3D maze
+   				 out of a 2D maze. Building touches nothing but the mazes it's
+   				 given, so it can be done on any thread
+*/
+
+
+#ifndef MAZE3DBUILDER_H_
+#define MAZE3DBUILDER_H_
+
+#include "Maze2D.h"
+#include "Maze3D.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+class Maze3DBuilder
+{
+	public:
+		/* the texture sizes are in world units
+		 */
+		Maze3DBuilder( int m_wallWidth, int m_wallHeight, int m_wallsTextureWidth, int m_wallsTextureHeight,
+					   int m_floorTextureWidth, int m_floorTextureHeight );
+
+		/* replaces everything in maze3D with walls standing on the lines of maze2D and a floor under all of it,
+		 * throws an OperationCanceled if the progress monitor asks for building to stop,
+		 * which leaves maze3D half built
+		 */
+		void build( const Maze2D & maze2D, Maze3D & maze3D, ProgressMonitor * progress = NULL ) const throw( IOError & );
+
+		/* adds the wall standing on a line just added to the 2D maze that maze3D was built out of,
+		 * without building anything else again, the wall mesh and impostor only take the wall in
+		 * the next time the maze is built
+		 */
+		void addALine( const LineSegment2D & line, Maze3D & maze3D ) const;
+
+		/* true if both builders build the same 3D maze out of the same 2D maze
+		 */
+		bool operator==( const Maze3DBuilder & other ) const;
+		bool operator!=( const Maze3DBuilder & other ) const { return !( *this == other ); }
+
+	private:
+		int wallWidth, wallHeight;
+		int wallsTextureWidth, wallsTextureHeight;
+		int floorTextureWidth, floorTextureHeight;
+};
+
+#endif /*MAZE3DBUILDER_H_*/
@@ -0,0 +1,302 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DExporter.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Writes the geometry of a 3D maze out as a Wavefront OBJ file,
+   				 with every distinct position and texture coordinate written
+   				 only once and each quad written as the indices of its four
+   				 corners' positions and texture coordinates
+*/
+
+
+#include "Maze3DExporter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string.h>
+
+#include "ConversionFunctions.h"
+
+using namespace std;
+
+namespace
+{
+	// starting value and multiplier used to hash positions and texture coordinates
+	const unsigned int hash_seed = 2166136261u;
+	const unsigned int hash_multiplier = 0x5bd1e995u;
+
+	// longest number written by writeInteger
+	const int max_integer_length = 12;
+}
+
+Maze3DExporter::Maze3DExporter( int m_bufferSize /* = default_buffer_size */ ) :
+	positions(),
+	textureCoordinates(),
+	cornerIndices(),
+	buffer( max( m_bufferSize, max_formatted_decimal_length ) ),
+	bufferUsed( 0 ) {}
+
+
+/* writes the floor and walls of the maze ( the wall mesh, when the maze has one )
+ * as a Wavefront OBJ file, for other programs to open ( the maze can't be read back in from it ):
+ * a "v" line for each position, a "vt" line for each texture coordinate,
+ * then an "f" line for each quad giving its corners as position/texture coordinate pairs,
+ * positions and texture coordinates are welded separately, so corners shared by walls
+ * with different texture coordinates still share one position
+ */
+void Maze3DExporter::exportMaze( const Maze3D & maze, ostream & out ) throw( IOError & )
+{
+	const WallMesh & mesh = maze.getWallMesh();
+	int numberOfQuads = 1 + ( mesh.isEmpty() ? ( maze.numberOfWalls() * Wall::getNumberOfQuadsPerWall() ) : ( mesh.numberOfSides() + mesh.numberOfTops() ) );
+	clear( numberOfQuads );
+
+	//weld everything together first, the faces can only be written once every index is known
+	addAQuad( maze.getFloor() );
+	if( mesh.isEmpty() )
+	{
+		for( int i = 0; i < maze.numberOfWalls(); i++ )
+		{
+			const Wall & wall = maze.getAWall( i );
+			addAQuad( wall.getFrontEnd() );
+			addAQuad( wall.getRightSide() );
+			addAQuad( wall.getLeftSide() );
+			addAQuad( wall.getBackEnd() );
+			addAQuad( wall.getTop() );
+		}
+	}
+	else
+	{
+		for( int i = 0; i < mesh.numberOfSides(); i++ )
+		{
+			addAQuad( mesh.getASide( i ) );
+		}
+		for( int i = 0; i < mesh.numberOfTops(); i++ )
+		{
+			addAQuad( mesh.getATop( i ) );
+		}
+	}
+
+	const char comment[] = "# 3DMaze\n";
+	write( comment, sizeof( comment ) - 1, out );
+
+	for( unsigned int i = 0; i < positions.values.size(); i += values_per_position )
+	{
+		write( "v", 1, out );
+		for( int j = 0; j < values_per_position; j++ )
+		{
+			write( " ", 1, out );
+			writeDecimal( positions.values[ i + j ], out );
+		}
+		write( "\n", 1, out );
+	}
+
+	for( unsigned int i = 0; i < textureCoordinates.values.size(); i += values_per_texture_coordinate )
+	{
+		write( "vt", 2, out );
+		for( int j = 0; j < values_per_texture_coordinate; j++ )
+		{
+			write( " ", 1, out );
+			writeDecimal( textureCoordinates.values[ i + j ], out );
+		}
+		write( "\n", 1, out );
+	}
+
+	//indices in an OBJ file count from 1
+	for( unsigned int i = 0; i < cornerIndices.size(); i += 4 * 2 )
+	{
+		write( "f", 1, out );
+		for( int j = 0; j < 4 * 2; j += 2 )
+		{
+			write( " ", 1, out );
+			writeInteger( cornerIndices[ i + j ] + 1, out );
+			write( "/", 1, out );
+			writeInteger( cornerIndices[ i + j + 1 ] + 1, out );
+		}
+		write( "\n", 1, out );
+	}
+
+	flush( out );
+}
+
+void Maze3DExporter::exportMaze( const Maze3D & maze, const string & fileName ) throw( IOError & )
+{
+	ofstream outFile( fileName.c_str(), ios::out | ios::binary );
+	if( !outFile )
+	{
+		throw IOError();
+	}
+
+	exportMaze( maze, outFile );
+}
+
+
+/* empties everything out, making room for the given number of quads
+ */
+void Maze3DExporter::clear( int numberOfQuads )
+{
+	positions.values.clear();
+	textureCoordinates.values.clear();
+	cornerIndices.clear();
+	positions.values.reserve( numberOfQuads * 4 * values_per_position );
+	textureCoordinates.values.reserve( numberOfQuads * 4 * values_per_texture_coordinate );
+	cornerIndices.reserve( numberOfQuads * 4 * 2 );
+
+	//make sure the slots never have to grow, even if nothing gets welded
+	unsigned int numberOfSlots = initial_number_of_hash_slots;
+	while( numberOfSlots < ( unsigned int ) ( numberOfQuads * 4 * 2 ) )
+	{
+		numberOfSlots *= 2;
+	}
+	positions.hashSlots.assign( numberOfSlots, -1 );
+	textureCoordinates.hashSlots.assign( numberOfSlots, -1 );
+
+	bufferUsed = 0;
+}
+
+void Maze3DExporter::addAQuad( const TexturedQuad & quad )
+{
+	addACorner( quad.getP1(), quad.getP1Texture() );
+	addACorner( quad.getP2(), quad.getP2Texture() );
+	addACorner( quad.getP3(), quad.getP3Texture() );
+	addACorner( quad.getP4(), quad.getP4Texture() );
+}
+
+void Maze3DExporter::addACorner( const Point3D & position, const Point2D & textureCoordinate )
+{
+	double positionValues[ values_per_position ] = { position.getX(), position.getY(), position.getZ() };
+	double textureValues[ values_per_texture_coordinate ] = { textureCoordinate.getX(), textureCoordinate.getY() };
+	cornerIndices.push_back( indexOf( positionValues, values_per_position, positions ) );
+	cornerIndices.push_back( indexOf( textureValues, values_per_texture_coordinate, textureCoordinates ) );
+}
+
+
+/* returns the index of these values, adding them if they're new
+ */
+int Maze3DExporter::indexOf( double * newValues, int valuesEach, WeldedValues & welded )
+{
+	//zero and negative zero should weld together, but their bytes differ
+	for( int i = 0; i < valuesEach; i++ )
+	{
+		if( newValues[ i ] == 0.0 )
+		{
+			newValues[ i ] = 0.0;
+		}
+	}
+
+	unsigned int mask = welded.hashSlots.size() - 1;
+	unsigned int slot = hashOf( newValues, valuesEach ) & mask;
+	while( welded.hashSlots[ slot ] != -1 )
+	{
+		const double * existing = &welded.values[ welded.hashSlots[ slot ] * valuesEach ];
+		if( memcmp( existing, newValues, valuesEach * sizeof( double ) ) == 0 )
+		{
+			return welded.hashSlots[ slot ];
+		}
+		slot = ( slot + 1 ) & mask;
+	}
+
+	int index = welded.values.size() / valuesEach;
+	welded.values.insert( welded.values.end(), newValues, newValues + valuesEach );
+	welded.hashSlots[ slot ] = index;
+
+	//keep at least half the slots empty, so searches stay short
+	if( ( 2 * ( index + 1 ) ) > ( int ) welded.hashSlots.size() )
+	{
+		growHashSlots( valuesEach, welded );
+	}
+
+	return index;
+}
+
+
+/* doubles the number of hash slots, putting every entry back in
+ */
+void Maze3DExporter::growHashSlots( int valuesEach, WeldedValues & welded )
+{
+	welded.hashSlots.assign( welded.hashSlots.size() * 2, -1 );
+	unsigned int mask = welded.hashSlots.size() - 1;
+	int numberOfEntries = welded.values.size() / valuesEach;
+	for( int index = 0; index < numberOfEntries; index++ )
+	{
+		unsigned int slot = hashOf( &welded.values[ index * valuesEach ], valuesEach ) & mask;
+		while( welded.hashSlots[ slot ] != -1 )
+		{
+			slot = ( slot + 1 ) & mask;
+		}
+		welded.hashSlots[ slot ] = index;
+	}
+}
+
+unsigned int Maze3DExporter::hashOf( const double * values, int valuesEach )
+{
+	// mix in the values a word at a time
+	const int max_number_of_words = ( values_per_position * sizeof( double ) ) / sizeof( unsigned int );
+	int numberOfWords = ( valuesEach * sizeof( double ) ) / sizeof( unsigned int );
+	unsigned int words[ max_number_of_words ];
+	memcpy( words, values, numberOfWords * sizeof( unsigned int ) );
+
+	unsigned int hash = hash_seed;
+	for( int i = 0; i < numberOfWords; i++ )
+	{
+		unsigned int word = words[ i ] * hash_multiplier;
+		word ^= word >> 24;
+		hash = ( hash * hash_multiplier ) ^ ( word * hash_multiplier );
+	}
+	hash ^= hash >> 13;
+	hash *= hash_multiplier;
+	hash ^= hash >> 15;
+	return hash;
+}
+
+
+void Maze3DExporter::write( const char * text, int length, ostream & out ) throw( IOError & )
+{
+	if( ( bufferUsed + length ) > ( int ) buffer.size() )
+	{
+		flush( out );
+	}
+	memcpy( &buffer[ bufferUsed ], text, length );
+	bufferUsed += length;
+}
+
+void Maze3DExporter::writeInteger( int value, ostream & out ) throw( IOError & )
+{
+	//the digits come out backwards, so fill in the scratch space from its end
+	char digits[ max_integer_length ];
+	int start = max_integer_length;
+	unsigned int remaining = ( value < 0 ) ? -( unsigned int ) value : value;
+	do
+	{
+		digits[ --start ] = '0' + ( remaining % 10 );
+		remaining /= 10;
+	} while( remaining != 0 );
+	if( value < 0 )
+	{
+		digits[ --start ] = '-';
+	}
+	write( digits + start, max_integer_length - start, out );
+}
+
+void Maze3DExporter::writeDecimal( double value, ostream & out ) throw( IOError & )
+{
+	if( ( bufferUsed + max_formatted_decimal_length ) > ( int ) buffer.size() )
+	{
+		flush( out );
+	}
+	bufferUsed += formatDecimal( value, &buffer[ bufferUsed ] );
+}
+
+void Maze3DExporter::flush( ostream & out ) throw( IOError & )
+{
+	if( bufferUsed > 0 )
+	{
+		out.write( &buffer[ 0 ], bufferUsed );
+		bufferUsed = 0;
+	}
+
+	if( !out )
+	{
+		throw IOError();
+	}
+}
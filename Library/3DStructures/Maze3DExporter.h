@@ -0,0 +1,96 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DExporter.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Writes the geometry of a 3D maze out as a Wavefront OBJ file,
+   				 with every distinct position and texture coordinate written
+   				 only once and each quad written as the indices of its four
+   				 corners' positions and texture coordinates
+*/
+
+
+#ifndef MAZE3DEXPORTER_H_
+#define MAZE3DEXPORTER_H_
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "Maze3D.h"
+#include "TexturedQuad.h"
+#include "IOError.h"
+
+class Maze3DExporter
+{
+	public:
+		Maze3DExporter( int m_bufferSize = default_buffer_size );
+
+		/* writes the floor and walls of the maze ( the wall mesh, when the maze has one )
+		 * as a Wavefront OBJ file, for other programs to open ( the maze can't be read back in from it ):
+		 * a "v" line for each position, a "vt" line for each texture coordinate,
+		 * then an "f" line for each quad giving its corners as position/texture coordinate pairs,
+		 * positions and texture coordinates are welded separately, so corners shared by walls
+		 * with different texture coordinates still share one position
+		 */
+		void exportMaze( const Maze3D & maze, std::ostream & out ) throw( IOError & );
+		void exportMaze( const Maze3D & maze, const std::string & fileName ) throw( IOError & );
+
+		/* the size of what was written the last time a maze was exported
+		 */
+		int numberOfPositionsWritten() const { return positions.values.size() / values_per_position; }
+		int numberOfTextureCoordinatesWritten() const { return textureCoordinates.values.size() / values_per_texture_coordinate; }
+		int numberOfQuadsWritten() const { return cornerIndices.size() / ( 4 * 2 ); }
+
+		static const int default_buffer_size = 1 << 20;
+
+	private:
+		static const int values_per_position = 3;
+		static const int values_per_texture_coordinate = 2;
+
+		/* distinct values, each a fixed number of doubles long,
+		 * found again through an open addressed hash table of their indices
+		 */
+		class WeldedValues
+		{
+			public:
+				std::vector<double> values;
+				std::vector<int> hashSlots;	// -1 where empty
+		};
+
+		WeldedValues positions;
+		WeldedValues textureCoordinates;
+
+		// the position index then the texture coordinate index of each corner of each quad
+		std::vector<int> cornerIndices;
+
+		// text waiting to be written
+		std::vector<char> buffer;
+		int bufferUsed;
+
+		static const int initial_number_of_hash_slots = 1 << 12;
+
+		/* empties everything out, making room for the given number of quads
+		 */
+		void clear( int numberOfQuads );
+
+		void addAQuad( const TexturedQuad & quad );
+		void addACorner( const Point3D & position, const Point2D & textureCoordinate );
+
+		/* returns the index of these values, adding them if they're new
+		 */
+		static int indexOf( double * newValues, int valuesEach, WeldedValues & welded );
+
+		/* doubles the number of hash slots, putting every entry back in
+		 */
+		static void growHashSlots( int valuesEach, WeldedValues & welded );
+
+		static unsigned int hashOf( const double * values, int valuesEach );
+
+		void write( const char * text, int length, std::ostream & out ) throw( IOError & );
+		void writeInteger( int value, std::ostream & out ) throw( IOError & );
+		void writeDecimal( double value, std::ostream & out ) throw( IOError & );
+		void flush( std::ostream & out ) throw( IOError & );
+};
+
+#endif /*MAZE3DEXPORTER_H_*/
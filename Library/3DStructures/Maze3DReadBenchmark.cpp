@@ -0,0 +1,176 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DReadBenchmark.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Times how long the text of a 3D maze file takes to read,
+   				 through a file stream and with Maze3DTextReader on more
+   				 and more threads
+*/
+
+
+#include "Maze3DReadBenchmark.h"
+
+#include <QThread>
+#include <QElapsedTimer>
+
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#include "Wall.h"
+#include "Quad.h"
+#include "TexturedQuad.h"
+#include "Maze3DTextReader.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+namespace
+{
+	/* reads the file the way Maze3D::readIn does, through a file stream
+	 * ( without putting the walls in chunks )
+	 */
+	void readWithStream( const string & fileName, TexturedQuad & floor, vector<Wall> & walls ) throw( IOError & )
+	{
+		ifstream in( fileName.c_str() );
+		if( !in )
+		{
+			throw IOError();
+		}
+
+		int numberOfVertices = 0;
+		int numberOfQuads = 0;
+		in >> numberOfVertices >> numberOfQuads;
+
+		floor.readIn( in );
+
+		walls.clear();
+		Wall wall;
+		for( int i = 0; i < ( numberOfQuads - 1 ) / Wall::getNumberOfQuadsPerWall(); i++ )
+		{
+			wall.readIn( in );
+			walls.push_back( wall );
+		}
+	}
+
+	bool samePoints( const Point2D & a, const Point2D & b )
+	{
+		return ( a.getX() == b.getX() ) && ( a.getY() == b.getY() );
+	}
+
+	bool samePoints( const Point3D & a, const Point3D & b )
+	{
+		return ( a.getX() == b.getX() ) && ( a.getY() == b.getY() ) && ( a.getZ() == b.getZ() );
+	}
+
+	bool sameQuads( const TexturedQuad & a, const TexturedQuad & b )
+	{
+		return samePoints( a.getP1(), b.getP1() ) && samePoints( a.getP2(), b.getP2() ) &&
+			   samePoints( a.getP3(), b.getP3() ) && samePoints( a.getP4(), b.getP4() ) &&
+			   samePoints( a.getP1Texture(), b.getP1Texture() ) && samePoints( a.getP2Texture(), b.getP2Texture() ) &&
+			   samePoints( a.getP3Texture(), b.getP3Texture() ) && samePoints( a.getP4Texture(), b.getP4Texture() );
+	}
+
+	bool sameWalls( const Wall & a, const Wall & b )
+	{
+		return sameQuads( a.getFrontEnd(), b.getFrontEnd() ) && sameQuads( a.getRightSide(), b.getRightSide() ) &&
+			   sameQuads( a.getLeftSide(), b.getLeftSide() ) && sameQuads( a.getBackEnd(), b.getBackEnd() ) &&
+			   sameQuads( a.getTop(), b.getTop() );
+	}
+
+	double secondsSince( const QElapsedTimer & timer )
+	{
+		return timer.nsecsElapsed() / 1e9;
+	}
+
+	void writeTime( ostream & out, const string & name, double seconds, double megabytes )
+	{
+		out << "  " << name << ": " << seconds << " s";
+		if( seconds > 0.0 )
+		{
+			out << " ( " << ( megabytes / seconds ) << " MB/s )";
+		}
+		out << endl;
+	}
+}
+
+
+/* reads the file through a file stream as Maze3D::readIn reads it, then mapped into memory
+ * for Maze3DTextReader on 1, 2, 4 ... threads up to one for each core, and writes the best
+ * of a number of times for each to out ( the walls aren't put in chunks either way ),
+ * throws an IOError if the file can't be read or the ways of reading it disagree
+ */
+void Maze3DReadBenchmark::run( const string & fileName, ostream & out, int numberOfRuns /* = default_number_of_runs */ ) throw( IOError & )
+{
+	TexturedQuad streamFloor;
+	vector<Wall> streamWalls;
+	double bestStreamTime = -1.0;
+	for( int run = 0; run < numberOfRuns; run++ )
+	{
+		QElapsedTimer timer;
+		timer.start();
+		readWithStream( fileName, streamFloor, streamWalls );
+		double streamTime = secondsSince( timer );
+		if( ( bestStreamTime < 0.0 ) || ( streamTime < bestStreamTime ) )
+		{
+			bestStreamTime = streamTime;
+		}
+	}
+
+	MappedFile mapping( fileName );
+	double megabytes = ( double ) mapping.getSize() / ( 1024.0 * 1024.0 );
+	out << fileName << ": " << streamWalls.size() << " walls, " << megabytes << " MB" << endl;
+	writeTime( out, "file stream              ", bestStreamTime, megabytes );
+
+	//the file is mapped once and for all, so each number of threads is timed on the same footing
+	int mostThreads = max( 1, QThread::idealThreadCount() );
+	double oneThreadTime = -1.0;
+	for( int numberOfThreads = 1; ; numberOfThreads = min( numberOfThreads * 2, mostThreads ) )
+	{
+		TexturedQuad readerFloor;
+		vector<Wall> readerWalls;
+		double bestReaderTime = -1.0;
+		for( int run = 0; run < numberOfRuns; run++ )
+		{
+			QElapsedTimer timer;
+			timer.start();
+			Maze3DTextReader reader( mapping.getData(), mapping.getSize(), numberOfThreads );
+			reader.read( readerFloor, readerWalls );
+			double readerTime = secondsSince( timer );
+			if( ( bestReaderTime < 0.0 ) || ( readerTime < bestReaderTime ) )
+			{
+				bestReaderTime = readerTime;
+			}
+		}
+
+		//a faster reader is no good if it reads something different
+		if( !sameQuads( streamFloor, readerFloor ) || ( streamWalls.size() != readerWalls.size() ) )
+		{
+			throw IOError();
+		}
+		for( unsigned int i = 0; i < streamWalls.size(); i++ )
+		{
+			if( !sameWalls( streamWalls[ i ], readerWalls[ i ] ) )
+			{
+				throw IOError();
+			}
+		}
+
+		if( numberOfThreads == 1 )
+		{
+			oneThreadTime = bestReaderTime;
+		}
+		out << "  Maze3DTextReader, " << numberOfThreads << ( ( numberOfThreads == 1 ) ? " thread : " : " threads: " ) << bestReaderTime << " s";
+		if( bestReaderTime > 0.0 )
+		{
+			out << " ( " << ( megabytes / bestReaderTime ) << " MB/s, " << ( oneThreadTime / bestReaderTime ) << " times one thread )";
+		}
+		out << endl;
+
+		if( numberOfThreads == mostThreads )
+		{
+			break;
+		}
+	}
+}
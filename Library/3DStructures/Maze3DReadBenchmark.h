@@ -0,0 +1,33 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DReadBenchmark.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Times how long the text of a 3D maze file takes to read,
+   				 through a file stream and with Maze3DTextReader on more
+   				 and more threads
+*/
+
+
+#ifndef MAZE3DREADBENCHMARK_H_
+#define MAZE3DREADBENCHMARK_H_
+
+#include <string>
+#include <iostream>
+
+#include "IOError.h"
+
+class Maze3DReadBenchmark
+{
+	public:
+		/* reads the file through a file stream as Maze3D::readIn reads it, then mapped into memory
+		 * for Maze3DTextReader on 1, 2, 4 ... threads up to one for each core, and writes the best
+		 * of a number of times for each to out ( the walls aren't put in chunks either way ),
+		 * throws an IOError if the file can't be read or the ways of reading it disagree
+		 */
+		static void run( const std::string & fileName, std::ostream & out, int numberOfRuns = default_number_of_runs ) throw( IOError & );
+
+		static const int default_number_of_runs = 3;
+};
+
+#endif /*MAZE3DREADBENCHMARK_H_*/
@@ -0,0 +1,318 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DTextReader.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Reads a 3D maze in text form straight out of memory, on
+   				 several threads at once. Every wall is exactly 20 "v" records,
+   				 so once the records in each part of the text have been counted
+   				 every part knows which walls start in it, and reads them
+   				 straight into their places
+*/
+
+
+#include "Maze3DTextReader.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+
+#include <algorithm>
+#include <string.h>
+
+#include "Quad.h"
+#include "Point3D.h"
+#include "Point2D.h"
+#include "MazeTextReader.h"
+#include "OperationCanceled.h"
+
+using namespace std;
+
+namespace
+{
+	int recordsPerWall()
+	{
+		return Wall::getNumberOfQuadsPerWall() * Quad::getNumberOfVerticesPerQuad();
+	}
+
+	// a part adds to the count of walls read, and looks to see if it should stop, after this many walls
+	const int walls_between_check_ins = 1 << 10;
+}
+
+
+/* one part of the text, counted and read on a thread of its own
+ * nothing but a "v" record starts with a 'v' ( numbers never hold one ),
+ * so counting the records in a part is just counting its 'v's
+ */
+class Maze3DTextReader::Part : public QRunnable
+{
+	public:
+		Part() :
+			start( NULL ),
+			finish( NULL ),
+			textStart( NULL ),
+			textEnd( NULL ),
+			walls( NULL ),
+			wallsRead( NULL ),
+			stop( NULL ),
+			counting( true ),
+			numberOfRecords( 0 ),
+			firstRecord( 0 ),
+			failed( false )
+		{
+			setAutoDelete( false );
+		}
+
+		/* the part runs from m_start up to m_finish, its last wall can carry on
+		 * past m_finish though, as far as the end of the text
+		 */
+		void setUp( const char * m_start, const char * m_finish, const char * m_textStart, const char * m_textEnd,
+					vector<Wall> & m_walls, QAtomicInt & m_wallsRead, QAtomicInt & m_stop )
+		{
+			start = m_start;
+			finish = m_finish;
+			textStart = m_textStart;
+			textEnd = m_textEnd;
+			walls = &m_walls;
+			wallsRead = &m_wallsRead;
+			stop = &m_stop;
+		}
+
+		/* the next time the part runs it counts its records
+		 */
+		void countRecords() { counting = true; }
+
+		/* the next time the part runs it reads every wall whose first record is in it,
+		 * given the number of its first record among the records of all the walls
+		 */
+		void readWalls( int m_firstRecord ) { counting = false; firstRecord = m_firstRecord; }
+
+		int getNumberOfRecords() const { return numberOfRecords; }
+		bool hasFailed() const { return failed; }
+
+		void run()
+		{
+			if( counting )
+			{
+				numberOfRecords = 0;
+				for( const char * next = start; ( next = ( const char * ) memchr( next, 'v', finish - next ) ) != NULL; next++ )
+				{
+					numberOfRecords++;
+				}
+			}
+			else
+			{
+				try
+				{
+					read();
+				}
+				catch( IOError & ioe )
+				{
+					// the other parts have no reason to carry on
+					failed = true;
+					stop->fetchAndStoreOrdered( 1 );
+				}
+			}
+		}
+
+	private:
+		const char * start;
+		const char * finish;
+		const char * textStart;
+		const char * textEnd;
+		vector<Wall> * walls;
+		QAtomicInt * wallsRead;
+		QAtomicInt * stop;
+
+		bool counting;
+		int numberOfRecords;
+		int firstRecord;
+		bool failed;
+
+		void read() throw( IOError & )
+		{
+			// the walls whose first records are in this part
+			int firstWall = ( firstRecord + recordsPerWall() - 1 ) / recordsPerWall();
+			int lastWall = ( firstRecord + numberOfRecords + recordsPerWall() - 1 ) / recordsPerWall();
+			if( firstWall >= lastWall )
+			{
+				return;
+			}
+
+			// skip the records of the wall that started in the part before this one
+			const char * firstRecordOfWall = ( const char * ) memchr( start, 'v', finish - start );
+			for( int i = firstRecord; i < firstWall * recordsPerWall(); i++ )
+			{
+				firstRecordOfWall = ( const char * ) memchr( firstRecordOfWall + 1, 'v', finish - ( firstRecordOfWall + 1 ) );
+			}
+
+			MazeTextReader reader( textStart, textEnd - textStart );
+			reader.moveTo( firstRecordOfWall );
+			for( int wall = firstWall; wall < lastWall; wall += walls_between_check_ins )
+			{
+				if( *stop != 0 )
+				{
+					return;
+				}
+				int lastWallOfBatch = min( wall + walls_between_check_ins, lastWall );
+				Maze3DTextReader::readWalls( reader, *walls, wall, lastWallOfBatch );
+				wallsRead->fetchAndAddOrdered( lastWallOfBatch - wall );
+			}
+		}
+};
+
+
+/* the text has to stay around for as long as this reader does, it's read
+ * on the given number of threads, or on one thread for each core when that's 0
+ */
+Maze3DTextReader::Maze3DTextReader( const char * m_text, size_t m_size, int m_numberOfThreads /* = 0 */ ) :
+	text( m_text ),
+	end( m_text + m_size ),
+	numberOfThreads( ( m_numberOfThreads > 0 ) ? m_numberOfThreads : max( 1, QThread::idealThreadCount() ) ) {}
+
+
+/* reads the floor and then every wall, accepting the same text Maze3D::readIn does,
+ * throws an IOError if the number of vertices and quads don't agree with each other
+ * or with the number of vertices in the text, or if a vertex can't be read
+ * ( or an OperationCanceled if the progress monitor asks for reading to stop )
+ */
+void Maze3DTextReader::read( TexturedQuad & floor, vector<Wall> & walls, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	MazeTextReader reader( text, end - text );
+
+	int numberOfVertices = reader.readInteger();
+	int numberOfQuads = reader.readInteger();
+	if( ( numberOfQuads < 1 ) || ( ( ( numberOfQuads - 1 ) % Wall::getNumberOfQuadsPerWall() ) != 0 ) ||
+		( numberOfVertices != ( long long ) numberOfQuads * Quad::getNumberOfVerticesPerQuad() ) )
+	{
+		throw IOError();
+	}
+	int numberOfWalls = ( numberOfQuads - 1 ) / Wall::getNumberOfQuadsPerWall();
+
+	//floor is read in first, before any of the walls
+	readQuad( reader, floor );
+
+	//the text after the floor is split into parts, each read on its own thread
+	const char * wallsStart = reader.getPosition();
+	size_t sizeOfWalls = end - wallsStart;
+	int numberOfParts = ( int ) max( ( size_t ) 1, min( ( size_t ) numberOfThreads, sizeOfWalls / min_part_size ) );
+
+	QAtomicInt wallsRead( 0 );
+	QAtomicInt stop( 0 );
+	vector<Part> parts( numberOfParts );
+	for( int i = 0; i < numberOfParts; i++ )
+	{
+		const char * partStart = wallsStart + ( ( sizeOfWalls / numberOfParts ) * i );
+		const char * partFinish = ( i == numberOfParts - 1 ) ? end : wallsStart + ( ( sizeOfWalls / numberOfParts ) * ( i + 1 ) );
+		parts[ i ].setUp( partStart, partFinish, text, end, walls, wallsRead, stop );
+	}
+
+	QThreadPool pool;
+	pool.setMaxThreadCount( numberOfParts );
+
+	//count the records in every part, which have to add up to the walls' vertices
+	for( int i = 0; i < numberOfParts; i++ )
+	{
+		parts[ i ].countRecords();
+		pool.start( &parts[ i ] );
+	}
+	pool.waitForDone();
+
+	long long numberOfRecords = 0;
+	for( int i = 0; i < numberOfParts; i++ )
+	{
+		numberOfRecords += parts[ i ].getNumberOfRecords();
+	}
+	if( numberOfRecords != ( long long ) numberOfWalls * recordsPerWall() )
+	{
+		throw IOError();
+	}
+
+	//then read every part's walls straight into their places
+	walls.clear();
+	walls.resize( numberOfWalls );
+	int firstRecord = 0;
+	for( int i = 0; i < numberOfParts; i++ )
+	{
+		parts[ i ].readWalls( firstRecord );
+		firstRecord += parts[ i ].getNumberOfRecords();
+		pool.start( &parts[ i ] );
+	}
+
+	while( !pool.waitForDone( check_in_interval ) )
+	{
+		try
+		{
+			ProgressMonitor::checkIn( progress, ( double ) wallsRead / max( 1, numberOfWalls ) );
+		}
+		catch( OperationCanceled & oc )
+		{
+			stop.fetchAndStoreOrdered( 1 );
+			pool.waitForDone();
+			walls.clear();
+			throw;
+		}
+	}
+
+	for( int i = 0; i < numberOfParts; i++ )
+	{
+		if( parts[ i ].hasFailed() )
+		{
+			walls.clear();
+			throw IOError();
+		}
+	}
+}
+
+
+/* reads the four vertices of a quad, in the order TexturedQuad::readIn reads them
+ */
+void Maze3DTextReader::readQuad( MazeTextReader & reader, TexturedQuad & quad ) throw( IOError & )
+{
+	Point3D corners[ 4 ];
+	Point2D textureCorners[ 4 ];
+	for( int i = 0; i < 4; i++ )
+	{
+		reader.readSymbol( 'v' );
+		double x = reader.readDecimal();
+		double y = reader.readDecimal();
+		double z = reader.readDecimal();
+		double textureX = reader.readDecimal();
+		double textureY = reader.readDecimal();
+		corners[ i ] = Point3D( x, y, z );
+		textureCorners[ i ] = Point2D( textureX, textureY );
+	}
+
+	quad.setP1( corners[ 0 ] );
+	quad.setP2( corners[ 1 ] );
+	quad.setP3( corners[ 2 ] );
+	quad.setP4( corners[ 3 ] );
+	quad.setP1Texture( textureCorners[ 0 ] );
+	quad.setP2Texture( textureCorners[ 1 ] );
+	quad.setP3Texture( textureCorners[ 2 ] );
+	quad.setP4Texture( textureCorners[ 3 ] );
+}
+
+
+/* reads the walls numbered from firstWall up to lastWall, the reader has to be at the first of them
+ */
+void Maze3DTextReader::readWalls( MazeTextReader & reader, vector<Wall> & walls, int firstWall, int lastWall ) throw( IOError & )
+{
+	TexturedQuad quad;
+	for( int i = firstWall; i < lastWall; i++ )
+	{
+		//in the same order Wall::readIn reads them
+		Wall & wall = walls[ i ];
+		readQuad( reader, quad );
+		wall.setFrontEnd( quad );
+		readQuad( reader, quad );
+		wall.setRightSide( quad );
+		readQuad( reader, quad );
+		wall.setLeftSide( quad );
+		readQuad( reader, quad );
+		wall.setBackEnd( quad );
+		readQuad( reader, quad );
+		wall.setTop( quad );
+	}
+}
@@ -0,0 +1,67 @@
+/*
+   Project     : 3DMaze
+   File        : Maze3DTextReader.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Reads a 3D maze in text form straight out of memory, on
+   				 several threads at once. Every wall is exactly 20 "v" records,
+   				 so once the records in each part of the text have been counted
+   				 every part knows which walls start in it, and reads them
+   				 straight into their places
+*/
+
+
+#ifndef MAZE3DTEXTREADER_H_
+#define MAZE3DTEXTREADER_H_
+
+#include <vector>
+#include <cstddef>
+
+#include "Wall.h"
+#include "TexturedQuad.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+class MazeTextReader;
+
+class Maze3DTextReader
+{
+	public:
+		/* the text has to stay around for as long as this reader does, it's read
+		 * on the given number of threads, or on one thread for each core when that's 0
+		 */
+		Maze3DTextReader( const char * m_text, std::size_t m_size, int m_numberOfThreads = 0 );
+
+		/* reads the floor and then every wall, accepting the same text Maze3D::readIn does,
+		 * throws an IOError if the number of vertices and quads don't agree with each other
+		 * or with the number of vertices in the text, or if a vertex can't be read
+		 * ( or an OperationCanceled if the progress monitor asks for reading to stop )
+		 */
+		void read( TexturedQuad & floor, std::vector<Wall> & walls, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		int getNumberOfThreads() const { return numberOfThreads; }
+
+		// the text is only split into parts at least this big
+		static const std::size_t min_part_size = 1 << 16;
+
+		// how often, in milliseconds, progress is reported while the parts are read
+		static const int check_in_interval = 50;
+
+	private:
+		const char * text;
+		const char * end;
+		int numberOfThreads;
+
+		/* reads the four vertices of a quad, in the order TexturedQuad::readIn reads them
+		 */
+		static void readQuad( MazeTextReader & reader, TexturedQuad & quad ) throw( IOError & );
+
+		/* reads the walls numbered from firstWall up to lastWall, the reader has to be at the first of them
+		 */
+		static void readWalls( MazeTextReader & reader, std::vector<Wall> & walls, int firstWall, int lastWall ) throw( IOError & );
+
+		// one part of the text, counted and read on a thread of its own
+		class Part;
+};
+
+#endif /*MAZE3DTEXTREADER_H_*/
@@ -0,0 +1,187 @@
+/*
+   Project     : 3DMaze
+   File        : MazeChunk.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents one fixed size square piece of a 3D maze,
+   				 holding the geometry that's drawn there and the walls
+   				 that need to be checked for collisions there
+*/
+
+
+#include "MazeChunk.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace
+{
+	// starting value and multiplier of the FNV-1a hash
+	const unsigned int hash_offset_basis = 2166136261u;
+	const unsigned int hash_prime = 16777619u;
+}
+
+MazeChunk::MazeChunk( int m_column /* = 0 */, int m_row /* = 0 */, double m_size /* = 1.0 */ ) :
+	column( m_column ),
+	row( m_row ),
+	size( m_size ),
+	minX( numeric_limits<double>::max() ),
+	maxX( -numeric_limits<double>::max() ),
+	minY( numeric_limits<double>::max() ),
+	maxY( -numeric_limits<double>::max() ),
+	minZ( numeric_limits<double>::max() ),
+	maxZ( -numeric_limits<double>::max() ),
+	vertices(),
+	contentHash( hash_offset_basis ),
+	collisionCells( collision_cells_per_side * collision_cells_per_side ) {}
+
+
+/* remembers that the given wall needs to be checked for collisions
+ * anywhere it overlaps this chunk
+ */
+void MazeChunk::addCollisionWall( int wallIndex, const Wall & wall )
+{
+	// the corners of the top of a wall are all four corners of its base
+	const TexturedQuad & top = wall.getTop();
+	double wallMinX = min( min( top.getP1().getX(), top.getP2().getX() ), min( top.getP3().getX(), top.getP4().getX() ) );
+	double wallMaxX = max( max( top.getP1().getX(), top.getP2().getX() ), max( top.getP3().getX(), top.getP4().getX() ) );
+	double wallMinY = min( min( top.getP1().getY(), top.getP2().getY() ), min( top.getP3().getY(), top.getP4().getY() ) );
+	double wallMaxY = max( max( top.getP1().getY(), top.getP2().getY() ), max( top.getP3().getY(), top.getP4().getY() ) );
+
+	int firstCell = collisionCellFor( wallMinX, wallMinY );
+	int lastCell = collisionCellFor( wallMaxX, wallMaxY );
+	int firstColumn = firstCell % collision_cells_per_side;
+	int lastColumn = lastCell % collision_cells_per_side;
+	int firstRow = firstCell / collision_cells_per_side;
+	int lastRow = lastCell / collision_cells_per_side;
+
+	for( int cellRow = firstRow; cellRow <= lastRow; cellRow++ )
+	{
+		for( int cellColumn = firstColumn; cellColumn <= lastColumn; cellColumn++ )
+		{
+			collisionCells[ cellRow * collision_cells_per_side + cellColumn ].push_back( wallIndex );
+		}
+	}
+}
+
+
+/* returns the indices of the walls that might contain the given point,
+ * in the order they were added
+ */
+const vector<int> & MazeChunk::getCollisionCandidates( const Point2D & point ) const
+{
+	return collisionCells[ collisionCellFor( point.getX(), point.getY() ) ];
+}
+
+
+/* adds the quad to the geometry drawn for this chunk
+ */
+void MazeChunk::addAQuad( const TexturedQuad & quad )
+{
+	addAVertex( quad.getP1(), quad.getP1Texture() );
+	addAVertex( quad.getP2(), quad.getP2Texture() );
+	addAVertex( quad.getP3(), quad.getP3Texture() );
+	addAVertex( quad.getP4(), quad.getP4Texture() );
+}
+
+void MazeChunk::clearQuads()
+{
+	vertices.clear();
+	contentHash = hash_offset_basis;
+	minX = minY = minZ = numeric_limits<double>::max();
+	maxX = maxY = maxZ = -numeric_limits<double>::max();
+}
+
+
+/* returns true unless the geometry in this chunk is certainly out of view
+ */
+bool MazeChunk::mightBeSeenBy( const ViewFrustum & frustum ) const
+{
+	if( vertices.empty() )
+	{
+		return false;
+	}
+	return frustum.mightSee( minX, maxX, minY, maxY, minZ, maxZ );
+}
+
+
+/* returns roughly how many pixels across the geometry in this chunk appears on screen
+ */
+double MazeChunk::screenSizeIn( const ViewFrustum & frustum ) const
+{
+	if( vertices.empty() )
+	{
+		return 0.0;
+	}
+	return frustum.screenSizeOf( minX, maxX, minY, maxY, minZ, maxZ );
+}
+
+
+/* Draws the chunk's quads straight out of memory using openGL calls
+ */
+void MazeChunk::Draw() const
+{
+	if( vertices.empty() )
+	{
+		return;
+	}
+
+	glInterleavedArrays( GL_T2F_V3F, 0, &vertices[ 0 ] );
+	glDrawArrays( GL_QUADS, 0, numberOfQuads() * 4 );
+	glDisableClientState( GL_TEXTURE_COORD_ARRAY );
+	glDisableClientState( GL_VERTEX_ARRAY );
+}
+
+
+/* Draws only the shape of the chunk's quads, without texturing them
+ */
+void MazeChunk::DrawOutline() const
+{
+	if( vertices.empty() )
+	{
+		return;
+	}
+
+	// skip past the texture coordinates at the start of each vertex
+	glEnableClientState( GL_VERTEX_ARRAY );
+	glVertexPointer( 3, GL_FLOAT, floats_per_vertex * sizeof( GLfloat ), &vertices[ 2 ] );
+	glDrawArrays( GL_QUADS, 0, numberOfQuads() * 4 );
+	glDisableClientState( GL_VERTEX_ARRAY );
+}
+
+
+/* returns the index of the collision cell holding the given point,
+ * points outside of the chunk are given the nearest cell
+ */
+int MazeChunk::collisionCellFor( double x, double y ) const
+{
+	double cellSize = size / collision_cells_per_side;
+	int cellColumn = ( int ) floor( ( x - ( column * size ) ) / cellSize );
+	int cellRow = ( int ) floor( ( y - ( row * size ) ) / cellSize );
+	cellColumn = max( 0, min( collision_cells_per_side - 1, cellColumn ) );
+	cellRow = max( 0, min( collision_cells_per_side - 1, cellRow ) );
+	return cellRow * collision_cells_per_side + cellColumn;
+}
+
+void MazeChunk::addAVertex( const Point3D & position, const Point2D & textureCoordinate )
+{
+	GLfloat vertex[ floats_per_vertex ] = { ( GLfloat ) textureCoordinate.getX(), ( GLfloat ) textureCoordinate.getY(),
+											( GLfloat ) position.getX(), ( GLfloat ) position.getY(), ( GLfloat ) position.getZ() };
+	vertices.insert( vertices.end(), vertex, vertex + floats_per_vertex );
+
+	//the hash is built up one byte at a time as vertices are added
+	const unsigned char * bytes = reinterpret_cast<const unsigned char *>( vertex );
+	for( unsigned int i = 0; i < sizeof( vertex ); i++ )
+	{
+		contentHash = ( contentHash ^ bytes[ i ] ) * hash_prime;
+	}
+
+	minX = min<double>( minX, position.getX() );
+	maxX = max<double>( maxX, position.getX() );
+	minY = min<double>( minY, position.getY() );
+	maxY = max<double>( maxY, position.getY() );
+	minZ = min<double>( minZ, position.getZ() );
+	maxZ = max<double>( maxZ, position.getZ() );
+}
@@ -0,0 +1,108 @@
+/*
+   Project     : 3DMaze
+   File        : MazeChunk.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents one fixed size square piece of a 3D maze,
+   				 holding the geometry that's drawn there and the walls
+   				 that need to be checked for collisions there
+*/
+
+
+#ifndef MAZECHUNK_H_
+#define MAZECHUNK_H_
+
+#include <vector>
+#include <QtOpenGL>
+
+#include "Point2D.h"
+#include "TexturedQuad.h"
+#include "Wall.h"
+#include "ViewFrustum.h"
+
+class MazeChunk
+{
+	public:
+		MazeChunk( int m_column = 0, int m_row = 0, double m_size = 1.0 );
+
+		int getColumn() const { return column; }
+		int getRow() const { return row; }
+
+		/* remembers that the given wall needs to be checked for collisions
+		 * anywhere it overlaps this chunk
+		 */
+		void addCollisionWall( int wallIndex, const Wall & wall );
+
+		/* returns the indices of the walls that might contain the given point,
+		 * in the order they were added
+		 */
+		const std::vector<int> & getCollisionCandidates( const Point2D & point ) const;
+
+		/* adds the quad to the geometry drawn for this chunk
+		 */
+		void addAQuad( const TexturedQuad & quad );
+		void clearQuads();
+
+		int numberOfQuads() const { return vertices.size() / floats_per_quad; }
+
+		/* the vertices of the quads, as texture coordinates followed by
+		 * the position ( the layout openGL calls GL_T2F_V3F )
+		 */
+		const std::vector<GLfloat> & getVertices() const { return vertices; }
+
+		/* changes whenever the vertices change, so a copy of them
+		 * ( on the graphics card for example ) can be checked to see if it's stale
+		 */
+		unsigned int getContentHash() const { return contentHash; }
+
+		/* returns true unless the geometry in this chunk is certainly out of view
+		 */
+		bool mightBeSeenBy( const ViewFrustum & frustum ) const;
+
+		/* returns roughly how many pixels across the geometry in this chunk appears on screen
+		 */
+		double screenSizeIn( const ViewFrustum & frustum ) const;
+
+		/* the square area of the world this chunk covers
+		 */
+		double getMinX() const { return column * size; }
+		double getMaxX() const { return ( column + 1 ) * size; }
+		double getMinY() const { return row * size; }
+		double getMaxY() const { return ( row + 1 ) * size; }
+
+		/* Draws the chunk's quads straight out of memory using openGL calls
+		 */
+		void Draw() const;
+
+		/* Draws only the shape of the chunk's quads, without texturing them
+		 */
+		void DrawOutline() const;
+
+		static const int floats_per_vertex = 5;
+		static const int floats_per_quad = 4 * floats_per_vertex;
+
+	private:
+		int column;
+		int row;
+		double size;
+
+		// bounds of the geometry drawn for this chunk, which can stick out a little past the chunk itself
+		double minX, maxX, minY, maxY, minZ, maxZ;
+
+		std::vector<GLfloat> vertices;
+		unsigned int contentHash;
+
+		// the walls to check for collisions, in a grid of cells covering the chunk
+		std::vector< std::vector<int> > collisionCells;
+
+		static const int collision_cells_per_side = 8;
+
+		/* returns the index of the collision cell holding the given point,
+		 * points outside of the chunk are given the nearest cell
+		 */
+		int collisionCellFor( double x, double y ) const;
+
+		void addAVertex( const Point3D & position, const Point2D & textureCoordinate );
+};
+
+#endif /*MAZECHUNK_H_*/
@@ -0,0 +1,203 @@
+/*
+   Project     : 3DMaze
+   File        : MazeImpostor.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A picture of the tops of all the walls in a maze, as seen
+   				 from straight above, used in place of the walls themselves
+   				 when they're too small on screen to be worth drawing
+*/
+
+
+#include "MazeImpostor.h"
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+
+using namespace std;
+
+namespace
+{
+	// starting value and multiplier of the FNV-1a hash
+	const unsigned int hash_offset_basis = 2166136261u;
+	const unsigned int hash_prime = 16777619u;
+
+	// an edge of an outline, going up from its lower end
+	class ScanEdge
+	{
+		public:
+			ScanEdge( double m_lowX, double m_lowY, double m_highX, double m_highY ) :
+				lowX( m_lowX ),
+				lowY( m_lowY ),
+				highY( m_highY ),
+				xPerY( ( m_highX - m_lowX ) / ( m_highY - m_lowY ) ) {}
+
+			double xAt( double y ) const { return lowX + ( ( y - lowY ) * xPerY ); }
+
+			bool operator<( const ScanEdge & other ) const { return lowY < other.lowY; }
+
+			double lowX;
+			double lowY;
+			double highY;
+			double xPerY;
+	};
+}
+
+MazeImpostor::MazeImpostor() :
+	resolution( 0 ),
+	coverage(),
+	contentHash( hash_offset_basis ),
+	minX( 0.0 ),
+	maxX( 0.0 ),
+	minY( 0.0 ),
+	maxY( 0.0 ),
+	heightOfTop( 0.0 ) {}
+
+
+/* changes this picture to show the area inside the given outlines,
+ * lying flat at the given height
+ */
+void MazeImpostor::fitToOutlines( const WallFootprintUnion & footprints, int heightOfWall )
+{
+	clear();
+
+	//gather up the edges, and find the area they cover
+	vector<ScanEdge> edges;
+	minX = minY = numeric_limits<double>::max();
+	maxX = maxY = -numeric_limits<double>::max();
+	for( int i = 0; i < footprints.numberOfOutlines(); i++ )
+	{
+		const Polygon2D & outline = footprints.getAnOutline( i );
+		for( int j = 0; j < outline.numberOfPoints(); j++ )
+		{
+			const Point2D & start = outline.getAPoint( j );
+			const Point2D & end = outline.getAPoint( ( j + 1 ) % outline.numberOfPoints() );
+
+			minX = min<double>( minX, start.getX() );
+			maxX = max<double>( maxX, start.getX() );
+			minY = min<double>( minY, start.getY() );
+			maxY = max<double>( maxY, start.getY() );
+
+			//flat edges never cross a row of samples, so they don't matter
+			if( start.getY() < end.getY() )
+			{
+				edges.push_back( ScanEdge( start.getX(), start.getY(), end.getX(), end.getY() ) );
+			}
+			else if( end.getY() < start.getY() )
+			{
+				edges.push_back( ScanEdge( end.getX(), end.getY(), start.getX(), start.getY() ) );
+			}
+		}
+	}
+
+	if( edges.empty() )
+	{
+		clear();
+		return;
+	}
+
+	heightOfTop = heightOfWall / 2.0;
+	resolution = max_resolution;
+	coverage.assign( resolution * resolution, 0 );
+
+	double pixelWidth = ( maxX - minX ) / resolution;
+	double pixelHeight = ( maxY - minY ) / resolution;
+
+	// each sample row adds this much to the pixels it completely covers
+	const double coverage_per_sample = 255.0 / samples_per_row;
+
+	//sweep up through the rows of samples, keeping track of the edges that cross the current row
+	sort( edges.begin(), edges.end() );
+	unsigned int nextEdge = 0;
+	vector<ScanEdge> activeEdges;
+	vector<double> crossings;
+	vector<double> rowCoverage( resolution );
+
+	for( int row = 0; row < resolution; row++ )
+	{
+		fill( rowCoverage.begin(), rowCoverage.end(), 0.0 );
+
+		for( int sample = 0; sample < samples_per_row; sample++ )
+		{
+			double y = minY + ( ( row + ( ( sample + 0.5 ) / samples_per_row ) ) * pixelHeight );
+
+			while( ( nextEdge < edges.size() ) && ( edges[ nextEdge ].lowY <= y ) )
+			{
+				activeEdges.push_back( edges[ nextEdge ] );
+				nextEdge++;
+			}
+
+			crossings.clear();
+			unsigned int kept = 0;
+			for( unsigned int i = 0; i < activeEdges.size(); i++ )
+			{
+				if( activeEdges[ i ].highY > y )
+				{
+					crossings.push_back( activeEdges[ i ].xAt( y ) );
+					activeEdges[ kept++ ] = activeEdges[ i ];
+				}
+			}
+			activeEdges.erase( activeEdges.begin() + kept, activeEdges.end() );
+			sort( crossings.begin(), crossings.end() );
+
+			//the inside of the outlines lies between every other pair of crossings
+			for( unsigned int i = 0; ( i + 1 ) < crossings.size(); i += 2 )
+			{
+				double spanStart = ( crossings[ i ] - minX ) / pixelWidth;
+				double spanEnd = ( crossings[ i + 1 ] - minX ) / pixelWidth;
+				int firstPixel = max( 0, ( int ) floor( spanStart ) );
+				int lastPixel = min( resolution - 1, ( int ) floor( spanEnd ) );
+				for( int pixel = firstPixel; pixel <= lastPixel; pixel++ )
+				{
+					double covered = min( spanEnd, pixel + 1.0 ) - max( spanStart, ( double ) pixel );
+					rowCoverage[ pixel ] += covered * coverage_per_sample;
+				}
+			}
+		}
+
+		for( int pixel = 0; pixel < resolution; pixel++ )
+		{
+			GLubyte value = ( GLubyte ) min( 255.0, rowCoverage[ pixel ] + 0.5 );
+			coverage[ row * resolution + pixel ] = value;
+			contentHash = ( contentHash ^ value ) * hash_prime;
+		}
+	}
+}
+
+void MazeImpostor::clear()
+{
+	resolution = 0;
+	coverage.clear();
+	contentHash = hash_offset_basis;
+	minX = maxX = minY = maxY = 0.0;
+	heightOfTop = 0.0;
+}
+
+
+/* trades pictures with the other impostor, without copying them
+ */
+void MazeImpostor::swap( MazeImpostor & other )
+{
+	std::swap( resolution, other.resolution );
+	coverage.swap( other.coverage );
+	std::swap( contentHash, other.contentHash );
+	std::swap( minX, other.minX );
+	std::swap( maxX, other.maxX );
+	std::swap( minY, other.minY );
+	std::swap( maxY, other.maxY );
+	std::swap( heightOfTop, other.heightOfTop );
+}
+
+
+/* the spot in the picture that lies over the given point in the world
+ */
+double MazeImpostor::textureXFor( double x ) const
+{
+	return ( x - minX ) / ( maxX - minX );
+}
+
+double MazeImpostor::textureYFor( double y ) const
+{
+	return ( y - minY ) / ( maxY - minY );
+}
@@ -0,0 +1,76 @@
+/*
+   Project     : 3DMaze
+   File        : MazeImpostor.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A picture of the tops of all the walls in a maze, as seen
+   				 from straight above, used in place of the walls themselves
+   				 when they're too small on screen to be worth drawing
+*/
+
+
+#ifndef MAZEIMPOSTOR_H_
+#define MAZEIMPOSTOR_H_
+
+#include <vector>
+#include <QtOpenGL>
+
+#include "WallFootprintUnion.h"
+
+class MazeImpostor
+{
+	public:
+		MazeImpostor();
+
+		/* changes this picture to show the area inside the given outlines,
+		 * lying flat at the given height
+		 */
+		void fitToOutlines( const WallFootprintUnion & footprints, int heightOfWall );
+
+		void clear();
+
+		/* trades pictures with the other impostor, without copying them
+		 */
+		void swap( MazeImpostor & other );
+		bool isEmpty() const { return coverage.empty(); }
+
+		/* the picture is a square grid of how much of each pixel is covered by a wall,
+		 * from 0 ( not at all ) to 255 ( completely ), starting at the lowest x and y
+		 */
+		int getResolution() const { return resolution; }
+		const std::vector<GLubyte> & getCoverage() const { return coverage; }
+
+		/* changes whenever the picture changes, so a copy of it
+		 * ( on the graphics card for example ) can be checked to see if it's stale
+		 */
+		unsigned int getContentHash() const { return contentHash; }
+
+		/* the area of the world the picture covers
+		 */
+		double getMinX() const { return minX; }
+		double getMaxX() const { return maxX; }
+		double getMinY() const { return minY; }
+		double getMaxY() const { return maxY; }
+		double getHeightOfTop() const { return heightOfTop; }
+
+		/* the spot in the picture that lies over the given point in the world
+		 */
+		double textureXFor( double x ) const;
+		double textureYFor( double y ) const;
+
+		// number of pixels along each side of the picture
+		static const int max_resolution = 1024;
+
+	private:
+		int resolution;
+		std::vector<GLubyte> coverage;
+		unsigned int contentHash;
+
+		double minX, maxX, minY, maxY;
+		double heightOfTop;
+
+		// each row of pixels is sampled this many times to smooth out the edges of the walls
+		static const int samples_per_row = 4;
+};
+
+#endif /*MAZEIMPOSTOR_H_*/
@@ -22,7 +22,7 @@ class Point3D : public Point2D
 		Point3D( double m_x = 0.0, double m_y = 0.0, double m_z = 0.0 );
 		Point3D( const Point3D & otherPoint );
 		
-		double getZ() const { return z; }
+		GeometryScalar getZ() const { return z; }
 		void setZ( double m_z ) { z = m_z; }
 		
 		const Point3D & operator=( const Point3D & rhs );
@@ -37,7 +37,7 @@ class Point3D : public Point2D
 		std::string type() const { return "3D Point";}
 	
 	private:
-		double z;
+		GeometryScalar z;
 		
 };
 
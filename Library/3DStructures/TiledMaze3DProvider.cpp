@@ -0,0 +1,74 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMaze3DProvider.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps a 3D maze filled with walls for just the tiles of a
+   				 tiled maze around a point ( where someone is standing, say ),
+   				 so a maze too big to hold in memory can still be walked through
+*/
+
+
+#include "TiledMaze3DProvider.h"
+
+#include "Wall.h"
+#include "Quad.h"
+#include "TexturedQuad.h"
+#include "Point3D.h"
+
+using namespace std;
+
+/* the walls and floor are built the same way MainWindow builds them,
+ * the texture sizes are in world units
+ */
+TiledMaze3DProvider::TiledMaze3DProvider( TiledMaze2DProvider & m_tiles, int m_wallWidth, int m_wallHeight,
+										  int m_wallsTextureWidth, int m_wallsTextureHeight, int m_floorTextureWidth, int m_floorTextureHeight ) :
+	tiles( m_tiles ),
+	wallWidth( m_wallWidth ),
+	wallHeight( m_wallHeight ),
+	wallsTextureWidth( m_wallsTextureWidth ),
+	wallsTextureHeight( m_wallsTextureHeight ),
+	floorTextureWidth( m_floorTextureWidth ),
+	floorTextureHeight( m_floorTextureHeight ),
+	shownTiles() {}
+
+
+/* fills the maze with the walls of every tile with lines within the given distance of center,
+ * the maze is only rebuilt when that changes which tiles are shown, returns true if it was rebuilt
+ */
+bool TiledMaze3DProvider::updateAround( Maze3D & maze, const Point2D & center, double distance ) throw( IOError & )
+{
+	//walls stick out past their lines by half their width
+	double reach = distance + ( wallWidth / 2.0 );
+	vector<int> tilesNearby;
+	tiles.findTilesIn( center.getX() - reach, center.getY() - reach, center.getX() + reach, center.getY() + reach, tilesNearby );
+	if( tilesNearby == shownTiles )
+	{
+		return false;
+	}
+
+	maze.clearWalls();
+
+	Wall wall;
+	for( unsigned int i = 0; i < tilesNearby.size(); i++ )
+	{
+		const vector<LineSegment2D> & lines = tiles.getTile( tilesNearby[ i ] );
+		for( unsigned int j = 0; j < lines.size(); j++ )
+		{
+			wall.fitToLine( lines[ j ], wallWidth, wallHeight, wallsTextureWidth, wallsTextureHeight );
+			maze.addAWall( wall );
+		}
+	}
+
+	//the floor covers the whole maze, not just the tiles shown
+	double halfWidth = tiles.getWidth() / 2.0;
+	double halfHeight = tiles.getHeight() / 2.0;
+	Point3D bottomLeft( -halfWidth, -halfHeight, -wallHeight / 2.0 );
+	Point3D topLeft( -halfWidth, halfHeight, -wallHeight / 2.0 );
+	Point3D topRight( halfWidth, halfHeight, -wallHeight / 2.0 );
+	Point3D bottomRight( halfWidth, -halfHeight, -wallHeight / 2.0 );
+	maze.setFloor( TexturedQuad( Quad( bottomLeft, topLeft, topRight, bottomRight ), floorTextureWidth, floorTextureHeight ) );
+
+	shownTiles.swap( tilesNearby );
+	return true;
+}
@@ -0,0 +1,49 @@
+/*
+   Project     : 3DMaze
+   File        : TiledMaze3DProvider.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps a 3D maze filled with walls for just the tiles of a
+   				 tiled maze around a point ( where someone is standing, say ),
+   				 so a maze too big to hold in memory can still be walked through
+*/
+
+
+#ifndef TILEDMAZE3DPROVIDER_H_
+#define TILEDMAZE3DPROVIDER_H_
+
+#include <vector>
+
+#include "TiledMaze2DProvider.h"
+#include "Maze3D.h"
+#include "Point2D.h"
+#include "IOError.h"
+
+class TiledMaze3DProvider
+{
+	public:
+		/* the walls and floor are built the same way MainWindow builds them,
+		 * the texture sizes are in world units
+		 */
+		TiledMaze3DProvider( TiledMaze2DProvider & m_tiles, int m_wallWidth, int m_wallHeight,
+							 int m_wallsTextureWidth, int m_wallsTextureHeight, int m_floorTextureWidth, int m_floorTextureHeight );
+
+		/* fills the maze with the walls of every tile with lines within the given distance of center,
+		 * the maze is only rebuilt when that changes which tiles are shown, returns true if it was rebuilt
+		 */
+		bool updateAround( Maze3D & maze, const Point2D & center, double distance ) throw( IOError & );
+
+		/* forgets which tiles are shown, so the next update rebuilds the maze
+		 */
+		void forgetShownTiles() { shownTiles.clear(); }
+		int numberOfTilesShown() const { return shownTiles.size(); }
+
+	private:
+		TiledMaze2DProvider & tiles;
+		int wallWidth, wallHeight;
+		int wallsTextureWidth, wallsTextureHeight;
+		int floorTextureWidth, floorTextureHeight;
+		std::vector<int> shownTiles;
+};
+
+#endif /*TILEDMAZE3DPROVIDER_H_*/
@@ -0,0 +1,112 @@
+/*
+   Project     : 3DMaze
+   File        : ViewFrustum.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents the volume of space that openGL can currently see,
+   				 used to skip drawing things that are out of view
+*/
+
+
+#include "ViewFrustum.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+
+/* builds the frustum from openGL's current projection and modelview matrices
+ */
+ViewFrustum::ViewFrustum()
+{
+	GLdouble projection[ 16 ];
+	GLdouble modelview[ 16 ];
+	glGetDoublev( GL_PROJECTION_MATRIX, projection );
+	glGetDoublev( GL_MODELVIEW_MATRIX, modelview );
+	glGetIntegerv( GL_VIEWPORT, viewport );
+
+	// combined = projection * modelview ( both stored in column major order )
+	for( int column = 0; column < 4; column++ )
+	{
+		for( int row = 0; row < 4; row++ )
+		{
+			combined[ column * 4 + row ] = 0.0;
+			for( int k = 0; k < 4; k++ )
+			{
+				combined[ column * 4 + row ] += projection[ k * 4 + row ] * modelview[ column * 4 + k ];
+			}
+		}
+	}
+
+	/* a point is inside the view when -w <= x, y, z <= w after being transformed,
+	 * so each plane is the last row of the combined matrix plus or minus one of the others
+	 */
+	for( int i = 0; i < number_of_planes; i++ )
+	{
+		int row = i / 2;
+		double sign = ( ( i % 2 ) == 0 ) ? 1.0 : -1.0;
+		for( int column = 0; column < 4; column++ )
+		{
+			planes[ i ][ column ] = combined[ column * 4 + 3 ] + ( sign * combined[ column * 4 + row ] );
+		}
+	}
+}
+
+
+/* returns false only if the box lying along the axes with the given bounds
+ * is certainly outside of the view ( boxes near a corner of the view might be
+ * reported as visible even though they aren't )
+ */
+bool ViewFrustum::mightSee( double minX, double maxX, double minY, double maxY, double minZ, double maxZ ) const
+{
+	for( int i = 0; i < number_of_planes; i++ )
+	{
+		// check the corner of the box that's furthest along the inside direction of this plane,
+		// if even that corner is outside then the whole box is
+		double x = ( planes[ i ][ 0 ] >= 0.0 ) ? maxX : minX;
+		double y = ( planes[ i ][ 1 ] >= 0.0 ) ? maxY : minY;
+		double z = ( planes[ i ][ 2 ] >= 0.0 ) ? maxZ : minZ;
+		if( ( planes[ i ][ 0 ] * x ) + ( planes[ i ][ 1 ] * y ) + ( planes[ i ][ 2 ] * z ) + planes[ i ][ 3 ] < 0.0 )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* returns roughly how many pixels across the box lying along the axes with
+ * the given bounds appears on screen, boxes reaching behind the camera are
+ * reported as being as large as possible
+ */
+double ViewFrustum::screenSizeOf( double minX, double maxX, double minY, double maxY, double minZ, double maxZ ) const
+{
+	double lowestX = numeric_limits<double>::max();
+	double highestX = -numeric_limits<double>::max();
+	double lowestY = numeric_limits<double>::max();
+	double highestY = -numeric_limits<double>::max();
+
+	for( int corner = 0; corner < 8; corner++ )
+	{
+		double x = ( ( corner & 1 ) != 0 ) ? maxX : minX;
+		double y = ( ( corner & 2 ) != 0 ) ? maxY : minY;
+		double z = ( ( corner & 4 ) != 0 ) ? maxZ : minZ;
+
+		double clipX = ( combined[ 0 ] * x ) + ( combined[ 4 ] * y ) + ( combined[ 8 ] * z ) + combined[ 12 ];
+		double clipY = ( combined[ 1 ] * x ) + ( combined[ 5 ] * y ) + ( combined[ 9 ] * z ) + combined[ 13 ];
+		double clipW = ( combined[ 3 ] * x ) + ( combined[ 7 ] * y ) + ( combined[ 11 ] * z ) + combined[ 15 ];
+		if( clipW <= 0.0 )
+		{
+			return numeric_limits<double>::max();
+		}
+
+		lowestX = min( lowestX, clipX / clipW );
+		highestX = max( highestX, clipX / clipW );
+		lowestY = min( lowestY, clipY / clipW );
+		highestY = max( highestY, clipY / clipW );
+	}
+
+	// after dividing by w the whole window is 2 units across
+	return max( ( highestX - lowestX ) * viewport[ 2 ], ( highestY - lowestY ) * viewport[ 3 ] ) / 2.0;
+}
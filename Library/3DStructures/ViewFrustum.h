@@ -0,0 +1,48 @@
+/*
+   Project     : 3DMaze
+   File        : ViewFrustum.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents the volume of space that openGL can currently see,
+   				 used to skip drawing things that are out of view
+*/
+
+
+#ifndef VIEWFRUSTUM_H_
+#define VIEWFRUSTUM_H_
+
+#include <QtOpenGL>
+
+class ViewFrustum
+{
+	public:
+		/* builds the frustum from openGL's current projection and modelview matrices
+		 */
+		ViewFrustum();
+
+		/* returns false only if the box lying along the axes with the given bounds
+		 * is certainly outside of the view ( boxes near a corner of the view might be
+		 * reported as visible even though they aren't )
+		 */
+		bool mightSee( double minX, double maxX, double minY, double maxY, double minZ, double maxZ ) const;
+
+		/* returns roughly how many pixels across the box lying along the axes with
+		 * the given bounds appears on screen, boxes reaching behind the camera are
+		 * reported as being as large as possible
+		 */
+		double screenSizeOf( double minX, double maxX, double minY, double maxY, double minZ, double maxZ ) const;
+
+	private:
+		static const int number_of_planes = 6;
+
+		// projection * modelview, in column major order
+		GLdouble combined[ 16 ];
+
+		// x, y, width, height of the window openGL is drawing into
+		GLint viewport[ 4 ];
+
+		// each plane is stored as a, b, c, d where a*x + b*y + c*z + d >= 0 on the inside of the plane
+		GLdouble planes[ number_of_planes ][ 4 ];
+};
+
+#endif /*VIEWFRUSTUM_H_*/
@@ -0,0 +1,113 @@
+/*
+   Project     : 3DMaze
+   File        : WallMesh.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents all the walls of a maze as one watertight mesh,
+   				 extruded straight up from the outlines of the walls' footprints
+*/
+
+
+#include "WallMesh.h"
+
+using namespace std;
+
+WallMesh::WallMesh() :
+	sides(),
+	tops() {}
+
+
+/*
+ * changes this mesh so that it has a side for every edge of the given outlines,
+ * standing up straight in the z-direction with the given height, and a top
+ * that covers exactly the area inside the outlines
+ */
+void WallMesh::fitToOutlines( const WallFootprintUnion & footprints, int heightOfWall, int widthOfTexture, int heightOfTexture )
+{
+	clear();
+
+	double bottom = -heightOfWall / 2.0;
+	double top = heightOfWall / 2.0;
+
+	for( int i = 0; i < footprints.numberOfOutlines(); i++ )
+	{
+		const Polygon2D & outline = footprints.getAnOutline( i );
+		for( int j = 0; j < outline.numberOfPoints(); j++ )
+		{
+			/* the inside of the walls is to the left of each edge of an outline,
+			 * so looking at the side from outside of the wall the edge runs left to right
+			 */
+			LineSegment2D edge( outline.getAnEdge( j ) );
+			const Point2D & start = edge.getP1();
+			const Point2D & end = edge.getP2();
+
+			Quad side( Point3D( start.getX(), start.getY(), bottom ),
+					   Point3D( start.getX(), start.getY(), top ),
+					   Point3D( end.getX(), end.getY(), top ),
+					   Point3D( end.getX(), end.getY(), bottom ) );
+
+			// same texture coordinates a Wall would give this side
+			sides.push_back( TexturedQuad( side, heightOfTexture, widthOfTexture ) );
+		}
+	}
+
+	vector<Polygon2D> trapezoids;
+	footprints.decomposeIntoTrapezoids( trapezoids );
+	for( unsigned int i = 0; i < trapezoids.size(); i++ )
+	{
+		const Polygon2D & trapezoid = trapezoids[ i ];
+		Point3D corners[ 4 ];
+		Point2D textureCorners[ 4 ];
+		for( int j = 0; j < 4; j++ )
+		{
+			const Point2D & corner = trapezoid.getAPoint( j );
+			corners[ j ] = Point3D( corner.getX(), corner.getY(), top );
+
+			// the texture is laid flat across all the tops so it lines up between neighboring trapezoids
+			textureCorners[ j ] = Point2D( corner.getX() / widthOfTexture, corner.getY() / heightOfTexture );
+		}
+
+		Quad quad( corners[ 0 ], corners[ 1 ], corners[ 2 ], corners[ 3 ] );
+		tops.push_back( TexturedQuad( quad, textureCorners[ 0 ], textureCorners[ 1 ], textureCorners[ 2 ], textureCorners[ 3 ] ) );
+	}
+}
+
+void WallMesh::clear()
+{
+	sides.clear();
+	tops.clear();
+}
+
+
+/* trades sides and tops with the other mesh, without copying them
+ */
+void WallMesh::swap( WallMesh & other )
+{
+	sides.swap( other.sides );
+	tops.swap( other.tops );
+}
+
+const TexturedQuad & WallMesh::getASide( int index ) const
+{
+	return sides.at( index );
+}
+
+const TexturedQuad & WallMesh::getATop( int index ) const
+{
+	return tops.at( index );
+}
+
+
+/* Draws the mesh using openGL calls
+ */
+void WallMesh::Draw() const
+{
+	for( int i = 0; i < numberOfSides(); i++ )
+	{
+		getASide( i ).Draw();
+	}
+	for( int i = 0; i < numberOfTops(); i++ )
+	{
+		getATop( i ).Draw();
+	}
+}
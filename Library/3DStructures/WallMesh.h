@@ -0,0 +1,52 @@
+/*
+   Project     : 3DMaze
+   File        : WallMesh.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Represents all the walls of a maze as one watertight mesh,
+   				 extruded straight up from the outlines of the walls' footprints
+*/
+
+
+#ifndef WALLMESH_H_
+#define WALLMESH_H_
+
+#include <vector>
+
+#include "TexturedQuad.h"
+#include "WallFootprintUnion.h"
+
+class WallMesh
+{
+	public:
+		WallMesh();
+
+		/*
+		 * changes this mesh so that it has a side for every edge of the given outlines,
+		 * standing up straight in the z-direction with the given height, and a top
+		 * that covers exactly the area inside the outlines
+		 */
+		void fitToOutlines( const WallFootprintUnion & footprints, int heightOfWall, int widthOfTexture, int heightOfTexture );
+
+		void clear();
+
+		/* trades sides and tops with the other mesh, without copying them
+		 */
+		void swap( WallMesh & other );
+		bool isEmpty() const { return sides.empty() && tops.empty(); }
+
+		int numberOfSides() const { return sides.size(); }
+		int numberOfTops() const { return tops.size(); }
+		const TexturedQuad & getASide( int index ) const;
+		const TexturedQuad & getATop( int index ) const;
+
+		/* Draws the mesh using openGL calls
+		 */
+		void Draw() const;
+
+	private:
+		std::vector<TexturedQuad> sides;
+		std::vector<TexturedQuad> tops;
+};
+
+#endif /*WALLMESH_H_*/
@@ -0,0 +1,70 @@
+/*
+   Project     : 3DMaze
+   File        : BacktrackerGenerator.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with a randomized depth first search ( the
+   				 "recursive backtracker" ), keeping its own stack of cells
+   				 instead of recursing, so huge mazes don't overflow the call stack.
+   				 Its mazes have long winding passages with few dead ends
+*/
+
+
+#include "BacktrackerGenerator.h"
+
+#include <vector>
+
+#include "RandomNumbers.h"
+
+using namespace std;
+
+void BacktrackerGenerator::carve( MazeGrid & grid, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	if( grid.numberOfCells() == 0 )
+	{
+		return;
+	}
+
+	RandomNumbers random( seed );
+	vector<bool> visited( grid.numberOfCells(), false );
+	vector<int> path;	// the cells from the start to the current cell, which is on top
+
+	int start = random.below( grid.numberOfCells() );
+	visited[ start ] = true;
+	path.push_back( start );
+	int cellsVisited = 1;
+
+	while( !path.empty() )
+	{
+		int cell = path.back();
+
+		MazeGrid::Direction unvisited[ MazeGrid::number_of_directions ];
+		int numberOfUnvisited = 0;
+		for( int i = 0; i < MazeGrid::number_of_directions; i++ )
+		{
+			MazeGrid::Direction direction = ( MazeGrid::Direction ) i;
+			if( grid.hasNeighbor( cell, direction ) && !visited[ grid.neighbor( cell, direction ) ] )
+			{
+				unvisited[ numberOfUnvisited++ ] = direction;
+			}
+		}
+
+		//back up once there's nowhere new to go from here
+		if( numberOfUnvisited == 0 )
+		{
+			path.pop_back();
+			continue;
+		}
+
+		MazeGrid::Direction direction = unvisited[ random.below( numberOfUnvisited ) ];
+		int next = grid.neighbor( cell, direction );
+		grid.open( cell, direction );
+		visited[ next ] = true;
+		path.push_back( next );
+
+		if( ( ++cellsVisited % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) cellsVisited / grid.numberOfCells() );
+		}
+	}
+}
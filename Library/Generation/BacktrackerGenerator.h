@@ -0,0 +1,28 @@
+/*
+   Project     : 3DMaze
+   File        : BacktrackerGenerator.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with a randomized depth first search ( the
+   				 "recursive backtracker" ), keeping its own stack of cells
+   				 instead of recursing, so huge mazes don't overflow the call stack.
+   				 Its mazes have long winding passages with few dead ends
+*/
+
+
+#ifndef BACKTRACKERGENERATOR_H_
+#define BACKTRACKERGENERATOR_H_
+
+#include "MazeGenerator.h"
+
+class BacktrackerGenerator : public MazeGenerator
+{
+	public:
+		BacktrackerGenerator( uint64_t m_seed ) : MazeGenerator( m_seed ) {}
+
+		//inherited from MazeGenerator
+		void carve( MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & );
+		std::string name() const { return "backtracker"; }
+};
+
+#endif /*BACKTRACKERGENERATOR_H_*/
@@ -0,0 +1,182 @@
+/*
+   Project     : 3DMaze
+   File        : EllerGenerator.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with Eller's algorithm, a row at a time from
+   				 the bottom up, remembering nothing about the rows below but
+   				 which cells of the last row are joined together. Since it
+   				 only ever holds a row, it can stream the walls of a maze far
+   				 too big to hold in memory straight out to a file
+*/
+
+
+#include "EllerGenerator.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "RandomNumbers.h"
+#include "DisjointSets.h"
+#include "WallTracer.h"
+
+using namespace std;
+
+/* carves the rows one after another, keeping track of which cells in the row are joined
+ * by the rows carved so far, every set is named by one of its cells in the row
+ */
+class EllerGenerator::RowCarver
+{
+	public:
+		RowCarver( int m_columns, uint64_t seed ) :
+			columns( m_columns ),
+			random( seed ),
+			sets( m_columns ),
+			setBelow( m_columns, -1 ),
+			firstCellOfSet( m_columns, -1 ),
+			cellsLeftInSet( m_columns, 0 ),
+			carriedUp( m_columns, false ),
+			setOf( m_columns, 0 ) {}
+
+		/* fills in the walls of the next row, a byte of wall bits for each column,
+		 * the last row joins together every set still apart
+		 */
+		void carveARow( bool lastRow, vector<unsigned char> & walls )
+		{
+			//cells opened up to from the row below stay joined the way the cells below them were
+			sets.reset( columns );
+			for( int column = 0; column < columns; column++ )
+			{
+				int set = setBelow[ column ];
+				if( set >= 0 )
+				{
+					if( firstCellOfSet[ set ] < 0 )
+					{
+						firstCellOfSet[ set ] = column;
+					}
+					else
+					{
+						sets.join( firstCellOfSet[ set ], column );
+					}
+				}
+			}
+			for( int column = 0; column < columns; column++ )
+			{
+				if( setBelow[ column ] >= 0 )
+				{
+					firstCellOfSet[ setBelow[ column ] ] = -1;
+				}
+			}
+
+			//join some of the cells next to each other that aren't already joined, or all of them in the last row
+			fill( walls.begin(), walls.end(), WallTracer::east_wall | WallTracer::north_wall );
+			for( int column = 0; column < columns - 1; column++ )
+			{
+				if( ( lastRow || ( random.below( 2 ) == 0 ) ) && sets.join( column, column + 1 ) )
+				{
+					walls[ column ] &= ~WallTracer::east_wall;
+				}
+			}
+			if( lastRow )
+			{
+				return;
+			}
+
+			//open some cells up to the row above, at least one in every set so no set is cut off
+			for( int column = 0; column < columns; column++ )
+			{
+				setOf[ column ] = sets.find( column );
+				cellsLeftInSet[ setOf[ column ] ]++;
+			}
+			for( int column = 0; column < columns; column++ )
+			{
+				int set = setOf[ column ];
+				cellsLeftInSet[ set ]--;
+				bool lastChance = ( cellsLeftInSet[ set ] == 0 ) && !carriedUp[ set ];
+				if( ( random.below( 2 ) == 0 ) || lastChance )
+				{
+					walls[ column ] &= ~WallTracer::north_wall;
+					carriedUp[ set ] = true;
+					setBelow[ column ] = set;
+				}
+				else
+				{
+					setBelow[ column ] = -1;
+				}
+			}
+			for( int column = 0; column < columns; column++ )
+			{
+				carriedUp[ setOf[ column ] ] = false;
+			}
+		}
+
+	private:
+		int columns;
+		RandomNumbers random;
+		DisjointSets sets;
+
+		vector<int> setBelow;			// for each cell, the set of the cell below it if they're joined, or -1
+		vector<int> firstCellOfSet;	// for each set in the row below, the first cell above it joined to it, or -1
+		vector<int> cellsLeftInSet;	// for each set, how many of its cells haven't been looked at yet
+		vector<bool> carriedUp;		// for each set, whether one of its cells has been opened up to the next row
+		vector<int> setOf;				// the set of each cell
+};
+
+
+void EllerGenerator::carve( MazeGrid & grid, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	int columns = grid.getColumns();
+	int rows = grid.getRows();
+	int rowsBetweenCheckIns = max( 1, ProgressMonitor::steps_between_check_ins / max( 1, columns ) );
+
+	RowCarver carver( columns, seed );
+	vector<unsigned char> walls( columns );
+	for( int row = 0; row < rows; row++ )
+	{
+		if( ( row % rowsBetweenCheckIns ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) row / rows );
+		}
+
+		carver.carveARow( row == rows - 1, walls );
+		for( int column = 0; column < columns; column++ )
+		{
+			int cell = grid.cellAt( column, row );
+			if( ( ( walls[ column ] & WallTracer::east_wall ) == 0 ) && grid.hasNeighbor( cell, MazeGrid::east ) )
+			{
+				grid.open( cell, MazeGrid::east );
+			}
+			if( ( ( walls[ column ] & WallTracer::north_wall ) == 0 ) && grid.hasNeighbor( cell, MazeGrid::north ) )
+			{
+				grid.open( cell, MazeGrid::north );
+			}
+		}
+	}
+}
+
+
+/* carves a maze the given number of cells across and up, with each cell cellSize across,
+ * sending its walls on to the sink from the bottom up as each row is carved, and telling
+ * the sink as it goes how far up its lines are finished. It's the same maze carve would carve,
+ * traced the same way, and the walls around the outside are left out just the same
+ */
+void EllerGenerator::stream( int columns, int rows, int cellSize, MazeLineSink & sink, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	int rowsBetweenCheckIns = max( 1, ProgressMonitor::steps_between_check_ins / max( 1, columns ) );
+
+	RowCarver carver( columns, seed );
+	WallTracer tracer( columns, rows, cellSize, sink );
+	vector<unsigned char> walls( columns );
+	for( int row = 0; row < rows; row++ )
+	{
+		if( ( row % rowsBetweenCheckIns ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) row / rows );
+		}
+
+		carver.carveARow( row == rows - 1, walls );
+		tracer.addARow( &walls[ 0 ] );
+	}
+	tracer.finish();
+	ProgressMonitor::checkIn( progress, 1.0 );
+}
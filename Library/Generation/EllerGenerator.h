@@ -0,0 +1,41 @@
+/*
+   Project     : 3DMaze
+   File        : EllerGenerator.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with Eller's algorithm, a row at a time from
+   				 the bottom up, remembering nothing about the rows below but
+   				 which cells of the last row are joined together. Since it
+   				 only ever holds a row, it can stream the walls of a maze far
+   				 too big to hold in memory straight out to a file
+*/
+
+
+#ifndef ELLERGENERATOR_H_
+#define ELLERGENERATOR_H_
+
+#include "MazeGenerator.h"
+#include "MazeLineSink.h"
+
+class EllerGenerator : public MazeGenerator
+{
+	public:
+		EllerGenerator( uint64_t m_seed ) : MazeGenerator( m_seed ) {}
+
+		//inherited from MazeGenerator
+		void carve( MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & );
+		std::string name() const { return "eller"; }
+
+		/* carves a maze the given number of cells across and up, with each cell cellSize across,
+		 * sending its walls on to the sink from the bottom up as each row is carved, and telling
+		 * the sink as it goes how far up its lines are finished. It's the same maze carve would carve,
+		 * traced the same way, and the walls around the outside are left out just the same
+		 */
+		void stream( int columns, int rows, int cellSize, MazeLineSink & sink, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+	private:
+		// carves the rows one after another
+		class RowCarver;
+};
+
+#endif /*ELLERGENERATOR_H_*/
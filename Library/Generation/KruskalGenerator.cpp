@@ -0,0 +1,62 @@
+/*
+   Project     : 3DMaze
+   File        : KruskalGenerator.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with randomized Kruskal's algorithm, knocking
+   				 down the walls in a random order wherever the cells on either
+   				 side aren't already joined, which a union-find keeps track of
+*/
+
+
+#include "KruskalGenerator.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "RandomNumbers.h"
+#include "DisjointSets.h"
+
+using namespace std;
+
+void KruskalGenerator::carve( MazeGrid & grid, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	RandomNumbers random( seed );
+
+	//every wall inside the grid, as its cell times two plus 0 for its east wall or 1 for its north wall
+	vector<int> walls;
+	walls.reserve( 2 * grid.numberOfCells() );
+	for( int cell = 0; cell < grid.numberOfCells(); cell++ )
+	{
+		if( grid.hasNeighbor( cell, MazeGrid::east ) )
+		{
+			walls.push_back( 2 * cell );
+		}
+		if( grid.hasNeighbor( cell, MazeGrid::north ) )
+		{
+			walls.push_back( ( 2 * cell ) + 1 );
+		}
+	}
+
+	//shuffled the same way everywhere ( random_shuffle is free to shuffle differently from one library to the next )
+	for( int i = ( int ) walls.size() - 1; i > 0; i-- )
+	{
+		swap( walls[ i ], walls[ random.below( i + 1 ) ] );
+	}
+
+	DisjointSets joinedCells( grid.numberOfCells() );
+	for( unsigned int i = 0; ( i < walls.size() ) && ( joinedCells.numberOfSets() > 1 ); i++ )
+	{
+		int cell = walls[ i ] / 2;
+		MazeGrid::Direction direction = ( ( walls[ i ] % 2 ) == 0 ) ? MazeGrid::east : MazeGrid::north;
+		if( joinedCells.join( cell, grid.neighbor( cell, direction ) ) )
+		{
+			grid.open( cell, direction );
+		}
+
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) ( grid.numberOfCells() - joinedCells.numberOfSets() ) / grid.numberOfCells() );
+		}
+	}
+}
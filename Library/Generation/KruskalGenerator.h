@@ -0,0 +1,27 @@
+/*
+   Project     : 3DMaze
+   File        : KruskalGenerator.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with randomized Kruskal's algorithm, knocking
+   				 down the walls in a random order wherever the cells on either
+   				 side aren't already joined, which a union-find keeps track of
+*/
+
+
+#ifndef KRUSKALGENERATOR_H_
+#define KRUSKALGENERATOR_H_
+
+#include "MazeGenerator.h"
+
+class KruskalGenerator : public MazeGenerator
+{
+	public:
+		KruskalGenerator( uint64_t m_seed ) : MazeGenerator( m_seed ) {}
+
+		//inherited from MazeGenerator
+		void carve( MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & );
+		std::string name() const { return "kruskal"; }
+};
+
+#endif /*KRUSKALGENERATOR_H_*/
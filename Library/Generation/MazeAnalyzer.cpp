@@ -0,0 +1,432 @@
+/*
+   Project     : 3DMaze
+   File        : MazeAnalyzer.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Measures the shape of a maze, generated or drawn by hand:
+   				 how many separate pieces its open space falls into, how many
+   				 dead ends and junctions it has, how many loops, how long the
+   				 way from its bottom left cell to its top right one is and how
+   				 long the longest way between any two cells is. The pieces are
+   				 found a band of rows at a time on every core, and the bands
+   				 are then joined along the rows between them
+*/
+
+
+#include "MazeAnalyzer.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cmath>
+
+#include "DisjointSets.h"
+
+using namespace std;
+
+namespace
+{
+	/* which side of the line from a to b the point is on, positive to the left, negative to the right
+	 */
+	double sideOf( double ax, double ay, double bx, double by, double px, double py )
+	{
+		return ( ( bx - ax ) * ( py - ay ) ) - ( ( by - ay ) * ( px - ax ) );
+	}
+
+	/* true if the line comes between the two points, touching counts
+	 */
+	bool comesBetween( const LineSegment2D & line, double px, double py, double qx, double qy )
+	{
+		double ax = line.getP1().getX(), ay = line.getP1().getY();
+		double bx = line.getP2().getX(), by = line.getP2().getY();
+		double p = sideOf( ax, ay, bx, by, px, py );
+		double q = sideOf( ax, ay, bx, by, qx, qy );
+		double a = sideOf( px, py, qx, qy, ax, ay );
+		double b = sideOf( px, py, qx, qy, bx, by );
+
+		if( ( p == 0.0 ) && ( q == 0.0 ) )
+		{
+			//a line running along the way between the points blocks it if they overlap at all
+			return ( max( min( ax, bx ), min( px, qx ) ) <= min( max( ax, bx ), max( px, qx ) ) ) &&
+				   ( max( min( ay, by ), min( py, qy ) ) <= min( max( ay, by ), max( py, qy ) ) );
+		}
+		return ( ( ( p <= 0.0 ) && ( q >= 0.0 ) ) || ( ( p >= 0.0 ) && ( q <= 0.0 ) ) ) &&
+			   ( ( ( a <= 0.0 ) && ( b >= 0.0 ) ) || ( ( a >= 0.0 ) && ( b <= 0.0 ) ) );
+	}
+
+	// the passages a line has walled up, kept for each cell like MazeGrid keeps its walls
+	const unsigned char east_blocked = 1;
+	const unsigned char north_blocked = 2;
+}
+
+
+/* finds the pieces one band of rows falls into, as if the rest of the grid weren't there,
+ * and counts the passages out of each of its cells
+ */
+class MazeAnalyzer::Band : public QRunnable
+{
+	public:
+		Band() : pieceSizes(), passages( 0 ), grid( NULL ), labels( NULL ), bandsDone( NULL ), stop( NULL ),
+				 firstRow( 0 ), lastRow( 0 )
+		{
+			setAutoDelete( false );
+			fill( passageCounts, passageCounts + MazeGrid::number_of_directions + 1, 0 );
+		}
+
+		void setUp( const MazeGrid & m_grid, vector<int> & m_labels, QAtomicInt & m_bandsDone, QAtomicInt & m_stop,
+					int m_firstRow, int m_lastRow )
+		{
+			grid = &m_grid;
+			labels = &m_labels;
+			bandsDone = &m_bandsDone;
+			stop = &m_stop;
+			firstRow = m_firstRow;
+			lastRow = m_lastRow;
+		}
+
+		void run()
+		{
+			int columns = grid->getColumns();
+			int firstCell = firstRow * columns;
+			int lastCell = lastRow * columns;
+			DisjointSets pieces( lastCell - firstCell );
+
+			for( int row = firstRow; row < lastRow; row++ )
+			{
+				if( *stop != 0 )
+				{
+					return;
+				}
+
+				for( int cell = row * columns; cell < ( row + 1 ) * columns; cell++ )
+				{
+					int passagesOut = 0;
+					for( int direction = 0; direction < MazeGrid::number_of_directions; direction++ )
+					{
+						MazeGrid::Direction way = ( MazeGrid::Direction ) direction;
+						if( grid->hasNeighbor( cell, way ) && grid->isOpen( cell, way ) )
+						{
+							passagesOut++;
+						}
+					}
+					passageCounts[ passagesOut ]++;
+
+					if( grid->hasNeighbor( cell, MazeGrid::east ) && grid->isOpen( cell, MazeGrid::east ) )
+					{
+						passages++;
+						pieces.join( cell - firstCell, cell + 1 - firstCell );
+					}
+					if( grid->hasNeighbor( cell, MazeGrid::north ) && grid->isOpen( cell, MazeGrid::north ) )
+					{
+						//passages up into the next band are counted here, but joined once every band is done
+						passages++;
+						if( cell + columns < lastCell )
+						{
+							pieces.join( cell - firstCell, cell + columns - firstCell );
+						}
+					}
+				}
+			}
+
+			//the pieces are numbered from 0 in the order their first cells come in
+			vector<int> numberOf( lastCell - firstCell, -1 );
+			for( int cell = firstCell; cell < lastCell; cell++ )
+			{
+				int piece = pieces.find( cell - firstCell );
+				if( numberOf[ piece ] < 0 )
+				{
+					numberOf[ piece ] = pieceSizes.size();
+					pieceSizes.push_back( 0 );
+				}
+				( *labels )[ cell ] = numberOf[ piece ];
+				pieceSizes[ numberOf[ piece ] ]++;
+			}
+			bandsDone->fetchAndAddOrdered( 1 );
+		}
+
+		int getFirstRow() const { return firstRow; }
+		int getLastRow() const { return lastRow; }
+
+		// how many cells each of the band's pieces has
+		vector<int> pieceSizes;
+		int passageCounts[ MazeGrid::number_of_directions + 1 ];
+		long long passages;
+
+	private:
+		const MazeGrid * grid;
+		vector<int> * labels;
+		QAtomicInt * bandsDone;
+		QAtomicInt * stop;
+		int firstRow, lastRow;
+};
+
+
+/* the pieces are found on the given number of threads, or on one thread for each core when that's 0
+ */
+MazeAnalyzer::MazeAnalyzer( int m_numberOfThreads /* = 0 */ ) :
+	numberOfThreads( ( m_numberOfThreads > 0 ) ? m_numberOfThreads : max( 1, QThread::idealThreadCount() ) ),
+	numberOfCells( 0 ),
+	numberOfPassages( 0 ),
+	numberOfComponents( 0 ),
+	largestComponent( 0 ),
+	solutionLength( -1 ),
+	diameter( 0 ),
+	secondsTaken( 0.0 ),
+	labels(),
+	distances(),
+	toVisit()
+{
+	fill( passageCounts, passageCounts + MazeGrid::number_of_directions + 1, 0 );
+}
+
+
+/* fills the grid with cells cellSize across covering the maze, with a passage
+ * between every two neighboring cells that none of the maze's lines come between
+ */
+void MazeAnalyzer::toGrid( const Maze2D & maze, int cellSize, MazeGrid & grid )
+{
+	int columns = max( 1, ( maze.getWidth() + ( cellSize / 2 ) ) / cellSize );
+	int rows = max( 1, ( maze.getHeight() + ( cellSize / 2 ) ) / cellSize );
+	grid = MazeGrid( columns, rows );
+
+	//the maze is centered on the origin, the same as the lines MazeGrid traces
+	double left = -( columns * ( double ) cellSize ) / 2.0;
+	double bottom = -( rows * ( double ) cellSize ) / 2.0;
+
+	vector<unsigned char> blocked( grid.numberOfCells(), 0 );
+	for( int i = 0; i < maze.numberOfLines(); i++ )
+	{
+		const LineSegment2D & line = maze.getALine( i );
+		double minX = min( line.getP1().getX(), line.getP2().getX() );
+		double maxX = max( line.getP1().getX(), line.getP2().getX() );
+		double minY = min( line.getP1().getY(), line.getP2().getY() );
+		double maxY = max( line.getP1().getY(), line.getP2().getY() );
+
+		//only the passages from cells whose centers are within a cell of the line's bounds can be walled up by it
+		int firstColumn = max( 0, ( int ) floor( ( minX - left ) / cellSize ) - 1 );
+		int lastColumn = min( columns - 1, ( int ) floor( ( maxX - left ) / cellSize ) + 1 );
+		int firstRow = max( 0, ( int ) floor( ( minY - bottom ) / cellSize ) - 1 );
+		int lastRow = min( rows - 1, ( int ) floor( ( maxY - bottom ) / cellSize ) + 1 );
+		for( int row = firstRow; row <= lastRow; row++ )
+		{
+			double y = bottom + ( ( row + 0.5 ) * cellSize );
+			for( int column = firstColumn; column <= lastColumn; column++ )
+			{
+				double x = left + ( ( column + 0.5 ) * cellSize );
+				int cell = grid.cellAt( column, row );
+				if( ( column + 1 < columns ) && comesBetween( line, x, y, x + cellSize, y ) )
+				{
+					blocked[ cell ] |= east_blocked;
+				}
+				if( ( row + 1 < rows ) && comesBetween( line, x, y, x, y + cellSize ) )
+				{
+					blocked[ cell ] |= north_blocked;
+				}
+			}
+		}
+	}
+
+	for( int cell = 0; cell < grid.numberOfCells(); cell++ )
+	{
+		if( grid.hasNeighbor( cell, MazeGrid::east ) && ( ( blocked[ cell ] & east_blocked ) == 0 ) )
+		{
+			grid.open( cell, MazeGrid::east );
+		}
+		if( grid.hasNeighbor( cell, MazeGrid::north ) && ( ( blocked[ cell ] & north_blocked ) == 0 ) )
+		{
+			grid.open( cell, MazeGrid::north );
+		}
+	}
+}
+
+
+/* measures the maze, split into cells cellSize across,
+ * throws an OperationCanceled if the progress monitor asks for it to stop
+ */
+void MazeAnalyzer::analyze( const Maze2D & maze, int cellSize /* = MazeGenerator::default_cell_size */,
+							ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	MazeGrid grid;
+	toGrid( maze, cellSize, grid );
+	analyze( grid, progress );
+}
+
+
+void MazeAnalyzer::analyze( const MazeGrid & grid, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	int columns = grid.getColumns();
+	int rows = grid.getRows();
+	numberOfCells = grid.numberOfCells();
+	labels.resize( numberOfCells );
+
+	//a few bands for each thread keeps them all busy to the end, as long as the bands aren't too thin
+	int numberOfBands = max( 1, min( numberOfThreads * 4, rows / min_rows_per_band ) );
+	vector<Band> bands( numberOfBands );
+	QAtomicInt bandsDone( 0 );
+	QAtomicInt stop( 0 );
+	for( int band = 0; band < numberOfBands; band++ )
+	{
+		bands[ band ].setUp( grid, labels, bandsDone, stop,
+							 ( int ) ( ( ( long long ) rows * band ) / numberOfBands ),
+							 ( int ) ( ( ( long long ) rows * ( band + 1 ) ) / numberOfBands ) );
+	}
+
+	QThreadPool pool;
+	pool.setMaxThreadCount( numberOfThreads );
+	for( int band = 0; band < numberOfBands; band++ )
+	{
+		pool.start( &bands[ band ] );
+	}
+	while( !pool.waitForDone( check_in_interval ) )
+	{
+		try
+		{
+			ProgressMonitor::checkIn( progress, ( double ) bandsDone / numberOfBands );
+		}
+		catch( OperationCanceled & oc )
+		{
+			stop.fetchAndStoreOrdered( 1 );
+			pool.waitForDone();
+			throw;
+		}
+	}
+
+	//each band's pieces get numbers of their own, following on from the band below's
+	vector<int> firstPieces( numberOfBands + 1, 0 );
+	numberOfPassages = 0;
+	fill( passageCounts, passageCounts + MazeGrid::number_of_directions + 1, 0 );
+	for( int band = 0; band < numberOfBands; band++ )
+	{
+		firstPieces[ band + 1 ] = firstPieces[ band ] + bands[ band ].pieceSizes.size();
+		numberOfPassages += bands[ band ].passages;
+		for( int passages = 0; passages <= MazeGrid::number_of_directions; passages++ )
+		{
+			passageCounts[ passages ] += bands[ band ].passageCounts[ passages ];
+		}
+	}
+
+	//the pieces that passages up out of the top row of a band lead into are the same piece
+	DisjointSets components( firstPieces[ numberOfBands ] );
+	for( int band = 0; band + 1 < numberOfBands; band++ )
+	{
+		int topRow = bands[ band ].getLastRow() - 1;
+		for( int cell = topRow * columns; cell < ( topRow + 1 ) * columns; cell++ )
+		{
+			if( grid.isOpen( cell, MazeGrid::north ) )
+			{
+				components.join( firstPieces[ band ] + labels[ cell ], firstPieces[ band + 1 ] + labels[ cell + columns ] );
+			}
+		}
+	}
+	numberOfComponents = components.numberOfSets();
+
+	vector<int> componentSizes( firstPieces[ numberOfBands ], 0 );
+	for( int band = 0; band < numberOfBands; band++ )
+	{
+		for( unsigned int piece = 0; piece < bands[ band ].pieceSizes.size(); piece++ )
+		{
+			componentSizes[ components.find( firstPieces[ band ] + piece ) ] += bands[ band ].pieceSizes[ piece ];
+		}
+	}
+	int largest = max_element( componentSizes.begin(), componentSizes.end() ) - componentSizes.begin();
+	largestComponent = componentSizes.empty() ? 0 : componentSizes[ largest ];
+	ProgressMonitor::checkIn( progress, 1.0 );
+
+	int farthest;
+	solutionLength = ( numberOfCells > 0 ) ? breadthFirst( grid, 0, numberOfCells - 1, farthest ) : -1;
+
+	//searching out from any cell of a tree, the farthest cell found is one end of its longest way
+	diameter = 0;
+	for( int band = 0; ( band < numberOfBands ) && ( numberOfCells > 0 ); band++ )
+	{
+		int firstCell = bands[ band ].getFirstRow() * columns;
+		int lastCell = bands[ band ].getLastRow() * columns;
+		int cell = firstCell;
+		while( ( cell < lastCell ) && ( components.find( firstPieces[ band ] + labels[ cell ] ) != largest ) )
+		{
+			cell++;
+		}
+		if( cell < lastCell )
+		{
+			breadthFirst( grid, cell, -1, farthest );
+			diameter = breadthFirst( grid, farthest, -1, farthest );
+			break;
+		}
+	}
+
+	secondsTaken = timer.nsecsElapsed() / 1e9;
+}
+
+
+/* searches out from the start through the grid's passages, returning how far it is to the target,
+ * or when the target is -1, how far it is to the farthest cell, which it sets farthest to
+ */
+int MazeAnalyzer::breadthFirst( const MazeGrid & grid, int start, int target, int & farthest )
+{
+	distances.assign( grid.numberOfCells(), -1 );
+	toVisit.resize( grid.numberOfCells() );
+
+	int next = 0;
+	int end = 0;
+	distances[ start ] = 0;
+	toVisit[ end++ ] = start;
+	farthest = start;
+	while( next < end )
+	{
+		int cell = toVisit[ next++ ];
+		if( cell == target )
+		{
+			return distances[ cell ];
+		}
+		farthest = cell;
+
+		for( int direction = 0; direction < MazeGrid::number_of_directions; direction++ )
+		{
+			MazeGrid::Direction way = ( MazeGrid::Direction ) direction;
+			if( grid.hasNeighbor( cell, way ) && grid.isOpen( cell, way ) )
+			{
+				int neighbor = grid.neighbor( cell, way );
+				if( distances[ neighbor ] < 0 )
+				{
+					distances[ neighbor ] = distances[ cell ] + 1;
+					toVisit[ end++ ] = neighbor;
+				}
+			}
+		}
+	}
+	return ( target < 0 ) ? distances[ farthest ] : -1;
+}
+
+
+/* writes everything measured out, a line at a time
+ */
+void MazeAnalyzer::report( ostream & out ) const
+{
+	out << numberOfCells << " cells, " << numberOfPassages << " passages" << endl;
+	out << "  pieces: " << numberOfComponents << " ( the biggest has " << largestComponent << " cells )" << endl;
+	out << "  dead ends: " << getDeadEnds() << ", junctions: " << getJunctions() << endl;
+	out << "  cells by passages out:";
+	for( int passages = 0; passages <= MazeGrid::number_of_directions; passages++ )
+	{
+		out << "  " << passages << ": " << passageCounts[ passages ];
+	}
+	out << endl;
+	out << "  loops: " << getLoops() << ( isPerfect() ? " ( a perfect maze )" : "" ) << endl;
+	if( solutionLength < 0 )
+	{
+		out << "  solution: none, the bottom left and top right cells aren't joined" << endl;
+	}
+	else
+	{
+		out << "  solution: " << solutionLength << " passages from the bottom left cell to the top right one" << endl;
+	}
+	out << "  diameter: " << ( ( getLoops() == 0 ) ? "" : "at least " ) << diameter << " passages" << endl;
+	out << "  analyzed in " << secondsTaken << " s on " << numberOfThreads << " threads" << endl;
+}
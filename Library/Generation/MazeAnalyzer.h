@@ -0,0 +1,119 @@
+/*
+   Project     : 3DMaze
+   File        : MazeAnalyzer.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Measures the shape of a maze, generated or drawn by hand:
+   				 how many separate pieces its open space falls into, how many
+   				 dead ends and junctions it has, how many loops, how long the
+   				 way from its bottom left cell to its top right one is and how
+   				 long the longest way between any two cells is. The pieces are
+   				 found a band of rows at a time on every core, and the bands
+   				 are then joined along the rows between them
+*/
+
+
+#ifndef MAZEANALYZER_H_
+#define MAZEANALYZER_H_
+
+#include <vector>
+#include <ostream>
+
+#include "MazeGrid.h"
+#include "MazeGenerator.h"
+#include "Maze2D.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+class MazeAnalyzer
+{
+	public:
+		/* the pieces are found on the given number of threads, or on one thread for each core when that's 0
+		 */
+		MazeAnalyzer( int m_numberOfThreads = 0 );
+
+		/* fills the grid with cells cellSize across covering the maze, with a passage
+		 * between every two neighboring cells that none of the maze's lines come between
+		 */
+		static void toGrid( const Maze2D & maze, int cellSize, MazeGrid & grid );
+
+		/* measures the maze, split into cells cellSize across,
+		 * throws an OperationCanceled if the progress monitor asks for it to stop
+		 */
+		void analyze( const Maze2D & maze, int cellSize = MazeGenerator::default_cell_size, ProgressMonitor * progress = NULL ) throw( IOError & );
+		void analyze( const MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		int getNumberOfCells() const { return numberOfCells; }
+		long long getNumberOfPassages() const { return numberOfPassages; }
+
+		/* how many separate pieces the cells fall into, and how many cells the biggest one has
+		 */
+		int getNumberOfComponents() const { return numberOfComponents; }
+		int getLargestComponent() const { return largestComponent; }
+
+		/* how many cells have the given number of passages out of them, from 0 to 4
+		 */
+		int cellsWithPassages( int passages ) const { return passageCounts[ passages ]; }
+		int getDeadEnds() const { return passageCounts[ 1 ]; }
+		int getJunctions() const { return passageCounts[ 3 ] + passageCounts[ 4 ]; }
+
+		/* how many passages could be walled up without splitting any piece in two
+		 */
+		long long getLoops() const { return numberOfPassages - numberOfCells + numberOfComponents; }
+
+		/* true if there's exactly one way from every cell to every other
+		 */
+		bool isPerfect() const { return ( numberOfComponents == 1 ) && ( getLoops() == 0 ); }
+
+		/* how many passages the shortest way from the bottom left cell to the top right one goes through,
+		 * or -1 if there's no way between them
+		 */
+		int getSolutionLength() const { return solutionLength; }
+
+		/* how many passages the longest of the shortest ways between two cells of the biggest piece goes through,
+		 * this is exact for a piece without loops, but may fall short for one with them
+		 */
+		int getDiameter() const { return diameter; }
+
+		/* how long the last analysis took, in seconds
+		 */
+		double getSecondsTaken() const { return secondsTaken; }
+		int getNumberOfThreads() const { return numberOfThreads; }
+
+		/* writes everything measured out, a line at a time
+		 */
+		void report( std::ostream & out ) const;
+
+		// how often, in milliseconds, progress is reported while the pieces are found
+		static const int check_in_interval = 50;
+
+		// how many rows each band has at least, fewer and the joins between them would be most of the work
+		static const int min_rows_per_band = 64;
+
+	private:
+		int numberOfThreads;
+
+		int numberOfCells;
+		long long numberOfPassages;
+		int numberOfComponents;
+		int largestComponent;
+		int passageCounts[ MazeGrid::number_of_directions + 1 ];
+		int solutionLength;
+		int diameter;
+		double secondsTaken;
+
+		// for each cell, which of its band's pieces it's in, and how far the last breadth first search took to reach it
+		std::vector<int> labels;
+		std::vector<int> distances;
+		std::vector<int> toVisit;
+
+		/* searches out from the start through the grid's passages, returning how far it is to the target,
+		 * or when the target is -1, how far it is to the farthest cell, which it sets farthest to
+		 */
+		int breadthFirst( const MazeGrid & grid, int start, int target, int & farthest );
+
+		// a band of rows to find the pieces of, on a thread of its own
+		class Band;
+};
+
+#endif /*MAZEANALYZER_H_*/
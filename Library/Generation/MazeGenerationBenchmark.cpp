@@ -0,0 +1,199 @@
+/*
+   Project     : 3DMaze
+   File        : MazeGenerationBenchmark.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Times how many cells a second each maze generator carves,
+   				 and checks that every one of them carves a perfect maze
+   				 and carves the same maze every time for the same seed.
+   				 Tiled generation is timed on more and more threads too
+*/
+
+
+#include "MazeGenerationBenchmark.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <string>
+#include <sstream>
+#include <memory>
+#include <algorithm>
+
+#include "MazeGenerator.h"
+#include "ParallelTiledGenerator.h"
+#include "MazeLineSink.h"
+#include "DisjointSets.h"
+
+using namespace std;
+
+namespace
+{
+	/* counts the lines it's sent, without keeping them
+	 */
+	class CountingLineSink : public MazeLineSink
+	{
+		public:
+			CountingLineSink() : linesCounted( 0 ) {}
+			void addALine( const LineSegment2D & ) throw( IOError & ) { linesCounted++; }
+			int linesCounted;
+	};
+
+	double secondsSince( const QElapsedTimer & timer )
+	{
+		return timer.nsecsElapsed() / 1e9;
+	}
+}
+
+
+/* carves a grid of the given size with each generator a number of times, and writes
+ * the best time of each to out, along with how long turning its walls into lines took,
+ * throws an IOError if a generator doesn't carve a perfect maze, or carves a different one for the same seed
+ */
+void MazeGenerationBenchmark::run( int columns, int rows, uint64_t seed, ostream & out, int numberOfRuns /* = default_number_of_runs */ ) throw( IOError & )
+{
+	double cells = ( double ) columns * rows;
+	out << columns << " x " << rows << " cells, seed " << seed << endl;
+
+	istringstream names( MazeGenerator::names );
+	string name;
+	while( names >> name )
+	{
+		auto_ptr<MazeGenerator> generator( MazeGenerator::create( name, seed ) );
+
+		MazeGrid firstGrid;
+		double bestCarveTime = -1.0;
+		for( int run = 0; run < numberOfRuns; run++ )
+		{
+			MazeGrid grid( columns, rows );
+			QElapsedTimer timer;
+			timer.start();
+			generator->carve( grid );
+			double carveTime = secondsSince( timer );
+			if( ( bestCarveTime < 0.0 ) || ( carveTime < bestCarveTime ) )
+			{
+				bestCarveTime = carveTime;
+			}
+
+			//every run has to carve the same maze
+			if( run == 0 )
+			{
+				firstGrid = grid;
+			}
+			else if( grid.getWalls() != firstGrid.getWalls() )
+			{
+				throw IOError();
+			}
+		}
+
+		if( !isPerfect( firstGrid ) )
+		{
+			throw IOError();
+		}
+
+		CountingLineSink sink;
+		QElapsedTimer timer;
+		timer.start();
+		firstGrid.traceWalls( MazeGenerator::default_cell_size, sink );
+		double traceTime = secondsSince( timer );
+
+		out << "  " << name << ": carved in " << bestCarveTime << " s";
+		if( bestCarveTime > 0.0 )
+		{
+			out << " ( " << ( cells / bestCarveTime ) << " cells/s )";
+		}
+		out << ", " << sink.linesCounted << " lines traced in " << traceTime << " s";
+		if( traceTime > 0.0 )
+		{
+			out << " ( " << ( cells / traceTime ) << " cells/s )";
+		}
+		out << endl;
+	}
+}
+
+
+/* carves a grid of the given size in tiles, each carved by the generator with the given name,
+ * on 1, 2, 4 and so on threads up to one for each core, and writes the best time of each to out,
+ * throws an IOError if the maze isn't perfect, or isn't the same maze on every number of threads
+ */
+void MazeGenerationBenchmark::runTiled( int columns, int rows, uint64_t seed, const string & tileGeneratorName, int tilesAcross,
+										ostream & out, int numberOfRuns /* = default_number_of_runs */ ) throw( IOError & )
+{
+	double cells = ( double ) columns * rows;
+	out << columns << " x " << rows << " cells in " << tilesAcross << " x " << tilesAcross << " tiles carved by " << tileGeneratorName << ", seed " << seed << endl;
+
+	int maxThreads = max( 1, QThread::idealThreadCount() );
+	MazeGrid firstGrid;
+	double oneThreadTime = -1.0;
+	for( int threads = 1; ; threads = min( threads * 2, maxThreads ) )
+	{
+		ParallelTiledGenerator generator( seed, tileGeneratorName, tilesAcross, tilesAcross, threads );
+
+		double bestCarveTime = -1.0;
+		for( int run = 0; run < numberOfRuns; run++ )
+		{
+			MazeGrid grid( columns, rows );
+			QElapsedTimer timer;
+			timer.start();
+			generator.carve( grid );
+			double carveTime = secondsSince( timer );
+			if( ( bestCarveTime < 0.0 ) || ( carveTime < bestCarveTime ) )
+			{
+				bestCarveTime = carveTime;
+			}
+
+			//every run, on every number of threads, has to carve the same maze
+			if( ( threads == 1 ) && ( run == 0 ) )
+			{
+				firstGrid = grid;
+			}
+			else if( grid.getWalls() != firstGrid.getWalls() )
+			{
+				throw IOError();
+			}
+		}
+		if( threads == 1 )
+		{
+			oneThreadTime = bestCarveTime;
+		}
+
+		out << "  " << threads << " thread" << ( ( threads == 1 ) ? "" : "s" ) << ": carved in " << bestCarveTime << " s";
+		if( bestCarveTime > 0.0 )
+		{
+			out << " ( " << ( cells / bestCarveTime ) << " cells/s, " << ( oneThreadTime / bestCarveTime ) << " times one thread )";
+		}
+		out << endl;
+
+		if( threads == maxThreads )
+		{
+			break;
+		}
+	}
+
+	if( !isPerfect( firstGrid ) )
+	{
+		throw IOError();
+	}
+}
+
+
+/* true if there's exactly one way from every cell of the grid to every other
+ */
+bool MazeGenerationBenchmark::isPerfect( const MazeGrid & grid )
+{
+	//a perfect maze is a tree, every passage joins two cells that weren't joined before and in the end they're all joined
+	DisjointSets joinedCells( grid.numberOfCells() );
+	for( int cell = 0; cell < grid.numberOfCells(); cell++ )
+	{
+		for( int i = 0; i < 2; i++ )
+		{
+			MazeGrid::Direction direction = ( i == 0 ) ? MazeGrid::east : MazeGrid::north;
+			if( grid.hasNeighbor( cell, direction ) && grid.isOpen( cell, direction ) &&
+				!joinedCells.join( cell, grid.neighbor( cell, direction ) ) )
+			{
+				return false;
+			}
+		}
+	}
+	return joinedCells.numberOfSets() <= 1;
+}
@@ -0,0 +1,46 @@
+/*
+   Project     : 3DMaze
+   File        : MazeGenerationBenchmark.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Times how many cells a second each maze generator carves,
+   				 and checks that every one of them carves a perfect maze
+   				 and carves the same maze every time for the same seed.
+   				 Tiled generation is timed on more and more threads too
+*/
+
+
+#ifndef MAZEGENERATIONBENCHMARK_H_
+#define MAZEGENERATIONBENCHMARK_H_
+
+#include <iostream>
+#include <string>
+#include <stdint.h>
+
+#include "MazeGrid.h"
+#include "IOError.h"
+
+class MazeGenerationBenchmark
+{
+	public:
+		/* carves a grid of the given size with each generator a number of times, and writes
+		 * the best time of each to out, along with how long turning its walls into lines took,
+		 * throws an IOError if a generator doesn't carve a perfect maze, or carves a different one for the same seed
+		 */
+		static void run( int columns, int rows, uint64_t seed, std::ostream & out, int numberOfRuns = default_number_of_runs ) throw( IOError & );
+
+		/* carves a grid of the given size in tiles, each carved by the generator with the given name,
+		 * on 1, 2, 4 and so on threads up to one for each core, and writes the best time of each to out,
+		 * throws an IOError if the maze isn't perfect, or isn't the same maze on every number of threads
+		 */
+		static void runTiled( int columns, int rows, uint64_t seed, const std::string & tileGeneratorName, int tilesAcross,
+							  std::ostream & out, int numberOfRuns = default_number_of_runs ) throw( IOError & );
+
+		/* true if there's exactly one way from every cell of the grid to every other
+		 */
+		static bool isPerfect( const MazeGrid & grid );
+
+		static const int default_number_of_runs = 3;
+};
+
+#endif /*MAZEGENERATIONBENCHMARK_H_*/
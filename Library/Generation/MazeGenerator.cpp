@@ -0,0 +1,74 @@
+/*
+   Project     : 3DMaze
+   File        : MazeGenerator.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Something that carves a perfect maze ( exactly one way from
+   				 every cell to every other ) out of a grid, always carving
+   				 the same maze for the same seed
+*/
+
+
+#include "MazeGenerator.h"
+
+#include "MazeLineSink.h"
+#include "BacktrackerGenerator.h"
+#include "KruskalGenerator.h"
+#include "PrimGenerator.h"
+#include "WilsonGenerator.h"
+#include "EllerGenerator.h"
+
+using namespace std;
+
+const char * const MazeGenerator::names = "backtracker kruskal prim wilson eller";
+
+MazeGenerator::MazeGenerator( uint64_t m_seed ) :
+	seed( m_seed ) {}
+
+
+/* replaces the maze with a newly carved one, the given number of cells across and up,
+ * with each cell cellSize across, and with walls that run along the same straight line merged together
+ * ( the maze isn't normalized, which would split the walls wherever other walls meet them )
+ */
+void MazeGenerator::generate( int columns, int rows, int cellSize, Maze2D & maze, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	MazeGrid grid( columns, rows );
+	ProgressRange carving( progress, 0.0, 0.8 );
+	carve( grid, &carving );
+
+	Maze2D generatedMaze( columns * cellSize, rows * cellSize );
+	Maze2DLineSink sink( generatedMaze );
+	grid.traceWalls( cellSize, sink );
+	ProgressMonitor::checkIn( progress, 1.0 );
+
+	maze.swap( generatedMaze );
+}
+
+
+/* makes the generator with the given name, which the caller has to delete,
+ * or returns NULL if there's no generator with that name
+ */
+MazeGenerator * MazeGenerator::create( const string & name, uint64_t seed )
+{
+	if( name == "backtracker" )
+	{
+		return new BacktrackerGenerator( seed );
+	}
+	else if( name == "kruskal" )
+	{
+		return new KruskalGenerator( seed );
+	}
+	else if( name == "prim" )
+	{
+		return new PrimGenerator( seed );
+	}
+	else if( name == "wilson" )
+	{
+		return new WilsonGenerator( seed );
+	}
+	else if( name == "eller" )
+	{
+		return new EllerGenerator( seed );
+	}
+	return NULL;
+}
@@ -0,0 +1,64 @@
+/*
+   Project     : 3DMaze
+   File        : MazeGenerator.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Something that carves a perfect maze ( exactly one way from
+   				 every cell to every other ) out of a grid, always carving
+   				 the same maze for the same seed
+*/
+
+
+#ifndef MAZEGENERATOR_H_
+#define MAZEGENERATOR_H_
+
+#include <string>
+#include <stdint.h>
+
+#include "MazeGrid.h"
+#include "Maze2D.h"
+#include "ProgressMonitor.h"
+#include "IOError.h"
+
+class MazeGenerator
+{
+	public:
+		MazeGenerator( uint64_t m_seed );
+		virtual ~MazeGenerator() {}
+
+		/* knocks down walls in the grid, which must have every wall in place to begin with,
+		 * until it's a perfect maze, throws an OperationCanceled if the progress monitor
+		 * asks for carving to stop, which leaves the grid half carved
+		 */
+		virtual void carve( MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & ) = 0;
+
+		virtual std::string name() const = 0;
+
+		/* replaces the maze with a newly carved one, the given number of cells across and up,
+		 * with each cell cellSize across, and with walls that run along the same straight line merged together
+		 * ( the maze isn't normalized, which would split the walls wherever other walls meet them )
+		 */
+		void generate( int columns, int rows, int cellSize, Maze2D & maze, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		uint64_t getSeed() const { return seed; }
+
+		/* makes the generator with the given name, which the caller has to delete,
+		 * or returns NULL if there's no generator with that name
+		 */
+		static MazeGenerator * create( const std::string & name, uint64_t seed );
+
+		// the names create accepts, separated by spaces
+		static const char * const names;
+
+		static const int default_cell_size = 30;
+
+	protected:
+		uint64_t seed;
+
+	private:
+		// disable copying
+		MazeGenerator( const MazeGenerator & );
+		const MazeGenerator & operator=( const MazeGenerator & );
+};
+
+#endif /*MAZEGENERATOR_H_*/
@@ -0,0 +1,129 @@
+/*
+   Project     : 3DMaze
+   File        : MazeGrid.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A rectangular grid of square cells with a wall between every
+   				 pair of neighboring cells to begin with, which maze generators
+   				 carve passages through. Each cell only keeps the walls on its
+   				 east and north sides, in a single byte
+*/
+
+
+#include "MazeGrid.h"
+
+/* every wall starts out in place
+ */
+MazeGrid::MazeGrid( int m_columns /* = 0 */, int m_rows /* = 0 */ ) :
+	columns( m_columns ),
+	rows( m_rows ),
+	walls( m_columns * m_rows, WallTracer::east_wall | WallTracer::north_wall ) {}
+
+
+/* false when the cell is on the edge of the grid in that direction
+ */
+bool MazeGrid::hasNeighbor( int cell, Direction direction ) const
+{
+	switch( direction )
+	{
+		case east:
+			return columnOf( cell ) < columns - 1;
+		case north:
+			return cell < ( rows - 1 ) * columns;
+		case west:
+			return columnOf( cell ) > 0;
+		default:
+			return cell >= columns;
+	}
+}
+
+int MazeGrid::neighbor( int cell, Direction direction ) const
+{
+	switch( direction )
+	{
+		case east:
+			return cell + 1;
+		case north:
+			return cell + columns;
+		case west:
+			return cell - 1;
+		default:
+			return cell - columns;
+	}
+}
+
+
+/* true if there's no wall between the cell and its neighbor in that direction
+ */
+bool MazeGrid::isOpen( int cell, Direction direction ) const
+{
+	switch( direction )
+	{
+		case east:
+			return ( walls[ cell ] & WallTracer::east_wall ) == 0;
+		case north:
+			return ( walls[ cell ] & WallTracer::north_wall ) == 0;
+		case west:
+			return ( walls[ cell - 1 ] & WallTracer::east_wall ) == 0;
+		default:
+			return ( walls[ cell - columns ] & WallTracer::north_wall ) == 0;
+	}
+}
+
+
+/* knocks down the wall between the cell and its neighbor in that direction
+ */
+void MazeGrid::open( int cell, Direction direction )
+{
+	//the wall is kept by whichever of the two cells is west or south of the other
+	switch( direction )
+	{
+		case east:
+			walls[ cell ] &= ~WallTracer::east_wall;
+			break;
+		case north:
+			walls[ cell ] &= ~WallTracer::north_wall;
+			break;
+		case west:
+			walls[ cell - 1 ] &= ~WallTracer::east_wall;
+			break;
+		default:
+			walls[ cell - columns ] &= ~WallTracer::north_wall;
+			break;
+	}
+}
+
+
+/* the number of walls that have been knocked down, a perfect maze
+ * has exactly one less than it has cells
+ */
+int MazeGrid::numberOfPassages() const
+{
+	int passages = 0;
+	for( int cell = 0; cell < numberOfCells(); cell++ )
+	{
+		if( hasNeighbor( cell, east ) && isOpen( cell, east ) )
+		{
+			passages++;
+		}
+		if( hasNeighbor( cell, north ) && isOpen( cell, north ) )
+		{
+			passages++;
+		}
+	}
+	return passages;
+}
+
+
+/* sends a line for every straight run of walls inside the grid to the sink,
+ * with the grid centered on the origin like a Maze2D of the same size
+ */
+void MazeGrid::traceWalls( int cellSize, MazeLineSink & sink ) const throw( IOError & )
+{
+	WallTracer tracer( columns, rows, cellSize, sink );
+	for( int row = 0; row < rows; row++ )
+	{
+		tracer.addARow( &walls[ cellAt( 0, row ) ] );
+	}
+	tracer.finish();
+}
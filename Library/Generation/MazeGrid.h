@@ -0,0 +1,74 @@
+/*
+   Project     : 3DMaze
+   File        : MazeGrid.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A rectangular grid of square cells with a wall between every
+   				 pair of neighboring cells to begin with, which maze generators
+   				 carve passages through. Each cell only keeps the walls on its
+   				 east and north sides, in a single byte
+*/
+
+
+#ifndef MAZEGRID_H_
+#define MAZEGRID_H_
+
+#include <vector>
+
+#include "WallTracer.h"
+#include "MazeLineSink.h"
+#include "IOError.h"
+
+class MazeGrid
+{
+	public:
+		enum Direction { east = 0, north = 1, west = 2, south = 3 };
+		static const int number_of_directions = 4;
+
+		/* every wall starts out in place
+		 */
+		MazeGrid( int m_columns = 0, int m_rows = 0 );
+
+		int getColumns() const { return columns; }
+		int getRows() const { return rows; }
+		int numberOfCells() const { return columns * rows; }
+
+		/* cells are numbered a row at a time, from the bottom left
+		 */
+		int cellAt( int column, int row ) const { return ( row * columns ) + column; }
+		int columnOf( int cell ) const { return cell % columns; }
+		int rowOf( int cell ) const { return cell / columns; }
+
+		/* false when the cell is on the edge of the grid in that direction
+		 */
+		bool hasNeighbor( int cell, Direction direction ) const;
+		int neighbor( int cell, Direction direction ) const;
+
+		/* true if there's no wall between the cell and its neighbor in that direction
+		 */
+		bool isOpen( int cell, Direction direction ) const;
+
+		/* knocks down the wall between the cell and its neighbor in that direction
+		 */
+		void open( int cell, Direction direction );
+
+		/* the number of walls that have been knocked down, a perfect maze
+		 * has exactly one less than it has cells
+		 */
+		int numberOfPassages() const;
+
+		/* sends a line for every straight run of walls inside the grid to the sink,
+		 * with the grid centered on the origin like a Maze2D of the same size
+		 */
+		void traceWalls( int cellSize, MazeLineSink & sink ) const throw( IOError & );
+
+		/* the bits of every cell's walls ( WallTracer::east_wall and WallTracer::north_wall ), a row at a time
+		 */
+		const std::vector<unsigned char> & getWalls() const { return walls; }
+
+	private:
+		int columns, rows;
+		std::vector<unsigned char> walls;
+};
+
+#endif /*MAZEGRID_H_*/
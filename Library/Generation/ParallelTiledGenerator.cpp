@@ -0,0 +1,275 @@
+/*
+   Project     : 3DMaze
+   File        : ParallelTiledGenerator.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze in tiles, each carved on a thread of its own
+   				 by another generator, then joins the tiles with one passage
+   				 along each border of a spanning tree of the tiles. Every tile
+   				 is a perfect maze and so is the tree joining them, so the whole
+   				 grid is a perfect maze. The maze depends only on the seed, the
+   				 generator and the number of tiles, never on the threads
+*/
+
+
+#include "ParallelTiledGenerator.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+
+#include "RandomNumbers.h"
+#include "DisjointSets.h"
+
+using namespace std;
+
+namespace
+{
+	/* tells a tile's generator to stop once the stop flag is raised,
+	 * the tile's own progress isn't reported, only how many tiles are done
+	 */
+	class StopFlagMonitor : public ProgressMonitor
+	{
+		public:
+			StopFlagMonitor( QAtomicInt & m_stop ) : stop( m_stop ) {}
+
+			void reportProgress( double ) {}
+			bool wasCanceled() const { return stop != 0; }
+
+		private:
+			QAtomicInt & stop;
+	};
+
+	/* where each of the given number of parts of a length starts, followed by the length itself
+	 */
+	vector<int> startsOfParts( int length, int numberOfParts )
+	{
+		vector<int> starts( numberOfParts + 1 );
+		for( int i = 0; i <= numberOfParts; i++ )
+		{
+			starts[ i ] = ( int ) ( ( ( long long ) length * i ) / numberOfParts );
+		}
+		return starts;
+	}
+}
+
+
+/* one tile, carved into a grid of its own on a thread of its own,
+ * then copied into its place in the whole grid, which no other tile touches
+ */
+class ParallelTiledGenerator::Tile : public QRunnable
+{
+	public:
+		Tile() :
+			grid( NULL ),
+			firstColumn( 0 ),
+			firstRow( 0 ),
+			columns( 0 ),
+			rows( 0 ),
+			seed( 0 ),
+			generatorName(),
+			tilesDone( NULL ),
+			stop( NULL ),
+			failed( false )
+		{
+			setAutoDelete( false );
+		}
+
+		void setUp( MazeGrid & m_grid, int m_firstColumn, int m_firstRow, int m_columns, int m_rows, uint64_t m_seed,
+					const string & m_generatorName, QAtomicInt & m_tilesDone, QAtomicInt & m_stop )
+		{
+			grid = &m_grid;
+			firstColumn = m_firstColumn;
+			firstRow = m_firstRow;
+			columns = m_columns;
+			rows = m_rows;
+			seed = m_seed;
+			generatorName = m_generatorName;
+			tilesDone = &m_tilesDone;
+			stop = &m_stop;
+		}
+
+		bool hasFailed() const { return failed; }
+
+		void run()
+		{
+			try
+			{
+				auto_ptr<MazeGenerator> generator( MazeGenerator::create( generatorName, seed ) );
+				if( generator.get() == NULL )
+				{
+					throw IOError();
+				}
+
+				MazeGrid tile( columns, rows );
+				StopFlagMonitor stopFlag( *stop );
+				generator->carve( tile, &stopFlag );
+
+				//only the walls inside the tile are copied, the walls along its east and north borders stay up
+				for( int row = 0; row < rows; row++ )
+				{
+					for( int column = 0; column < columns; column++ )
+					{
+						int tileCell = tile.cellAt( column, row );
+						int cell = grid->cellAt( firstColumn + column, firstRow + row );
+						if( tile.hasNeighbor( tileCell, MazeGrid::east ) && tile.isOpen( tileCell, MazeGrid::east ) )
+						{
+							grid->open( cell, MazeGrid::east );
+						}
+						if( tile.hasNeighbor( tileCell, MazeGrid::north ) && tile.isOpen( tileCell, MazeGrid::north ) )
+						{
+							grid->open( cell, MazeGrid::north );
+						}
+					}
+				}
+				tilesDone->fetchAndAddOrdered( 1 );
+			}
+			catch( IOError & ioe )
+			{
+				// the other tiles have no reason to carry on
+				failed = true;
+				stop->fetchAndStoreOrdered( 1 );
+			}
+		}
+
+	private:
+		MazeGrid * grid;
+		int firstColumn, firstRow;
+		int columns, rows;
+		uint64_t seed;
+		string generatorName;
+		QAtomicInt * tilesDone;
+		QAtomicInt * stop;
+		bool failed;
+};
+
+
+/* the tiles are carved by the generator with the given name, the grid is cut into
+ * tilesAcross by tilesUp tiles ( or fewer, if the grid has fewer cells than that ),
+ * which are carved on the given number of threads, or on one thread for each core when that's 0
+ */
+ParallelTiledGenerator::ParallelTiledGenerator( uint64_t m_seed, const string & m_tileGeneratorName,
+												int m_tilesAcross /* = default_tiles_across */, int m_tilesUp /* = default_tiles_across */,
+												int m_numberOfThreads /* = 0 */ ) :
+	MazeGenerator( m_seed ),
+	tileGeneratorName( m_tileGeneratorName ),
+	tilesAcross( max( 1, m_tilesAcross ) ),
+	tilesUp( max( 1, m_tilesUp ) ),
+	numberOfThreads( ( m_numberOfThreads > 0 ) ? m_numberOfThreads : max( 1, QThread::idealThreadCount() ) ) {}
+
+
+/* throws an IOError if there's no generator with the name given for the tiles
+ */
+void ParallelTiledGenerator::carve( MazeGrid & grid, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	vector<int> columnStarts = startsOfParts( grid.getColumns(), max( 1, min( tilesAcross, grid.getColumns() ) ) );
+	vector<int> rowStarts = startsOfParts( grid.getRows(), max( 1, min( tilesUp, grid.getRows() ) ) );
+	int across = columnStarts.size() - 1;
+	int up = rowStarts.size() - 1;
+	int numberOfTiles = across * up;
+
+	//every tile gets a seed of its own, numbered the same way however many threads there are
+	QAtomicInt tilesDone( 0 );
+	QAtomicInt stop( 0 );
+	vector<Tile> tiles( numberOfTiles );
+	for( int tileRow = 0; tileRow < up; tileRow++ )
+	{
+		for( int tileColumn = 0; tileColumn < across; tileColumn++ )
+		{
+			int tile = ( tileRow * across ) + tileColumn;
+			tiles[ tile ].setUp( grid, columnStarts[ tileColumn ], rowStarts[ tileRow ],
+								 columnStarts[ tileColumn + 1 ] - columnStarts[ tileColumn ], rowStarts[ tileRow + 1 ] - rowStarts[ tileRow ],
+								 RandomNumbers::seedFor( seed, tile ), tileGeneratorName, tilesDone, stop );
+		}
+	}
+
+	QThreadPool pool;
+	pool.setMaxThreadCount( numberOfThreads );
+	for( int tile = 0; tile < numberOfTiles; tile++ )
+	{
+		pool.start( &tiles[ tile ] );
+	}
+
+	while( !pool.waitForDone( check_in_interval ) )
+	{
+		try
+		{
+			ProgressMonitor::checkIn( progress, ( double ) tilesDone / numberOfTiles );
+		}
+		catch( OperationCanceled & oc )
+		{
+			stop.fetchAndStoreOrdered( 1 );
+			pool.waitForDone();
+			throw;
+		}
+	}
+
+	for( int tile = 0; tile < numberOfTiles; tile++ )
+	{
+		if( tiles[ tile ].hasFailed() )
+		{
+			throw IOError();
+		}
+	}
+
+	joinTiles( grid, columnStarts, rowStarts );
+	ProgressMonitor::checkIn( progress, 1.0 );
+}
+
+
+/* opens one wall along the border between each pair of tiles joined by a random spanning tree of the tiles
+ */
+void ParallelTiledGenerator::joinTiles( MazeGrid & grid, const vector<int> & columnStarts, const vector<int> & rowStarts )
+{
+	RandomNumbers random( seed );
+	int across = columnStarts.size() - 1;
+	int up = rowStarts.size() - 1;
+
+	//every border between tiles, as the tile west or south of it times two plus 0 for its east border or 1 for its north border
+	vector<int> borders;
+	for( int tile = 0; tile < across * up; tile++ )
+	{
+		if( ( tile % across ) < across - 1 )
+		{
+			borders.push_back( 2 * tile );
+		}
+		if( ( tile / across ) < up - 1 )
+		{
+			borders.push_back( ( 2 * tile ) + 1 );
+		}
+	}
+	for( int i = ( int ) borders.size() - 1; i > 0; i-- )
+	{
+		swap( borders[ i ], borders[ random.below( i + 1 ) ] );
+	}
+
+	//Kruskal's algorithm over the tiles, opening a random wall along every border it keeps
+	DisjointSets joinedTiles( across * up );
+	for( unsigned int i = 0; i < borders.size(); i++ )
+	{
+		int tile = borders[ i ] / 2;
+		int tileColumn = tile % across;
+		int tileRow = tile / across;
+		if( ( borders[ i ] % 2 ) == 0 )
+		{
+			if( joinedTiles.join( tile, tile + 1 ) )
+			{
+				int row = rowStarts[ tileRow ] + random.below( rowStarts[ tileRow + 1 ] - rowStarts[ tileRow ] );
+				grid.open( grid.cellAt( columnStarts[ tileColumn + 1 ] - 1, row ), MazeGrid::east );
+			}
+		}
+		else
+		{
+			if( joinedTiles.join( tile, tile + across ) )
+			{
+				int column = columnStarts[ tileColumn ] + random.below( columnStarts[ tileColumn + 1 ] - columnStarts[ tileColumn ] );
+				grid.open( grid.cellAt( column, rowStarts[ tileRow + 1 ] - 1 ), MazeGrid::north );
+			}
+		}
+	}
+}
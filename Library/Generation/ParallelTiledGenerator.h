@@ -0,0 +1,58 @@
+/*
+   Project     : 3DMaze
+   File        : ParallelTiledGenerator.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze in tiles, each carved on a thread of its own
+   				 by another generator, then joins the tiles with one passage
+   				 along each border of a spanning tree of the tiles. Every tile
+   				 is a perfect maze and so is the tree joining them, so the whole
+   				 grid is a perfect maze. The maze depends only on the seed, the
+   				 generator and the number of tiles, never on the threads
+*/
+
+
+#ifndef PARALLELTILEDGENERATOR_H_
+#define PARALLELTILEDGENERATOR_H_
+
+#include <string>
+#include <vector>
+
+#include "MazeGenerator.h"
+
+class ParallelTiledGenerator : public MazeGenerator
+{
+	public:
+		/* the tiles are carved by the generator with the given name, the grid is cut into
+		 * tilesAcross by tilesUp tiles ( or fewer, if the grid has fewer cells than that ),
+		 * which are carved on the given number of threads, or on one thread for each core when that's 0
+		 */
+		ParallelTiledGenerator( uint64_t m_seed, const std::string & m_tileGeneratorName,
+								int m_tilesAcross = default_tiles_across, int m_tilesUp = default_tiles_across, int m_numberOfThreads = 0 );
+
+		/* throws an IOError if there's no generator with the name given for the tiles
+		 */
+		void carve( MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & );
+		std::string name() const { return "tiled " + tileGeneratorName; }
+
+		int getNumberOfThreads() const { return numberOfThreads; }
+
+		static const int default_tiles_across = 8;
+
+		// how often, in milliseconds, progress is reported while the tiles are carved
+		static const int check_in_interval = 50;
+
+	private:
+		std::string tileGeneratorName;
+		int tilesAcross, tilesUp;
+		int numberOfThreads;
+
+		/* opens one wall along the border between each pair of tiles joined by a random spanning tree of the tiles
+		 */
+		void joinTiles( MazeGrid & grid, const std::vector<int> & columnStarts, const std::vector<int> & rowStarts );
+
+		// one tile, carved on a thread of its own
+		class Tile;
+};
+
+#endif /*PARALLELTILEDGENERATOR_H_*/
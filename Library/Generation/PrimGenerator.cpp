@@ -0,0 +1,84 @@
+/*
+   Project     : 3DMaze
+   File        : PrimGenerator.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with randomized Prim's algorithm, growing the
+   				 maze out from one cell by joining a random cell on its
+   				 frontier each step, which gives lots of short dead ends
+*/
+
+
+#include "PrimGenerator.h"
+
+#include <vector>
+
+#include "RandomNumbers.h"
+
+using namespace std;
+
+namespace
+{
+	// where each cell stands while the maze grows
+	const unsigned char outside = 0;
+	const unsigned char on_frontier = 1;
+	const unsigned char in_maze = 2;
+}
+
+void PrimGenerator::carve( MazeGrid & grid, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	if( grid.numberOfCells() == 0 )
+	{
+		return;
+	}
+
+	RandomNumbers random( seed );
+	vector<unsigned char> states( grid.numberOfCells(), outside );
+	vector<int> frontier;	// the cells next to the maze that aren't in it yet
+
+	int cell = random.below( grid.numberOfCells() );
+	int cellsInMaze = 0;
+	while( true )
+	{
+		states[ cell ] = in_maze;
+		cellsInMaze++;
+		for( int i = 0; i < MazeGrid::number_of_directions; i++ )
+		{
+			MazeGrid::Direction direction = ( MazeGrid::Direction ) i;
+			if( grid.hasNeighbor( cell, direction ) && ( states[ grid.neighbor( cell, direction ) ] == outside ) )
+			{
+				states[ grid.neighbor( cell, direction ) ] = on_frontier;
+				frontier.push_back( grid.neighbor( cell, direction ) );
+			}
+		}
+
+		if( frontier.empty() )
+		{
+			break;
+		}
+
+		if( ( cellsInMaze % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) cellsInMaze / grid.numberOfCells() );
+		}
+
+		//take a random cell off the frontier, moving the last one into its place
+		int index = random.below( frontier.size() );
+		cell = frontier[ index ];
+		frontier[ index ] = frontier.back();
+		frontier.pop_back();
+
+		//and join it to a random neighbor that's already in the maze
+		MazeGrid::Direction inMaze[ MazeGrid::number_of_directions ];
+		int numberInMaze = 0;
+		for( int i = 0; i < MazeGrid::number_of_directions; i++ )
+		{
+			MazeGrid::Direction direction = ( MazeGrid::Direction ) i;
+			if( grid.hasNeighbor( cell, direction ) && ( states[ grid.neighbor( cell, direction ) ] == in_maze ) )
+			{
+				inMaze[ numberInMaze++ ] = direction;
+			}
+		}
+		grid.open( cell, inMaze[ random.below( numberInMaze ) ] );
+	}
+}
@@ -0,0 +1,27 @@
+/*
+   Project     : 3DMaze
+   File        : PrimGenerator.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with randomized Prim's algorithm, growing the
+   				 maze out from one cell by joining a random cell on its
+   				 frontier each step, which gives lots of short dead ends
+*/
+
+
+#ifndef PRIMGENERATOR_H_
+#define PRIMGENERATOR_H_
+
+#include "MazeGenerator.h"
+
+class PrimGenerator : public MazeGenerator
+{
+	public:
+		PrimGenerator( uint64_t m_seed ) : MazeGenerator( m_seed ) {}
+
+		//inherited from MazeGenerator
+		void carve( MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & );
+		std::string name() const { return "prim"; }
+};
+
+#endif /*PRIMGENERATOR_H_*/
@@ -0,0 +1,47 @@
+/*
+   Project     : 3DMaze
+   File        : RandomNumbers.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A small, fast source of random numbers that always gives
+   				 the same numbers for the same seed, on every platform
+   				 ( unlike rand(), whose numbers differ from one library to the next )
+*/
+
+
+#include "RandomNumbers.h"
+
+namespace
+{
+	// the numbers come from the "splitmix64" generator, which steps its state
+	// by a fixed amount and scrambles the result
+	const uint64_t golden_ratio_step = 0x9E3779B97F4A7C15ULL;
+
+	uint64_t scramble( uint64_t value )
+	{
+		value = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+		value = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBULL;
+		return value ^ ( value >> 31 );
+	}
+}
+
+RandomNumbers::RandomNumbers( uint64_t m_seed /* = 0 */ ) :
+	state( m_seed ) {}
+
+
+/* 32 random bits
+ */
+uint32_t RandomNumbers::next()
+{
+	state += golden_ratio_step;
+	return ( uint32_t ) ( scramble( state ) >> 32 );
+}
+
+
+/* a seed for the numbered part of something seeded with the given seed,
+ * the numbers from the seeds of different parts have nothing to do with each other
+ */
+uint64_t RandomNumbers::seedFor( uint64_t seed, uint64_t part )
+{
+	return scramble( scramble( seed ) + ( ( part + 1 ) * golden_ratio_step ) );
+}
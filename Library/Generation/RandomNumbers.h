@@ -0,0 +1,39 @@
+/*
+   Project     : 3DMaze
+   File        : RandomNumbers.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A small, fast source of random numbers that always gives
+   				 the same numbers for the same seed, on every platform
+   				 ( unlike rand(), whose numbers differ from one library to the next )
+*/
+
+
+#ifndef RANDOMNUMBERS_H_
+#define RANDOMNUMBERS_H_
+
+#include <stdint.h>
+
+class RandomNumbers
+{
+	public:
+		RandomNumbers( uint64_t m_seed = 0 );
+
+		/* 32 random bits
+		 */
+		uint32_t next();
+
+		/* a random number from 0 up to ( but not including ) the limit, which must be positive
+		 */
+		int below( int limit ) { return ( int ) ( ( ( uint64_t ) next() * ( uint32_t ) limit ) >> 32 ); }
+
+		/* a seed for the numbered part of something seeded with the given seed,
+		 * the numbers from the seeds of different parts have nothing to do with each other
+		 */
+		static uint64_t seedFor( uint64_t seed, uint64_t part );
+
+	private:
+		uint64_t state;
+};
+
+#endif /*RANDOMNUMBERS_H_*/
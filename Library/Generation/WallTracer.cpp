@@ -0,0 +1,109 @@
+/*
+   Project     : 3DMaze
+   File        : WallTracer.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Turns the walls of a grid maze into lines, handed to it
+   				 a row of cells at a time from the bottom row up. Walls
+   				 that carry on along the same straight line are merged
+   				 into one line, and nothing but the current row and the
+   				 start of each unfinished run of walls is kept. After each
+   				 row the sink is told how far up its lines are finished
+*/
+
+
+#include "WallTracer.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/* the grid is centered on the origin, just like a Maze2D of the same size,
+ * the walls around the outside of the grid are left out, since every Maze2D has them already
+ */
+WallTracer::WallTracer( int m_columns, int m_rows, int m_cellSize, MazeLineSink & m_sink ) :
+	columns( m_columns ),
+	rows( m_rows ),
+	cellSize( m_cellSize ),
+	sink( m_sink ),
+	row( 0 ),
+	runStarts( m_columns, -1 ),
+	linesTraced( 0 ) {}
+
+
+/* the walls of the cells of the next row, a byte of wall bits for each column
+ */
+void WallTracer::addARow( const unsigned char * walls ) throw( IOError & )
+{
+	//the walls between columns run up from row to row, so each is carried on or ended here
+	int earliestRunStart = row;
+	for( int column = 0; column < columns - 1; column++ )
+	{
+		if( ( walls[ column ] & east_wall ) != 0 )
+		{
+			if( runStarts[ column ] < 0 )
+			{
+				runStarts[ column ] = row;
+			}
+			earliestRunStart = min( earliestRunStart, runStarts[ column ] );
+		}
+		else if( runStarts[ column ] >= 0 )
+		{
+			addALine( xOf( column + 1 ), yOf( runStarts[ column ] ), xOf( column + 1 ), yOf( row ) );
+			runStarts[ column ] = -1;
+		}
+	}
+
+	//the walls along the top of this row run across it, so they're done with right away
+	if( row < rows - 1 )
+	{
+		int runStart = -1;
+		for( int column = 0; column < columns; column++ )
+		{
+			if( ( walls[ column ] & north_wall ) != 0 )
+			{
+				if( runStart < 0 )
+				{
+					runStart = column;
+				}
+			}
+			else if( runStart >= 0 )
+			{
+				addALine( xOf( runStart ), yOf( row + 1 ), xOf( column ), yOf( row + 1 ) );
+				runStart = -1;
+			}
+		}
+		if( runStart >= 0 )
+		{
+			addALine( xOf( runStart ), yOf( row + 1 ), xOf( columns ), yOf( row + 1 ) );
+		}
+	}
+
+	row++;
+
+	//every line still to come is either a run that's already started, which reaches at least this far up,
+	//or lies above this row, so nothing still to come has its middle below halfway up the earliest run
+	sink.linesFinishedBelow( yOf( min( ( double ) row, ( earliestRunStart + row ) / 2.0 ) ) );
+}
+
+
+/* sends the last of the lines on to the sink, once every row has been added
+ */
+void WallTracer::finish() throw( IOError & )
+{
+	for( int column = 0; column < columns - 1; column++ )
+	{
+		if( runStarts[ column ] >= 0 )
+		{
+			addALine( xOf( column + 1 ), yOf( runStarts[ column ] ), xOf( column + 1 ), yOf( row ) );
+			runStarts[ column ] = -1;
+		}
+	}
+}
+
+
+void WallTracer::addALine( double x1, double y1, double x2, double y2 ) throw( IOError & )
+{
+	sink.addALine( LineSegment2D( Point2D( x1, y1 ), Point2D( x2, y2 ) ) );
+	linesTraced++;
+}
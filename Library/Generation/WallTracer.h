@@ -0,0 +1,60 @@
+/*
+   Project     : 3DMaze
+   File        : WallTracer.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Turns the walls of a grid maze into lines, handed to it
+   				 a row of cells at a time from the bottom row up. Walls
+   				 that carry on along the same straight line are merged
+   				 into one line, and nothing but the current row and the
+   				 start of each unfinished run of walls is kept. After each
+   				 row the sink is told how far up its lines are finished
+*/
+
+
+#ifndef WALLTRACER_H_
+#define WALLTRACER_H_
+
+#include <vector>
+
+#include "MazeLineSink.h"
+#include "IOError.h"
+
+class WallTracer
+{
+	public:
+		// the walls of a cell, as bits
+		static const unsigned char east_wall = 1;
+		static const unsigned char north_wall = 2;
+
+		/* the grid is centered on the origin, just like a Maze2D of the same size,
+		 * the walls around the outside of the grid are left out, since every Maze2D has them already
+		 */
+		WallTracer( int m_columns, int m_rows, int m_cellSize, MazeLineSink & m_sink );
+
+		/* the walls of the cells of the next row, a byte of wall bits for each column
+		 */
+		void addARow( const unsigned char * walls ) throw( IOError & );
+
+		/* sends the last of the lines on to the sink, once every row has been added
+		 */
+		void finish() throw( IOError & );
+
+		int numberOfLinesTraced() const { return linesTraced; }
+
+	private:
+		int columns, rows;
+		int cellSize;
+		MazeLineSink & sink;
+
+		int row;
+		std::vector<int> runStarts;	// for each column's east wall, the row its current run started in, or -1 if there's no run
+		int linesTraced;
+
+		double xOf( int column ) const { return ( column * ( double ) cellSize ) - ( ( columns * ( double ) cellSize ) / 2.0 ); }
+		double yOf( double row ) const { return ( row * ( double ) cellSize ) - ( ( rows * ( double ) cellSize ) / 2.0 ); }
+
+		void addALine( double x1, double y1, double x2, double y2 ) throw( IOError & );
+};
+
+#endif /*WALLTRACER_H_*/
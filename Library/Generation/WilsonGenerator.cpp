@@ -0,0 +1,70 @@
+/*
+   Project     : 3DMaze
+   File        : WilsonGenerator.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with Wilson's algorithm, adding loop erased
+   				 random walks to the maze one at a time, which picks every
+   				 possible maze with the same chance ( a uniform spanning tree )
+*/
+
+
+#include "WilsonGenerator.h"
+
+#include <vector>
+
+#include "RandomNumbers.h"
+
+using namespace std;
+
+void WilsonGenerator::carve( MazeGrid & grid, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	if( grid.numberOfCells() == 0 )
+	{
+		return;
+	}
+
+	RandomNumbers random( seed );
+	vector<bool> inMaze( grid.numberOfCells(), false );
+	vector<unsigned char> wayOut( grid.numberOfCells() );	// the direction each cell was last left in, during a walk
+
+	inMaze[ random.below( grid.numberOfCells() ) ] = true;
+	int cellsInMaze = 1;
+	long long stepsWalked = 0;	// the first walks can be very long, so progress is checked in on as they go
+
+	//walks start from every cell that isn't in the maze yet, in order, so the same seed always gives the same maze
+	for( int start = 0; start < grid.numberOfCells(); start++ )
+	{
+		if( inMaze[ start ] )
+		{
+			continue;
+		}
+
+		//wander until the maze is reached, only the last way out of each cell counts,
+		//which erases the loops the walk made along the way
+		int cell = start;
+		while( !inMaze[ cell ] )
+		{
+			MazeGrid::Direction direction;
+			do
+			{
+				direction = ( MazeGrid::Direction ) random.below( MazeGrid::number_of_directions );
+			} while( !grid.hasNeighbor( cell, direction ) );
+			wayOut[ cell ] = direction;
+			cell = grid.neighbor( cell, direction );
+
+			if( ( ++stepsWalked % ProgressMonitor::steps_between_check_ins ) == 0 )
+			{
+				ProgressMonitor::checkIn( progress, ( double ) cellsInMaze / grid.numberOfCells() );
+			}
+		}
+
+		//then add the path that's left to the maze
+		for( cell = start; !inMaze[ cell ]; cell = grid.neighbor( cell, ( MazeGrid::Direction ) wayOut[ cell ] ) )
+		{
+			inMaze[ cell ] = true;
+			grid.open( cell, ( MazeGrid::Direction ) wayOut[ cell ] );
+			cellsInMaze++;
+		}
+	}
+}
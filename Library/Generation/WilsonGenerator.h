@@ -0,0 +1,27 @@
+/*
+   Project     : 3DMaze
+   File        : WilsonGenerator.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Carves a maze with Wilson's algorithm, adding loop erased
+   				 random walks to the maze one at a time, which picks every
+   				 possible maze with the same chance ( a uniform spanning tree )
+*/
+
+
+#ifndef WILSONGENERATOR_H_
+#define WILSONGENERATOR_H_
+
+#include "MazeGenerator.h"
+
+class WilsonGenerator : public MazeGenerator
+{
+	public:
+		WilsonGenerator( uint64_t m_seed ) : MazeGenerator( m_seed ) {}
+
+		//inherited from MazeGenerator
+		void carve( MazeGrid & grid, ProgressMonitor * progress = NULL ) throw( IOError & );
+		std::string name() const { return "wilson"; }
+};
+
+#endif /*WILSONGENERATOR_H_*/
@@ -0,0 +1,206 @@
+/*
+   Project     : 3DMaze
+   File        : DurableFile.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A file that's only ever added to at its end or cut short,
+   				 and that can be made to reach the disk before anything else
+   				 happens, along with a way of replacing one file with another
+   				 all at once, so a crash never leaves a half written file behind
+*/
+
+
+#include "DurableFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+DurableFile::DurableFile( const string & m_fileName ) throw( IOError & ) :
+	fileName( m_fileName ),
+	size( 0 ),
+	fileHandle( INVALID_HANDLE_VALUE )
+{
+	fileHandle = CreateFileA( fileName.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( fileHandle == INVALID_HANDLE_VALUE )
+	{
+		throw IOError();
+	}
+
+	LARGE_INTEGER fileSize;
+	if( !GetFileSizeEx( fileHandle, &fileSize ) )
+	{
+		CloseHandle( fileHandle );
+		throw IOError();
+	}
+	size = fileSize.QuadPart;
+}
+
+DurableFile::~DurableFile()
+{
+	CloseHandle( fileHandle );
+}
+
+void DurableFile::append( const char * data, size_t length ) throw( IOError & )
+{
+	LARGE_INTEGER end;
+	end.QuadPart = size;
+	DWORD written = 0;
+	if( !SetFilePointerEx( fileHandle, end, NULL, FILE_BEGIN ) ||
+		!WriteFile( fileHandle, data, ( DWORD ) length, &written, NULL ) || ( written != length ) )
+	{
+		throw IOError();
+	}
+	size += length;
+}
+
+void DurableFile::truncate( long long length ) throw( IOError & )
+{
+	LARGE_INTEGER end;
+	end.QuadPart = length;
+	if( !SetFilePointerEx( fileHandle, end, NULL, FILE_BEGIN ) || !SetEndOfFile( fileHandle ) )
+	{
+		throw IOError();
+	}
+	size = length;
+}
+
+void DurableFile::flushToDisk() throw( IOError & )
+{
+	if( !FlushFileBuffers( fileHandle ) )
+	{
+		throw IOError();
+	}
+}
+
+void DurableFile::flushToDisk( const string & fileName ) throw( IOError & )
+{
+	DurableFile file( fileName );
+	file.flushToDisk();
+}
+
+void DurableFile::replace( const string & from, const string & to ) throw( IOError & )
+{
+	if( !MoveFileExA( from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH ) )
+	{
+		throw IOError();
+	}
+}
+
+bool DurableFile::getStamp( const string & fileName, long long & fileSize, long long & modified )
+{
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if( !GetFileAttributesExA( fileName.c_str(), GetFileExInfoStandard, &attributes ) )
+	{
+		return false;
+	}
+	fileSize = ( ( long long ) attributes.nFileSizeHigh << 32 ) | attributes.nFileSizeLow;
+	modified = ( ( long long ) attributes.ftLastWriteTime.dwHighDateTime << 32 ) | attributes.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
+#else
+
+DurableFile::DurableFile( const string & m_fileName ) throw( IOError & ) :
+	fileName( m_fileName ),
+	size( 0 ),
+	fileDescriptor( -1 )
+{
+	fileDescriptor = open( fileName.c_str(), O_RDWR | O_CREAT, 0666 );
+	if( fileDescriptor == -1 )
+	{
+		throw IOError();
+	}
+
+	struct stat fileStatus;
+	if( fstat( fileDescriptor, &fileStatus ) != 0 )
+	{
+		close( fileDescriptor );
+		throw IOError();
+	}
+	size = fileStatus.st_size;
+}
+
+DurableFile::~DurableFile()
+{
+	close( fileDescriptor );
+}
+
+void DurableFile::append( const char * data, size_t length ) throw( IOError & )
+{
+	size_t written = 0;
+	while( written < length )
+	{
+		ssize_t result = pwrite( fileDescriptor, data + written, length - written, size + written );
+		if( result <= 0 )
+		{
+			throw IOError();
+		}
+		written += result;
+	}
+	size += length;
+}
+
+void DurableFile::truncate( long long length ) throw( IOError & )
+{
+	if( ftruncate( fileDescriptor, length ) != 0 )
+	{
+		throw IOError();
+	}
+	size = length;
+}
+
+void DurableFile::flushToDisk() throw( IOError & )
+{
+	if( fsync( fileDescriptor ) != 0 )
+	{
+		throw IOError();
+	}
+}
+
+void DurableFile::flushToDisk( const string & fileName ) throw( IOError & )
+{
+	DurableFile file( fileName );
+	file.flushToDisk();
+}
+
+void DurableFile::replace( const string & from, const string & to ) throw( IOError & )
+{
+	if( rename( from.c_str(), to.c_str() ) != 0 )
+	{
+		throw IOError();
+	}
+
+	//the new name only survives a crash once the directory holding it reaches the disk too
+	string::size_type lastSlash = to.rfind( '/' );
+	string directory = ( lastSlash == string::npos ) ? string( "." ) : to.substr( 0, lastSlash + 1 );
+	int directoryDescriptor = open( directory.c_str(), O_RDONLY );
+	if( directoryDescriptor != -1 )
+	{
+		fsync( directoryDescriptor );
+		close( directoryDescriptor );
+	}
+}
+
+bool DurableFile::getStamp( const string & fileName, long long & fileSize, long long & modified )
+{
+	struct stat fileStatus;
+	if( stat( fileName.c_str(), &fileStatus ) != 0 )
+	{
+		return false;
+	}
+	fileSize = fileStatus.st_size;
+	modified = fileStatus.st_mtime;
+	return true;
+}
+
+#endif
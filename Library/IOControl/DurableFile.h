@@ -0,0 +1,73 @@
+/*
+   Project     : 3DMaze
+   File        : DurableFile.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A file that's only ever added to at its end or cut short,
+   				 and that can be made to reach the disk before anything else
+   				 happens, along with a way of replacing one file with another
+   				 all at once, so a crash never leaves a half written file behind
+*/
+
+
+#ifndef DURABLEFILE_H_
+#define DURABLEFILE_H_
+
+#include <string>
+#include <cstddef>
+
+#include "IOError.h"
+
+class DurableFile
+{
+	public:
+		/* opens the file for writing, creating it if it doesn't exist yet,
+		 * whatever is already in it is kept
+		 */
+		DurableFile( const std::string & m_fileName ) throw( IOError & );
+		~DurableFile();
+
+		long long getSize() const { return size; }
+
+		/* writes the data onto the end of the file, it's safe from the program crashing
+		 * once this returns, but not from the machine crashing until flushToDisk is called
+		 */
+		void append( const char * data, std::size_t length ) throw( IOError & );
+
+		/* cuts the file short, dropping everything past the given length
+		 */
+		void truncate( long long length ) throw( IOError & );
+
+		/* waits until everything written to the file is on the disk
+		 */
+		void flushToDisk() throw( IOError & );
+
+		/* waits until everything written to the named file is on the disk
+		 */
+		static void flushToDisk( const std::string & fileName ) throw( IOError & );
+
+		/* puts the file named from in place of the file named to, all at once, so anyone opening to
+		 * finds either all of the old file or all of the new one, the new one having reached the disk
+		 */
+		static void replace( const std::string & from, const std::string & to ) throw( IOError & );
+
+		/* the size and last modification time of the file, false if it doesn't exist
+		 */
+		static bool getStamp( const std::string & fileName, long long & fileSize, long long & modified );
+
+	private:
+		std::string fileName;
+		long long size;
+
+#ifdef _WIN32
+		void * fileHandle;
+#else
+		int fileDescriptor;
+#endif
+
+		// disable copying, a file can only be closed once
+		DurableFile( const DurableFile & );
+		const DurableFile & operator=( const DurableFile & );
+};
+
+#endif /*DURABLEFILE_H_*/
@@ -4,40 +4,100 @@
    Author      : Jacob Enget  (jacob.enget@gmail.com)
 
    Description : Handles reading from and writing to files
-   				 for Serializable objects
+   				 for Serializable objects, files in binary form
+   				 are recognized by the magic number they start with
 */
 
 
 #include "FileHandler.h"
 
+#include <string.h>
+#include <stdio.h>
+
 #include "Serializable.h"
+#include "MappedFile.h"
+#include "DurableFile.h"
 
 using namespace std;
 
+const char FileHandler::binary_magic_number[ FileHandler::magic_number_length ] = { '3', 'D', 'M', 'a', 'z', 'e', '\x1a', '\0' };
+const char * const FileHandler::temporary_file_suffix = ".saving";
+
 FileHandler::FileHandler( const std::string & m_fileName ) : 
 	fileName( m_fileName ) {}
 
-void FileHandler::ReadFromFile( Serializable & serialObject ) const throw( IOError & )
+/* objects that take a while to read or write report their progress to the monitor, if there is one,
+ * an OperationCanceled is thrown if the monitor asks for the reading or writing to stop
+ */
+void FileHandler::ReadFromFile( Serializable & serialObject, ProgressMonitor * progress /* = NULL */ ) const throw( IOError & )
 {
-	ifstream inFile( fileName.c_str() );
-	if( !inFile )
+	//binary files are used right where they're mapped into memory
+	if( IsBinary() )
 	{
-		throw IOError();
+		MappedFile mapping( fileName );
+		serialObject.readInBinary( mapping.getData(), mapping.getSize(), progress );
+		return;
 	}
+
+	//text files are mapped too, so they can be read without going through a stream
+	MappedFile mapping( fileName );
 	
 	//this might throw an IOError, but if it does we'll just have it propagate up
-	serialObject.readIn( inFile );
+	serialObject.readInText( mapping.getData(), mapping.getSize(), progress );
 }
 
 
-void FileHandler::WriteToFile( const Serializable & serialObject ) const throw( IOError & )
+/* the object is written to a temporary file that's then put in place of the file all at once,
+ * so if writing fails ( or is canceled ) part way through the file is left just as it was
+ */
+void FileHandler::WriteToFile( const Serializable & serialObject, bool asBinary /* = false */, ProgressMonitor * progress /* = NULL */ ) const throw( IOError & )
 {
-	ofstream outFile( fileName.c_str() );
-	if( !outFile )
+	string temporaryFileName = fileName + temporary_file_suffix;
+	try
+	{
+		{
+			ofstream outFile( temporaryFileName.c_str(), asBinary ? ( ios::out | ios::binary ) : ios::out );
+			if( !outFile )
+			{
+				throw IOError();
+			}
+
+			if( asBinary )
+			{
+				serialObject.writeOutBinary( outFile, progress );
+			}
+			else
+			{
+				serialObject.writeOutText( outFile, progress );
+			}
+
+			outFile.close();
+			if( !outFile )
+			{
+				throw IOError();
+			}
+		}
+
+		DurableFile::flushToDisk( temporaryFileName );
+		DurableFile::replace( temporaryFileName, fileName );
+	}
+	catch( IOError & ioe )
 	{
-		throw IOError();
+		remove( temporaryFileName.c_str() );
+		throw;
 	}
+}
 
-	//this might throw an IOError, but if it does we'll just have it propagate up
-	serialObject.writeOut( outFile );
+
+/* returns true if the file exists and starts with the binary magic number
+ */
+bool FileHandler::IsBinary() const
+{
+	ifstream inFile( fileName.c_str(), ios::in | ios::binary );
+	char start[ magic_number_length ];
+	if( !inFile.read( start, magic_number_length ) )
+	{
+		return false;
+	}
+	return memcmp( start, binary_magic_number, magic_number_length ) == 0;
 }
@@ -4,7 +4,8 @@
    Author      : Jacob Enget  (jacob.enget@gmail.com)
 
    Description : Handles reading from and writing to files
-   				 for Serializable objects
+   				 for Serializable objects, files in binary form
+   				 are recognized by the magic number they start with
 */
 
 
@@ -15,14 +16,33 @@
 #include <iostream>
 
 #include "Serializable.h"
+#include "ProgressMonitor.h"
 #include "IOError.h"
 
 class FileHandler
 {
 	public:
 		FileHandler( const std::string & m_fileName );
-		void ReadFromFile( Serializable & serialObject ) const throw( IOError & );
-		void WriteToFile( const Serializable &serialObject ) const throw( IOError & );
+		/* objects that take a while to read or write report their progress to the monitor, if there is one,
+		 * an OperationCanceled is thrown if the monitor asks for the reading or writing to stop
+		 */
+		void ReadFromFile( Serializable & serialObject, ProgressMonitor * progress = NULL ) const throw( IOError & );
+
+		/* the object is written to a temporary file that's then put in place of the file all at once,
+		 * so if writing fails ( or is canceled ) part way through the file is left just as it was
+		 */
+		void WriteToFile( const Serializable &serialObject, bool asBinary = false, ProgressMonitor * progress = NULL ) const throw( IOError & );
+
+		/* returns true if the file exists and starts with the binary magic number
+		 */
+		bool IsBinary() const;
+
+		// every file in binary form starts with these bytes
+		static const int magic_number_length = 8;
+		static const char binary_magic_number[ magic_number_length ];
+
+		// added to the file's name to name the temporary file it's written to
+		static const char * const temporary_file_suffix;
 		
 	private:
 		std::string fileName;
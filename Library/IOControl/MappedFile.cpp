@@ -0,0 +1,143 @@
+/*
+   Project     : 3DMaze
+   File        : MappedFile.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Maps the whole of a file into memory, read only,
+   				 so its contents can be used without being read in
+*/
+
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+MappedFile::MappedFile( const string & fileName ) throw( IOError & ) :
+	data( NULL ),
+	size( 0 ),
+	fileHandle( INVALID_HANDLE_VALUE ),
+	mappingHandle( NULL )
+{
+	fileHandle = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( fileHandle == INVALID_HANDLE_VALUE )
+	{
+		throw IOError();
+	}
+
+	LARGE_INTEGER fileSize;
+	if( !GetFileSizeEx( fileHandle, &fileSize ) )
+	{
+		unmap();
+		throw IOError();
+	}
+	size = ( size_t ) fileSize.QuadPart;
+
+	//there's nothing to map in an empty file
+	if( size == 0 )
+	{
+		return;
+	}
+
+	mappingHandle = CreateFileMappingA( fileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+	if( mappingHandle == NULL )
+	{
+		unmap();
+		throw IOError();
+	}
+
+	data = static_cast<const char *>( MapViewOfFile( mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+	if( data == NULL )
+	{
+		unmap();
+		throw IOError();
+	}
+}
+
+void MappedFile::unmap()
+{
+	if( data != NULL )
+	{
+		UnmapViewOfFile( data );
+		data = NULL;
+	}
+	if( mappingHandle != NULL )
+	{
+		CloseHandle( mappingHandle );
+		mappingHandle = NULL;
+	}
+	if( fileHandle != INVALID_HANDLE_VALUE )
+	{
+		CloseHandle( fileHandle );
+		fileHandle = INVALID_HANDLE_VALUE;
+	}
+	size = 0;
+}
+
+#else
+
+MappedFile::MappedFile( const string & fileName ) throw( IOError & ) :
+	data( NULL ),
+	size( 0 ),
+	fileDescriptor( -1 )
+{
+	fileDescriptor = open( fileName.c_str(), O_RDONLY );
+	if( fileDescriptor == -1 )
+	{
+		throw IOError();
+	}
+
+	struct stat fileStatus;
+	if( fstat( fileDescriptor, &fileStatus ) != 0 )
+	{
+		unmap();
+		throw IOError();
+	}
+	size = fileStatus.st_size;
+
+	//there's nothing to map in an empty file
+	if( size == 0 )
+	{
+		return;
+	}
+
+	void * mapping = mmap( NULL, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0 );
+	if( mapping == MAP_FAILED )
+	{
+		unmap();
+		throw IOError();
+	}
+	data = static_cast<const char *>( mapping );
+}
+
+void MappedFile::unmap()
+{
+	if( data != NULL )
+	{
+		munmap( const_cast<char *>( data ), size );
+		data = NULL;
+	}
+	if( fileDescriptor != -1 )
+	{
+		close( fileDescriptor );
+		fileDescriptor = -1;
+	}
+	size = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
@@ -0,0 +1,51 @@
+/*
+   Project     : 3DMaze
+   File        : MappedFile.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Maps the whole of a file into memory, read only,
+   				 so its contents can be used without being read in
+*/
+
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <string>
+#include <cstddef>
+
+#include "IOError.h"
+
+class MappedFile
+{
+	public:
+		MappedFile( const std::string & fileName ) throw( IOError & );
+		~MappedFile();
+
+		/* the contents of the file, which stay valid as long as this object is around
+		 * ( an empty file has no contents, so NULL is returned for it )
+		 */
+		const char * getData() const { return data; }
+		std::size_t getSize() const { return size; }
+
+	private:
+		const char * data;
+		std::size_t size;
+
+#ifdef _WIN32
+		void * fileHandle;
+		void * mappingHandle;
+#else
+		int fileDescriptor;
+#endif
+
+		/* gives back everything the operating system handed out for this mapping
+		 */
+		void unmap();
+
+		// disable copying, a mapping can only be undone once
+		MappedFile( const MappedFile & );
+		const MappedFile & operator=( const MappedFile & );
+};
+
+#endif /*MAPPEDFILE_H_*/
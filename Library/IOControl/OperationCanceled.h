@@ -0,0 +1,24 @@
+/*
+   Project     : 3DMaze
+   File        : OperationCanceled.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Thrown when someone asks for a long running operation
+   				 ( like reading a huge file ) to stop before it's done,
+   				 it's a kind of IOError so it can pass through anything
+   				 that's allowed to throw an IOError
+*/
+
+
+#ifndef OPERATIONCANCELED_H_
+#define OPERATIONCANCELED_H_
+
+#include "IOError.h"
+
+class OperationCanceled : public IOError
+{
+	public:
+		OperationCanceled() {}
+};
+
+#endif /*OPERATIONCANCELED_H_*/
@@ -0,0 +1,76 @@
+/*
+   Project     : 3DMaze
+   File        : ProgressMonitor.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Interface for anything that wants to hear how far along
+   				 a long running operation is, and maybe stop it early.
+   				 Operations take a pointer to one of these, which can be NULL
+*/
+
+
+#ifndef PROGRESSMONITOR_H_
+#define PROGRESSMONITOR_H_
+
+#include "OperationCanceled.h"
+#include "IOError.h"
+
+class ProgressMonitor
+{
+	public:
+		virtual ~ProgressMonitor() {}
+
+		/* how much of the operation is done, from 0 to 1
+		 * ( this can be called from whatever thread the operation runs on )
+		 */
+		virtual void reportProgress( double fractionDone ) = 0;
+		virtual bool wasCanceled() const = 0;
+
+		// operations made up of many small steps ( like reading lines ) check in after this many of them
+		static const int steps_between_check_ins = 1 << 14;
+
+		/* reports the progress and throws an OperationCanceled if the operation should stop,
+		 * doing nothing when there's no monitor
+		 */
+		static void checkIn( ProgressMonitor * progress, double fractionDone ) throw( IOError & )
+		{
+			if( progress != NULL )
+			{
+				progress->reportProgress( fractionDone );
+				if( progress->wasCanceled() )
+				{
+					throw OperationCanceled();
+				}
+			}
+		}
+};
+
+
+/* passes progress on to another monitor as just one part of a bigger operation
+ */
+class ProgressRange : public ProgressMonitor
+{
+	public:
+		/* progress from 0 to 1 is passed on as going from start to end
+		 */
+		ProgressRange( ProgressMonitor * m_whole, double m_start, double m_end ) :
+			whole( m_whole ),
+			start( m_start ),
+			end( m_end ) {}
+
+		void reportProgress( double fractionDone )
+		{
+			if( whole != NULL )
+			{
+				whole->reportProgress( start + ( fractionDone * ( end - start ) ) );
+			}
+		}
+
+		bool wasCanceled() const { return ( whole != NULL ) && whole->wasCanceled(); }
+
+	private:
+		ProgressMonitor * whole;
+		double start, end;
+};
+
+#endif /*PROGRESSMONITOR_H_*/
@@ -14,7 +14,11 @@
 #define SERIALIZABLE_H_
 
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <cstddef>
 
+#include "ProgressMonitor.h"
 #include "IOError.h"
 
 class Serializable
@@ -24,6 +28,27 @@ class Serializable
 		virtual void readIn( std::istream & in = std::cin ) throw( IOError & ) = 0;
 		virtual void writeOut( std::ostream & out = std::cout ) const throw( IOError & ) = 0;
 		virtual std::string type() const = 0;
+
+		/* reads the text form of the object straight out of memory, objects
+		 * without a faster way of doing this just read it through a stream
+		 * ( objects big enough to take a while report their progress to the monitor,
+		 *   and throw an OperationCanceled if it asks them to stop )
+		 */
+		virtual void readInText( const char * data, std::size_t size, ProgressMonitor * = NULL ) throw( IOError & )
+		{
+			std::istringstream in( ( size > 0 ) ? std::string( data, size ) : std::string() );
+			readIn( in );
+		}
+		virtual void writeOutText( std::ostream & out, ProgressMonitor * = NULL ) const throw( IOError & )
+		{
+			writeOut( out );
+		}
+
+		/* objects that also have a binary form can be read straight out of a file
+		 * that's been mapped into memory, objects without one just throw an IOError
+		 */
+		virtual void readInBinary( const char *, std::size_t, ProgressMonitor * = NULL ) throw( IOError & ) { throw IOError(); }
+		virtual void writeOutBinary( std::ostream &, ProgressMonitor * = NULL ) const throw( IOError & ) { throw IOError(); }
 };
 
 #endif /*SERIALIZABLE_H_*/
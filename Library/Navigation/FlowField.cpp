@@ -0,0 +1,377 @@
+/*
+   Project     : 3DMaze
+   File        : FlowField.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : How far every open cell of an occupancy grid is from the
+   				 nearest of a set of goals, and which neighbor to step to from
+   				 each one to get there, so any number of agents heading for the
+   				 same goals can each find their way with one lookup a step.
+   				 When a line is added to the grid, only the cells whose way to
+   				 the goals it cuts off are worked out again
+*/
+
+
+#include "FlowField.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+const int FlowField::column_steps[ 8 ] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+const int FlowField::row_steps[ 8 ] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+const int FlowField::unreached = numeric_limits<int>::max();
+const int FlowField::no_direction;
+const int FlowField::straight_step;
+const int FlowField::diagonal_step;
+
+namespace
+{
+	// straight steps are tried first, so that where a straight and a diagonal step cost the same the straight one is taken
+	const int directions_to_try[ 8 ] = { 0, 2, 4, 6, 1, 3, 5, 7 };
+
+	// the directions, as vectors one unit long
+	const double unit_steps[ 8 ][ 2 ] =
+	{
+		{ 1.0, 0.0 }, { 0.70710678, 0.70710678 }, { 0.0, 1.0 }, { -0.70710678, 0.70710678 },
+		{ -1.0, 0.0 }, { -0.70710678, -0.70710678 }, { 0.0, -1.0 }, { 0.70710678, -0.70710678 }
+	};
+
+	// fewer rows than this aren't worth handing out to threads
+	const int rows_per_band = 64;
+}
+
+
+/* a band of rows, pointed on a thread of its own, no other band touches its rows
+ */
+class FlowField::Band : public QRunnable
+{
+	public:
+		Band() : field( NULL ), firstRow( 0 ), lastRow( 0 )
+		{
+			setAutoDelete( false );
+		}
+
+		void setUp( FlowField & m_field, int m_firstRow, int m_lastRow )
+		{
+			field = &m_field;
+			firstRow = m_firstRow;
+			lastRow = m_lastRow;
+		}
+
+		void run()
+		{
+			field->pointRows( firstRow, lastRow );
+		}
+
+	private:
+		FlowField * field;
+		int firstRow, lastRow;
+};
+
+
+/* the directions are worked out on the given number of threads, or on one thread for each core when that's 0
+ */
+FlowField::FlowField( int m_numberOfThreads /* = 0 */ ) :
+	grid( NULL ),
+	columns( 0 ),
+	rows( 0 ),
+	numberOfThreads( ( m_numberOfThreads > 0 ) ? m_numberOfThreads : max( 1, QThread::idealThreadCount() ) ),
+	costs(),
+	directions(),
+	seeds(),
+	invalidated() {}
+
+
+/* works out the field over the grid, for the goals given, the grid has to outlast the field
+ */
+void FlowField::compute( const OccupancyGrid & m_grid, const vector<Point2D> & goals )
+{
+	grid = &m_grid;
+	columns = grid->getColumns();
+	rows = grid->getRows();
+	costs.assign( grid->numberOfCells(), unreached );
+	directions.assign( grid->numberOfCells(), no_direction );
+
+	seeds.clear();
+	for( unsigned int i = 0; i < goals.size(); i++ )
+	{
+		int column, row;
+		if( grid->cellAt( goals[ i ], column, row ) && grid->isOpen( column, row ) )
+		{
+			int cell = ( row * columns ) + column;
+			costs[ cell ] = 0;
+			seeds.push_back( make_pair( 0, cell ) );
+		}
+	}
+	integrate();
+
+	//every cell's step only depends on the costs around it, so the rows can be pointed in any order
+	int numberOfBands = max( 1, min( numberOfThreads, rows / rows_per_band ) );
+	if( numberOfBands == 1 )
+	{
+		pointRows( 0, rows );
+		return;
+	}
+
+	vector<Band> bands( numberOfBands );
+	QThreadPool pool;
+	pool.setMaxThreadCount( numberOfThreads );
+	for( int band = 0; band < numberOfBands; band++ )
+	{
+		bands[ band ].setUp( *this, ( rows * band ) / numberOfBands, ( rows * ( band + 1 ) ) / numberOfBands );
+		pool.start( &bands[ band ] );
+	}
+	pool.waitForDone();
+}
+
+
+/* call once the line has been added to the grid, to work out again the cells whose way to the goals it cut off
+ */
+void FlowField::lineAdded( const LineSegment2D & line )
+{
+	int firstColumn, firstRow, lastColumn, lastRow;
+	if( ( grid == NULL ) || !grid->cellsNear( line, firstColumn, firstRow, lastColumn, lastRow ) )
+	{
+		return;
+	}
+
+	/* blocking cells only ever makes ways longer, so a cell only has to be worked out again if its step
+	 * leads onto a newly blocked cell ( or cuts a newly blocked corner ), or onto a cell that has to be worked out again.
+	 * A blocked cell can stop diagonal steps between the cells on either side of it, so the cells next to the ones that
+	 * were blocked are checked too
+	 */
+	invalidated.clear();
+	for( int row = max( 0, firstRow - 1 ); row <= min( rows - 1, lastRow + 1 ); row++ )
+	{
+		for( int column = max( 0, firstColumn - 1 ); column <= min( columns - 1, lastColumn + 1 ); column++ )
+		{
+			int cell = ( row * columns ) + column;
+			if( ( costs[ cell ] != unreached ) &&
+				( !grid->isOpen( column, row ) || ( ( directions[ cell ] != no_direction ) && !canStep( column, row, directions[ cell ] ) ) ) )
+			{
+				costs[ cell ] = unreached;
+				directions[ cell ] = no_direction;
+				invalidated.push_back( cell );
+			}
+		}
+	}
+
+	//the cells stepping onto a cell that was worked out again have to be too, and so on back along their ways
+	for( unsigned int i = 0; i < invalidated.size(); i++ )
+	{
+		int column = invalidated[ i ] % columns;
+		int row = invalidated[ i ] / columns;
+		for( int direction = 0; direction < 8; direction++ )
+		{
+			int fromColumn = column + column_steps[ direction ];
+			int fromRow = row + row_steps[ direction ];
+			if( ( fromColumn < 0 ) || ( fromRow < 0 ) || ( fromColumn >= columns ) || ( fromRow >= rows ) )
+			{
+				continue;
+			}
+
+			// the neighbor steps back the opposite way to get here
+			int from = ( fromRow * columns ) + fromColumn;
+			if( ( costs[ from ] != unreached ) && ( directions[ from ] == ( ( direction + 4 ) & 7 ) ) )
+			{
+				costs[ from ] = unreached;
+				directions[ from ] = no_direction;
+				invalidated.push_back( from );
+			}
+		}
+	}
+
+	//the costs spread back in from the cells around the ones worked out again, which kept theirs
+	seeds.clear();
+	for( unsigned int i = 0; i < invalidated.size(); i++ )
+	{
+		int column = invalidated[ i ] % columns;
+		int row = invalidated[ i ] / columns;
+		if( !grid->isOpen( column, row ) )
+		{
+			continue;
+		}
+
+		int best = unreached;
+		for( int direction = 0; direction < 8; direction++ )
+		{
+			if( canStep( column, row, direction ) )
+			{
+				int next = invalidated[ i ] + ( row_steps[ direction ] * columns ) + column_steps[ direction ];
+				if( costs[ next ] != unreached )
+				{
+					best = min( best, costs[ next ] + ( ( direction & 1 ) ? diagonal_step : straight_step ) );
+				}
+			}
+		}
+		if( best != unreached )
+		{
+			costs[ invalidated[ i ] ] = best;
+			seeds.push_back( make_pair( best, invalidated[ i ] ) );
+		}
+	}
+	integrate();
+
+	for( unsigned int i = 0; i < invalidated.size(); i++ )
+	{
+		pointCell( invalidated[ i ] % columns, invalidated[ i ] / columns );
+	}
+}
+
+
+/* the way to head from the point, as a vector one unit long, or no length at all
+ * if the point is in a goal's cell, or can't reach any goal
+ */
+Vector2D FlowField::directionAt( const Point2D & point ) const
+{
+	int column, row;
+	if( ( grid == NULL ) || !grid->cellAt( point, column, row ) )
+	{
+		return Vector2D();
+	}
+
+	int direction = directionOf( column, row );
+	if( direction == no_direction )
+	{
+		return Vector2D();
+	}
+	return Vector2D( unit_steps[ direction ][ 0 ], unit_steps[ direction ][ 1 ] );
+}
+
+
+/* how far the point's cell is from the nearest goal, following the grid, or -1 if it can't reach any goal
+ */
+double FlowField::distanceAt( const Point2D & point ) const
+{
+	int column, row;
+	if( ( grid == NULL ) || !grid->cellAt( point, column, row ) || ( costs[ ( row * columns ) + column ] == unreached ) )
+	{
+		return -1.0;
+	}
+	return costs[ ( row * columns ) + column ] * grid->getCellSize() / straight_step;
+}
+
+
+/* true if the step from the cell in the given direction stays on open cells and doesn't cut a corner
+ */
+bool FlowField::canStep( int column, int row, int direction ) const
+{
+	int nextColumn = column + column_steps[ direction ];
+	int nextRow = row + row_steps[ direction ];
+	if( !grid->isOpen( nextColumn, nextRow ) )
+	{
+		return false;
+	}
+	return ( ( direction & 1 ) == 0 ) || ( grid->isOpen( nextColumn, row ) && grid->isOpen( column, nextRow ) );
+}
+
+
+/* spreads the costs out from the seeds ( each a cost and a cell ), cheapest first
+ */
+void FlowField::integrate()
+{
+	/* every step costs a whole number no bigger than there are buckets, so the cells waiting to be expanded
+	 * can be kept in a bucket for each cost, circling around, instead of a heap. The seeds can cost anything,
+	 * so they're sorted and each goes into its bucket once the costs being expanded get close enough to it
+	 */
+	const int numberOfBuckets = diagonal_step + 1;
+	sort( seeds.begin(), seeds.end() );
+	unsigned int nextSeed = 0;
+	int waiting = 0;
+	int current = 0;
+	while( ( waiting > 0 ) || ( nextSeed < seeds.size() ) )
+	{
+		if( waiting == 0 )
+		{
+			current = max( current, seeds[ nextSeed ].first );
+		}
+		while( ( nextSeed < seeds.size() ) && ( seeds[ nextSeed ].first <= current + diagonal_step ) )
+		{
+			buckets[ seeds[ nextSeed ].first % numberOfBuckets ].push_back( seeds[ nextSeed ].second );
+			nextSeed++;
+			waiting++;
+		}
+
+		// a step always costs more than nothing, so nothing expanded here lands back in this bucket
+		vector<int> & bucket = buckets[ current % numberOfBuckets ];
+		for( unsigned int i = 0; i < bucket.size(); i++ )
+		{
+			int cell = bucket[ i ];
+
+			// a cell can be in more than one bucket, if a cheaper way to it was found after it was added
+			if( costs[ cell ] != current )
+			{
+				continue;
+			}
+
+			int column = cell % columns;
+			int row = cell / columns;
+			for( int direction = 0; direction < 8; direction++ )
+			{
+				if( !canStep( column, row, direction ) )
+				{
+					continue;
+				}
+				int next = cell + ( row_steps[ direction ] * columns ) + column_steps[ direction ];
+				int cost = current + ( ( direction & 1 ) ? diagonal_step : straight_step );
+				if( cost < costs[ next ] )
+				{
+					costs[ next ] = cost;
+					buckets[ cost % numberOfBuckets ].push_back( next );
+					waiting++;
+				}
+			}
+		}
+		waiting -= bucket.size();
+		bucket.clear();
+		current++;
+	}
+}
+
+
+/* picks the step for each of the cells in the rows from firstRow up to but not including lastRow
+ */
+void FlowField::pointRows( int firstRow, int lastRow )
+{
+	for( int row = firstRow; row < lastRow; row++ )
+	{
+		for( int column = 0; column < columns; column++ )
+		{
+			pointCell( column, row );
+		}
+	}
+}
+
+
+void FlowField::pointCell( int column, int row )
+{
+	int cell = ( row * columns ) + column;
+	directions[ cell ] = no_direction;
+	if( ( costs[ cell ] == unreached ) || ( costs[ cell ] == 0 ) )
+	{
+		return;
+	}
+
+	// the step down to the neighbor whose cost plus the step's is lowest, which is exactly this cell's cost
+	int best = unreached;
+	for( int i = 0; i < 8; i++ )
+	{
+		int direction = directions_to_try[ i ];
+		if( !canStep( column, row, direction ) )
+		{
+			continue;
+		}
+		int next = cell + ( row_steps[ direction ] * columns ) + column_steps[ direction ];
+		if( ( costs[ next ] != unreached ) && ( costs[ next ] + ( ( direction & 1 ) ? diagonal_step : straight_step ) < best ) )
+		{
+			best = costs[ next ] + ( ( direction & 1 ) ? diagonal_step : straight_step );
+			directions[ cell ] = direction;
+		}
+	}
+}
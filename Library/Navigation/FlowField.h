@@ -0,0 +1,96 @@
+/*
+   Project     : 3DMaze
+   File        : FlowField.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : How far every open cell of an occupancy grid is from the
+   				 nearest of a set of goals, and which neighbor to step to from
+   				 each one to get there, so any number of agents heading for the
+   				 same goals can each find their way with one lookup a step.
+   				 When a line is added to the grid, only the cells whose way to
+   				 the goals it cuts off are worked out again
+*/
+
+
+#ifndef FLOWFIELD_H_
+#define FLOWFIELD_H_
+
+#include <vector>
+#include <utility>
+
+#include "Point2D.h"
+#include "Vector2D.h"
+#include "LineSegment2D.h"
+#include "OccupancyGrid.h"
+
+class FlowField
+{
+	public:
+		/* the directions are worked out on the given number of threads, or on one thread for each core when that's 0
+		 */
+		FlowField( int m_numberOfThreads = 0 );
+
+		/* works out the field over the grid, for the goals given, the grid has to outlast the field
+		 */
+		void compute( const OccupancyGrid & m_grid, const std::vector<Point2D> & goals );
+
+		/* call once the line has been added to the grid, to work out again the cells whose way to the goals it cut off
+		 */
+		void lineAdded( const LineSegment2D & line );
+
+		/* the way to head from the point, as a vector one unit long, or no length at all
+		 * if the point is in a goal's cell, or can't reach any goal
+		 */
+		Vector2D directionAt( const Point2D & point ) const;
+
+		/* how far the point's cell is from the nearest goal, following the grid, or -1 if it can't reach any goal
+		 */
+		double distanceAt( const Point2D & point ) const;
+
+		/* which neighbor to step to from the cell, as one of the directions below, or no_direction
+		 */
+		int directionOf( int column, int row ) const { return directions[ ( row * columns ) + column ]; }
+
+		// the directions to a cell's neighbors, counterclockwise from the one to its right, the even ones are straight
+		static const int no_direction = 8;
+		static const int column_steps[ 8 ];
+		static const int row_steps[ 8 ];
+
+		// how much a step costs, the ratio between them is close to the square root of 2
+		static const int straight_step = 5;
+		static const int diagonal_step = 7;
+
+	private:
+		const OccupancyGrid * grid;
+		int columns, rows;
+		int numberOfThreads;
+
+		// for each cell, the cost of the cheapest way to a goal ( unreached when there isn't one ), and the step to take
+		std::vector<int> costs;
+		std::vector<unsigned char> directions;
+
+		// the cells waiting to be expanded, circling around by cost, a step never costs more than there are buckets
+		std::vector<int> buckets[ diagonal_step + 1 ];
+		std::vector< std::pair<int, int> > seeds;
+		std::vector<int> invalidated;
+
+		static const int unreached;
+
+		/* true if the step from the cell in the given direction stays on open cells and doesn't cut a corner
+		 */
+		bool canStep( int column, int row, int direction ) const;
+
+		/* spreads the costs out from the seeds ( each a cost and a cell ), cheapest first
+		 */
+		void integrate();
+
+		/* picks the step for each of the cells in the rows from firstRow up to but not including lastRow
+		 */
+		void pointRows( int firstRow, int lastRow );
+		void pointCell( int column, int row );
+
+		// a band of rows to point, on a thread of its own
+		class Band;
+};
+
+#endif /*FLOWFIELD_H_*/
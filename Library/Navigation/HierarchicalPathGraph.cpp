@@ -0,0 +1,622 @@
+/*
+   Project     : 3DMaze
+   File        : HierarchicalPathGraph.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : An abstraction of an occupancy grid for hierarchical path
+   				 finding. The grid is cut into square clusters, every stretch
+   				 of open cells along the border between two clusters gets an
+   				 entrance ( a node on each side ), and the nodes of a cluster
+   				 are joined by the shortest paths between them that stay
+   				 inside it, which are kept so searches never have to find
+   				 them again. Adding a line to the maze only redoes the
+   				 clusters it reaches and the borders around them. The
+   				 distances from a few landmark nodes to every node are
+   				 kept as well, for searches to estimate how far they are
+   				 from the goal
+*/
+
+
+#include "HierarchicalPathGraph.h"
+#include "PathSearch.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+namespace
+{
+	// a stretch of open cells along a border shorter than this gets one entrance in its middle,
+	// a longer one gets one at each end
+	const int long_entrance = 6;
+}
+
+
+HierarchicalPathGraph::LocalSearch::LocalSearch() :
+	left( 0 ),
+	bottom( 0 ),
+	width( 0 ),
+	height( 0 ),
+	columns( 1 ),
+	costs(),
+	cameFrom(),
+	marks(),
+	searchNumber( 0 ),
+	openCells(),
+	openAround() {}
+
+
+/* searches from the source cell through the open cells within the rectangle, until the target cell is
+ * reached or, if the target is -1, until every cell that can be reached has been
+ */
+void HierarchicalPathGraph::LocalSearch::run( const OccupancyGrid & grid, int m_left, int m_bottom, int m_width, int m_height,
+											   int sourceCell, int targetCell )
+{
+	left = m_left;
+	bottom = m_bottom;
+	width = m_width;
+	height = m_height;
+	columns = grid.getColumns();
+
+	size_t numberOfCells = width * height;
+	if( marks.size() < numberOfCells )
+	{
+		costs.resize( numberOfCells );
+		cameFrom.resize( numberOfCells );
+		marks.assign( numberOfCells, 0 );
+		searchNumber = 0;
+	}
+	if( searchNumber >= numeric_limits<unsigned int>::max() - 2 )
+	{
+		fill( marks.begin(), marks.end(), 0 );
+		searchNumber = 0;
+	}
+	searchNumber += 2;
+
+	// looking the cells up in a copy of the rectangle with a closed border around it saves checking
+	// whether every step leaves the rectangle or the grid
+	openAround.assign( ( width + 2 ) * ( height + 2 ), 0 );
+	size_t numberOfOpenCells = 0;
+	for( int row = 0; row < height; row++ )
+	{
+		for( int column = 0; column < width; column++ )
+		{
+			openAround[ ( ( row + 1 ) * ( width + 2 ) ) + column + 1 ] = grid.isOpen( left + column, bottom + row );
+			numberOfOpenCells += openAround[ ( ( row + 1 ) * ( width + 2 ) ) + column + 1 ];
+		}
+	}
+
+	// when nothing's in the way the shortest way back from every cell goes diagonally towards the source
+	// until it's level with it and then straight on, so there's nothing to search
+	if( numberOfOpenCells == numberOfCells )
+	{
+		int sourceColumn = ( sourceCell % columns ) - left;
+		int sourceRow = ( sourceCell / columns ) - bottom;
+		for( int local = 0; local < ( int ) numberOfCells; local++ )
+		{
+			int column = local % width;
+			int row = local / width;
+			int stepX = ( sourceColumn > column ) ? 1 : ( ( sourceColumn < column ) ? -1 : 0 );
+			int stepY = ( sourceRow > row ) ? 1 : ( ( sourceRow < row ) ? -1 : 0 );
+			marks[ local ] = searchNumber + 1;
+			costs[ local ] = PathSearch::octileDistance( column, row, sourceColumn, sourceRow );
+			cameFrom[ local ] = local + ( stepY * width ) + stepX;
+		}
+		return;
+	}
+
+	int targetColumn = ( targetCell >= 0 ) ? targetCell % columns : 0;
+	int targetRow = ( targetCell >= 0 ) ? targetCell / columns : 0;
+
+	int source = localOf( sourceCell );
+	marks[ source ] = searchNumber;
+	costs[ source ] = 0.0f;
+	cameFrom[ source ] = source;
+	openCells.clear();
+	openCells.push_back( OpenCell( 0.0f, source ) );
+	while( !openCells.empty() )
+	{
+		pop_heap( openCells.begin(), openCells.end() );
+		int local = openCells.back().cell;
+		openCells.pop_back();
+		if( marks[ local ] != searchNumber )
+		{
+			continue;
+		}
+		marks[ local ] = searchNumber + 1;
+
+		int column = left + ( local % width );
+		int row = bottom + ( local / width );
+		if( ( targetCell >= 0 ) && ( ( ( row * columns ) + column ) == targetCell ) )
+		{
+			return;
+		}
+
+		int around = ( ( ( local / width ) + 1 ) * ( width + 2 ) ) + ( local % width ) + 1;
+		for( int stepY = -1; stepY <= 1; stepY++ )
+		{
+			for( int stepX = -1; stepX <= 1; stepX++ )
+			{
+				int nextAround = around + ( stepY * ( width + 2 ) ) + stepX;
+				if( ( ( stepX == 0 ) && ( stepY == 0 ) ) || !openAround[ nextAround ] )
+				{
+					continue;
+				}
+
+				bool diagonal = ( stepX != 0 ) && ( stepY != 0 );
+				if( diagonal && ( !openAround[ around + stepX ] || !openAround[ around + ( stepY * ( width + 2 ) ) ] ) )
+				{
+					continue;
+				}
+
+				int next = local + ( stepY * width ) + stepX;
+				float cost = costs[ local ] + ( diagonal ? PathSearch::diagonal_step : 1.0f );
+				if( ( marks[ next ] == searchNumber + 1 ) || ( ( marks[ next ] == searchNumber ) && ( costs[ next ] <= cost ) ) )
+				{
+					continue;
+				}
+				marks[ next ] = searchNumber;
+				costs[ next ] = cost;
+				cameFrom[ next ] = local;
+
+				float estimate = cost;
+				if( targetCell >= 0 )
+				{
+					estimate += PathSearch::octileDistance( column + stepX, row + stepY, targetColumn, targetRow );
+				}
+				openCells.push_back( OpenCell( estimate, next ) );
+				push_heap( openCells.begin(), openCells.end() );
+			}
+		}
+	}
+}
+
+
+/* true if the shortest way to the cell has been found
+ */
+bool HierarchicalPathGraph::LocalSearch::reached( int cell ) const
+{
+	int column = cell % columns;
+	int row = cell / columns;
+	if( ( column < left ) || ( row < bottom ) || ( column >= left + width ) || ( row >= bottom + height ) )
+	{
+		return false;
+	}
+	return marks[ localOf( cell ) ] == searchNumber + 1;
+}
+
+
+/* adds the cells along the shortest way to the cell, from the one after the source up to the cell
+ */
+void HierarchicalPathGraph::LocalSearch::pathTo( int cell, vector<int> & cells ) const
+{
+	size_t first = cells.size();
+	for( int local = localOf( cell ); cameFrom[ local ] != local; local = cameFrom[ local ] )
+	{
+		cells.push_back( cellOf( local ) );
+	}
+	reverse( cells.begin() + first, cells.end() );
+}
+
+
+/* adds the cells along the shortest way back from the cell, from the one before it down to the source
+ */
+void HierarchicalPathGraph::LocalSearch::pathFrom( int cell, vector<int> & cells ) const
+{
+	int local = localOf( cell );
+	while( cameFrom[ local ] != local )
+	{
+		local = cameFrom[ local ];
+		cells.push_back( cellOf( local ) );
+	}
+}
+
+
+/* clusters are clusterSize cells across, the graph is built over the grid as it is, and the grid
+ * has to outlast the graph
+ */
+HierarchicalPathGraph::HierarchicalPathGraph( OccupancyGrid & m_grid, int m_clusterSize /* = default_cluster_size */ ) :
+	grid( m_grid ),
+	clusterSize( max( 2, m_clusterSize ) ),
+	clusterColumns( 0 ),
+	clusterRows( 0 ),
+	nodes(),
+	freeNodes(),
+	clusterNodes(),
+	rightEntrances(),
+	topEntrances(),
+	search(),
+	components(),
+	numberOfLandmarks( 0 ),
+	landmarkDistances(),
+	openNodes()
+{
+	rebuild();
+}
+
+
+/* throws away the graph and builds it again over the whole grid, for when the grid has been rasterized again
+ */
+void HierarchicalPathGraph::rebuild()
+{
+	clusterColumns = ( grid.getColumns() + clusterSize - 1 ) / clusterSize;
+	clusterRows = ( grid.getRows() + clusterSize - 1 ) / clusterSize;
+	int numberOfClusters = clusterColumns * clusterRows;
+
+	nodes.clear();
+	freeNodes.clear();
+	clusterNodes.assign( numberOfClusters, vector<int>() );
+	rightEntrances.assign( numberOfClusters, vector<int>() );
+	topEntrances.assign( numberOfClusters, vector<int>() );
+
+	for( int cluster = 0; cluster < numberOfClusters; cluster++ )
+	{
+		findEntrances( cluster, true );
+		findEntrances( cluster, false );
+	}
+	for( int cluster = 0; cluster < numberOfClusters; cluster++ )
+	{
+		connectNodes( cluster );
+	}
+	findComponents();
+	findLandmarks();
+}
+
+
+/* adds the line to the grid, and redoes the part of the graph around the cells it blocks
+ */
+void HierarchicalPathGraph::addALine( const LineSegment2D & line )
+{
+	grid.addALine( line );
+
+	int firstColumn, firstRow, lastColumn, lastRow;
+	if( !grid.cellsNear( line, firstColumn, firstRow, lastColumn, lastRow ) )
+	{
+		return;
+	}
+	int firstClusterColumn = firstColumn / clusterSize;
+	int lastClusterColumn = lastColumn / clusterSize;
+	int firstClusterRow = firstRow / clusterSize;
+	int lastClusterRow = lastRow / clusterSize;
+
+	//every border of a cluster the line reaches can have lost some of its entrances
+	for( int clusterRow = max( 0, firstClusterRow - 1 ); clusterRow <= lastClusterRow; clusterRow++ )
+	{
+		for( int clusterColumn = max( 0, firstClusterColumn - 1 ); clusterColumn <= lastClusterColumn; clusterColumn++ )
+		{
+			int cluster = ( clusterRow * clusterColumns ) + clusterColumn;
+			if( clusterRow >= firstClusterRow )
+			{
+				removeEntrances( cluster, true );
+				findEntrances( cluster, true );
+			}
+			if( clusterColumn >= firstClusterColumn )
+			{
+				removeEntrances( cluster, false );
+				findEntrances( cluster, false );
+			}
+		}
+	}
+
+	//which changes the nodes of the clusters on both sides of those borders
+	for( int clusterRow = max( 0, firstClusterRow - 1 ); clusterRow <= min( clusterRows - 1, lastClusterRow + 1 ); clusterRow++ )
+	{
+		for( int clusterColumn = max( 0, firstClusterColumn - 1 ); clusterColumn <= min( clusterColumns - 1, lastClusterColumn + 1 ); clusterColumn++ )
+		{
+			connectNodes( ( clusterRow * clusterColumns ) + clusterColumn );
+		}
+	}
+
+	//the line can have cut the graph in two, but it can only have made the ways between the nodes longer
+	//( give or take where the entrances moved to ), so what the landmarks measured is still a fair estimate
+	findComponents();
+}
+
+
+int HierarchicalPathGraph::clusterOf( int cell ) const
+{
+	int columns = grid.getColumns();
+	return ( ( ( cell / columns ) / clusterSize ) * clusterColumns ) + ( ( cell % columns ) / clusterSize );
+}
+
+
+/* the cells of the cluster, which can be smaller than the rest along the top and right of the grid
+ */
+void HierarchicalPathGraph::clusterBounds( int cluster, int & left, int & bottom, int & width, int & height ) const
+{
+	left = ( cluster % clusterColumns ) * clusterSize;
+	bottom = ( cluster / clusterColumns ) * clusterSize;
+	width = min( clusterSize, grid.getColumns() - left );
+	height = min( clusterSize, grid.getRows() - bottom );
+}
+
+
+/* finds the entrances along the border between the cluster and the one to its right ( or above it ),
+ * where there's an unbroken stretch of cells open on both sides
+ */
+void HierarchicalPathGraph::findEntrances( int cluster, bool rightBorder )
+{
+	int clusterColumn = cluster % clusterColumns;
+	int clusterRow = cluster / clusterColumns;
+	if( rightBorder ? ( clusterColumn + 1 >= clusterColumns ) : ( clusterRow + 1 >= clusterRows ) )
+	{
+		return;
+	}
+
+	int left, bottom, width, height;
+	clusterBounds( cluster, left, bottom, width, height );
+	int columns = grid.getColumns();
+	int otherCluster = rightBorder ? cluster + 1 : cluster + clusterColumns;
+	vector<int> & entrances = rightBorder ? rightEntrances[ cluster ] : topEntrances[ cluster ];
+
+	// walking along the border, the cell on this side is at ( column, row ) and the one across it is a step away
+	int length = rightBorder ? height : width;
+	int runStart = -1;
+	for( int along = 0; along <= length; along++ )
+	{
+		int column = rightBorder ? left + width - 1 : left + along;
+		int row = rightBorder ? bottom + along : bottom + height - 1;
+		bool open = ( along < length ) && grid.isOpen( column, row ) &&
+					grid.isOpen( column + ( rightBorder ? 1 : 0 ), row + ( rightBorder ? 0 : 1 ) );
+		if( open )
+		{
+			if( runStart < 0 )
+			{
+				runStart = along;
+			}
+			continue;
+		}
+		if( runStart < 0 )
+		{
+			continue;
+		}
+
+		int runEnd = along - 1;
+		int places[ 2 ] = { runStart, runEnd };
+		int numberOfPlaces = 2;
+		if( runEnd - runStart + 1 < long_entrance )
+		{
+			places[ 0 ] = ( runStart + runEnd ) / 2;
+			numberOfPlaces = 1;
+		}
+		for( int i = 0; i < numberOfPlaces; i++ )
+		{
+			int placeColumn = rightBorder ? column : left + places[ i ];
+			int placeRow = rightBorder ? bottom + places[ i ] : row;
+			int cell = ( placeRow * columns ) + placeColumn;
+			addEntrance( cell, rightBorder ? cell + 1 : cell + columns, cluster, otherCluster, entrances );
+		}
+		runStart = -1;
+	}
+}
+
+
+/* removes the entrances along the cluster's right ( or top ) border
+ */
+void HierarchicalPathGraph::removeEntrances( int cluster, bool rightBorder )
+{
+	vector<int> & entrances = rightBorder ? rightEntrances[ cluster ] : topEntrances[ cluster ];
+	for( unsigned int i = 0; i < entrances.size(); i++ )
+	{
+		Node & node = nodes[ entrances[ i ] ];
+		vector<int> & inCluster = clusterNodes[ node.cluster ];
+		inCluster.erase( find( inCluster.begin(), inCluster.end(), entrances[ i ] ) );
+		node.inUse = false;
+		node.edges.clear();
+		node.paths.clear();
+		freeNodes.push_back( entrances[ i ] );
+	}
+	entrances.clear();
+}
+
+
+/* adds a node on either side of the border, partnered with each other
+ */
+void HierarchicalPathGraph::addEntrance( int cell, int otherCell, int cluster, int otherCluster, vector<int> & entrances )
+{
+	int node = addANode( cell, cluster );
+	int otherNode = addANode( otherCell, otherCluster );
+	nodes[ node ].partner = otherNode;
+	nodes[ otherNode ].partner = node;
+	entrances.push_back( node );
+	entrances.push_back( otherNode );
+}
+
+
+int HierarchicalPathGraph::addANode( int cell, int cluster )
+{
+	int node;
+	if( freeNodes.empty() )
+	{
+		node = nodes.size();
+		nodes.push_back( Node() );
+	}
+	else
+	{
+		node = freeNodes.back();
+		freeNodes.pop_back();
+	}
+
+	nodes[ node ].cell = cell;
+	nodes[ node ].cluster = cluster;
+	nodes[ node ].partner = -1;
+	nodes[ node ].edges.clear();
+	nodes[ node ].paths.clear();
+	nodes[ node ].inUse = true;
+	clusterNodes[ cluster ].push_back( node );
+
+	// a new node's distances from the landmarks aren't known until they're measured again
+	if( landmarkDistances.size() < nodes.size() * number_of_landmarks )
+	{
+		landmarkDistances.resize( nodes.size() * number_of_landmarks, -1.0f );
+	}
+	fill( landmarkDistances.begin() + ( node * number_of_landmarks ), landmarkDistances.begin() + ( ( node + 1 ) * number_of_landmarks ), -1.0f );
+	return node;
+}
+
+
+/* joins every pair of nodes in the cluster that can reach each other without leaving it
+ */
+void HierarchicalPathGraph::connectNodes( int cluster )
+{
+	const vector<int> & inCluster = clusterNodes[ cluster ];
+	for( unsigned int i = 0; i < inCluster.size(); i++ )
+	{
+		nodes[ inCluster[ i ] ].edges.clear();
+		nodes[ inCluster[ i ] ].paths.clear();
+	}
+
+	int left, bottom, width, height;
+	clusterBounds( cluster, left, bottom, width, height );
+	for( unsigned int i = 0; i + 1 < inCluster.size(); i++ )
+	{
+		Node & from = nodes[ inCluster[ i ] ];
+		search.run( grid, left, bottom, width, height, from.cell, -1 );
+		for( unsigned int j = i + 1; j < inCluster.size(); j++ )
+		{
+			Node & to = nodes[ inCluster[ j ] ];
+			if( search.reached( to.cell ) )
+			{
+				float cost = search.costTo( to.cell );
+				from.edges.push_back( Edge( inCluster[ j ], cost ) );
+				from.paths.push_back( vector<int>() );
+				search.pathTo( to.cell, from.paths.back() );
+				to.edges.push_back( Edge( inCluster[ i ], cost ) );
+				to.paths.push_back( vector<int>() );
+				search.pathFrom( to.cell, to.paths.back() );
+			}
+		}
+	}
+}
+
+
+/* numbers the components and picks the landmarks again, after any change to the nodes or edges
+ */
+void HierarchicalPathGraph::findComponents()
+{
+	components.assign( nodes.size(), -1 );
+	vector<int> toVisit;
+	int numberOfComponents = 0;
+	for( unsigned int first = 0; first < nodes.size(); first++ )
+	{
+		if( !nodes[ first ].inUse || ( components[ first ] >= 0 ) )
+		{
+			continue;
+		}
+
+		components[ first ] = numberOfComponents;
+		toVisit.push_back( first );
+		while( !toVisit.empty() )
+		{
+			const Node & node = nodes[ toVisit.back() ];
+			toVisit.pop_back();
+
+			// the partner across the border, then the nodes joined to it inside the cluster
+			for( int i = -1; i < ( int ) node.edges.size(); i++ )
+			{
+				int next = ( i < 0 ) ? node.partner : node.edges[ i ].node;
+				if( components[ next ] < 0 )
+				{
+					components[ next ] = numberOfComponents;
+					toVisit.push_back( next );
+				}
+			}
+		}
+		numberOfComponents++;
+	}
+}
+
+
+void HierarchicalPathGraph::findLandmarks()
+{
+	numberOfLandmarks = 0;
+	landmarkDistances.assign( nodes.size() * number_of_landmarks, -1.0f );
+
+	// the landmarks all go in the biggest component, searches in the others make do with the straight line estimate
+	vector<int> componentSizes;
+	for( unsigned int node = 0; node < nodes.size(); node++ )
+	{
+		if( components[ node ] >= ( int ) componentSizes.size() )
+		{
+			componentSizes.resize( components[ node ] + 1, 0 );
+		}
+		if( components[ node ] >= 0 )
+		{
+			componentSizes[ components[ node ] ]++;
+		}
+	}
+	if( componentSizes.empty() )
+	{
+		return;
+	}
+	int biggest = max_element( componentSizes.begin(), componentSizes.end() ) - componentSizes.begin();
+	int first = find( components.begin(), components.end(), biggest ) - components.begin();
+
+	// the first landmark is the node farthest from some node of the component,
+	// and each one after it is the node farthest from the closest of the landmarks before it
+	vector<float> closest;
+	vector<float> distances;
+	measureDistancesFrom( first, closest );
+	for( int i = 0; i < number_of_landmarks; i++ )
+	{
+		int landmark = first;
+		for( unsigned int node = 0; node < nodes.size(); node++ )
+		{
+			if( ( components[ node ] == biggest ) && ( closest[ node ] > closest[ landmark ] ) )
+			{
+				landmark = node;
+			}
+		}
+		if( ( i > 0 ) && ( closest[ landmark ] <= 0.0f ) )
+		{
+			// every node of the component is a landmark already
+			break;
+		}
+
+		measureDistancesFrom( landmark, distances );
+		numberOfLandmarks++;
+		for( unsigned int node = 0; node < nodes.size(); node++ )
+		{
+			landmarkDistances[ ( node * number_of_landmarks ) + i ] = distances[ node ];
+			if( ( i == 0 ) || ( distances[ node ] < closest[ node ] ) )
+			{
+				closest[ node ] = distances[ node ];
+			}
+		}
+	}
+}
+
+
+/* the length of the shortest way from the node to every other node, -1 for the ones it can't reach
+ */
+void HierarchicalPathGraph::measureDistancesFrom( int source, vector<float> & distances )
+{
+	distances.assign( nodes.size(), -1.0f );
+	distances[ source ] = 0.0f;
+	openNodes.clear();
+	openNodes.push_back( OpenNode( 0.0f, source ) );
+	while( !openNodes.empty() )
+	{
+		pop_heap( openNodes.begin(), openNodes.end() );
+		OpenNode open = openNodes.back();
+		openNodes.pop_back();
+		if( open.cost > distances[ open.node ] )
+		{
+			continue;
+		}
+
+		const Node & node = nodes[ open.node ];
+		for( int i = -1; i < ( int ) node.edges.size(); i++ )
+		{
+			int next = ( i < 0 ) ? node.partner : node.edges[ i ].node;
+			float cost = open.cost + ( ( i < 0 ) ? 1.0f : node.edges[ i ].cost );
+			if( ( distances[ next ] < 0.0f ) || ( cost < distances[ next ] ) )
+			{
+				distances[ next ] = cost;
+				openNodes.push_back( OpenNode( cost, next ) );
+				push_heap( openNodes.begin(), openNodes.end() );
+			}
+		}
+	}
+}
@@ -0,0 +1,228 @@
+/*
+   Project     : 3DMaze
+   File        : HierarchicalPathGraph.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : An abstraction of an occupancy grid for hierarchical path
+   				 finding. The grid is cut into square clusters, every stretch
+   				 of open cells along the border between two clusters gets an
+   				 entrance ( a node on each side ), and the nodes of a cluster
+   				 are joined by the shortest paths between them that stay
+   				 inside it, which are kept so searches never have to find
+   				 them again. Adding a line to the maze only redoes the
+   				 clusters it reaches and the borders around them. The
+   				 distances from a few landmark nodes to every node are
+   				 kept as well, for searches to estimate how far they are
+   				 from the goal
+*/
+
+
+#ifndef HIERARCHICALPATHGRAPH_H_
+#define HIERARCHICALPATHGRAPH_H_
+
+#include <vector>
+
+#include "LineSegment2D.h"
+#include "OccupancyGrid.h"
+
+class HierarchicalPathGraph
+{
+	public:
+		/* the shortest way from one node to another node of the same cluster, and its length in cells
+		 */
+		class Edge
+		{
+			public:
+				Edge( int m_node, float m_cost ) : node( m_node ), cost( m_cost ) {}
+
+				int node;
+				float cost;
+		};
+
+		/* one side of an entrance, the cell on the other side of the border is its partner's.
+		 * The cells along each edge, from the one after the node's cell up to the one the edge leads to,
+		 * are kept apart from the edges so a search over the nodes doesn't have to wade through them
+		 */
+		class Node
+		{
+			public:
+				Node() : cell( -1 ), cluster( -1 ), partner( -1 ), edges(), paths(), inUse( false ) {}
+
+				int cell;
+				int cluster;
+				int partner;
+				std::vector<Edge> edges;
+				std::vector< std::vector<int> > paths;
+				bool inUse;
+		};
+
+		/* the shortest paths from a cell to the others within a rectangle of the grid, moving the same way
+		 * as PathSearch does, everything it needs is kept between searches
+		 */
+		class LocalSearch
+		{
+			public:
+				LocalSearch();
+
+				/* searches from the source cell through the open cells within the rectangle, until the target cell is
+				 * reached or, if the target is -1, until every cell that can be reached has been
+				 */
+				void run( const OccupancyGrid & grid, int m_left, int m_bottom, int m_width, int m_height, int sourceCell, int targetCell );
+
+				/* true if the shortest way to the cell has been found
+				 */
+				bool reached( int cell ) const;
+				float costTo( int cell ) const { return costs[ localOf( cell ) ]; }
+
+				/* adds the cells along the shortest way to the cell, from the one after the source up to the cell
+				 */
+				void pathTo( int cell, std::vector<int> & cells ) const;
+
+				/* adds the cells along the shortest way back from the cell, from the one before it down to the source
+				 */
+				void pathFrom( int cell, std::vector<int> & cells ) const;
+
+			private:
+				/* a cell on the open list, the heap keeps the one with the lowest estimated total cost on top
+				 */
+				class OpenCell
+				{
+					public:
+						OpenCell( float m_estimate, int m_cell ) : estimate( m_estimate ), cell( m_cell ) {}
+
+						bool operator<( const OpenCell & rhs ) const { return estimate > rhs.estimate; }
+
+						float estimate;
+						int cell;
+				};
+
+				// the rectangle searched, and the number of columns in the whole grid
+				int left, bottom, width, height;
+				int columns;
+
+				// indexed by the cell's place in the rectangle, marked the same way PathSearch marks cells
+				std::vector<float> costs;
+				std::vector<int> cameFrom;
+				std::vector<unsigned int> marks;
+				unsigned int searchNumber;
+				std::vector<OpenCell> openCells;
+
+				// 1 for each open cell of the rectangle, with a border of closed cells one cell wide around it
+				std::vector<unsigned char> openAround;
+
+				int localOf( int cell ) const { return ( ( ( cell / columns ) - bottom ) * width ) + ( cell % columns ) - left; }
+				int cellOf( int local ) const { return ( ( bottom + ( local / width ) ) * columns ) + left + ( local % width ); }
+		};
+
+		/* clusters are clusterSize cells across, the graph is built over the grid as it is, and the grid
+		 * has to outlast the graph
+		 */
+		HierarchicalPathGraph( OccupancyGrid & m_grid, int m_clusterSize = default_cluster_size );
+
+		/* throws away the graph and builds it again over the whole grid, for when the grid has been rasterized again
+		 */
+		void rebuild();
+
+		/* adds the line to the grid, and redoes the part of the graph around the cells it blocks
+		 */
+		void addALine( const LineSegment2D & line );
+
+		const OccupancyGrid & getGrid() const { return grid; }
+		int getClusterSize() const { return clusterSize; }
+		int getClusterColumns() const { return clusterColumns; }
+		int getClusterRows() const { return clusterRows; }
+
+		int clusterOf( int cell ) const;
+
+		/* the cells of the cluster, which can be smaller than the rest along the top and right of the grid
+		 */
+		void clusterBounds( int cluster, int & left, int & bottom, int & width, int & height ) const;
+
+		/* nodes are never moved, so a node's number stays the same until its entrance is removed,
+		 * there are at most as many nodes as there are slots, some of which may not be in use
+		 */
+		int numberOfNodeSlots() const { return nodes.size(); }
+		int numberOfNodes() const { return nodes.size() - freeNodes.size(); }
+		const Node & getNode( int node ) const { return nodes[ node ]; }
+		const std::vector<int> & nodesIn( int cluster ) const { return clusterNodes[ cluster ]; }
+
+		/* nodes that can reach each other through the graph are in the same component, slots not in use are in -1
+		 */
+		int componentOf( int node ) const { return components[ node ]; }
+
+		/* the length of the shortest way through the graph from the landmark to the node, or -1 if there isn't one
+		 * or the node was added by a line since the landmarks were picked. The landmarks are nodes spread as far
+		 * from each other as they'll go, and the difference between a node's and the goal's distances from any of them
+		 * is never more than the way from the node to the goal. They're only picked and measured when the graph
+		 * is rebuilt, lines added after that only make the ways longer so the distances still serve as estimates
+		 */
+		int getNumberOfLandmarks() const { return numberOfLandmarks; }
+		float distanceFromLandmark( int landmark, int node ) const { return landmarkDistances[ ( node * number_of_landmarks ) + landmark ]; }
+
+		static const int default_cluster_size = 32;
+		static const int number_of_landmarks = 16;
+
+	private:
+		OccupancyGrid & grid;
+		int clusterSize;
+		int clusterColumns, clusterRows;
+
+		std::vector<Node> nodes;
+		std::vector<int> freeNodes;
+
+		// the nodes of each cluster, and the nodes of the entrances on its right and top borders ( from both sides )
+		std::vector< std::vector<int> > clusterNodes;
+		std::vector< std::vector<int> > rightEntrances;
+		std::vector< std::vector<int> > topEntrances;
+
+		LocalSearch search;
+
+		std::vector<int> components;
+
+		// the distances from every landmark to a node are kept together, since a search wants all of them at once
+		int numberOfLandmarks;
+		std::vector<float> landmarkDistances;
+
+		/* a node on the open list while measuring the distances from a landmark
+		 */
+		class OpenNode
+		{
+			public:
+				OpenNode( float m_cost, int m_node ) : cost( m_cost ), node( m_node ) {}
+
+				bool operator<( const OpenNode & rhs ) const { return cost > rhs.cost; }
+
+				float cost;
+				int node;
+		};
+		std::vector<OpenNode> openNodes;
+
+		/* finds the entrances along the border between the cluster and the one to its right ( or above it ),
+		 * where there's an unbroken stretch of cells open on both sides
+		 */
+		void findEntrances( int cluster, bool rightBorder );
+
+		/* removes the entrances along the cluster's right ( or top ) border
+		 */
+		void removeEntrances( int cluster, bool rightBorder );
+
+		/* adds a node on either side of the border, partnered with each other
+		 */
+		void addEntrance( int cell, int otherCell, int cluster, int otherCluster, std::vector<int> & entrances );
+		int addANode( int cell, int cluster );
+
+		/* joins every pair of nodes in the cluster that can reach each other without leaving it
+		 */
+		void connectNodes( int cluster );
+
+		/* numbers the components and picks the landmarks again, after any change to the nodes or edges
+		 */
+		void findComponents();
+		void findLandmarks();
+
+		/* the length of the shortest way from the node to every other node, -1 for the ones it can't reach
+		 */
+		void measureDistancesFrom( int source, std::vector<float> & distances );
+};
+
+#endif /*HIERARCHICALPATHGRAPH_H_*/
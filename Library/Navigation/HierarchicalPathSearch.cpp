@@ -0,0 +1,289 @@
+/*
+   Project     : 3DMaze
+   File        : HierarchicalPathSearch.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Finds a path between two points over a hierarchical path
+   				 graph. The start and goal are joined to the nodes of their
+   				 clusters, A* runs over the graph's nodes instead of the grid's
+   				 cells, guided by the graph's landmarks, and the way found is
+   				 filled in with the paths the graph keeps between the nodes.
+   				 The path is close to the shortest one, but not always exactly it
+*/
+
+
+#include "HierarchicalPathSearch.h"
+#include "PathSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace
+{
+	// estimates are stretched by this much, so the search heads for the goal instead of working through
+	// every way that looks about as short, at the cost of a way through the nodes up to this much longer than the best one
+	const float estimate_weight = 1.03f;
+}
+
+
+HierarchicalPathSearch::HierarchicalPathSearch() :
+	costs(),
+	cameFrom(),
+	marks(),
+	searchNumber( 0 ),
+	openNodes(),
+	fromStart(),
+	fromGoal(),
+	goalDistances(),
+	goalComponents(),
+	nodesAlongPath(),
+	cellsAlongPath(),
+	pointsAlongPath(),
+	nodesExpanded( 0 ),
+	graph( NULL ),
+	goalCell( 0 ) {}
+
+
+/* finds a path from start to goal through the open cells of the graph's grid, and returns true if there is one.
+ * The path is given the same way PathSearch gives it
+ */
+bool HierarchicalPathSearch::findPath( const HierarchicalPathGraph & m_graph, const Point2D & start, const Point2D & goal, vector<Point2D> & path )
+{
+	path.clear();
+	nodesExpanded = 0;
+
+	const OccupancyGrid & grid = m_graph.getGrid();
+	int startColumn, startRow, goalColumn, goalRow;
+	if( !grid.cellAt( start, startColumn, startRow ) || !grid.cellAt( goal, goalColumn, goalRow ) ||
+		!grid.isOpen( startColumn, startRow ) || !grid.isOpen( goalColumn, goalRow ) )
+	{
+		return false;
+	}
+
+	prepareFor( m_graph );
+	int columns = grid.getColumns();
+	int startCell = ( startRow * columns ) + startColumn;
+	goalCell = ( goalRow * columns ) + goalColumn;
+	int startCluster = graph->clusterOf( startCell );
+	int goalCluster = graph->clusterOf( goalCell );
+
+	// how far it is from the start to the nodes of its cluster, and from the nodes of the goal's cluster to the goal
+	int left, bottom, width, height;
+	graph->clusterBounds( startCluster, left, bottom, width, height );
+	fromStart.run( grid, left, bottom, width, height, startCell, -1 );
+	graph->clusterBounds( goalCluster, left, bottom, width, height );
+	fromGoal.run( grid, left, bottom, width, height, goalCell, -1 );
+
+	// when both are in the same cluster the way between them that stays in it may be the best one
+	float direct = -1.0f;
+	if( ( startCluster == goalCluster ) && fromStart.reached( goalCell ) )
+	{
+		direct = fromStart.costTo( goalCell );
+	}
+
+	// how far the goal is from each landmark, through the nodes of its cluster,
+	// a landmark is no use when any of those nodes' distances from it aren't known
+	const vector<int> & goalNodes = graph->nodesIn( goalCluster );
+	goalDistances.assign( graph->getNumberOfLandmarks(), numeric_limits<float>::max() );
+	goalComponents.clear();
+	for( unsigned int i = 0; i < goalNodes.size(); i++ )
+	{
+		int cell = graph->getNode( goalNodes[ i ] ).cell;
+		if( !fromGoal.reached( cell ) )
+		{
+			continue;
+		}
+		for( int landmark = 0; landmark < graph->getNumberOfLandmarks(); landmark++ )
+		{
+			float distance = graph->distanceFromLandmark( landmark, goalNodes[ i ] );
+			if( ( distance < 0.0f ) || ( goalDistances[ landmark ] < 0.0f ) )
+			{
+				goalDistances[ landmark ] = -1.0f;
+			}
+			else
+			{
+				goalDistances[ landmark ] = min( goalDistances[ landmark ], distance + fromGoal.costTo( cell ) );
+			}
+		}
+		if( find( goalComponents.begin(), goalComponents.end(), graph->componentOf( goalNodes[ i ] ) ) == goalComponents.end() )
+		{
+			goalComponents.push_back( graph->componentOf( goalNodes[ i ] ) );
+		}
+	}
+
+	// nodes in any other component can't lead to the goal, so when the goal's cut off from the start nothing is searched.
+	// The search only ever stops at the nodes just inside a cluster, stepping across the border from the nodes on the way out
+	const vector<int> & startNodes = graph->nodesIn( startCluster );
+	openNodes.clear();
+	for( unsigned int i = 0; i < startNodes.size(); i++ )
+	{
+		if( fromStart.reached( graph->getNode( startNodes[ i ] ).cell ) &&
+			( find( goalComponents.begin(), goalComponents.end(), graph->componentOf( startNodes[ i ] ) ) != goalComponents.end() ) )
+		{
+			reach( graph->getNode( startNodes[ i ] ).partner, -1, fromStart.costTo( graph->getNode( startNodes[ i ] ).cell ) + 1.0f );
+		}
+	}
+
+	// the goal itself is the node after the last slot
+	int goalNode = graph->numberOfNodeSlots();
+	while( !openNodes.empty() )
+	{
+		if( ( direct >= 0.0f ) && ( direct <= openNodes.front().estimate ) )
+		{
+			break;
+		}
+
+		pop_heap( openNodes.begin(), openNodes.end() );
+		int node = openNodes.back().node;
+		openNodes.pop_back();
+		if( marks[ node ] != searchNumber )
+		{
+			continue;
+		}
+		marks[ node ] = searchNumber + 1;
+		nodesExpanded++;
+
+		if( node == goalNode )
+		{
+			// each node the way comes to is preceded by its partner on the other side of the border
+			nodesAlongPath.clear();
+			for( int along = cameFrom[ goalNode ]; along >= 0; along = cameFrom[ along ] )
+			{
+				nodesAlongPath.push_back( along );
+				nodesAlongPath.push_back( graph->getNode( along ).partner );
+			}
+			reverse( nodesAlongPath.begin(), nodesAlongPath.end() );
+			refinePath( startCell );
+			PathSearch::smoothPath( grid, cellsAlongPath, start, goal, pointsAlongPath, path );
+			return true;
+		}
+
+		const HierarchicalPathGraph::Node & expanded = graph->getNode( node );
+		if( ( expanded.cluster == goalCluster ) && fromGoal.reached( expanded.cell ) )
+		{
+			reach( goalNode, node, costs[ node ] + fromGoal.costTo( expanded.cell ) );
+		}
+		// every edge from the node it leads to is matched by one from this node, so there's no need to stop there
+		// instead of going straight on across the border
+		for( unsigned int i = 0; i < expanded.edges.size(); i++ )
+		{
+			reach( graph->getNode( expanded.edges[ i ].node ).partner, node, costs[ node ] + expanded.edges[ i ].cost + 1.0f );
+		}
+	}
+
+	if( direct < 0.0f )
+	{
+		return false;
+	}
+	cellsAlongPath.clear();
+	cellsAlongPath.push_back( startCell );
+	fromStart.pathTo( goalCell, cellsAlongPath );
+	PathSearch::smoothPath( grid, cellsAlongPath, start, goal, pointsAlongPath, path );
+	return true;
+}
+
+
+/* makes sure there's room for every node of the graph, and starts a new search number
+ */
+void HierarchicalPathSearch::prepareFor( const HierarchicalPathGraph & m_graph )
+{
+	graph = &m_graph;
+
+	size_t numberOfNodes = graph->numberOfNodeSlots() + 1;
+	if( marks.size() < numberOfNodes )
+	{
+		costs.resize( numberOfNodes );
+		cameFrom.resize( numberOfNodes );
+		marks.assign( numberOfNodes, 0 );
+		searchNumber = 0;
+	}
+
+	//once the numbers run out every mark has to be cleared, which only happens once every couple of billion searches
+	if( searchNumber >= numeric_limits<unsigned int>::max() - 2 )
+	{
+		fill( marks.begin(), marks.end(), 0 );
+		searchNumber = 0;
+	}
+	searchNumber += 2;
+}
+
+
+/* adds the node to the open list, if the given way to it is better than the best one found so far
+ */
+void HierarchicalPathSearch::reach( int node, int from, float cost )
+{
+	if( ( marks[ node ] == searchNumber + 1 ) || ( ( marks[ node ] == searchNumber ) && ( costs[ node ] <= cost ) ) )
+	{
+		return;
+	}
+
+	marks[ node ] = searchNumber;
+	costs[ node ] = cost;
+	cameFrom[ node ] = from;
+
+	float estimate = cost;
+	if( node < graph->numberOfNodeSlots() )
+	{
+		estimate += estimate_weight * estimateToGoal( node );
+	}
+	openNodes.push_back( OpenNode( estimate, node ) );
+	push_heap( openNodes.begin(), openNodes.end() );
+}
+
+
+/* never more than the length of the way from the node to the goal
+ */
+float HierarchicalPathSearch::estimateToGoal( int node ) const
+{
+	int columns = graph->getGrid().getColumns();
+	int cell = graph->getNode( node ).cell;
+	float estimate = PathSearch::octileDistance( cell % columns, cell / columns, goalCell % columns, goalCell / columns );
+
+	// the way to the goal is at least as long as the difference between the node's and the goal's distances from a landmark,
+	// which in a maze is usually far longer than the straight line
+	for( int landmark = 0; landmark < graph->getNumberOfLandmarks(); landmark++ )
+	{
+		float distance = graph->distanceFromLandmark( landmark, node );
+		if( ( distance >= 0.0f ) && ( goalDistances[ landmark ] >= 0.0f ) )
+		{
+			estimate = max( estimate, ( float ) fabs( goalDistances[ landmark ] - distance ) );
+		}
+	}
+	return estimate;
+}
+
+
+/* fills in the cells along the way found through the nodes
+ */
+void HierarchicalPathSearch::refinePath( int startCell )
+{
+	cellsAlongPath.clear();
+	cellsAlongPath.push_back( startCell );
+	fromStart.pathTo( graph->getNode( nodesAlongPath.front() ).cell, cellsAlongPath );
+
+	for( unsigned int i = 0; i + 1 < nodesAlongPath.size(); i++ )
+	{
+		const HierarchicalPathGraph::Node & from = graph->getNode( nodesAlongPath[ i ] );
+		const HierarchicalPathGraph::Node & to = graph->getNode( nodesAlongPath[ i + 1 ] );
+		if( from.cluster != to.cluster )
+		{
+			// across an entrance, into the neighboring cell
+			cellsAlongPath.push_back( to.cell );
+			continue;
+		}
+
+		for( unsigned int j = 0; j < from.edges.size(); j++ )
+		{
+			if( from.edges[ j ].node == nodesAlongPath[ i + 1 ] )
+			{
+				cellsAlongPath.insert( cellsAlongPath.end(), from.paths[ j ].begin(), from.paths[ j ].end() );
+				break;
+			}
+		}
+	}
+
+	fromGoal.pathFrom( graph->getNode( nodesAlongPath.back() ).cell, cellsAlongPath );
+}
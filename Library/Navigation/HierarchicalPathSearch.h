@@ -0,0 +1,93 @@
+/*
+   Project     : 3DMaze
+   File        : HierarchicalPathSearch.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Finds a path between two points over a hierarchical path
+   				 graph. The start and goal are joined to the nodes of their
+   				 clusters, A* runs over the graph's nodes instead of the grid's
+   				 cells, guided by the graph's landmarks, and the way found is
+   				 filled in with the paths the graph keeps between the nodes.
+   				 The path is close to the shortest one, but not always exactly it
+*/
+
+
+#ifndef HIERARCHICALPATHSEARCH_H_
+#define HIERARCHICALPATHSEARCH_H_
+
+#include <vector>
+
+#include "Point2D.h"
+#include "HierarchicalPathGraph.h"
+
+class HierarchicalPathSearch
+{
+	public:
+		HierarchicalPathSearch();
+
+		/* finds a path from start to goal through the open cells of the graph's grid, and returns true if there is one.
+		 * The path is given the same way PathSearch gives it
+		 */
+		bool findPath( const HierarchicalPathGraph & graph, const Point2D & start, const Point2D & goal, std::vector<Point2D> & path );
+
+		/* the number of nodes the last search took off the open list
+		 */
+		int getNodesExpanded() const { return nodesExpanded; }
+
+	private:
+		/* a node on the open list, the heap keeps the one with the lowest estimated total cost on top
+		 */
+		class OpenNode
+		{
+			public:
+				OpenNode( float m_estimate, int m_node ) : estimate( m_estimate ), node( m_node ) {}
+
+				bool operator<( const OpenNode & rhs ) const { return estimate > rhs.estimate; }
+
+				float estimate;
+				int node;
+		};
+
+		// for each node slot ( and one more for the goal ), marked the same way PathSearch marks cells
+		std::vector<float> costs;
+		std::vector<int> cameFrom;
+		std::vector<unsigned int> marks;
+		unsigned int searchNumber;
+		std::vector<OpenNode> openNodes;
+
+		// the ways from the start and from the goal to the nodes of their clusters
+		HierarchicalPathGraph::LocalSearch fromStart;
+		HierarchicalPathGraph::LocalSearch fromGoal;
+
+		// how far the goal is from each of the graph's landmarks ( -1 for the ones that are no use ),
+		// and the components of the nodes it can be reached from
+		std::vector<float> goalDistances;
+		std::vector<int> goalComponents;
+
+		std::vector<int> nodesAlongPath;
+		std::vector<int> cellsAlongPath;
+		std::vector<Point2D> pointsAlongPath;
+		int nodesExpanded;
+
+		// the graph being searched and its goal, for the length of a search
+		const HierarchicalPathGraph * graph;
+		int goalCell;
+
+		/* makes sure there's room for every node of the graph, and starts a new search number
+		 */
+		void prepareFor( const HierarchicalPathGraph & m_graph );
+
+		/* adds the node to the open list, if the given way to it is better than the best one found so far
+		 */
+		void reach( int node, int from, float cost );
+
+		/* never more than the length of the way from the node to the goal
+		 */
+		float estimateToGoal( int node ) const;
+
+		/* fills in the cells along the way found through the nodes
+		 */
+		void refinePath( int startCell );
+};
+
+#endif /*HIERARCHICALPATHSEARCH_H_*/
@@ -0,0 +1,755 @@
+/*
+   Project     : 3DMaze
+   File        : NavigationGraph.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Splits the open floor of a 2D maze into convex regions
+   				 a player can walk straight across, and keeps track of the
+   				 portals joining each region to its neighbors. Walls are
+   				 inflated by the player's buffer before the floor is split,
+   				 so anywhere inside a region is somewhere the player can stand
+*/
+
+
+#include "NavigationGraph.h"
+
+#include <set>
+#include <algorithm>
+#include <cmath>
+
+#include "Vector2D.h"
+#include "WallFootprintUnion.h"
+
+using namespace std;
+
+namespace
+{
+	// distances smaller than this are considered to be rounding error
+	const double smudgeFactor = 0.001;
+
+	double crossProduct( double ax, double ay, double bx, double by )
+	{
+		return ( ax * by ) - ( ay * bx );
+	}
+
+	/* how far to the left of the line from start to end the point is, times the length of the line
+	 */
+	double sideOf( const Point2D & start, const Point2D & end, const Point2D & point )
+	{
+		return crossProduct( end.getX() - start.getX(), end.getY() - start.getY(), point.getX() - start.getX(), point.getY() - start.getY() );
+	}
+
+	double heightAlong( const LineSegment2D & edge, double x )
+	{
+		double fraction = ( x - edge.getP1().getX() ) / ( edge.getP2().getX() - edge.getP1().getX() );
+		return edge.getP1().getY() + ( fraction * ( edge.getP2().getY() - edge.getP1().getY() ) );
+	}
+
+	/* adds a corner to the outline, unless it's right on top of the last one
+	 */
+	void addACorner( Polygon2D & outline, const Point2D & corner )
+	{
+		if( ( outline.numberOfPoints() == 0 ) || ( outline.getAPoint( outline.numberOfPoints() - 1 ).distanceTo( corner ) > smudgeFactor ) )
+		{
+			outline.addAPoint( corner );
+		}
+	}
+
+	/* drops a last corner that's right on top of the first
+	 */
+	Polygon2D closeOutline( const Polygon2D & outline )
+	{
+		Polygon2D closed;
+		int numberOfCorners = outline.numberOfPoints();
+		if( ( numberOfCorners > 1 ) && ( outline.getAPoint( numberOfCorners - 1 ).distanceTo( outline.getAPoint( 0 ) ) <= smudgeFactor ) )
+		{
+			numberOfCorners--;
+		}
+		for( int i = 0; i < numberOfCorners; i++ )
+		{
+			closed.addAPoint( outline.getAPoint( i ) );
+		}
+		return closed;
+	}
+
+	/* the part of a convex outline on the left of the line from start to end ( or on the right, if keepLeft is false )
+	 */
+	Polygon2D clipOutline( const Polygon2D & outline, const Point2D & start, const Point2D & end, bool keepLeft )
+	{
+		Polygon2D clipped;
+		double sign = keepLeft ? 1.0 : -1.0;
+		for( int i = 0; i < outline.numberOfPoints(); i++ )
+		{
+			const Point2D & current = outline.getAPoint( i );
+			const Point2D & next = outline.getAPoint( ( i + 1 ) % outline.numberOfPoints() );
+			double currentSide = sign * sideOf( start, end, current );
+			double nextSide = sign * sideOf( start, end, next );
+
+			if( currentSide >= 0.0 )
+			{
+				addACorner( clipped, current );
+			}
+			if( ( ( currentSide > 0.0 ) && ( nextSide < 0.0 ) ) || ( ( currentSide < 0.0 ) && ( nextSide > 0.0 ) ) )
+			{
+				double fraction = currentSide / ( currentSide - nextSide );
+				addACorner( clipped, Point2D( current.getX() + ( fraction * ( next.getX() - current.getX() ) ),
+											  current.getY() + ( fraction * ( next.getY() - current.getY() ) ) ) );
+			}
+		}
+		return closeOutline( clipped );
+	}
+
+	bool hasArea( const Polygon2D & outline )
+	{
+		return ( outline.numberOfPoints() >= 3 ) && ( outline.signedArea() > ( smudgeFactor * smudgeFactor ) );
+	}
+
+	/* finds the stretch of boundary two convex outlines share, if they share any more than a point
+	 */
+	bool sharedBoundary( const Polygon2D & first, const Polygon2D & second, LineSegment2D & crossing )
+	{
+		for( int i = 0; i < first.numberOfPoints(); i++ )
+		{
+			const Point2D & start = first.getAPoint( i );
+			const Point2D & end = first.getAPoint( ( i + 1 ) % first.numberOfPoints() );
+			Vector2D along( end.getX() - start.getX(), end.getY() - start.getY() );
+			double length = along.length();
+			if( length <= smudgeFactor )
+			{
+				continue;
+			}
+
+			for( int j = 0; j < second.numberOfPoints(); j++ )
+			{
+				const Point2D & otherStart = second.getAPoint( j );
+				const Point2D & otherEnd = second.getAPoint( ( j + 1 ) % second.numberOfPoints() );
+				if( ( fabs( sideOf( start, end, otherStart ) ) > ( smudgeFactor * length ) ) ||
+					( fabs( sideOf( start, end, otherEnd ) ) > ( smudgeFactor * length ) ) )
+				{
+					continue;
+				}
+
+				//both edges lie along the same line, so they share whatever stretch of it they both cover
+				double otherStartAlong = along.dotProduct( Vector2D( otherStart.getX() - start.getX(), otherStart.getY() - start.getY() ) ) / length;
+				double otherEndAlong = along.dotProduct( Vector2D( otherEnd.getX() - start.getX(), otherEnd.getY() - start.getY() ) ) / length;
+				double from = max( 0.0, min( otherStartAlong, otherEndAlong ) );
+				double to = min( length, max( otherStartAlong, otherEndAlong ) );
+				if( ( to - from ) > smudgeFactor )
+				{
+					crossing = LineSegment2D( Point2D( start.getX() + ( along.getX() * from / length ), start.getY() + ( along.getY() * from / length ) ),
+											  Point2D( start.getX() + ( along.getX() * to / length ), start.getY() + ( along.getY() * to / length ) ) );
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
+	/* orders the edges crossing the strip being swept from the bottom up,
+	 * the edges of the walls' outlines never cross, so within a strip the order never changes
+	 */
+	class EdgeOrder
+	{
+		public:
+			EdgeOrder( const vector<LineSegment2D> & m_edges, const double & m_sweepX ) : edges( &m_edges ), sweepX( &m_sweepX ) {}
+
+			bool operator()( int first, int second ) const
+			{
+				if( first == second )
+				{
+					return false;
+				}
+				double firstHeight = heightAlong( ( *edges )[ first ], *sweepX );
+				double secondHeight = heightAlong( ( *edges )[ second ], *sweepX );
+				if( firstHeight != secondHeight )
+				{
+					return firstHeight < secondHeight;
+				}
+				return first < second;
+			}
+
+		private:
+			const vector<LineSegment2D> * edges;
+			const double * sweepX;
+	};
+
+	/* one side of a trapezoid along a line parallel to the y-axis
+	 */
+	class Side
+	{
+		public:
+			Side( double m_bottom, double m_top, int m_region ) : bottom( m_bottom ), top( m_top ), region( m_region ) {}
+
+			bool operator<( const Side & rhs ) const { return bottom < rhs.bottom; }
+
+			double bottom, top;
+			int region;
+	};
+}
+
+
+NavigationGraph::Region::Region() :
+	outline(),
+	portals(),
+	minX( 0.0 ),
+	minY( 0.0 ),
+	maxX( 0.0 ),
+	maxY( 0.0 ),
+	removed( false ) {}
+
+
+/* the average of the region's corners, which is always inside it
+ */
+Point2D NavigationGraph::Region::center() const
+{
+	double x = 0.0;
+	double y = 0.0;
+	for( int i = 0; i < outline.numberOfPoints(); i++ )
+	{
+		x += outline.getAPoint( i ).getX();
+		y += outline.getAPoint( i ).getY();
+	}
+	int numberOfCorners = max( 1, outline.numberOfPoints() );
+	return Point2D( x / numberOfCorners, y / numberOfCorners );
+}
+
+
+/* true if the point is inside the region or on its edge
+ */
+bool NavigationGraph::Region::contains( const Point2D & point ) const
+{
+	if( removed || ( point.getX() < minX - smudgeFactor ) || ( point.getX() > maxX + smudgeFactor ) ||
+		( point.getY() < minY - smudgeFactor ) || ( point.getY() > maxY + smudgeFactor ) )
+	{
+		return false;
+	}
+	for( int i = 0; i < outline.numberOfPoints(); i++ )
+	{
+		const Point2D & start = outline.getAPoint( i );
+		const Point2D & end = outline.getAPoint( ( i + 1 ) % outline.numberOfPoints() );
+		if( sideOf( start, end, point ) < -( smudgeFactor * start.distanceTo( end ) ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* the walls are widthOfWall across, and the player keeps bufferDistance away from them
+ */
+NavigationGraph::NavigationGraph( const Maze2D & maze, double m_widthOfWall, double m_bufferDistance ) :
+	widthOfWall( m_widthOfWall ),
+	bufferDistance( m_bufferDistance ),
+	regions(),
+	openRegions( 0 ),
+	portalsBetweenRegions( 0 ),
+	bucketsLeft( 0.0 ),
+	bucketsBottom( 0.0 ),
+	bucketSize( 1.0 ),
+	bucketsAcross( 1 ),
+	bucketsUp( 1 ),
+	buckets()
+{
+	//the player can't come any closer than the buffer to any side of a wall, ends included
+	WallFootprintUnion walls( maze, widthOfWall + ( 2.0 * bufferDistance ), bufferDistance );
+	double left = -maze.getWidth() / 2.0;
+	double bottom = -maze.getHeight() / 2.0;
+	double right = maze.getWidth() / 2.0;
+	double top = maze.getHeight() / 2.0;
+	decomposeFreeSpace( walls, left, bottom, right, top );
+
+	setUpBuckets( left, bottom, right, top, regions.size() );
+	for( unsigned int region = 0; region < regions.size(); region++ )
+	{
+		placeInBuckets( region );
+	}
+}
+
+
+const NavigationGraph::Region & NavigationGraph::getARegion( int index ) const
+{
+	return regions.at( index );
+}
+
+
+/* the region holding the point, or -1 if the point is too close to a wall or outside the maze
+ */
+int NavigationGraph::regionAt( const Point2D & point ) const
+{
+	int firstColumn, firstRow, lastColumn, lastRow;
+	bucketRange( point.getX(), point.getY(), point.getX(), point.getY(), firstColumn, firstRow, lastColumn, lastRow );
+	const vector<int> & bucket = buckets[ ( firstRow * bucketsAcross ) + firstColumn ];
+	for( unsigned int i = 0; i < bucket.size(); i++ )
+	{
+		if( regions[ bucket[ i ] ].contains( point ) )
+		{
+			return bucket[ i ];
+		}
+	}
+	return -1;
+}
+
+
+/* cuts the inflated footprint of a newly added wall out of the regions it covers,
+ * only the regions it touches are replaced, everything else is left as it is
+ */
+void NavigationGraph::addALine( const LineSegment2D & line )
+{
+	if( line.getP1().distanceTo( line.getP2() ) <= smudgeFactor )
+	{
+		return;
+	}
+
+	WallFootprintUnion::Footprint footprint( line, widthOfWall + ( 2.0 * bufferDistance ), bufferDistance );
+	vector<int> nearby;
+	regionsNear( footprint.getMinX(), footprint.getMinY(), footprint.getMaxX(), footprint.getMaxY(), nearby );
+
+	/* the floor that's left of a convex region once a convex footprint is cut out of it is
+	 * the part outside the footprint's first side, then the part inside the first side but outside the second,
+	 * and so on, each of which is convex
+	 */
+	vector<int> covered;
+	vector<Polygon2D> pieces;
+	for( unsigned int i = 0; i < nearby.size(); i++ )
+	{
+		Polygon2D remaining = regions[ nearby[ i ] ].outline;
+		vector<Polygon2D> piecesOfRegion;
+		for( int side = 0; ( side < 4 ) && hasArea( remaining ); side++ )
+		{
+			const Point2D & start = footprint.getACorner( side );
+			const Point2D & end = footprint.getACorner( side + 1 );
+			Polygon2D outside = clipOutline( remaining, start, end, false );
+			if( hasArea( outside ) )
+			{
+				piecesOfRegion.push_back( outside );
+			}
+			remaining = clipOutline( remaining, start, end, true );
+		}
+
+		//a region the footprint doesn't cut into is left alone
+		if( hasArea( remaining ) )
+		{
+			covered.push_back( nearby[ i ] );
+			pieces.insert( pieces.end(), piecesOfRegion.begin(), piecesOfRegion.end() );
+		}
+	}
+	if( covered.empty() )
+	{
+		return;
+	}
+
+	//the pieces can only meet each other, or the regions the covered regions used to meet
+	vector<int> neighbors;
+	for( unsigned int i = 0; i < covered.size(); i++ )
+	{
+		const vector<Portal> & portals = regions[ covered[ i ] ].portals;
+		for( unsigned int j = 0; j < portals.size(); j++ )
+		{
+			neighbors.push_back( portals[ j ].region );
+		}
+	}
+	for( unsigned int i = 0; i < covered.size(); i++ )
+	{
+		removeARegion( covered[ i ] );
+	}
+	sort( neighbors.begin(), neighbors.end() );
+	neighbors.erase( unique( neighbors.begin(), neighbors.end() ), neighbors.end() );
+
+	vector<int> newRegions;
+	for( unsigned int i = 0; i < pieces.size(); i++ )
+	{
+		int region = addARegion( pieces[ i ] );
+		placeInBuckets( region );
+		newRegions.push_back( region );
+	}
+
+	LineSegment2D crossing;
+	for( unsigned int i = 0; i < newRegions.size(); i++ )
+	{
+		const Polygon2D & outline = regions[ newRegions[ i ] ].outline;
+		for( unsigned int j = i + 1; j < newRegions.size(); j++ )
+		{
+			if( sharedBoundary( outline, regions[ newRegions[ j ] ].outline, crossing ) )
+			{
+				connect( newRegions[ i ], newRegions[ j ], crossing );
+			}
+		}
+		for( unsigned int j = 0; j < neighbors.size(); j++ )
+		{
+			if( !regions[ neighbors[ j ] ].removed && sharedBoundary( outline, regions[ neighbors[ j ] ].outline, crossing ) )
+			{
+				connect( newRegions[ i ], neighbors[ j ], crossing );
+			}
+		}
+	}
+}
+
+
+/* splits the space inside the given rectangle that isn't covered by the walls into trapezoids whose parallel sides
+ * run along the y-axis, with a portal wherever two trapezoids meet, sweeping across the maze from left to right
+ */
+void NavigationGraph::decomposeFreeSpace( const WallFootprintUnion & walls, double left, double bottom, double right, double top )
+{
+	/* gather every edge of every outline, pointing in the positive x direction, along with
+	 * every x value at which an edge starts or stops. The outlines keep the walls on their left,
+	 * so an edge that had to be turned around to point that way has the open floor above it
+	 */
+	vector<LineSegment2D> edges;
+	vector<bool> openAbove;
+	vector<double> stops;
+	for( int i = 0; i < walls.numberOfOutlines(); i++ )
+	{
+		const Polygon2D & outline = walls.getAnOutline( i );
+		for( int j = 0; j < outline.numberOfPoints(); j++ )
+		{
+			LineSegment2D edge( outline.getAnEdge( j ) );
+			stops.push_back( edge.getP1().getX() );
+
+			//edges parallel to the y-axis don't bound any trapezoid from above or below
+			if( fabs( edge.getP2().getX() - edge.getP1().getX() ) > smudgeFactor )
+			{
+				bool turnedAround = edge.getP1().getX() > edge.getP2().getX();
+				if( turnedAround )
+				{
+					edge = LineSegment2D( edge.getP2(), edge.getP1() );
+				}
+				edges.push_back( edge );
+				openAbove.push_back( turnedAround );
+			}
+		}
+	}
+
+	sort( stops.begin(), stops.end() );
+	vector<double> distinctStops;
+	for( unsigned int i = 0; i < stops.size(); i++ )
+	{
+		if( distinctStops.empty() || ( stops[ i ] - distinctStops.back() ) > smudgeFactor )
+		{
+			distinctStops.push_back( stops[ i ] );
+		}
+	}
+	int numberOfStops = distinctStops.size();
+
+	//which edges start and finish at each stop
+	vector< vector<int> > startingAt( numberOfStops );
+	vector< vector<int> > finishingAt( numberOfStops );
+	for( unsigned int i = 0; i < edges.size(); i++ )
+	{
+		int start = lower_bound( distinctStops.begin(), distinctStops.end(), edges[ i ].getP1().getX() - smudgeFactor ) - distinctStops.begin();
+		int finish = lower_bound( distinctStops.begin(), distinctStops.end(), edges[ i ].getP2().getX() - smudgeFactor ) - distinctStops.begin();
+		if( ( start < finish ) && ( finish < numberOfStops ) )
+		{
+			startingAt[ start ].push_back( i );
+			finishingAt[ finish ].push_back( i );
+		}
+	}
+
+	/* sweep across the stops, keeping the edges crossing the strip after each stop in order from the bottom up.
+	 * The open floor in a strip is the space above each edge with open floor above it, up to the next edge,
+	 * and it stays one trapezoid for as long as it's between the same two edges. Only the trapezoids next to
+	 * the edges that start or finish at a stop can change there, and where one closes and another opens
+	 * on the same stretch of a stop the two are joined by a portal
+	 */
+	double sweepX = 0.0;
+	typedef set<int, EdgeOrder> ActiveEdges;
+	ActiveEdges activeEdges( ( EdgeOrder( edges, sweepX ) ) );
+	vector<ActiveEdges::iterator> positions( edges.size(), activeEdges.end() );
+	vector<bool> active( edges.size(), false );
+
+	// for each edge with a trapezoid open above it, the edge along the top of the trapezoid and the trapezoid's region
+	vector<int> edgeAbove( edges.size(), -1 );
+	vector<int> regionAbove( edges.size(), -1 );
+	vector<double> leftOfRegion( edges.size(), 0.0 );
+
+	vector<int> changed;
+	vector<Side> closed;
+	vector<Side> opened;
+	for( int stop = 0; stop < numberOfStops; stop++ )
+	{
+		double x = distinctStops[ stop ];
+		changed.clear();
+		closed.clear();
+		opened.clear();
+
+		//edges finishing here take the space above them, and above the edge below them, with them
+		const vector<int> & finishing = finishingAt[ stop ];
+		for( unsigned int i = 0; i < finishing.size(); i++ )
+		{
+			ActiveEdges::iterator position = positions[ finishing[ i ] ];
+			if( position != activeEdges.begin() )
+			{
+				ActiveEdges::iterator below = position;
+				--below;
+				changed.push_back( *below );
+			}
+			changed.push_back( finishing[ i ] );
+		}
+		for( unsigned int i = 0; i < finishing.size(); i++ )
+		{
+			activeEdges.erase( positions[ finishing[ i ] ] );
+			active[ finishing[ i ] ] = false;
+		}
+
+		//and edges starting here split the space they start in
+		if( stop + 1 < numberOfStops )
+		{
+			sweepX = ( x + distinctStops[ stop + 1 ] ) / 2.0;
+			const vector<int> & starting = startingAt[ stop ];
+			for( unsigned int i = 0; i < starting.size(); i++ )
+			{
+				positions[ starting[ i ] ] = activeEdges.insert( starting[ i ] ).first;
+				active[ starting[ i ] ] = true;
+			}
+			for( unsigned int i = 0; i < starting.size(); i++ )
+			{
+				ActiveEdges::iterator position = positions[ starting[ i ] ];
+				if( position != activeEdges.begin() )
+				{
+					ActiveEdges::iterator below = position;
+					--below;
+					changed.push_back( *below );
+				}
+				changed.push_back( starting[ i ] );
+			}
+		}
+
+		sort( changed.begin(), changed.end() );
+		changed.erase( unique( changed.begin(), changed.end() ), changed.end() );
+		for( unsigned int i = 0; i < changed.size(); i++ )
+		{
+			int edge = changed[ i ];
+			int newEdgeAbove = -1;
+			if( active[ edge ] && openAbove[ edge ] )
+			{
+				ActiveEdges::iterator above = positions[ edge ];
+				++above;
+				if( above != activeEdges.end() )
+				{
+					newEdgeAbove = *above;
+				}
+			}
+			if( newEdgeAbove == edgeAbove[ edge ] )
+			{
+				continue;
+			}
+
+			if( edgeAbove[ edge ] >= 0 )
+			{
+				//finish off the trapezoid that was open above the edge
+				const LineSegment2D & below = edges[ edge ];
+				const LineSegment2D & above = edges[ edgeAbove[ edge ] ];
+				double start = leftOfRegion[ edge ];
+				Polygon2D outline;
+				addACorner( outline, Point2D( start, heightAlong( below, start ) ) );
+				addACorner( outline, Point2D( x, heightAlong( below, x ) ) );
+				addACorner( outline, Point2D( x, heightAlong( above, x ) ) );
+				addACorner( outline, Point2D( start, heightAlong( above, start ) ) );
+				regions[ regionAbove[ edge ] ].outline = closeOutline( outline );
+				closed.push_back( Side( heightAlong( below, x ), heightAlong( above, x ), regionAbove[ edge ] ) );
+			}
+
+			edgeAbove[ edge ] = newEdgeAbove;
+			regionAbove[ edge ] = -1;
+			if( newEdgeAbove >= 0 )
+			{
+				regionAbove[ edge ] = addARegion( Polygon2D() );
+				leftOfRegion[ edge ] = x;
+				opened.push_back( Side( heightAlong( edges[ edge ], x ), heightAlong( edges[ newEdgeAbove ], x ), regionAbove[ edge ] ) );
+			}
+		}
+
+		//the trapezoids closed here don't overlap each other, and neither do the ones opened here,
+		//so going up both lists together finds every place one meets another
+		sort( closed.begin(), closed.end() );
+		sort( opened.begin(), opened.end() );
+		unsigned int nextClosed = 0;
+		unsigned int nextOpened = 0;
+		while( ( nextClosed < closed.size() ) && ( nextOpened < opened.size() ) )
+		{
+			const Side & leftSide = closed[ nextClosed ];
+			const Side & rightSide = opened[ nextOpened ];
+			double from = max( max( leftSide.bottom, rightSide.bottom ), bottom );
+			double to = min( min( leftSide.top, rightSide.top ), top );
+			if( ( ( to - from ) > smudgeFactor ) && ( x > left + smudgeFactor ) && ( x < right - smudgeFactor ) )
+			{
+				connect( leftSide.region, rightSide.region, LineSegment2D( Point2D( x, from ), Point2D( x, to ) ) );
+			}
+			if( leftSide.top < rightSide.top )
+			{
+				nextClosed++;
+			}
+			else
+			{
+				nextOpened++;
+			}
+		}
+	}
+
+	/* lines sticking out past the edges of the maze can leave pockets of open space outside it,
+	 * so every trapezoid is cut down to the maze, and the ones left without any floor are dropped
+	 */
+	for( unsigned int region = 0; region < regions.size(); region++ )
+	{
+		Polygon2D & outline = regions[ region ].outline;
+		outline = clipOutline( outline, Point2D( left, bottom ), Point2D( right, bottom ), true );
+		outline = clipOutline( outline, Point2D( right, bottom ), Point2D( right, top ), true );
+		outline = clipOutline( outline, Point2D( right, top ), Point2D( left, top ), true );
+		outline = clipOutline( outline, Point2D( left, top ), Point2D( left, bottom ), true );
+		if( !hasArea( outline ) )
+		{
+			disconnect( region );
+			regions[ region ].outline = Polygon2D();
+			regions[ region ].removed = true;
+			openRegions--;
+		}
+	}
+}
+
+
+/* adds a region with the given outline, and no portals yet, returning its number
+ */
+int NavigationGraph::addARegion( const Polygon2D & outline )
+{
+	regions.push_back( Region() );
+	regions.back().outline = outline;
+	openRegions++;
+	return regions.size() - 1;
+}
+
+
+/* sets the region's bounds from its outline and drops it into the buckets it covers
+ */
+void NavigationGraph::placeInBuckets( int region )
+{
+	Region & placed = regions[ region ];
+	if( placed.outline.numberOfPoints() == 0 )
+	{
+		return;
+	}
+
+	placed.minX = placed.maxX = placed.outline.getAPoint( 0 ).getX();
+	placed.minY = placed.maxY = placed.outline.getAPoint( 0 ).getY();
+	for( int i = 1; i < placed.outline.numberOfPoints(); i++ )
+	{
+		placed.minX = min<double>( placed.minX, placed.outline.getAPoint( i ).getX() );
+		placed.maxX = max<double>( placed.maxX, placed.outline.getAPoint( i ).getX() );
+		placed.minY = min<double>( placed.minY, placed.outline.getAPoint( i ).getY() );
+		placed.maxY = max<double>( placed.maxY, placed.outline.getAPoint( i ).getY() );
+	}
+
+	int firstColumn, firstRow, lastColumn, lastRow;
+	bucketRange( placed.minX, placed.minY, placed.maxX, placed.maxY, firstColumn, firstRow, lastColumn, lastRow );
+	for( int row = firstRow; row <= lastRow; row++ )
+	{
+		for( int column = firstColumn; column <= lastColumn; column++ )
+		{
+			buckets[ ( row * bucketsAcross ) + column ].push_back( region );
+		}
+	}
+}
+
+
+/* takes the region out of its buckets and out of its neighbors' portals, and leaves its slot empty
+ */
+void NavigationGraph::removeARegion( int region )
+{
+	Region & removed = regions[ region ];
+
+	int firstColumn, firstRow, lastColumn, lastRow;
+	bucketRange( removed.minX, removed.minY, removed.maxX, removed.maxY, firstColumn, firstRow, lastColumn, lastRow );
+	for( int row = firstRow; row <= lastRow; row++ )
+	{
+		for( int column = firstColumn; column <= lastColumn; column++ )
+		{
+			vector<int> & bucket = buckets[ ( row * bucketsAcross ) + column ];
+			bucket.erase( remove( bucket.begin(), bucket.end(), region ), bucket.end() );
+		}
+	}
+
+	disconnect( region );
+	removed.outline = Polygon2D();
+	removed.removed = true;
+	openRegions--;
+}
+
+
+/* takes the region out of its neighbors' portals, and clears its own
+ */
+void NavigationGraph::disconnect( int region )
+{
+	vector<Portal> & portalsOut = regions[ region ].portals;
+	for( unsigned int i = 0; i < portalsOut.size(); i++ )
+	{
+		vector<Portal> & portals = regions[ portalsOut[ i ].region ].portals;
+		for( unsigned int j = 0; j < portals.size(); j++ )
+		{
+			if( portals[ j ].region == region )
+			{
+				portals.erase( portals.begin() + j );
+				break;
+			}
+		}
+	}
+	portalsBetweenRegions -= portalsOut.size();
+	portalsOut.clear();
+}
+
+
+void NavigationGraph::connect( int first, int second, const LineSegment2D & crossing )
+{
+	regions[ first ].portals.push_back( Portal( second, crossing ) );
+	regions[ second ].portals.push_back( Portal( first, crossing ) );
+	portalsBetweenRegions++;
+}
+
+
+/* sets up the buckets to cover the given area, with about as many buckets as the given number of regions
+ */
+void NavigationGraph::setUpBuckets( double left, double bottom, double right, double top, int expectedRegions )
+{
+	bucketsLeft = left;
+	bucketsBottom = bottom;
+	bucketSize = max( smudgeFactor, sqrt( ( ( right - left ) * ( top - bottom ) ) / max( 1, expectedRegions ) ) );
+	bucketsAcross = ( int ) ( ( right - left ) / bucketSize ) + 1;
+	bucketsUp = ( int ) ( ( top - bottom ) / bucketSize ) + 1;
+	buckets.assign( bucketsAcross * bucketsUp, vector<int>() );
+}
+
+
+void NavigationGraph::bucketRange( double minX, double minY, double maxX, double maxY,
+								   int & firstColumn, int & firstRow, int & lastColumn, int & lastRow ) const
+{
+	//anything outside the area the buckets cover goes in the nearest buckets
+	firstColumn = max( 0, min( bucketsAcross - 1, ( int ) floor( ( minX - smudgeFactor - bucketsLeft ) / bucketSize ) ) );
+	lastColumn = max( 0, min( bucketsAcross - 1, ( int ) floor( ( maxX + smudgeFactor - bucketsLeft ) / bucketSize ) ) );
+	firstRow = max( 0, min( bucketsUp - 1, ( int ) floor( ( minY - smudgeFactor - bucketsBottom ) / bucketSize ) ) );
+	lastRow = max( 0, min( bucketsUp - 1, ( int ) floor( ( maxY + smudgeFactor - bucketsBottom ) / bucketSize ) ) );
+}
+
+
+/* the regions whose bounds come near the given area, each listed once
+ */
+void NavigationGraph::regionsNear( double minX, double minY, double maxX, double maxY, vector<int> & nearby ) const
+{
+	int firstColumn, firstRow, lastColumn, lastRow;
+	bucketRange( minX, minY, maxX, maxY, firstColumn, firstRow, lastColumn, lastRow );
+	for( int row = firstRow; row <= lastRow; row++ )
+	{
+		for( int column = firstColumn; column <= lastColumn; column++ )
+		{
+			const vector<int> & bucket = buckets[ ( row * bucketsAcross ) + column ];
+			for( unsigned int i = 0; i < bucket.size(); i++ )
+			{
+				const Region & region = regions[ bucket[ i ] ];
+				if( ( region.minX <= maxX + smudgeFactor ) && ( region.maxX >= minX - smudgeFactor ) &&
+					( region.minY <= maxY + smudgeFactor ) && ( region.maxY >= minY - smudgeFactor ) )
+				{
+					nearby.push_back( bucket[ i ] );
+				}
+			}
+		}
+	}
+	sort( nearby.begin(), nearby.end() );
+	nearby.erase( unique( nearby.begin(), nearby.end() ), nearby.end() );
+}
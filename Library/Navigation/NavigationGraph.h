@@ -0,0 +1,138 @@
+/*
+   Project     : 3DMaze
+   File        : NavigationGraph.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Splits the open floor of a 2D maze into convex regions
+   				 a player can walk straight across, and keeps track of the
+   				 portals joining each region to its neighbors. Walls are
+   				 inflated by the player's buffer before the floor is split,
+   				 so anywhere inside a region is somewhere the player can stand
+*/
+
+
+#ifndef NAVIGATIONGRAPH_H_
+#define NAVIGATIONGRAPH_H_
+
+#include <vector>
+
+#include "Point2D.h"
+#include "LineSegment2D.h"
+#include "Polygon2D.h"
+#include "Maze2D.h"
+
+class WallFootprintUnion;
+
+class NavigationGraph
+{
+	public:
+		/* where a region's floor meets a neighboring region's, walking across it leads into that region
+		 */
+		class Portal
+		{
+			public:
+				Portal( int m_region, const LineSegment2D & m_crossing ) : region( m_region ), crossing( m_crossing ) {}
+
+				int region;
+				LineSegment2D crossing;
+		};
+
+		/* a convex piece of open floor, its corners listed counter-clockwise
+		 */
+		class Region
+		{
+			public:
+				Region();
+
+				Polygon2D outline;
+				std::vector<Portal> portals;
+				double minX, minY, maxX, maxY;
+
+				// a region cut up by a line added later is left in place without an outline or portals,
+				// so the numbers of the other regions never change
+				bool removed;
+
+				/* the average of the region's corners, which is always inside it
+				 */
+				Point2D center() const;
+
+				/* true if the point is inside the region or on its edge
+				 */
+				bool contains( const Point2D & point ) const;
+		};
+
+		/* the walls are widthOfWall across, and the player keeps bufferDistance away from them
+		 */
+		NavigationGraph( const Maze2D & maze, double m_widthOfWall, double m_bufferDistance );
+
+		/* every region ever made, including the ones that have been removed
+		 */
+		int numberOfRegions() const { return regions.size(); }
+		int numberOfOpenRegions() const { return openRegions; }
+		const Region & getARegion( int index ) const;
+
+		/* each portal is counted once, though both of the regions it joins list it
+		 */
+		int numberOfPortals() const { return portalsBetweenRegions; }
+
+		/* the region holding the point, or -1 if the point is too close to a wall or outside the maze
+		 */
+		int regionAt( const Point2D & point ) const;
+
+		/* cuts the inflated footprint of a newly added wall out of the regions it covers,
+		 * only the regions it touches are replaced, everything else is left as it is
+		 */
+		void addALine( const LineSegment2D & line );
+
+		double getWidthOfWall() const { return widthOfWall; }
+		double getBufferDistance() const { return bufferDistance; }
+
+	private:
+		double widthOfWall;
+		double bufferDistance;
+
+		std::vector<Region> regions;
+		int openRegions;
+		int portalsBetweenRegions;
+
+		// regions are dropped into a grid of square buckets covering the maze, so finding the regions near a point is quick
+		double bucketsLeft, bucketsBottom;
+		double bucketSize;
+		int bucketsAcross, bucketsUp;
+		std::vector< std::vector<int> > buckets;
+
+		/* splits the space inside the given rectangle that isn't covered by the walls into trapezoids whose parallel sides
+		 * run along the y-axis, with a portal wherever two trapezoids meet, sweeping across the maze from left to right
+		 */
+		void decomposeFreeSpace( const WallFootprintUnion & walls, double left, double bottom, double right, double top );
+
+		/* adds a region with the given outline, and no portals yet, returning its number
+		 */
+		int addARegion( const Polygon2D & outline );
+
+		/* sets the region's bounds from its outline and drops it into the buckets it covers
+		 */
+		void placeInBuckets( int region );
+
+		/* takes the region out of its buckets and out of its neighbors' portals, and leaves its slot empty
+		 */
+		void removeARegion( int region );
+
+		/* takes the region out of its neighbors' portals, and clears its own
+		 */
+		void disconnect( int region );
+
+		void connect( int first, int second, const LineSegment2D & crossing );
+
+		/* sets up the buckets to cover the given area, with about as many buckets as the given number of regions
+		 */
+		void setUpBuckets( double left, double bottom, double right, double top, int expectedRegions );
+		void bucketRange( double minX, double minY, double maxX, double maxY,
+						  int & firstColumn, int & firstRow, int & lastColumn, int & lastRow ) const;
+
+		/* the regions whose bounds come near the given area, each listed once
+		 */
+		void regionsNear( double minX, double minY, double maxX, double maxY, std::vector<int> & nearby ) const;
+};
+
+#endif /*NAVIGATIONGRAPH_H_*/
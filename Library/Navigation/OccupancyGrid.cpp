@@ -0,0 +1,316 @@
+/*
+   Project     : 3DMaze
+   File        : OccupancyGrid.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A bitmap of square cells covering a 2D maze, one bit a cell,
+   				 set for every cell that comes within a given clearance of
+   				 a wall. A path that only passes through open cells never
+   				 comes any closer to a wall than the clearance
+*/
+
+
+#include "OccupancyGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+const int OccupancyGrid::max_cells;
+
+namespace
+{
+	/* narrows the range of x values from low to high down to those where
+	 * from <= ( slope * x ) + offset <= to, leaving high below low if there aren't any
+	 */
+	void narrowRange( double slope, double offset, double from, double to, double & low, double & high )
+	{
+		if( slope == 0.0 )
+		{
+			if( ( offset < from ) || ( offset > to ) )
+			{
+				high = low - 1.0;
+			}
+			return;
+		}
+		double first = ( from - offset ) / slope;
+		double second = ( to - offset ) / slope;
+		low = max( low, min( first, second ) );
+		high = min( high, max( first, second ) );
+	}
+}
+
+
+/* an empty grid, with no cells until a maze is rasterized into it
+ */
+OccupancyGrid::OccupancyGrid() :
+	left( 0.0 ),
+	bottom( 0.0 ),
+	cellSize( 1.0 ),
+	clearance( 0.0 ),
+	columns( 0 ),
+	rows( 0 ),
+	wordsPerRow( 0 ),
+	bits() {}
+
+
+/* cells are cellSize across, or wider for mazes that would need more than max_cells of them,
+ * and any cell within the clearance of a wall is blocked
+ */
+OccupancyGrid::OccupancyGrid( const Maze2D & maze, double m_cellSize, double m_clearance ) :
+	left( 0.0 ),
+	bottom( 0.0 ),
+	cellSize( 1.0 ),
+	clearance( 0.0 ),
+	columns( 0 ),
+	rows( 0 ),
+	wordsPerRow( 0 ),
+	bits()
+{
+	rasterize( maze, m_cellSize, m_clearance );
+}
+
+
+/* throws away whatever was in the grid and covers the given maze instead,
+ * throws an OperationCanceled if the progress monitor cancels it ( leaving the grid half covered )
+ */
+void OccupancyGrid::rasterize( const Maze2D & maze, double m_cellSize, double m_clearance, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	double area = max( 1.0, ( double ) maze.getWidth() * maze.getHeight() );
+	cellSize = max( m_cellSize, sqrt( area / max_cells ) );
+	while( ( max( 1.0, ceil( maze.getWidth() / cellSize ) ) * max( 1.0, ceil( maze.getHeight() / cellSize ) ) ) > max_cells )
+	{
+		cellSize *= 1.25;	//long thin mazes need their cells wider still
+	}
+
+	clearance = m_clearance;
+	left = -maze.getWidth() / 2.0;
+	bottom = -maze.getHeight() / 2.0;
+	columns = max( 1, ( int ) ceil( maze.getWidth() / cellSize ) );
+	rows = max( 1, ( int ) ceil( maze.getHeight() / cellSize ) );
+	wordsPerRow = ( columns + 63 ) / 64;
+	bits.assign( ( size_t ) wordsPerRow * rows, 0 );
+
+	for( int i = 0; i < maze.numberOfLines(); i++ )
+	{
+		if( ( i % ProgressMonitor::steps_between_check_ins ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, ( double ) i / maze.numberOfLines() );
+		}
+		addALine( maze.getALine( i ) );
+	}
+	ProgressMonitor::checkIn( progress, 1.0 );
+}
+
+
+/* trades cells with the other grid, without copying them
+ */
+void OccupancyGrid::swap( OccupancyGrid & other )
+{
+	std::swap( left, other.left );
+	std::swap( bottom, other.bottom );
+	std::swap( cellSize, other.cellSize );
+	std::swap( clearance, other.clearance );
+	std::swap( columns, other.columns );
+	std::swap( rows, other.rows );
+	std::swap( wordsPerRow, other.wordsPerRow );
+	bits.swap( other.bits );
+}
+
+
+/* blocks the cells within the clearance of a line that's been added to the maze
+ */
+void OccupancyGrid::addALine( const LineSegment2D & line )
+{
+	/* a cell is blocked if any part of it comes within the clearance of the line,
+	 * which it can only do if its center is within the clearance plus half the cell's diagonal
+	 */
+	double reach = clearance + ( cellSize * sqrt( 2.0 ) / 2.0 );
+
+	const Point2D & p1 = line.getP1();
+	const Point2D & p2 = line.getP2();
+	double alongX = p2.getX() - p1.getX();
+	double alongY = p2.getY() - p1.getY();
+	double length = sqrt( ( alongX * alongX ) + ( alongY * alongY ) );
+
+	int firstRow = max( 0, ( int ) ceil( ( ( min( p1.getY(), p2.getY() ) - reach - bottom ) / cellSize ) - 0.5 ) );
+	int lastRow = min( rows - 1, ( int ) floor( ( ( max( p1.getY(), p2.getY() ) + reach - bottom ) / cellSize ) - 0.5 ) );
+	for( int row = firstRow; row <= lastRow; row++ )
+	{
+		/* the points within reach of a line make up a convex shape, so the centers of the cells in a row
+		 * that are within reach run unbroken from the lowest x value to the highest one found within reach
+		 * of either end of the line, or of the stretch in between
+		 */
+		double y = bottom + ( ( row + 0.5 ) * cellSize );
+		bool found = false;
+		double low = 0.0;
+		double high = 0.0;
+
+		const Point2D * ends[ 2 ] = { &p1, &p2 };
+		for( int i = 0; i < 2; i++ )
+		{
+			double height = fabs( y - ends[ i ]->getY() );
+			if( height <= reach )
+			{
+				double halfWidth = sqrt( ( reach * reach ) - ( height * height ) );
+				low = found ? min( low, ends[ i ]->getX() - halfWidth ) : ends[ i ]->getX() - halfWidth;
+				high = found ? max( high, ends[ i ]->getX() + halfWidth ) : ends[ i ]->getX() + halfWidth;
+				found = true;
+			}
+		}
+
+		if( length > 0.0 )
+		{
+			// between the ends, the point has to be no further than the reach from the line, and alongside it
+			double betweenLow = left - reach;
+			double betweenHigh = left + ( columns * cellSize ) + reach;
+			narrowRange( alongY / length, ( ( p1.getY() - y ) * alongX / length ) - ( p1.getX() * alongY / length ), -reach, reach, betweenLow, betweenHigh );
+			narrowRange( alongX, ( ( y - p1.getY() ) * alongY ) - ( p1.getX() * alongX ), 0.0, length * length, betweenLow, betweenHigh );
+			if( betweenLow <= betweenHigh )
+			{
+				low = found ? min( low, betweenLow ) : betweenLow;
+				high = found ? max( high, betweenHigh ) : betweenHigh;
+				found = true;
+			}
+		}
+
+		if( found )
+		{
+			int firstColumn = max( 0, ( int ) ceil( max( -1.0, ( ( low - left ) / cellSize ) - 0.5 ) ) );
+			int lastColumn = min( columns - 1, ( int ) floor( min( ( double ) columns, ( ( high - left ) / cellSize ) - 0.5 ) ) );
+			if( firstColumn <= lastColumn )
+			{
+				block( row, firstColumn, lastColumn );
+			}
+		}
+	}
+}
+
+
+/* the rectangle of cells that adding the line could block, returns false if it can't block any
+ */
+bool OccupancyGrid::cellsNear( const LineSegment2D & line, int & firstColumn, int & firstRow, int & lastColumn, int & lastRow ) const
+{
+	double reach = clearance + ( cellSize * sqrt( 2.0 ) / 2.0 );
+	const Point2D & p1 = line.getP1();
+	const Point2D & p2 = line.getP2();
+	firstColumn = max( 0, ( int ) ceil( max( -1.0, ( ( min( p1.getX(), p2.getX() ) - reach - left ) / cellSize ) - 0.5 ) ) );
+	lastColumn = min( columns - 1, ( int ) floor( min( ( double ) columns, ( ( max( p1.getX(), p2.getX() ) + reach - left ) / cellSize ) - 0.5 ) ) );
+	firstRow = max( 0, ( int ) ceil( max( -1.0, ( ( min( p1.getY(), p2.getY() ) - reach - bottom ) / cellSize ) - 0.5 ) ) );
+	lastRow = min( rows - 1, ( int ) floor( min( ( double ) rows, ( ( max( p1.getY(), p2.getY() ) + reach - bottom ) / cellSize ) - 0.5 ) ) );
+	return ( firstColumn <= lastColumn ) && ( firstRow <= lastRow );
+}
+
+
+/* finds the cell holding the point, returns false if the point is outside the grid
+ */
+bool OccupancyGrid::cellAt( const Point2D & point, int & column, int & row ) const
+{
+	double x = floor( ( point.getX() - left ) / cellSize );
+	double y = floor( ( point.getY() - bottom ) / cellSize );
+	if( ( x < 0.0 ) || ( y < 0.0 ) || ( x >= columns ) || ( y >= rows ) )
+	{
+		return false;
+	}
+	column = ( int ) x;
+	row = ( int ) y;
+	return true;
+}
+
+
+Point2D OccupancyGrid::centerOf( int column, int row ) const
+{
+	return Point2D( left + ( ( column + 0.5 ) * cellSize ), bottom + ( ( row + 0.5 ) * cellSize ) );
+}
+
+
+/* true if every cell the straight line between the points passes through is open
+ * ( where the line passes exactly through a corner, the cells on both sides of the corner have to be open )
+ */
+bool OccupancyGrid::lineOfSight( const Point2D & from, const Point2D & to ) const
+{
+	int column, row, lastColumn, lastRow;
+	if( !cellAt( from, column, row ) || !cellAt( to, lastColumn, lastRow ) || !isOpen( column, row ) )
+	{
+		return false;
+	}
+
+	// step from cell to cell along the line, always into whichever neighbor the line reaches first
+	double startX = ( from.getX() - left ) / cellSize;
+	double startY = ( from.getY() - bottom ) / cellSize;
+	double alongX = ( ( to.getX() - left ) / cellSize ) - startX;
+	double alongY = ( ( to.getY() - bottom ) / cellSize ) - startY;
+	int stepX = ( lastColumn > column ) ? 1 : -1;
+	int stepY = ( lastRow > row ) ? 1 : -1;
+
+	// how far along the line ( from 0 to 1 ) the next column and row begin, and how far it is between them
+	double nextColumnAt = ( column != lastColumn ) ? ( ( column + ( stepX > 0 ? 1 : 0 ) ) - startX ) / alongX : 2.0;
+	double nextRowAt = ( row != lastRow ) ? ( ( row + ( stepY > 0 ? 1 : 0 ) ) - startY ) / alongY : 2.0;
+	double betweenColumns = ( column != lastColumn ) ? fabs( 1.0 / alongX ) : 0.0;
+	double betweenRows = ( row != lastRow ) ? fabs( 1.0 / alongY ) : 0.0;
+
+	// the line crosses exactly this many column and row boundaries, however rounding turns out
+	int columnsLeft = abs( lastColumn - column );
+	int rowsLeft = abs( lastRow - row );
+	const double sameSpot = 1e-9;
+	while( ( columnsLeft > 0 ) || ( rowsLeft > 0 ) )
+	{
+		if( ( rowsLeft == 0 ) || ( ( columnsLeft > 0 ) && ( nextColumnAt < nextRowAt - sameSpot ) ) )
+		{
+			column += stepX;
+			nextColumnAt += betweenColumns;
+			columnsLeft--;
+		}
+		else if( ( columnsLeft == 0 ) || ( nextRowAt < nextColumnAt - sameSpot ) )
+		{
+			row += stepY;
+			nextRowAt += betweenRows;
+			rowsLeft--;
+		}
+		else
+		{
+			//through a corner
+			if( !isOpen( column + stepX, row ) || !isOpen( column, row + stepY ) )
+			{
+				return false;
+			}
+			column += stepX;
+			row += stepY;
+			nextColumnAt += betweenColumns;
+			nextRowAt += betweenRows;
+			columnsLeft--;
+			rowsLeft--;
+		}
+
+		if( !isOpen( column, row ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* sets the bits of the cells from firstColumn to lastColumn in the row
+ */
+void OccupancyGrid::block( int row, int firstColumn, int lastColumn )
+{
+	uint64_t * rowBits = &bits[ ( size_t ) row * wordsPerRow ];
+	int firstWord = firstColumn >> 6;
+	int lastWord = lastColumn >> 6;
+	uint64_t firstMask = ~( uint64_t ) 0 << ( firstColumn & 63 );
+	uint64_t lastMask = ~( uint64_t ) 0 >> ( 63 - ( lastColumn & 63 ) );
+	if( firstWord == lastWord )
+	{
+		rowBits[ firstWord ] |= ( firstMask & lastMask );
+		return;
+	}
+	rowBits[ firstWord ] |= firstMask;
+	for( int word = firstWord + 1; word < lastWord; word++ )
+	{
+		rowBits[ word ] = ~( uint64_t ) 0;
+	}
+	rowBits[ lastWord ] |= lastMask;
+}
@@ -0,0 +1,94 @@
+/*
+   Project     : 3DMaze
+   File        : OccupancyGrid.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : A bitmap of square cells covering a 2D maze, one bit a cell,
+   				 set for every cell that comes within a given clearance of
+   				 a wall. A path that only passes through open cells never
+   				 comes any closer to a wall than the clearance
+*/
+
+
+#ifndef OCCUPANCYGRID_H_
+#define OCCUPANCYGRID_H_
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+#include "Point2D.h"
+#include "LineSegment2D.h"
+#include "Maze2D.h"
+#include "ProgressMonitor.h"
+
+class OccupancyGrid
+{
+	public:
+		/* an empty grid, with no cells until a maze is rasterized into it
+		 */
+		OccupancyGrid();
+
+		/* cells are cellSize across, or wider for mazes that would need more than max_cells of them,
+		 * and any cell within the clearance of a wall is blocked
+		 */
+		OccupancyGrid( const Maze2D & maze, double m_cellSize, double m_clearance );
+
+		/* throws away whatever was in the grid and covers the given maze instead,
+		 * throws an OperationCanceled if the progress monitor cancels it ( leaving the grid half covered )
+		 */
+		void rasterize( const Maze2D & maze, double m_cellSize, double m_clearance, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		/* trades cells with the other grid, without copying them
+		 */
+		void swap( OccupancyGrid & other );
+
+		/* blocks the cells within the clearance of a line that's been added to the maze
+		 */
+		void addALine( const LineSegment2D & line );
+
+		/* the rectangle of cells that adding the line could block, returns false if it can't block any
+		 */
+		bool cellsNear( const LineSegment2D & line, int & firstColumn, int & firstRow, int & lastColumn, int & lastRow ) const;
+
+		int getColumns() const { return columns; }
+		int getRows() const { return rows; }
+		std::size_t numberOfCells() const { return ( std::size_t ) columns * rows; }
+		double getCellSize() const { return cellSize; }
+		double getClearance() const { return clearance; }
+
+		/* cells outside the grid are never open
+		 */
+		bool isOpen( int column, int row ) const
+		{
+			return ( column >= 0 ) && ( row >= 0 ) && ( column < columns ) && ( row < rows ) &&
+				   ( ( bits[ ( ( std::size_t ) row * wordsPerRow ) + ( column >> 6 ) ] >> ( column & 63 ) ) & 1 ) == 0;
+		}
+
+		/* finds the cell holding the point, returns false if the point is outside the grid
+		 */
+		bool cellAt( const Point2D & point, int & column, int & row ) const;
+		Point2D centerOf( int column, int row ) const;
+
+		/* true if every cell the straight line between the points passes through is open
+		 * ( where the line passes exactly through a corner, the cells on both sides of the corner have to be open )
+		 */
+		bool lineOfSight( const Point2D & from, const Point2D & to ) const;
+
+		// grids never have more cells than this, which keeps every cell's index well within an int
+		static const int max_cells = 1 << 24;
+
+	private:
+		double left, bottom;
+		double cellSize;
+		double clearance;
+		int columns, rows;
+		int wordsPerRow;
+		std::vector<uint64_t> bits;
+
+		/* sets the bits of the cells from firstColumn to lastColumn in the row
+		 */
+		void block( int row, int firstColumn, int lastColumn );
+};
+
+#endif /*OCCUPANCYGRID_H_*/
@@ -0,0 +1,296 @@
+/*
+   Project     : 3DMaze
+   File        : PathQueryBatch.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Answers a batch of path queries on every core at once. Each
+   				 thread starts with an even share of the queries and, once it
+   				 runs out, steals half of what's left of another thread's
+   				 share. Every thread keeps its own search, so after the first
+   				 batch the searches allocate nothing. The queries go to either
+   				 a flat search of an occupancy grid or a hierarchical search of
+   				 a graph built over one, and the results come back in the same
+   				 order as the queries
+*/
+
+
+#include "PathQueryBatch.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+
+#include <algorithm>
+#include <cmath>
+
+#include "PathSearch.h"
+#include "HierarchicalPathSearch.h"
+
+using namespace std;
+
+
+/* one thread's share of the queries and the searches it answers them with,
+ * its share is a run of queries it takes from the front of, and other threads steal from the back of
+ */
+class PathQueryBatch::Worker : public QRunnable
+{
+	public:
+		Worker( const OccupancyGrid * m_grid, const HierarchicalPathGraph * m_graph, bool m_jumpPointSearch ) :
+			grid( m_grid ),
+			graph( m_graph ),
+			search( m_jumpPointSearch ),
+			hierarchicalSearch(),
+			share(),
+			nextQuery( 0 ),
+			endOfShare( 0 ),
+			workers( NULL ),
+			queries( NULL ),
+			results( NULL ),
+			queriesDone( NULL ),
+			stop( NULL )
+		{
+			setAutoDelete( false );
+		}
+
+		void setUp( int firstQuery, int lastQuery, vector<Worker *> & m_workers, const vector<Query> & m_queries,
+					vector<Result> & m_results, QAtomicInt & m_queriesDone, QAtomicInt & m_stop )
+		{
+			nextQuery = firstQuery;
+			endOfShare = lastQuery;
+			workers = &m_workers;
+			queries = &m_queries;
+			results = &m_results;
+			queriesDone = &m_queriesDone;
+			stop = &m_stop;
+		}
+
+		void run()
+		{
+			int first, last;
+			while( takeFromShare( first, last ) || stealFromAnother( first, last ) )
+			{
+				for( int query = first; query < last; query++ )
+				{
+					if( *stop != 0 )
+					{
+						return;
+					}
+					answer( query );
+				}
+				queriesDone->fetchAndAddOrdered( last - first );
+			}
+		}
+
+	private:
+		const OccupancyGrid * grid;
+		const HierarchicalPathGraph * graph;
+		PathSearch search;
+		HierarchicalPathSearch hierarchicalSearch;
+
+		// guards the share, which this thread and any thread stealing from it both change
+		QMutex share;
+		int nextQuery, endOfShare;
+
+		vector<Worker *> * workers;
+		const vector<Query> * queries;
+		vector<Result> * results;
+		QAtomicInt * queriesDone;
+		QAtomicInt * stop;
+
+		/* takes the next few queries from the front of the share, returns false if there are none left
+		 */
+		bool takeFromShare( int & first, int & last )
+		{
+			QMutexLocker locker( &share );
+			if( nextQuery >= endOfShare )
+			{
+				return false;
+			}
+			first = nextQuery;
+			last = min( endOfShare, nextQuery + queries_per_turn );
+			nextQuery = last;
+			return true;
+		}
+
+		/* takes the back half of what's left of another thread's share, trying each other thread in turn,
+		 * and makes it this thread's share, returns false once every other share has run out too
+		 */
+		bool stealFromAnother( int & first, int & last )
+		{
+			int numberOfWorkers = workers->size();
+			int self = find( workers->begin(), workers->end(), this ) - workers->begin();
+			for( int i = 1; i < numberOfWorkers; i++ )
+			{
+				Worker * victim = ( *workers )[ ( self + i ) % numberOfWorkers ];
+				int stolenFrom, stolenTo;
+				{
+					QMutexLocker locker( &victim->share );
+					int left = victim->endOfShare - victim->nextQuery;
+					if( left <= 0 )
+					{
+						continue;
+					}
+					stolenTo = victim->endOfShare;
+					stolenFrom = stolenTo - ( ( left + 1 ) / 2 );
+					victim->endOfShare = stolenFrom;
+				}
+
+				{
+					QMutexLocker locker( &share );
+					nextQuery = stolenFrom;
+					endOfShare = stolenTo;
+				}
+				return takeFromShare( first, last );
+			}
+			return false;
+		}
+
+		void answer( int query )
+		{
+			const Query & startAndGoal = ( *queries )[ query ];
+			Result & result = ( *results )[ query ];
+			QElapsedTimer timer;
+			timer.start();
+			if( graph != NULL )
+			{
+				result.found = hierarchicalSearch.findPath( *graph, startAndGoal.first, startAndGoal.second, result.path );
+			}
+			else
+			{
+				result.found = search.findPath( *grid, startAndGoal.first, startAndGoal.second, result.path );
+			}
+			result.seconds = timer.nsecsElapsed() / 1e9;
+		}
+};
+
+
+/* queries are answered by searching the grid cell by cell ( with jump point search, if asked for ),
+ * on the given number of threads, or on one thread for each core when that's 0
+ */
+PathQueryBatch::PathQueryBatch( const OccupancyGrid & m_grid, bool m_jumpPointSearch /* = true */, int m_numberOfThreads /* = 0 */ ) :
+	grid( &m_grid ),
+	graph( NULL ),
+	jumpPointSearch( m_jumpPointSearch ),
+	numberOfThreads( ( m_numberOfThreads > 0 ) ? m_numberOfThreads : max( 1, QThread::idealThreadCount() ) ),
+	workers(),
+	secondsTaken( 0.0 ),
+	latencies()
+{
+	createWorkers();
+}
+
+
+/* queries are answered by a hierarchical search of the graph,
+ * on the given number of threads, or on one thread for each core when that's 0
+ */
+PathQueryBatch::PathQueryBatch( const HierarchicalPathGraph & m_graph, int m_numberOfThreads /* = 0 */ ) :
+	grid( &m_graph.getGrid() ),
+	graph( &m_graph ),
+	jumpPointSearch( false ),
+	numberOfThreads( ( m_numberOfThreads > 0 ) ? m_numberOfThreads : max( 1, QThread::idealThreadCount() ) ),
+	workers(),
+	secondsTaken( 0.0 ),
+	latencies()
+{
+	createWorkers();
+}
+
+
+PathQueryBatch::~PathQueryBatch()
+{
+	for( unsigned int i = 0; i < workers.size(); i++ )
+	{
+		delete workers[ i ];
+	}
+}
+
+
+void PathQueryBatch::createWorkers()
+{
+	for( int i = 0; i < numberOfThreads; i++ )
+	{
+		workers.push_back( new Worker( grid, graph, jumpPointSearch ) );
+	}
+}
+
+
+/* answers every query, putting the answer to each in the same place in results as the query has in queries.
+ * Nothing may change the grid or graph until it returns, and it throws an OperationCanceled if the progress monitor cancels it
+ */
+void PathQueryBatch::run( const vector<Query> & queries, vector<Result> & results, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	QElapsedTimer timer;
+	timer.start();
+
+	//resizing rather than replacing the results keeps the room their paths already have
+	int numberOfQueries = queries.size();
+	results.resize( numberOfQueries );
+
+	QAtomicInt queriesDone( 0 );
+	QAtomicInt stop( 0 );
+	for( int i = 0; i < numberOfThreads; i++ )
+	{
+		workers[ i ]->setUp( ( int ) ( ( ( long long ) numberOfQueries * i ) / numberOfThreads ),
+							 ( int ) ( ( ( long long ) numberOfQueries * ( i + 1 ) ) / numberOfThreads ),
+							 workers, queries, results, queriesDone, stop );
+	}
+
+	QThreadPool pool;
+	pool.setMaxThreadCount( numberOfThreads );
+	for( int i = 0; i < numberOfThreads; i++ )
+	{
+		pool.start( workers[ i ] );
+	}
+
+	while( !pool.waitForDone( check_in_interval ) )
+	{
+		try
+		{
+			ProgressMonitor::checkIn( progress, ( double ) queriesDone / max( 1, numberOfQueries ) );
+		}
+		catch( OperationCanceled & oc )
+		{
+			stop.fetchAndStoreOrdered( 1 );
+			pool.waitForDone();
+			throw;
+		}
+	}
+
+	secondsTaken = timer.nsecsElapsed() / 1e9;
+	latencies.resize( numberOfQueries );
+	for( int query = 0; query < numberOfQueries; query++ )
+	{
+		latencies[ query ] = results[ query ].seconds;
+	}
+	ProgressMonitor::checkIn( progress, 1.0 );
+}
+
+
+/* how many queries a second the last batch answered, counting from when it started to when the last query was answered
+ */
+double PathQueryBatch::getQueriesPerSecond() const
+{
+	return ( secondsTaken > 0.0 ) ? latencies.size() / secondsTaken : 0.0;
+}
+
+
+/* the time, in seconds, that the given fraction of the last batch's queries took no longer than
+ */
+double PathQueryBatch::getLatencyPercentile( double fraction ) const
+{
+	if( latencies.empty() )
+	{
+		return 0.0;
+	}
+
+	//only the one latency is needed, so the rest are only sorted as far as it takes to find it
+	vector<double> sorted( latencies );
+	int place = ( int ) ceil( fraction * sorted.size() ) - 1;
+	place = max( 0, min( ( int ) sorted.size() - 1, place ) );
+	nth_element( sorted.begin(), sorted.begin() + place, sorted.end() );
+	return sorted[ place ];
+}
@@ -0,0 +1,100 @@
+/*
+   Project     : 3DMaze
+   File        : PathQueryBatch.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Answers a batch of path queries on every core at once. Each
+   				 thread starts with an even share of the queries and, once it
+   				 runs out, steals half of what's left of another thread's
+   				 share. Every thread keeps its own search, so after the first
+   				 batch the searches allocate nothing. The queries go to either
+   				 a flat search of an occupancy grid or a hierarchical search of
+   				 a graph built over one, and the results come back in the same
+   				 order as the queries
+*/
+
+
+#ifndef PATHQUERYBATCH_H_
+#define PATHQUERYBATCH_H_
+
+#include <vector>
+#include <utility>
+
+#include "Point2D.h"
+#include "OccupancyGrid.h"
+#include "HierarchicalPathGraph.h"
+#include "ProgressMonitor.h"
+
+class PathQueryBatch
+{
+	public:
+		// a start and a goal
+		typedef std::pair<Point2D, Point2D> Query;
+
+		/* the answer to a query, and how long it took in seconds
+		 */
+		class Result
+		{
+			public:
+				Result() : found( false ), path(), seconds( 0.0 ) {}
+
+				bool found;
+				std::vector<Point2D> path;
+				double seconds;
+		};
+
+		/* queries are answered by searching the grid cell by cell ( with jump point search, if asked for ),
+		 * on the given number of threads, or on one thread for each core when that's 0
+		 */
+		PathQueryBatch( const OccupancyGrid & m_grid, bool m_jumpPointSearch = true, int m_numberOfThreads = 0 );
+
+		/* queries are answered by a hierarchical search of the graph,
+		 * on the given number of threads, or on one thread for each core when that's 0
+		 */
+		PathQueryBatch( const HierarchicalPathGraph & m_graph, int m_numberOfThreads = 0 );
+		~PathQueryBatch();
+
+		/* answers every query, putting the answer to each in the same place in results as the query has in queries.
+		 * Nothing may change the grid or graph until it returns, and it throws an OperationCanceled if the progress monitor cancels it
+		 */
+		void run( const std::vector<Query> & queries, std::vector<Result> & results, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		int getNumberOfThreads() const { return numberOfThreads; }
+
+		/* how many queries a second the last batch answered, counting from when it started to when the last query was answered
+		 */
+		double getQueriesPerSecond() const;
+
+		/* the time, in seconds, that the given fraction of the last batch's queries took no longer than
+		 */
+		double getLatencyPercentile( double fraction ) const;
+		double getP99Latency() const { return getLatencyPercentile( 0.99 ); }
+
+		// how often, in milliseconds, progress is reported while the queries are answered
+		static const int check_in_interval = 50;
+
+		// how many queries a thread takes from its own share at a time
+		static const int queries_per_turn = 4;
+
+	private:
+		const OccupancyGrid * grid;
+		const HierarchicalPathGraph * graph;
+		bool jumpPointSearch;
+		int numberOfThreads;
+
+		// kept from one batch to the next, along with the searches they hold
+		class Worker;
+		std::vector<Worker *> workers;
+
+		// what the last batch took, all in seconds
+		double secondsTaken;
+		std::vector<double> latencies;
+
+		void createWorkers();
+
+		// disable copying, the workers belong to one batch
+		PathQueryBatch( const PathQueryBatch & );
+		const PathQueryBatch & operator=( const PathQueryBatch & );
+};
+
+#endif /*PATHQUERYBATCH_H_*/
@@ -0,0 +1,412 @@
+/*
+   Project     : 3DMaze
+   File        : PathSearch.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Finds the shortest path between two points through the open
+   				 cells of an occupancy grid, with A* over a binary heap and,
+   				 optionally, jump point search to skip over the cells along
+   				 straight runs. The path found is smoothed into as few straight
+   				 lines as it takes. Everything a search needs is kept between
+   				 searches, so once a search has been run on a grid the next one
+   				 on a grid the same size allocates nothing
+*/
+
+
+#include "PathSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+using namespace std;
+
+const float PathSearch::diagonal_step = 1.41421356f;
+
+namespace
+{
+	int signOf( int value )
+	{
+		return ( value > 0 ) - ( value < 0 );
+	}
+}
+
+
+PathSearch::PathSearch( bool m_jumpPointSearch /* = true */ ) :
+	jumpPointSearch( m_jumpPointSearch ),
+	costs(),
+	cameFrom(),
+	marks(),
+	searchNumber( 0 ),
+	openCells(),
+	cellsAlongPath(),
+	pointsAlongPath(),
+	cellsExpanded( 0 ),
+	grid( NULL ),
+	goalColumn( 0 ),
+	goalRow( 0 ) {}
+
+
+/* finds the shortest path from start to goal, moving between neighboring cells ( diagonal ones included,
+ * as long as the cells on both sides of the corner are open too ), and returns true if there is one.
+ * The path is given as the start, the corners the path turns at, and then the goal
+ */
+bool PathSearch::findPath( const OccupancyGrid & m_grid, const Point2D & start, const Point2D & goal, vector<Point2D> & path )
+{
+	path.clear();
+	cellsAlongPath.clear();
+	cellsExpanded = 0;
+
+	int startColumn, startRow;
+	if( !m_grid.cellAt( start, startColumn, startRow ) || !m_grid.cellAt( goal, goalColumn, goalRow ) ||
+		!m_grid.isOpen( startColumn, startRow ) || !m_grid.isOpen( goalColumn, goalRow ) )
+	{
+		return false;
+	}
+
+	prepareFor( m_grid );
+	int columns = grid->getColumns();
+	int startCell = ( startRow * columns ) + startColumn;
+	int goalCell = ( goalRow * columns ) + goalColumn;
+
+	openCells.clear();
+	reach( startCell, startCell, 0.0f );
+	while( !openCells.empty() )
+	{
+		pop_heap( openCells.begin(), openCells.end() );
+		int cell = openCells.back().cell;
+		openCells.pop_back();
+
+		// a cell can be on the open list more than once, if a better way to it was found after it was added
+		if( marks[ cell ] != searchNumber )
+		{
+			continue;
+		}
+		marks[ cell ] = searchNumber + 1;
+		cellsExpanded++;
+
+		if( cell == goalCell )
+		{
+			cellsAlongPath.clear();
+			for( int along = goalCell; along != startCell; along = cameFrom[ along ] )
+			{
+				cellsAlongPath.push_back( along );
+			}
+			cellsAlongPath.push_back( startCell );
+			reverse( cellsAlongPath.begin(), cellsAlongPath.end() );
+			smoothPath( *grid, cellsAlongPath, start, goal, pointsAlongPath, path );
+			return true;
+		}
+
+		if( jumpPointSearch )
+		{
+			expandJumpPoints( cell );
+		}
+		else
+		{
+			expandNeighbors( cell );
+		}
+	}
+
+	return false;
+}
+
+
+/* true if the path the last search found, given back as path, is still open on the grid: every cell it stepped through
+ * and every straight line of it. Blocking cells can't make a path shorter, so if they've only been blocked since,
+ * searching again would find one just as short ( false if the last search didn't find a path )
+ */
+bool PathSearch::pathStillOpen( const OccupancyGrid & m_grid, const vector<Point2D> & path ) const
+{
+	if( cellsAlongPath.empty() || path.empty() || ( grid == NULL ) ||
+		( m_grid.getColumns() != grid->getColumns() ) || ( m_grid.getRows() != grid->getRows() ) )
+	{
+		return false;
+	}
+
+	// the cells along the path are joined by straight or exactly diagonal runs, and a diagonal step needs the cells beside it open too
+	int columns = m_grid.getColumns();
+	int column = cellsAlongPath[ 0 ] % columns;
+	int row = cellsAlongPath[ 0 ] / columns;
+	if( !m_grid.isOpen( column, row ) )
+	{
+		return false;
+	}
+	for( unsigned int i = 1; i < cellsAlongPath.size(); i++ )
+	{
+		int nextColumn = cellsAlongPath[ i ] % columns;
+		int nextRow = cellsAlongPath[ i ] / columns;
+		int stepX = signOf( nextColumn - column );
+		int stepY = signOf( nextRow - row );
+		while( ( column != nextColumn ) || ( row != nextRow ) )
+		{
+			if( ( ( stepX != 0 ) && ( stepY != 0 ) ) && ( !m_grid.isOpen( column + stepX, row ) || !m_grid.isOpen( column, row + stepY ) ) )
+			{
+				return false;
+			}
+			column += stepX;
+			row += stepY;
+			if( !m_grid.isOpen( column, row ) )
+			{
+				return false;
+			}
+		}
+	}
+
+	for( unsigned int i = 1; i < path.size(); i++ )
+	{
+		if( !m_grid.lineOfSight( path[ i - 1 ], path[ i ] ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* makes sure there's room for every cell in the grid, and starts a new search number
+ */
+void PathSearch::prepareFor( const OccupancyGrid & m_grid )
+{
+	grid = &m_grid;
+
+	size_t numberOfCells = grid->numberOfCells();
+	if( marks.size() != numberOfCells )
+	{
+		costs.resize( numberOfCells );
+		cameFrom.resize( numberOfCells );
+		marks.assign( numberOfCells, 0 );
+		searchNumber = 0;
+	}
+
+	//once the numbers run out every mark has to be cleared, which only happens once every couple of billion searches
+	if( searchNumber >= numeric_limits<unsigned int>::max() - 2 )
+	{
+		fill( marks.begin(), marks.end(), 0 );
+		searchNumber = 0;
+	}
+	searchNumber += 2;
+}
+
+
+/* adds the cell to the open list, if the given way to it is better than the best one found so far
+ */
+void PathSearch::reach( int cell, int from, float cost )
+{
+	if( ( marks[ cell ] == searchNumber + 1 ) || ( ( marks[ cell ] == searchNumber ) && ( costs[ cell ] <= cost ) ) )
+	{
+		return;
+	}
+
+	marks[ cell ] = searchNumber;
+	costs[ cell ] = cost;
+	cameFrom[ cell ] = from;
+
+	int columns = grid->getColumns();
+	openCells.push_back( OpenCell( cost + octileDistance( cell % columns, cell / columns, goalColumn, goalRow ), cell ) );
+	push_heap( openCells.begin(), openCells.end() );
+}
+
+
+/* every neighbor of the cell that the search can step to
+ */
+void PathSearch::expandNeighbors( int cell )
+{
+	int columns = grid->getColumns();
+	int column = cell % columns;
+	int row = cell / columns;
+	for( int stepY = -1; stepY <= 1; stepY++ )
+	{
+		for( int stepX = -1; stepX <= 1; stepX++ )
+		{
+			if( ( ( stepX == 0 ) && ( stepY == 0 ) ) || !grid->isOpen( column + stepX, row + stepY ) )
+			{
+				continue;
+			}
+
+			bool diagonal = ( stepX != 0 ) && ( stepY != 0 );
+			if( diagonal && ( !grid->isOpen( column + stepX, row ) || !grid->isOpen( column, row + stepY ) ) )
+			{
+				continue;
+			}
+			reach( cell + ( stepY * columns ) + stepX, cell, costs[ cell ] + ( diagonal ? diagonal_step : 1.0f ) );
+		}
+	}
+}
+
+
+/* the neighbors worth looking at when the cell was reached from the given direction,
+ * jumping from each to the next cell the search has to stop at
+ */
+void PathSearch::expandJumpPoints( int cell )
+{
+	int columns = grid->getColumns();
+	int column = cell % columns;
+	int row = cell / columns;
+
+	// the directions to try, the jumps themselves turn back the ones leading straight into a blocked cell
+	int directions[ 8 ][ 2 ];
+	int numberOfDirections = 0;
+	if( cameFrom[ cell ] == cell )
+	{
+		// every way out of the start
+		for( int stepY = -1; stepY <= 1; stepY++ )
+		{
+			for( int stepX = -1; stepX <= 1; stepX++ )
+			{
+				if( ( stepX != 0 ) || ( stepY != 0 ) )
+				{
+					directions[ numberOfDirections ][ 0 ] = stepX;
+					directions[ numberOfDirections ][ 1 ] = stepY;
+					numberOfDirections++;
+				}
+			}
+		}
+	}
+	else
+	{
+		int stepX = signOf( column - ( cameFrom[ cell ] % columns ) );
+		int stepY = signOf( row - ( cameFrom[ cell ] / columns ) );
+		if( ( stepX != 0 ) && ( stepY != 0 ) )
+		{
+			// carrying on diagonally, or along either of the directions that make up the diagonal
+			int diagonalDirections[ 3 ][ 2 ] = { { stepX, stepY }, { stepX, 0 }, { 0, stepY } };
+			for( int i = 0; i < 3; i++ )
+			{
+				directions[ numberOfDirections ][ 0 ] = diagonalDirections[ i ][ 0 ];
+				directions[ numberOfDirections ][ 1 ] = diagonalDirections[ i ][ 1 ];
+				numberOfDirections++;
+			}
+		}
+		else
+		{
+			/* without cutting corners, a straight run can turn to either side wherever it passes the end of a wall,
+			 * so carrying on straight, turning to either side, and heading diagonally forward to either side are all tried
+			 */
+			int sideX = ( stepX == 0 ) ? 1 : 0;
+			int sideY = ( stepY == 0 ) ? 1 : 0;
+			int straightDirections[ 5 ][ 2 ] = { { stepX, stepY },
+												 { sideX, sideY }, { -sideX, -sideY },
+												 { stepX + sideX, stepY + sideY }, { stepX - sideX, stepY - sideY } };
+			for( int i = 0; i < 5; i++ )
+			{
+				directions[ numberOfDirections ][ 0 ] = straightDirections[ i ][ 0 ];
+				directions[ numberOfDirections ][ 1 ] = straightDirections[ i ][ 1 ];
+				numberOfDirections++;
+			}
+		}
+	}
+
+	for( int i = 0; i < numberOfDirections; i++ )
+	{
+		int jumpColumn, jumpRow;
+		if( jump( column, row, directions[ i ][ 0 ], directions[ i ][ 1 ], jumpColumn, jumpRow ) )
+		{
+			reach( ( jumpRow * columns ) + jumpColumn, cell, costs[ cell ] + octileDistance( column, row, jumpColumn, jumpRow ) );
+		}
+	}
+}
+
+
+/* moves from the cell in the given direction ( each step is -1, 0 or 1 ) until it reaches a cell
+ * the search has to stop at, returning false if it runs into a blocked cell first
+ */
+bool PathSearch::jump( int column, int row, int stepX, int stepY, int & jumpColumn, int & jumpRow ) const
+{
+	while( true )
+	{
+		if( ( stepX != 0 ) && ( stepY != 0 ) && ( !grid->isOpen( column + stepX, row ) || !grid->isOpen( column, row + stepY ) ) )
+		{
+			return false;
+		}
+		column += stepX;
+		row += stepY;
+		if( !grid->isOpen( column, row ) )
+		{
+			return false;
+		}
+
+		bool stop = ( column == goalColumn ) && ( row == goalRow );
+		if( !stop && ( stepX != 0 ) && ( stepY != 0 ) )
+		{
+			// a diagonal run stops wherever one of the straight runs it's made of would stop
+			int ignoredColumn, ignoredRow;
+			stop = jump( column, row, stepX, 0, ignoredColumn, ignoredRow ) || jump( column, row, 0, stepY, ignoredColumn, ignoredRow );
+		}
+		else if( !stop && ( stepX != 0 ) )
+		{
+			// a straight run stops just past the end of a wall alongside it
+			stop = ( grid->isOpen( column, row - 1 ) && !grid->isOpen( column - stepX, row - 1 ) ) ||
+				   ( grid->isOpen( column, row + 1 ) && !grid->isOpen( column - stepX, row + 1 ) );
+		}
+		else if( !stop )
+		{
+			stop = ( grid->isOpen( column - 1, row ) && !grid->isOpen( column - 1, row - stepY ) ) ||
+				   ( grid->isOpen( column + 1, row ) && !grid->isOpen( column + 1, row - stepY ) );
+		}
+
+		if( stop )
+		{
+			jumpColumn = column;
+			jumpRow = row;
+			return true;
+		}
+	}
+}
+
+
+/* the cheapest way from one cell to another, moving diagonally as much as possible
+ */
+float PathSearch::octileDistance( int fromColumn, int fromRow, int toColumn, int toRow )
+{
+	int across = abs( toColumn - fromColumn );
+	int up = abs( toRow - fromRow );
+	return ( float ) ( max( across, up ) - min( across, up ) ) + ( diagonal_step * min( across, up ) );
+}
+
+
+/* replaces a path through neighboring cells ( or cells joined by straight or exactly diagonal runs of open cells ),
+ * running from the cell holding the start to the cell holding the goal, with the fewest straight lines
+ * that only pass through open cells, the points along the way are kept in the scratch list given
+ */
+void PathSearch::smoothPath( const OccupancyGrid & grid, const vector<int> & cells, const Point2D & start, const Point2D & goal,
+							 vector<Point2D> & pointsAlongPath, vector<Point2D> & path )
+{
+	//only the cells the path turns at matter, and since every step between cells is straight or exactly diagonal
+	//the path only turns where the direction changes
+	int columns = grid.getColumns();
+	pointsAlongPath.clear();
+	pointsAlongPath.push_back( start );
+	for( unsigned int i = 0; i < cells.size(); i++ )
+	{
+		int cell = cells[ i ];
+		if( ( i > 0 ) && ( i + 1 < cells.size() ) )
+		{
+			int before = cells[ i - 1 ];
+			int after = cells[ i + 1 ];
+			if( ( signOf( ( cell % columns ) - ( before % columns ) ) == signOf( ( after % columns ) - ( cell % columns ) ) ) &&
+				( signOf( ( cell / columns ) - ( before / columns ) ) == signOf( ( after / columns ) - ( cell / columns ) ) ) )
+			{
+				continue;
+			}
+		}
+		pointsAlongPath.push_back( grid.centerOf( cell % columns, cell / columns ) );
+	}
+	pointsAlongPath.push_back( goal );
+
+	//from each point, head straight for the furthest point along the path that can be seen from it
+	path.clear();
+	path.push_back( start );
+	unsigned int from = 0;
+	while( from + 1 < pointsAlongPath.size() )
+	{
+		unsigned int to = from + 1;
+		while( ( to + 1 < pointsAlongPath.size() ) && grid.lineOfSight( pointsAlongPath[ from ], pointsAlongPath[ to + 1 ] ) )
+		{
+			to++;
+		}
+		path.push_back( pointsAlongPath[ to ] );
+		from = to;
+	}
+}
@@ -0,0 +1,121 @@
+/*
+   Project     : 3DMaze
+   File        : PathSearch.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Finds the shortest path between two points through the open
+   				 cells of an occupancy grid, with A* over a binary heap and,
+   				 optionally, jump point search to skip over the cells along
+   				 straight runs. The path found is smoothed into as few straight
+   				 lines as it takes. Everything a search needs is kept between
+   				 searches, so once a search has been run on a grid the next one
+   				 on a grid the same size allocates nothing
+*/
+
+
+#ifndef PATHSEARCH_H_
+#define PATHSEARCH_H_
+
+#include <vector>
+
+#include "Point2D.h"
+#include "OccupancyGrid.h"
+
+class PathSearch
+{
+	public:
+		PathSearch( bool m_jumpPointSearch = true );
+
+		void setJumpPointSearch( bool m_jumpPointSearch ) { jumpPointSearch = m_jumpPointSearch; }
+		bool usesJumpPointSearch() const { return jumpPointSearch; }
+
+		/* finds the shortest path from start to goal, moving between neighboring cells ( diagonal ones included,
+		 * as long as the cells on both sides of the corner are open too ), and returns true if there is one.
+		 * The path is given as the start, the corners the path turns at, and then the goal
+		 */
+		bool findPath( const OccupancyGrid & grid, const Point2D & start, const Point2D & goal, std::vector<Point2D> & path );
+
+		/* true if the path the last search found, given back as path, is still open on the grid: every cell it stepped through
+		 * and every straight line of it. Blocking cells can't make a path shorter, so if they've only been blocked since,
+		 * searching again would find one just as short ( false if the last search didn't find a path )
+		 */
+		bool pathStillOpen( const OccupancyGrid & m_grid, const std::vector<Point2D> & path ) const;
+
+		/* the number of cells the last search took off the open list
+		 */
+		int getCellsExpanded() const { return cellsExpanded; }
+
+		/* replaces a path through neighboring cells ( or cells joined by straight or exactly diagonal runs of open cells ),
+		 * running from the cell holding the start to the cell holding the goal, with the fewest straight lines
+		 * that only pass through open cells, the points along the way are kept in the scratch list given
+		 */
+		static void smoothPath( const OccupancyGrid & grid, const std::vector<int> & cells, const Point2D & start, const Point2D & goal,
+								std::vector<Point2D> & pointsAlongPath, std::vector<Point2D> & path );
+
+		/* the cheapest way from one cell to another, moving diagonally as much as possible
+		 */
+		static float octileDistance( int fromColumn, int fromRow, int toColumn, int toRow );
+
+		// the cost of a step to a diagonal neighbor, a step to any other neighbor costs 1
+		static const float diagonal_step;
+
+	private:
+		bool jumpPointSearch;
+
+		/* a cell on the open list, the heap keeps the one with the lowest estimated total cost on top
+		 */
+		class OpenCell
+		{
+			public:
+				OpenCell( float m_estimate, int m_cell ) : estimate( m_estimate ), cell( m_cell ) {}
+
+				bool operator<( const OpenCell & rhs ) const { return estimate > rhs.estimate; }
+
+				float estimate;
+				int cell;
+		};
+
+		// for each cell, the cost of the best way found to it and the cell that way came from,
+		// only worth anything if the cell has been reached in the current search
+		std::vector<float> costs;
+		std::vector<int> cameFrom;
+
+		// a cell whose mark is the current search's number has been reached, and one marked a number higher has been closed,
+		// so nothing has to be cleared between searches
+		std::vector<unsigned int> marks;
+		unsigned int searchNumber;
+
+		std::vector<OpenCell> openCells;
+		std::vector<int> cellsAlongPath;
+		std::vector<Point2D> pointsAlongPath;
+		int cellsExpanded;
+
+		// the grid being searched and its goal, for the length of a search
+		const OccupancyGrid * grid;
+		int goalColumn, goalRow;
+
+		/* makes sure there's room for every cell in the grid, and starts a new search number
+		 */
+		void prepareFor( const OccupancyGrid & m_grid );
+
+		/* adds the cell to the open list, if the given way to it is better than the best one found so far
+		 */
+		void reach( int cell, int from, float cost );
+
+		/* every neighbor of the cell that the search can step to
+		 */
+		void expandNeighbors( int cell );
+
+		/* the neighbors worth looking at when the cell was reached from the given direction,
+		 * jumping from each to the next cell the search has to stop at
+		 */
+		void expandJumpPoints( int cell );
+
+		/* moves from the cell in the given direction ( each step is -1, 0 or 1 ) until it reaches a cell
+		 * the search has to stop at, returning false if it runs into a blocked cell first
+		 */
+		bool jump( int column, int row, int stepX, int stepY, int & jumpColumn, int & jumpRow ) const;
+
+};
+
+#endif /*PATHSEARCH_H_*/
@@ -0,0 +1,815 @@
+/*
+   Project     : 3DMaze
+   File        : ReachabilityMap.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Which of the open cells of an occupancy grid can be reached
+   				 from a starting point. The grid is cut into square clusters,
+   				 the open cells of each cluster are split into the regions
+   				 that are joined within it, and the regions are joined across
+   				 the borders between clusters by a union-find. When a line is
+   				 added to the grid, only the clusters it reaches are split up
+   				 again, and only the components they were in are searched to
+   				 see if they came apart, from all the places they could have
+   				 come apart at at once, stopping as soon as all but one of the
+   				 searches has run out of regions. A start that lands on a wall
+   				 is moved to the nearest open cell
+*/
+
+
+#include "ReachabilityMap.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+const int ReachabilityMap::default_cluster_size;
+const int ReachabilityMap::max_cluster_size;
+const ReachabilityMap::LocalRegion ReachabilityMap::no_region;
+const ReachabilityMap::LocalRegion ReachabilityMap::unlabeled;
+
+namespace
+{
+	// the steps to a cell's neighbors, regions only spread straight across, never diagonally
+	const int neighbor_steps[ 4 ][ 2 ] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+}
+
+
+/* clusters are clusterSize cells across, no more than max_cluster_size
+ */
+ReachabilityMap::ReachabilityMap( int m_clusterSize /* = default_cluster_size */ ) :
+	start(),
+	startColumn( -1 ),
+	startRow( -1 ),
+	clusterSize( max( 1, min( m_clusterSize, max_cluster_size ) ) ),
+	columns( 0 ),
+	rows( 0 ),
+	clusterColumns( 0 ),
+	clusterRows( 0 ),
+	localRegions(),
+	regionCounts(),
+	firstRegions(),
+	runs(),
+	eastLinks(),
+	northLinks(),
+	components(),
+	clustersOfRegions(),
+	liveRegions( 0 ),
+	deadRegions( 0 ),
+	nextComponent( 0 ),
+	clusterReachable(),
+	startRegion( -1 ),
+	startComponent( -1 ),
+	searches(),
+	searchesOfRegions(),
+	searchRounds(),
+	searchRound( 0 ),
+	toVisit(),
+	previousComponents(),
+	touchedComponents(),
+	seeds(),
+	changedClusters(),
+	neighbors() {}
+
+
+/* splits the whole grid up into regions, and works out which can be reached from the start,
+ * throws an OperationCanceled if the progress monitor cancels it
+ */
+void ReachabilityMap::rebuild( const OccupancyGrid & grid, const Point2D & m_start, ProgressMonitor * progress /* = NULL */ ) throw( IOError & )
+{
+	start = m_start;
+	columns = grid.getColumns();
+	rows = grid.getRows();
+	clusterColumns = ( columns + clusterSize - 1 ) / clusterSize;
+	clusterRows = ( rows + clusterSize - 1 ) / clusterSize;
+	int numberOfClusters = clusterColumns * clusterRows;
+
+	localRegions.assign( ( size_t ) columns * rows, no_region );
+	regionCounts.assign( numberOfClusters, 0 );
+	firstRegions.assign( numberOfClusters, 0 );
+	runs.assign( numberOfClusters, vector<Run>() );
+	eastLinks.assign( numberOfClusters, vector<Link>() );
+	northLinks.assign( numberOfClusters, vector<Link>() );
+
+	// splitting is most of the work, linking the rest
+	int clustersBetweenCheckIns = max( 1, ProgressMonitor::steps_between_check_ins / ( clusterSize * clusterSize ) );
+	for( int cluster = 0; cluster < numberOfClusters; cluster++ )
+	{
+		if( ( cluster % clustersBetweenCheckIns ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, 0.8 * cluster / numberOfClusters );
+		}
+		split( grid, cluster );
+	}
+	for( int cluster = 0; cluster < numberOfClusters; cluster++ )
+	{
+		if( ( cluster % clustersBetweenCheckIns ) == 0 )
+		{
+			ProgressMonitor::checkIn( progress, 0.8 + ( 0.2 * cluster / numberOfClusters ) );
+		}
+		link( cluster );
+	}
+
+	//the regions are numbered one after another, and the union-find's sets are the components they start out in
+	liveRegions = 0;
+	clustersOfRegions.clear();
+	for( int cluster = 0; cluster < numberOfClusters; cluster++ )
+	{
+		firstRegions[ cluster ] = liveRegions;
+		liveRegions += regionCounts[ cluster ];
+		clustersOfRegions.insert( clustersOfRegions.end(), regionCounts[ cluster ], cluster );
+	}
+	deadRegions = 0;
+
+	DisjointSets joinedRegions( liveRegions );
+	for( int cluster = 0; cluster < numberOfClusters; cluster++ )
+	{
+		for( unsigned int i = 0; i < eastLinks[ cluster ].size(); i++ )
+		{
+			joinedRegions.join( firstRegions[ cluster ] + eastLinks[ cluster ][ i ].first,
+								firstRegions[ cluster + 1 ] + eastLinks[ cluster ][ i ].second );
+		}
+		for( unsigned int i = 0; i < northLinks[ cluster ].size(); i++ )
+		{
+			joinedRegions.join( firstRegions[ cluster ] + northLinks[ cluster ][ i ].first,
+								firstRegions[ cluster + clusterColumns ] + northLinks[ cluster ][ i ].second );
+		}
+	}
+	components.resize( liveRegions );
+	for( int region = 0; region < liveRegions; region++ )
+	{
+		components[ region ] = joinedRegions.find( region );
+	}
+	nextComponent = liveRegions;
+	searchesOfRegions.assign( liveRegions, 0 );
+	searchRounds.assign( liveRegions, 0 );
+	searchRound = 0;
+
+	findStartCell( grid );
+	findStartComponent();
+	clusterReachable.resize( numberOfClusters );
+	for( int cluster = 0; cluster < numberOfClusters; cluster++ )
+	{
+		updateClusterReachable( cluster );
+	}
+	ProgressMonitor::checkIn( progress, 1.0 );
+}
+
+
+/* call once the line has been added to the grid, to split up the clusters it reaches again
+ * ( the grid has to be the one the map was last rebuilt from )
+ */
+void ReachabilityMap::lineAdded( const OccupancyGrid & grid, const LineSegment2D & line )
+{
+	int firstColumn, firstRow, lastColumn, lastRow;
+	if( ( grid.getColumns() != columns ) || ( grid.getRows() != rows ) ||
+		!grid.cellsNear( line, firstColumn, firstRow, lastColumn, lastRow ) )
+	{
+		return;
+	}
+
+	int firstClusterColumn = firstColumn / clusterSize;
+	int firstClusterRow = firstRow / clusterSize;
+	int lastClusterColumn = lastColumn / clusterSize;
+	int lastClusterRow = lastRow / clusterSize;
+	touchedComponents.clear();
+	seeds.clear();
+	changedClusters.clear();
+	for( int clusterRow = firstClusterRow; clusterRow <= lastClusterRow; clusterRow++ )
+	{
+		for( int clusterColumn = firstClusterColumn; clusterColumn <= lastClusterColumn; clusterColumn++ )
+		{
+			splitAgain( grid, ( clusterRow * clusterColumns ) + clusterColumn );
+		}
+	}
+
+	// the clusters to the west and south link into the ones split up again too
+	for( int clusterRow = max( 0, firstClusterRow - 1 ); clusterRow <= lastClusterRow; clusterRow++ )
+	{
+		for( int clusterColumn = max( 0, firstClusterColumn - 1 ); clusterColumn <= lastClusterColumn; clusterColumn++ )
+		{
+			link( ( clusterRow * clusterColumns ) + clusterColumn );
+		}
+	}
+
+	// lines only ever block cells, so the start only moves if its own cell was blocked
+	if( ( startColumn >= 0 ) && !grid.isOpen( startColumn, startRow ) )
+	{
+		findStartCell( grid );
+	}
+	startRegion = ( startColumn >= 0 ) ? regionAt( startColumn, startRow ) : -1;
+
+	/* blocking cells can only break components apart, and every piece of one that did come apart
+	 * has regions in the clusters split up again, or in the clusters bordering them
+	 */
+	sort( touchedComponents.begin(), touchedComponents.end() );
+	touchedComponents.erase( unique( touchedComponents.begin(), touchedComponents.end() ), touchedComponents.end() );
+	for( int clusterRow = max( 0, firstClusterRow - 1 ); clusterRow <= min( clusterRows - 1, lastClusterRow + 1 ); clusterRow++ )
+	{
+		for( int clusterColumn = max( 0, firstClusterColumn - 1 ); clusterColumn <= min( clusterColumns - 1, lastClusterColumn + 1 ); clusterColumn++ )
+		{
+			bool inside = ( clusterRow >= firstClusterRow ) && ( clusterRow <= lastClusterRow ) &&
+						  ( clusterColumn >= firstClusterColumn ) && ( clusterColumn <= lastClusterColumn );
+			bool corner = ( ( clusterRow < firstClusterRow ) || ( clusterRow > lastClusterRow ) ) &&
+						  ( ( clusterColumn < firstClusterColumn ) || ( clusterColumn > lastClusterColumn ) );
+			if( inside || corner )
+			{
+				continue;
+			}
+			int cluster = ( clusterRow * clusterColumns ) + clusterColumn;
+			for( int region = firstRegions[ cluster ]; region < firstRegions[ cluster ] + regionCounts[ cluster ]; region++ )
+			{
+				if( binary_search( touchedComponents.begin(), touchedComponents.end(), components[ region ] ) )
+				{
+					seeds.push_back( make_pair( components[ region ], region ) );
+				}
+			}
+		}
+	}
+	sort( seeds.begin(), seeds.end() );
+	for( unsigned int firstSeed = 0; firstSeed < seeds.size(); )
+	{
+		unsigned int endSeed = firstSeed + 1;
+		while( ( endSeed < seeds.size() ) && ( seeds[ endSeed ].first == seeds[ firstSeed ].first ) )
+		{
+			endSeed++;
+		}
+		separate( seeds[ firstSeed ].first, seeds, firstSeed, endSeed );
+		firstSeed = endSeed;
+	}
+
+	// only the clusters whose regions changed need to be looked at again, unless the start ended up in a different component
+	int previousStartComponent = startComponent;
+	findStartComponent();
+	if( startComponent != previousStartComponent )
+	{
+		for( unsigned int cluster = 0; cluster < clusterReachable.size(); cluster++ )
+		{
+			updateClusterReachable( cluster );
+		}
+	}
+	else
+	{
+		for( unsigned int i = 0; i < changedClusters.size(); i++ )
+		{
+			updateClusterReachable( changedClusters[ i ] );
+		}
+	}
+
+	if( deadRegions > max( liveRegions, 1 << 12 ) )
+	{
+		renumber();
+	}
+}
+
+
+/* true if the cell is open and there's a way to it from the start
+ */
+bool ReachabilityMap::isReachable( int column, int row ) const
+{
+	if( ( column < 0 ) || ( row < 0 ) || ( column >= columns ) || ( row >= rows ) )
+	{
+		return false;
+	}
+	int region = regionAt( column, row );
+	return ( region >= 0 ) && ( startComponent >= 0 ) && ( components[ region ] == startComponent );
+}
+
+
+/* the open cell everything is reached from, the one nearest the start, returns false if there isn't one
+ */
+bool ReachabilityMap::startCell( int & column, int & row ) const
+{
+	if( startColumn < 0 )
+	{
+		return false;
+	}
+	column = startColumn;
+	row = startRow;
+	return true;
+}
+
+
+/* trades everything worked out with the other map, without copying it
+ */
+void ReachabilityMap::swap( ReachabilityMap & other )
+{
+	std::swap( start, other.start );
+	std::swap( startColumn, other.startColumn );
+	std::swap( startRow, other.startRow );
+	std::swap( clusterSize, other.clusterSize );
+	std::swap( columns, other.columns );
+	std::swap( rows, other.rows );
+	std::swap( clusterColumns, other.clusterColumns );
+	std::swap( clusterRows, other.clusterRows );
+	localRegions.swap( other.localRegions );
+	regionCounts.swap( other.regionCounts );
+	firstRegions.swap( other.firstRegions );
+	runs.swap( other.runs );
+	eastLinks.swap( other.eastLinks );
+	northLinks.swap( other.northLinks );
+	components.swap( other.components );
+	clustersOfRegions.swap( other.clustersOfRegions );
+	std::swap( liveRegions, other.liveRegions );
+	std::swap( deadRegions, other.deadRegions );
+	std::swap( nextComponent, other.nextComponent );
+	clusterReachable.swap( other.clusterReachable );
+	std::swap( startRegion, other.startRegion );
+	std::swap( startComponent, other.startComponent );
+	searchesOfRegions.swap( other.searchesOfRegions );
+	searchRounds.swap( other.searchRounds );
+	std::swap( searchRound, other.searchRound );
+}
+
+
+void ReachabilityMap::clusterBounds( int cluster, int & left, int & bottom, int & width, int & height ) const
+{
+	left = ( cluster % clusterColumns ) * clusterSize;
+	bottom = ( cluster / clusterColumns ) * clusterSize;
+	width = min( clusterSize, columns - left );
+	height = min( clusterSize, rows - bottom );
+}
+
+
+/* splits the cluster's open cells into regions, and the regions into runs
+ */
+void ReachabilityMap::split( const OccupancyGrid & grid, int cluster )
+{
+	int left, bottom, width, height;
+	clusterBounds( cluster, left, bottom, width, height );
+	for( int row = bottom; row < bottom + height; row++ )
+	{
+		for( int column = left; column < left + width; column++ )
+		{
+			localRegions[ ( ( size_t ) row * columns ) + column ] = grid.isOpen( column, row ) ? unlabeled : no_region;
+		}
+	}
+
+	//every open cell not labeled yet starts a region of its own, which spreads to the open cells beside it
+	int count = 0;
+	for( int row = bottom; row < bottom + height; row++ )
+	{
+		for( int column = left; column < left + width; column++ )
+		{
+			size_t cell = ( ( size_t ) row * columns ) + column;
+			if( localRegions[ cell ] != unlabeled )
+			{
+				continue;
+			}
+
+			localRegions[ cell ] = count;
+			toVisit.clear();
+			toVisit.push_back( ( ( row - bottom ) * width ) + column - left );
+			while( !toVisit.empty() )
+			{
+				int local = toVisit.back();
+				toVisit.pop_back();
+				int x = left + ( local % width );
+				int y = bottom + ( local / width );
+				for( int i = 0; i < 4; i++ )
+				{
+					int nextX = x + neighbor_steps[ i ][ 0 ];
+					int nextY = y + neighbor_steps[ i ][ 1 ];
+					if( ( nextX < left ) || ( nextY < bottom ) || ( nextX >= left + width ) || ( nextY >= bottom + height ) )
+					{
+						continue;
+					}
+					LocalRegion & next = localRegions[ ( ( size_t ) nextY * columns ) + nextX ];
+					if( next == unlabeled )
+					{
+						next = count;
+						toVisit.push_back( ( ( nextY - bottom ) * width ) + nextX - left );
+					}
+				}
+			}
+			count++;
+		}
+	}
+	regionCounts[ cluster ] = count;
+
+	vector<Run> & clusterRuns = runs[ cluster ];
+	clusterRuns.clear();
+	for( int row = bottom; row < bottom + height; row++ )
+	{
+		const LocalRegion * regions = &localRegions[ ( size_t ) row * columns ];
+		for( int column = left; column < left + width; column++ )
+		{
+			if( regions[ column ] == no_region )
+			{
+				continue;
+			}
+			int first = column;
+			while( ( column + 1 < left + width ) && ( regions[ column + 1 ] == regions[ first ] ) )
+			{
+				column++;
+			}
+			clusterRuns.push_back( Run( row, first, column, regions[ first ] ) );
+		}
+	}
+}
+
+
+/* finds which regions open cells join across the cluster's east and north borders
+ */
+void ReachabilityMap::link( int cluster )
+{
+	int left, bottom, width, height;
+	clusterBounds( cluster, left, bottom, width, height );
+
+	//the same pair of regions usually meets across a long stretch of the border, so only changes are kept
+	vector<Link> & east = eastLinks[ cluster ];
+	east.clear();
+	if( left + width < columns )
+	{
+		for( int row = bottom; row < bottom + height; row++ )
+		{
+			size_t cell = ( ( size_t ) row * columns ) + left + width - 1;
+			Link across( localRegions[ cell ], localRegions[ cell + 1 ] );
+			if( ( across.first != no_region ) && ( across.second != no_region ) && ( east.empty() || ( east.back() != across ) ) )
+			{
+				east.push_back( across );
+			}
+		}
+	}
+
+	vector<Link> & north = northLinks[ cluster ];
+	north.clear();
+	if( bottom + height < rows )
+	{
+		for( int column = left; column < left + width; column++ )
+		{
+			size_t cell = ( ( size_t ) ( bottom + height - 1 ) * columns ) + column;
+			Link across( localRegions[ cell ], localRegions[ cell + columns ] );
+			if( ( across.first != no_region ) && ( across.second != no_region ) && ( north.empty() || ( north.back() != across ) ) )
+			{
+				north.push_back( across );
+			}
+		}
+	}
+}
+
+
+/* splits the cluster up again, giving its regions new numbers, and notes which components its old regions were in
+ */
+void ReachabilityMap::splitAgain( const OccupancyGrid & grid, int cluster )
+{
+	int left, bottom, width, height;
+	clusterBounds( cluster, left, bottom, width, height );
+
+	// lines only block cells, so each new region lies inside an old one, and is in the same component for now
+	previousComponents.resize( width * height );
+	for( int row = bottom; row < bottom + height; row++ )
+	{
+		for( int column = left; column < left + width; column++ )
+		{
+			LocalRegion region = localRegions[ ( ( size_t ) row * columns ) + column ];
+			previousComponents[ ( ( row - bottom ) * width ) + column - left ] = ( region == no_region ) ? -1 : components[ firstRegions[ cluster ] + region ];
+		}
+	}
+	for( int region = firstRegions[ cluster ]; region < firstRegions[ cluster ] + regionCounts[ cluster ]; region++ )
+	{
+		touchedComponents.push_back( components[ region ] );
+		components[ region ] = -1;
+	}
+	liveRegions -= regionCounts[ cluster ];
+	deadRegions += regionCounts[ cluster ];
+
+	split( grid, cluster );
+	firstRegions[ cluster ] = components.size();
+	components.insert( components.end(), regionCounts[ cluster ], -1 );
+	clustersOfRegions.insert( clustersOfRegions.end(), regionCounts[ cluster ], cluster );
+	liveRegions += regionCounts[ cluster ];
+	for( unsigned int i = 0; i < runs[ cluster ].size(); i++ )
+	{
+		const Run & run = runs[ cluster ][ i ];
+		int region = firstRegions[ cluster ] + run.region;
+		if( components[ region ] < 0 )
+		{
+			components[ region ] = previousComponents[ ( ( run.row - bottom ) * width ) + run.firstColumn - left ];
+			seeds.push_back( make_pair( components[ region ], region ) );
+		}
+	}
+	changedClusters.push_back( cluster );
+}
+
+
+/* the number of the region holding the cell, or -1 if it's blocked
+ */
+int ReachabilityMap::regionAt( int column, int row ) const
+{
+	LocalRegion region = localRegions[ ( ( size_t ) row * columns ) + column ];
+	if( region == no_region )
+	{
+		return -1;
+	}
+	return firstRegions[ ( ( row / clusterSize ) * clusterColumns ) + ( column / clusterSize ) ] + region;
+}
+
+
+/* fills neighbors with every region linked to the region across its cluster's borders
+ */
+void ReachabilityMap::neighborsOf( int region, vector<int> & neighbors ) const
+{
+	neighbors.clear();
+	int cluster = clustersOfRegions[ region ];
+	LocalRegion local = region - firstRegions[ cluster ];
+	const vector<Link> & east = eastLinks[ cluster ];
+	for( unsigned int i = 0; i < east.size(); i++ )
+	{
+		if( east[ i ].first == local )
+		{
+			neighbors.push_back( firstRegions[ cluster + 1 ] + east[ i ].second );
+		}
+	}
+	const vector<Link> & north = northLinks[ cluster ];
+	for( unsigned int i = 0; i < north.size(); i++ )
+	{
+		if( north[ i ].first == local )
+		{
+			neighbors.push_back( firstRegions[ cluster + clusterColumns ] + north[ i ].second );
+		}
+	}
+	if( ( cluster % clusterColumns ) > 0 )
+	{
+		const vector<Link> & west = eastLinks[ cluster - 1 ];
+		for( unsigned int i = 0; i < west.size(); i++ )
+		{
+			if( west[ i ].second == local )
+			{
+				neighbors.push_back( firstRegions[ cluster - 1 ] + west[ i ].first );
+			}
+		}
+	}
+	if( cluster >= clusterColumns )
+	{
+		const vector<Link> & south = northLinks[ cluster - clusterColumns ];
+		for( unsigned int i = 0; i < south.size(); i++ )
+		{
+			if( south[ i ].second == local )
+			{
+				neighbors.push_back( firstRegions[ cluster - clusterColumns ] + south[ i ].first );
+			}
+		}
+	}
+}
+
+
+/* searches the component from each of the regions it could have come apart at, and gives every piece but one
+ * a component of its own ( the seeds are the component's regions in and around the clusters split up again )
+ */
+void ReachabilityMap::separate( int component, const vector< pair<int, int> > & seeds, int firstSeed, int endSeed )
+{
+	int numberOfSearches = endSeed - firstSeed;
+	if( numberOfSearches < 2 )
+	{
+		return;
+	}
+
+	// regions are marked with the round they were reached in, so nothing has to be cleared between rounds
+	if( searchRounds.size() < components.size() )
+	{
+		searchesOfRegions.resize( components.size(), 0 );
+		searchRounds.resize( components.size(), 0 );
+	}
+	if( ++searchRound == 0 )
+	{
+		searchRounds.assign( searchRounds.size(), 0 );
+		searchRound = 1;
+	}
+
+	if( ( int ) searches.size() < numberOfSearches )
+	{
+		searches.resize( numberOfSearches );
+	}
+	for( int i = 0; i < numberOfSearches; i++ )
+	{
+		int seed = seeds[ firstSeed + i ].second;
+		Search & search = searches[ i ];
+		search.toExpand.assign( 1, seed );
+		search.expanded = 0;
+		search.reached.assign( 1, seed );
+		search.joinedTo = i;
+		search.finished = false;
+		searchesOfRegions[ seed ] = i;
+		searchRounds[ seed ] = searchRound;
+	}
+
+	/* every search takes a step in turn, so the work done is about as much as the pieces that came apart take,
+	 * apart from the biggest, which is never searched all the way through
+	 */
+	int searching = numberOfSearches;
+	while( searching > 1 )
+	{
+		for( int i = 0; ( i < numberOfSearches ) && ( searching > 1 ); i++ )
+		{
+			if( ( searches[ i ].joinedTo != i ) || searches[ i ].finished )
+			{
+				continue;
+			}
+			if( searches[ i ].expanded == searches[ i ].toExpand.size() )
+			{
+				searches[ i ].finished = true;
+				searching--;
+				continue;
+			}
+
+			int region = searches[ i ].toExpand[ searches[ i ].expanded++ ];
+			neighborsOf( region, neighbors );
+			for( unsigned int j = 0; j < neighbors.size(); j++ )
+			{
+				int neighbor = neighbors[ j ];
+				int current = joinedSearch( i );
+				if( searchRounds[ neighbor ] != searchRound )
+				{
+					searchRounds[ neighbor ] = searchRound;
+					searchesOfRegions[ neighbor ] = current;
+					searches[ current ].toExpand.push_back( neighbor );
+					searches[ current ].reached.push_back( neighbor );
+					continue;
+				}
+
+				// searches that meet are in the same piece, the smaller one is folded into the bigger one
+				int other = joinedSearch( searchesOfRegions[ neighbor ] );
+				if( other == current )
+				{
+					continue;
+				}
+				int bigger = ( searches[ current ].reached.size() >= searches[ other ].reached.size() ) ? current : other;
+				int smaller = ( bigger == current ) ? other : current;
+				Search & into = searches[ bigger ];
+				Search & from = searches[ smaller ];
+				into.toExpand.insert( into.toExpand.end(), from.toExpand.begin() + from.expanded, from.toExpand.end() );
+				into.reached.insert( into.reached.end(), from.reached.begin(), from.reached.end() );
+				from.joinedTo = bigger;
+				if( into.finished != from.finished )
+				{
+					into.finished = false;
+				}
+				else if( !into.finished )
+				{
+					searching--;
+				}
+			}
+		}
+	}
+
+	/* the one search still going keeps the component, every finished one found a whole piece that came apart,
+	 * if they all finished, the piece with the start in it keeps the component ( or else the biggest )
+	 */
+	int keeper = -1;
+	for( int i = 0; i < numberOfSearches; i++ )
+	{
+		if( ( searches[ i ].joinedTo == i ) && !searches[ i ].finished )
+		{
+			keeper = i;
+		}
+	}
+	if( keeper < 0 )
+	{
+		if( ( startRegion >= 0 ) && ( searchRounds[ startRegion ] == searchRound ) && ( components[ startRegion ] == component ) )
+		{
+			keeper = joinedSearch( searchesOfRegions[ startRegion ] );
+		}
+		else
+		{
+			for( int i = 0; i < numberOfSearches; i++ )
+			{
+				if( ( searches[ i ].joinedTo == i ) && ( ( keeper < 0 ) || ( searches[ i ].reached.size() > searches[ keeper ].reached.size() ) ) )
+				{
+					keeper = i;
+				}
+			}
+		}
+	}
+	for( int i = 0; i < numberOfSearches; i++ )
+	{
+		if( ( searches[ i ].joinedTo != i ) || ( i == keeper ) )
+		{
+			continue;
+		}
+		int piece = nextComponent++;
+		for( unsigned int j = 0; j < searches[ i ].reached.size(); j++ )
+		{
+			int region = searches[ i ].reached[ j ];
+			components[ region ] = piece;
+			changedClusters.push_back( clustersOfRegions[ region ] );
+		}
+	}
+}
+
+int ReachabilityMap::joinedSearch( int search )
+{
+	while( searches[ search ].joinedTo != search )
+	{
+		searches[ search ].joinedTo = searches[ searches[ search ].joinedTo ].joinedTo;
+		search = searches[ search ].joinedTo;
+	}
+	return search;
+}
+
+
+/* works out which regions are in the start's component again
+ */
+void ReachabilityMap::findStartComponent()
+{
+	startRegion = ( startColumn >= 0 ) ? regionAt( startColumn, startRow ) : -1;
+	startComponent = ( startRegion >= 0 ) ? components[ startRegion ] : -1;
+}
+
+void ReachabilityMap::updateClusterReachable( int cluster )
+{
+	clusterReachable[ cluster ] = 1;
+	for( int region = firstRegions[ cluster ]; region < firstRegions[ cluster ] + regionCounts[ cluster ]; region++ )
+	{
+		if( ( startComponent < 0 ) || ( components[ region ] != startComponent ) )
+		{
+			clusterReachable[ cluster ] = 0;
+			return;
+		}
+	}
+}
+
+
+/* numbers the regions one after another again, once a lot of numbers have stopped being used
+ */
+void ReachabilityMap::renumber()
+{
+	vector<int> renumbered;
+	renumbered.reserve( liveRegions );
+	clustersOfRegions.clear();
+	for( unsigned int cluster = 0; cluster < runs.size(); cluster++ )
+	{
+		int first = renumbered.size();
+		renumbered.insert( renumbered.end(), components.begin() + firstRegions[ cluster ], components.begin() + firstRegions[ cluster ] + regionCounts[ cluster ] );
+		clustersOfRegions.insert( clustersOfRegions.end(), regionCounts[ cluster ], cluster );
+		firstRegions[ cluster ] = first;
+	}
+	components.swap( renumbered );
+	deadRegions = 0;
+	searchesOfRegions.assign( components.size(), 0 );
+	searchRounds.assign( components.size(), 0 );
+	searchRound = 0;
+	findStartComponent();
+}
+
+
+/* moves the start to the open cell nearest it, the start can be on a wall
+ * ( like the post in the middle of a maze an even number of cells across )
+ */
+void ReachabilityMap::findStartCell( const OccupancyGrid & grid )
+{
+	startColumn = -1;
+	startRow = -1;
+	if( ( columns <= 0 ) || ( rows <= 0 ) )
+	{
+		return;
+	}
+
+	// where the start is, measured in cells from the center of the first one
+	Point2D firstCenter = grid.centerOf( 0, 0 );
+	double x = ( start.getX() - firstCenter.getX() ) / grid.getCellSize();
+	double y = ( start.getY() - firstCenter.getY() ) / grid.getCellSize();
+	int centerColumn = ( int ) max( 0.0, min( floor( x + 0.5 ), columns - 1.0 ) );
+	int centerRow = ( int ) max( 0.0, min( floor( y + 0.5 ), rows - 1.0 ) );
+
+	/* look through rings of cells around the start's cell, each a cell further out than the last,
+	 * until the rings are further away than the nearest open cell found so far
+	 */
+	double nearest = -1.0;
+	int furthestRing = max( columns, rows );
+	for( int ring = 0; ring <= furthestRing; ring++ )
+	{
+		if( ( nearest >= 0.0 ) && ( ( ring - 0.5 ) * ( ring - 0.5 ) > nearest ) )
+		{
+			break;
+		}
+
+		int firstColumn = max( 0, centerColumn - ring );
+		int lastColumn = min( columns - 1, centerColumn + ring );
+		for( int row = max( 0, centerRow - ring ); row <= min( rows - 1, centerRow + ring ); row++ )
+		{
+			// the ring's top and bottom rows are looked at all the way across, the rows between only at its sides
+			bool wholeRow = ( row == centerRow - ring ) || ( row == centerRow + ring );
+			for( int column = firstColumn; column <= lastColumn; column++ )
+			{
+				if( !wholeRow && ( column != centerColumn - ring ) && ( column != centerColumn + ring ) )
+				{
+					column = centerColumn + ring - 1;	// skip across to the ring's other side
+					continue;
+				}
+				if( !grid.isOpen( column, row ) )
+				{
+					continue;
+				}
+				double distance = ( ( column - x ) * ( column - x ) ) + ( ( row - y ) * ( row - y ) );
+				if( ( nearest < 0.0 ) || ( distance < nearest ) )
+				{
+					nearest = distance;
+					startColumn = column;
+					startRow = row;
+				}
+			}
+		}
+	}
+}
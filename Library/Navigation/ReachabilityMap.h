@@ -0,0 +1,201 @@
+/*
+   Project     : 3DMaze
+   File        : ReachabilityMap.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Which of the open cells of an occupancy grid can be reached
+   				 from a starting point. The grid is cut into square clusters,
+   				 the open cells of each cluster are split into the regions
+   				 that are joined within it, and the regions are joined across
+   				 the borders between clusters by a union-find. When a line is
+   				 added to the grid, only the clusters it reaches are split up
+   				 again, and only the components they were in are searched to
+   				 see if they came apart, from all the places they could have
+   				 come apart at at once, stopping as soon as all but one of the
+   				 searches has run out of regions. A start that lands on a wall
+   				 is moved to the nearest open cell
+*/
+
+
+#ifndef REACHABILITYMAP_H_
+#define REACHABILITYMAP_H_
+
+#include <vector>
+#include <utility>
+
+#include "Point2D.h"
+#include "LineSegment2D.h"
+#include "OccupancyGrid.h"
+#include "DisjointSets.h"
+#include "ProgressMonitor.h"
+
+class ReachabilityMap
+{
+	public:
+		/* a stretch of open cells along a row, all in the same region of the same cluster
+		 */
+		class Run
+		{
+			public:
+				Run( int m_row, int m_firstColumn, int m_lastColumn, int m_region ) :
+					row( m_row ), firstColumn( m_firstColumn ), lastColumn( m_lastColumn ), region( m_region ) {}
+
+				int row;
+				int firstColumn, lastColumn;
+				int region;
+		};
+
+		/* clusters are clusterSize cells across, no more than max_cluster_size
+		 */
+		ReachabilityMap( int m_clusterSize = default_cluster_size );
+
+		/* splits the whole grid up into regions, and works out which can be reached from the start,
+		 * throws an OperationCanceled if the progress monitor cancels it
+		 */
+		void rebuild( const OccupancyGrid & grid, const Point2D & m_start, ProgressMonitor * progress = NULL ) throw( IOError & );
+
+		/* call once the line has been added to the grid, to split up the clusters it reaches again
+		 * ( the grid has to be the one the map was last rebuilt from )
+		 */
+		void lineAdded( const OccupancyGrid & grid, const LineSegment2D & line );
+
+		/* true if the cell is open and there's a way to it from the start
+		 */
+		bool isReachable( int column, int row ) const;
+
+		/* false when there isn't an open cell anywhere to start from, in which case nothing can be reached
+		 */
+		bool startIsOpen() const { return startRegion >= 0; }
+
+		/* the open cell everything is reached from, the one nearest the start, returns false if there isn't one
+		 */
+		bool startCell( int & column, int & row ) const;
+
+		int numberOfRegions() const { return liveRegions; }
+
+		/* the open cells of each cluster, as runs, for shading the ones that can't be reached
+		 * without looking at every cell ( clusters whose every cell can be reached can be skipped over )
+		 */
+		int numberOfClusters() const { return runs.size(); }
+		bool clusterIsReachable( int cluster ) const { return clusterReachable[ cluster ] != 0; }
+		const std::vector<Run> & runsIn( int cluster ) const { return runs[ cluster ]; }
+		bool runIsReachable( int cluster, const Run & run ) const
+		{
+			return ( startComponent >= 0 ) && ( components[ firstRegions[ cluster ] + run.region ] == startComponent );
+		}
+
+		/* trades everything worked out with the other map, without copying it
+		 */
+		void swap( ReachabilityMap & other );
+
+		static const int default_cluster_size = 32;
+		static const int max_cluster_size = 255;
+
+	private:
+		// which of its cluster's regions each cell is in, or no_region for blocked cells
+		typedef unsigned short LocalRegion;
+		static const LocalRegion no_region = 0xFFFF;
+		static const LocalRegion unlabeled = 0xFFFE;
+
+		// a pair of regions on either side of a border that open cells join
+		typedef std::pair<LocalRegion, LocalRegion> Link;
+
+		Point2D start;
+		int startColumn, startRow;	// -1 if there isn't an open cell to start from
+		int clusterSize;
+		int columns, rows;
+		int clusterColumns, clusterRows;
+
+		std::vector<LocalRegion> localRegions;
+
+		/* for each cluster, its regions and the open cells in them, and the links across its east and north borders,
+		 * each cluster's regions are numbered one after another from its first region's number,
+		 * a cluster that's split up again gets new numbers from the end, until there are as many unused numbers as used ones
+		 */
+		std::vector<int> regionCounts;
+		std::vector<int> firstRegions;
+		std::vector< std::vector<Run> > runs;
+		std::vector< std::vector<Link> > eastLinks;
+		std::vector< std::vector<Link> > northLinks;
+
+		// for each region number, the component its region is in ( -1 once the number isn't used ) and its cluster
+		std::vector<int> components;
+		std::vector<int> clustersOfRegions;
+		int liveRegions, deadRegions;
+		int nextComponent;
+
+		std::vector<unsigned char> clusterReachable;	// 1 when every region of the cluster can be reached
+		int startRegion;
+		int startComponent;
+
+		/* a search through the regions of a component, from one of the places it could have come apart,
+		 * searches that meet are joined into one
+		 */
+		class Search
+		{
+			public:
+				std::vector<int> toExpand;
+				unsigned int expanded;
+				std::vector<int> reached;
+				int joinedTo;
+				bool finished;
+		};
+		std::vector<Search> searches;
+
+		// which search reached each region, only if the region's search round is the current one
+		std::vector<int> searchesOfRegions;
+		std::vector<unsigned int> searchRounds;
+		unsigned int searchRound;
+
+		// kept from one cluster or line to the next
+		std::vector<int> toVisit;
+		std::vector<int> previousComponents;
+		std::vector<int> touchedComponents;
+		std::vector< std::pair<int, int> > seeds;	// component, region
+		std::vector<int> changedClusters;
+		std::vector<int> neighbors;
+
+		void clusterBounds( int cluster, int & left, int & bottom, int & width, int & height ) const;
+
+		/* splits the cluster's open cells into regions, and the regions into runs
+		 */
+		void split( const OccupancyGrid & grid, int cluster );
+
+		/* finds which regions open cells join across the cluster's east and north borders
+		 */
+		void link( int cluster );
+
+		/* splits the cluster up again, giving its regions new numbers, and notes which components its old regions were in
+		 */
+		void splitAgain( const OccupancyGrid & grid, int cluster );
+
+		/* the number of the region holding the cell, or -1 if it's blocked
+		 */
+		int regionAt( int column, int row ) const;
+
+		/* fills neighbors with every region linked to the region across its cluster's borders
+		 */
+		void neighborsOf( int region, std::vector<int> & neighbors ) const;
+
+		/* searches the component from each of the regions it could have come apart at, and gives every piece but one
+		 * a component of its own ( the seeds are the component's regions in and around the clusters split up again )
+		 */
+		void separate( int component, const std::vector< std::pair<int, int> > & seeds, int firstSeed, int endSeed );
+		int joinedSearch( int search );
+
+		/* works out which regions are in the start's component again
+		 */
+		void findStartComponent();
+		void updateClusterReachable( int cluster );
+
+		/* numbers the regions one after another again, once a lot of numbers have stopped being used
+		 */
+		void renumber();
+
+		/* moves the start to the open cell nearest it, the start can be on a wall
+		 * ( like the post in the middle of a maze an even number of cells across )
+		 */
+		void findStartCell( const OccupancyGrid & grid );
+};
+
+#endif /*REACHABILITYMAP_H_*/
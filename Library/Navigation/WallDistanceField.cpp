@@ -0,0 +1,446 @@
+/*
+   Project     : 3DMaze
+   File        : WallDistanceField.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : How far every point of a 2D maze is from the nearest wall,
+   				 sampled on a square grid, negative inside the walls. The
+   				 samples come from an exact Euclidean distance transform of
+   				 the walls' footprints, worked out a column and then a row at
+   				 a time on every core, so how close a point is to a wall takes
+   				 one lookup instead of a search through the walls. When a line
+   				 is added, only the tiles of samples within reach of it are
+   				 worked out again
+*/
+
+
+#include "WallDistanceField.h"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+const double WallDistanceField::default_sample_spacing = 2.0;
+const double WallDistanceField::default_max_distance = 64.0;
+const int WallDistanceField::max_samples;
+const int WallDistanceField::tile_size;
+const int WallDistanceField::min_samples_to_share;
+
+
+/* a run of columns or rows, transformed on a thread of its own, no other pass touches its samples
+ */
+class WallDistanceField::Pass : public QRunnable
+{
+	public:
+		Pass() : field( NULL ), overRows( false ), first( 0 ), last( 0 ), nearest(), parabolas(), bounds()
+		{
+			setAutoDelete( false );
+		}
+
+		void setUp( WallDistanceField & m_field, bool m_overRows, int m_first, int m_last )
+		{
+			field = &m_field;
+			overRows = m_overRows;
+			first = m_first;
+			last = m_last;
+		}
+
+		void run()
+		{
+			if( overRows )
+			{
+				field->transformRows( first, last, nearest, parabolas, bounds );
+			}
+			else
+			{
+				field->transformColumns( first, last );
+			}
+		}
+
+	private:
+		WallDistanceField * field;
+		bool overRows;
+		int first, last;
+
+		// room for the lower envelope of a row, kept from one row to the next
+		vector<float> nearest;
+		vector<int> parabolas;
+		vector<double> bounds;
+};
+
+
+/* the field is worked out on the given number of threads, or on one thread for each core when that's 0
+ */
+WallDistanceField::WallDistanceField( int m_numberOfThreads /* = 0 */ ) :
+	left( 0.0 ),
+	bottom( 0.0 ),
+	widthOfWall( 0.0 ),
+	sampleSpacing( default_sample_spacing ),
+	maxDistance( default_max_distance ),
+	columns( 0 ),
+	rows( 0 ),
+	numberOfThreads( ( m_numberOfThreads > 0 ) ? m_numberOfThreads : max( 1, QThread::idealThreadCount() ) ),
+	covered(),
+	distances(),
+	windowLeft( 0 ),
+	windowBottom( 0 ),
+	windowRight( 0 ),
+	windowTop( 0 ),
+	reach( 0 ),
+	rebuiltLeft( 0 ),
+	rebuiltBottom( 0 ),
+	rebuiltRight( 0 ),
+	rebuiltTop( 0 ) {}
+
+
+/* throws away whatever was in the field and samples the given maze instead, with walls widthOfWall across.
+ * Samples are sampleSpacing apart, or further for mazes that would need more than max_samples of them,
+ * and distances are only worked out as far as maxDistance, anything further is given as maxDistance
+ */
+void WallDistanceField::build( const Maze2D & maze, double m_widthOfWall, double m_sampleSpacing /* = default_sample_spacing */,
+							   double m_maxDistance /* = default_max_distance */ )
+{
+	widthOfWall = m_widthOfWall;
+	maxDistance = m_maxDistance;
+	double area = max( 1.0, ( double ) maze.getWidth() * maze.getHeight() );
+	sampleSpacing = max( m_sampleSpacing, sqrt( area / max_samples ) );
+	left = -maze.getWidth() / 2.0;
+	bottom = -maze.getHeight() / 2.0;
+	columns = max( 1, ( int ) ceil( maze.getWidth() / sampleSpacing ) );
+	rows = max( 1, ( int ) ceil( maze.getHeight() / sampleSpacing ) );
+
+	//one sample more than the furthest distance kept makes sure everything further is found to be further
+	reach = ( int ) ceil( maxDistance / sampleSpacing ) + 1;
+
+	covered.assign( ( size_t ) columns * rows, 0 );
+	distances.assign( ( size_t ) columns * rows, ( float ) maxDistance );
+	for( int i = 0; i < maze.numberOfLines(); i++ )
+	{
+		int firstColumn, firstRow, lastColumn, lastRow;
+		cover( maze.getALine( i ), firstColumn, firstRow, lastColumn, lastRow );
+	}
+	transform( 0, 0, columns - 1, rows - 1 );
+
+	//the column distances of the whole field take as much room as the field itself, while later windows are only a few tiles
+	vector<float>().swap( columnDistances[ 0 ] );
+	vector<float>().swap( columnDistances[ 1 ] );
+}
+
+
+/* works out the samples near a line that's been added to the maze again
+ */
+void WallDistanceField::addALine( const LineSegment2D & line )
+{
+	int firstColumn, firstRow, lastColumn, lastRow;
+	if( !cover( line, firstColumn, firstRow, lastColumn, lastRow ) )
+	{
+		rebuiltRight = rebuiltLeft;
+		rebuiltTop = rebuiltBottom;
+		return;
+	}
+
+	//only samples within reach of the newly covered ones can have changed, and they're worked out again a whole tile at a time
+	firstColumn = ( max( 0, firstColumn - reach ) / tile_size ) * tile_size;
+	firstRow = ( max( 0, firstRow - reach ) / tile_size ) * tile_size;
+	lastColumn = min( columns - 1, ( ( ( lastColumn + reach ) / tile_size ) + 1 ) * tile_size - 1 );
+	lastRow = min( rows - 1, ( ( ( lastRow + reach ) / tile_size ) + 1 ) * tile_size - 1 );
+	transform( firstColumn, firstRow, lastColumn, lastRow );
+}
+
+
+/* how far the point is from the nearest wall, negative inside one, worked out from the four samples around it
+ */
+double WallDistanceField::distanceAt( const Point2D & point ) const
+{
+	if( distances.empty() )
+	{
+		return maxDistance;
+	}
+
+	int column, row, nextColumn, nextRow;
+	double across, up;
+	samplesAround( point, column, row, nextColumn, nextRow, across, up );
+	double below = ( sampleAt( column, row ) * ( 1.0 - across ) ) + ( sampleAt( nextColumn, row ) * across );
+	double above = ( sampleAt( column, nextRow ) * ( 1.0 - across ) ) + ( sampleAt( nextColumn, nextRow ) * across );
+	return ( below * ( 1.0 - up ) ) + ( above * up );
+}
+
+
+/* the way away from the nearest wall, as a vector one unit long, or no length at all where the distance doesn't change
+ */
+Vector2D WallDistanceField::gradientAt( const Point2D & point ) const
+{
+	if( distances.empty() )
+	{
+		return Vector2D( 0.0, 0.0 );
+	}
+
+	int column, row, nextColumn, nextRow;
+	double across, up;
+	samplesAround( point, column, row, nextColumn, nextRow, across, up );
+	double alongX = ( ( sampleAt( nextColumn, row ) - sampleAt( column, row ) ) * ( 1.0 - up ) ) +
+					( ( sampleAt( nextColumn, nextRow ) - sampleAt( column, nextRow ) ) * up );
+	double alongY = ( ( sampleAt( column, nextRow ) - sampleAt( column, row ) ) * ( 1.0 - across ) ) +
+					( ( sampleAt( nextColumn, nextRow ) - sampleAt( nextColumn, row ) ) * across );
+	if( ( alongX == 0.0 ) && ( alongY == 0.0 ) )
+	{
+		return Vector2D( 0.0, 0.0 );
+	}
+	Vector2D gradient( alongX, alongY );
+	gradient.normalize();
+	return gradient;
+}
+
+
+/* how far distanceAt can be from the true distance, which comes from the walls being sampled
+ */
+double WallDistanceField::getErrorBound() const
+{
+	/* a sample is off by no more than half its square's diagonal, since every square a wall comes into is covered,
+	 * and between samples blending them can be off by as much again
+	 */
+	return sampleSpacing * sqrt( 2.0 );
+}
+
+
+/* the samples the last line added changed, whole tiles at a time, so only that part of a picture
+ * or texture made from them has to be redone ( the last come before the first if it changed none )
+ */
+void WallDistanceField::lastRebuilt( int & firstColumn, int & firstRow, int & lastColumn, int & lastRow ) const
+{
+	firstColumn = rebuiltLeft;
+	firstRow = rebuiltBottom;
+	lastColumn = rebuiltRight - 1;
+	lastRow = rebuiltTop - 1;
+}
+
+
+/* covers the samples whose squares the line's wall comes into, and gives the rectangle of the ones
+ * it newly covered, returns false if there weren't any
+ */
+bool WallDistanceField::cover( const LineSegment2D & line, int & firstColumn, int & firstRow, int & lastColumn, int & lastRow )
+{
+	const Point2D & p1 = line.getP1();
+	const Point2D & p2 = line.getP2();
+	double alongX = p2.getX() - p1.getX();
+	double alongY = p2.getY() - p1.getY();
+	double length = sqrt( ( alongX * alongX ) + ( alongY * alongY ) );
+	if( ( length == 0.0 ) || covered.empty() )
+	{
+		return false;
+	}
+	alongX /= length;
+	alongY /= length;
+
+	/* a wall comes into a sample's square if it comes within half the square's diagonal of its center,
+	 * or a little further in places, which only makes the field err toward walls being closer
+	 */
+	double slack = sampleSpacing * sqrt( 2.0 ) / 2.0;
+	double halfWidth = ( widthOfWall / 2.0 ) + slack;
+	double extentX = ( fabs( alongX ) * slack ) + ( fabs( alongY ) * halfWidth );
+	double extentY = ( fabs( alongY ) * slack ) + ( fabs( alongX ) * halfWidth );
+
+	int fromColumn = max( 0, ( int ) ceil( ( ( min( p1.getX(), p2.getX() ) - extentX - left ) / sampleSpacing ) - 0.5 ) );
+	int toColumn = min( columns - 1, ( int ) floor( ( ( max( p1.getX(), p2.getX() ) + extentX - left ) / sampleSpacing ) - 0.5 ) );
+	int fromRow = max( 0, ( int ) ceil( ( ( min( p1.getY(), p2.getY() ) - extentY - bottom ) / sampleSpacing ) - 0.5 ) );
+	int toRow = min( rows - 1, ( int ) floor( ( ( max( p1.getY(), p2.getY() ) + extentY - bottom ) / sampleSpacing ) - 0.5 ) );
+
+	bool coveredAny = false;
+	for( int row = fromRow; row <= toRow; row++ )
+	{
+		double y = bottom + ( ( row + 0.5 ) * sampleSpacing ) - p1.getY();
+		for( int column = fromColumn; column <= toColumn; column++ )
+		{
+			double x = left + ( ( column + 0.5 ) * sampleSpacing ) - p1.getX();
+			double along = ( x * alongX ) + ( y * alongY );
+			double aside = ( x * alongY ) - ( y * alongX );
+			unsigned char & sample = covered[ ( row * columns ) + column ];
+			if( ( sample == 0 ) && ( along >= -slack ) && ( along <= length + slack ) && ( fabs( aside ) <= halfWidth ) )
+			{
+				sample = 1;
+				firstColumn = coveredAny ? min( firstColumn, column ) : column;
+				lastColumn = coveredAny ? max( lastColumn, column ) : column;
+				firstRow = coveredAny ? firstRow : row;
+				lastRow = row;
+				coveredAny = true;
+			}
+		}
+	}
+	return coveredAny;
+}
+
+
+/* works out the distances of the samples from firstColumn to lastColumn and firstRow to lastRow,
+ * looking no further than the reach of the field past them
+ */
+void WallDistanceField::transform( int firstColumn, int firstRow, int lastColumn, int lastRow )
+{
+	windowLeft = max( 0, firstColumn - reach );
+	windowBottom = max( 0, firstRow - reach );
+	windowRight = min( columns, lastColumn + 1 + reach );
+	windowTop = min( rows, lastRow + 1 + reach );
+	rebuiltLeft = firstColumn;
+	rebuiltBottom = firstRow;
+	rebuiltRight = lastColumn + 1;
+	rebuiltTop = lastRow + 1;
+
+	size_t windowSamples = ( size_t ) ( windowRight - windowLeft ) * ( windowTop - windowBottom );
+	columnDistances[ 0 ].resize( windowSamples );
+	columnDistances[ 1 ].resize( windowSamples );
+	runPass( false, windowRight - windowLeft );
+	runPass( true, rebuiltTop - rebuiltBottom );
+}
+
+
+/* the first pass of the transform, how far each sample of the window is from the nearest covered sample,
+ * and the nearest open one, in its own column, no further than the reach
+ */
+void WallDistanceField::transformColumns( int first, int last )
+{
+	int width = windowRight - windowLeft;
+	int height = windowTop - windowBottom;
+	for( int kind = 0; kind < 2; kind++ )
+	{
+		vector<float> & toNearest = columnDistances[ kind ];
+		unsigned char wanted = ( kind == 0 ) ? 1 : 0;
+		for( int column = first; column < last; column++ )
+		{
+			const unsigned char * samples = &covered[ ( windowBottom * columns ) + windowLeft + column ];
+			float * out = &toNearest[ column ];
+
+			//up the column and then back down, each sample takes the nearer of what was found below and above it
+			int run = reach;
+			for( int y = 0; y < height; y++ )
+			{
+				run = ( samples[ y * columns ] == wanted ) ? 0 : min( run + 1, reach );
+				out[ y * width ] = run;
+			}
+			run = reach;
+			for( int y = height - 1; y >= 0; y-- )
+			{
+				run = ( samples[ y * columns ] == wanted ) ? 0 : min( run + 1, reach );
+				float nearest = min( out[ y * width ], ( float ) run );
+				out[ y * width ] = nearest * nearest;
+			}
+		}
+	}
+}
+
+
+/* the second pass of the transform, for the rows being worked out, takes the nearest of the distances down every column
+ * of the window, as the lower envelope of the parabolas rising from each column's distance
+ */
+void WallDistanceField::transformRows( int first, int last, vector<float> & nearest, vector<int> & parabolas, vector<double> & bounds )
+{
+	int width = windowRight - windowLeft;
+	int firstColumn = rebuiltLeft - windowLeft;
+	int lastColumn = rebuiltRight - windowLeft;
+	nearest.resize( 2 * width );
+	parabolas.resize( width );
+	bounds.resize( width + 1 );
+
+	for( int row = rebuiltBottom + first; row < rebuiltBottom + last; row++ )
+	{
+		for( int kind = 0; kind < 2; kind++ )
+		{
+			const float * squares = &columnDistances[ kind ][ ( size_t ) ( row - windowBottom ) * width ];
+
+			//each parabola takes over from the last one where they cross, dropping any it passes before they take over
+			int top = 0;
+			parabolas[ 0 ] = 0;
+			bounds[ 0 ] = -numeric_limits<double>::max();
+			bounds[ 1 ] = numeric_limits<double>::max();
+			for( int column = 1; column < width; column++ )
+			{
+				double crossing;
+				while( true )
+				{
+					int previous = parabolas[ top ];
+					crossing = ( ( squares[ column ] + ( ( double ) column * column ) ) - ( squares[ previous ] + ( ( double ) previous * previous ) ) ) /
+							   ( 2.0 * ( column - previous ) );
+					if( crossing > bounds[ top ] )
+					{
+						break;
+					}
+					top--;
+				}
+				top++;
+				parabolas[ top ] = column;
+				bounds[ top ] = crossing;
+				bounds[ top + 1 ] = numeric_limits<double>::max();
+			}
+
+			int lowest = 0;
+			for( int column = firstColumn; column < lastColumn; column++ )
+			{
+				while( bounds[ lowest + 1 ] < column )
+				{
+					lowest++;
+				}
+				int from = parabolas[ lowest ];
+				nearest[ ( kind * width ) + column ] = ( float ) ( column - from ) * ( column - from ) + squares[ from ];
+			}
+		}
+
+		for( int column = firstColumn; column < lastColumn; column++ )
+		{
+			size_t sample = ( ( size_t ) row * columns ) + windowLeft + column;
+			double distance = ( covered[ sample ] != 0 ) ? -sqrt( nearest[ width + column ] ) : sqrt( nearest[ column ] );
+			distances[ sample ] = ( float ) max( -maxDistance, min( maxDistance, distance * sampleSpacing ) );
+		}
+	}
+}
+
+
+/* runs a pass of the transform over the given number of columns or rows, shared out between the threads
+ * when the window is big enough to be worth it
+ */
+void WallDistanceField::runPass( bool overRows, int count )
+{
+	int windowSamples = ( windowRight - windowLeft ) * ( windowTop - windowBottom );
+	int numberOfPasses = ( windowSamples < min_samples_to_share ) ? 1 : max( 1, min( numberOfThreads, count ) );
+	vector<Pass> passes( numberOfPasses );
+	for( int i = 0; i < numberOfPasses; i++ )
+	{
+		passes[ i ].setUp( *this, overRows, ( int ) ( ( ( long long ) count * i ) / numberOfPasses ),
+						   ( int ) ( ( ( long long ) count * ( i + 1 ) ) / numberOfPasses ) );
+	}
+
+	if( numberOfPasses == 1 )
+	{
+		passes[ 0 ].run();
+		return;
+	}
+
+	QThreadPool pool;
+	pool.setMaxThreadCount( numberOfPasses );
+	for( int i = 0; i < numberOfPasses; i++ )
+	{
+		pool.start( &passes[ i ] );
+	}
+	pool.waitForDone();
+}
+
+
+/* the sample at or below and to the left of the point, with the one past it in each direction,
+ * and how far along the point is between them
+ */
+void WallDistanceField::samplesAround( const Point2D & point, int & column, int & row, int & nextColumn, int & nextRow,
+									   double & across, double & up ) const
+{
+	//points past the outermost samples take their values
+	double x = max( 0.0, min( columns - 1.0, ( ( point.getX() - left ) / sampleSpacing ) - 0.5 ) );
+	double y = max( 0.0, min( rows - 1.0, ( ( point.getY() - bottom ) / sampleSpacing ) - 0.5 ) );
+	column = min( ( int ) x, max( 0, columns - 2 ) );
+	row = min( ( int ) y, max( 0, rows - 2 ) );
+	nextColumn = min( column + 1, columns - 1 );
+	nextRow = min( row + 1, rows - 1 );
+	across = x - column;
+	up = y - row;
+}
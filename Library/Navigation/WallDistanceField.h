@@ -0,0 +1,133 @@
+/*
+   Project     : 3DMaze
+   File        : WallDistanceField.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : How far every point of a 2D maze is from the nearest wall,
+   				 sampled on a square grid, negative inside the walls. The
+   				 samples come from an exact Euclidean distance transform of
+   				 the walls' footprints, worked out a column and then a row at
+   				 a time on every core, so how close a point is to a wall takes
+   				 one lookup instead of a search through the walls. When a line
+   				 is added, only the tiles of samples within reach of it are
+   				 worked out again
+*/
+
+
+#ifndef WALLDISTANCEFIELD_H_
+#define WALLDISTANCEFIELD_H_
+
+#include <vector>
+
+#include "Point2D.h"
+#include "Vector2D.h"
+#include "LineSegment2D.h"
+#include "Maze2D.h"
+
+class WallDistanceField
+{
+	public:
+		/* the field is worked out on the given number of threads, or on one thread for each core when that's 0
+		 */
+		WallDistanceField( int m_numberOfThreads = 0 );
+
+		/* throws away whatever was in the field and samples the given maze instead, with walls widthOfWall across.
+		 * Samples are sampleSpacing apart, or further for mazes that would need more than max_samples of them,
+		 * and distances are only worked out as far as maxDistance, anything further is given as maxDistance
+		 */
+		void build( const Maze2D & maze, double m_widthOfWall, double m_sampleSpacing = default_sample_spacing,
+					double m_maxDistance = default_max_distance );
+
+		/* works out the samples near a line that's been added to the maze again
+		 */
+		void addALine( const LineSegment2D & line );
+
+		/* how far the point is from the nearest wall, negative inside one, worked out from the four samples around it
+		 */
+		double distanceAt( const Point2D & point ) const;
+
+		/* the way away from the nearest wall, as a vector one unit long, or no length at all where the distance doesn't change
+		 */
+		Vector2D gradientAt( const Point2D & point ) const;
+
+		/* true if the point is certainly further than the radius from every wall
+		 * ( false doesn't mean it isn't, only that the samples are too coarse to tell )
+		 */
+		bool isClear( const Point2D & point, double radius = 0.0 ) const { return distanceAt( point ) - getErrorBound() > radius; }
+
+		/* how far distanceAt can be from the true distance, which comes from the walls being sampled
+		 */
+		double getErrorBound() const;
+
+		int getColumns() const { return columns; }
+		int getRows() const { return rows; }
+		double getSampleSpacing() const { return sampleSpacing; }
+		double getMaxDistance() const { return maxDistance; }
+
+		/* every sample, a row at a time from the bottom left, ready to be drawn as a picture of the maze
+		 * or handed over as a texture, the sample in each corner is at the center of that corner's square
+		 */
+		const std::vector<float> & getDistances() const { return distances; }
+		float sampleAt( int column, int row ) const { return distances[ ( row * columns ) + column ]; }
+
+		/* the samples the last line added changed, whole tiles at a time, so only that part of a picture
+		 * or texture made from them has to be redone ( the last come before the first if it changed none )
+		 */
+		void lastRebuilt( int & firstColumn, int & firstRow, int & lastColumn, int & lastRow ) const;
+
+		static const double default_sample_spacing;
+		static const double default_max_distance;
+		static const int max_samples = 1 << 22;
+
+		// how many samples across the squares the field is worked out again in are
+		static const int tile_size = 64;
+
+		// windows with fewer samples than this aren't worth handing out to other threads
+		static const int min_samples_to_share = 1 << 16;
+
+	private:
+		double left, bottom;
+		double widthOfWall;
+		double sampleSpacing;
+		double maxDistance;
+		int columns, rows;
+		int numberOfThreads;
+
+		// 1 for every sample whose square a wall's footprint comes into, and each sample's distance
+		std::vector<unsigned char> covered;
+		std::vector<float> distances;
+
+		/* the part of the field being worked out, the samples from windowLeft up to but not including windowRight and so on,
+		 * and the squared distances, in samples, down each of its columns to the nearest covered sample and to the nearest open one
+		 */
+		int windowLeft, windowBottom, windowRight, windowTop;
+		int reach;
+		std::vector<float> columnDistances[ 2 ];
+		int rebuiltLeft, rebuiltBottom, rebuiltRight, rebuiltTop;
+
+		/* covers the samples whose squares the line's wall comes into, and gives the rectangle of the ones
+		 * it newly covered, returns false if there weren't any
+		 */
+		bool cover( const LineSegment2D & line, int & firstColumn, int & firstRow, int & lastColumn, int & lastRow );
+
+		/* works out the distances of the samples from firstColumn to lastColumn and firstRow to lastRow,
+		 * looking no further than the reach of the field past them
+		 */
+		void transform( int firstColumn, int firstRow, int lastColumn, int lastRow );
+
+		/* the two passes of the transform, over the window's columns, then over the rows being worked out
+		 */
+		void transformColumns( int first, int last );
+		void transformRows( int first, int last, std::vector<float> & nearest, std::vector<int> & parabolas, std::vector<double> & bounds );
+		void runPass( bool overRows, int count );
+
+		/* the sample at or below and to the left of the point, with the one past it in each direction,
+		 * and how far along the point is between them
+		 */
+		void samplesAround( const Point2D & point, int & column, int & row, int & nextColumn, int & nextRow, double & across, double & up ) const;
+
+		// a run of columns or rows to transform, on a thread of its own
+		class Pass;
+};
+
+#endif /*WALLDISTANCEFIELD_H_*/
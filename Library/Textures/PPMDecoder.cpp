@@ -0,0 +1,243 @@
+/*
+   Project     : 3DMaze
+   File        : PPMDecoder.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Decodes PPM images, in both their text ( P3 ) and binary ( P6 )
+   				 forms, straight out of memory into a texture image
+*/
+
+
+#include "PPMDecoder.h"
+
+using namespace std;
+
+namespace
+{
+	bool isWhiteSpace( unsigned char character )
+	{
+		// ' ' and everything from '\t' to '\r' ( '\t', '\n', '\v', '\f' and '\r' ) is white space
+		return ( character == ' ' ) || ( ( character >= '\t' ) && ( character <= '\r' ) );
+	}
+
+	bool isDigit( unsigned char character )
+	{
+		return ( unsigned char ) ( character - '0' ) <= 9;
+	}
+
+	const int samples_per_pixel = 3;
+}
+
+/* the data has to stay around for as long as this decoder does,
+ * it doesn't need to end with a null character
+ */
+PPMDecoder::PPMDecoder( const char * m_data, size_t m_size ) :
+	position( reinterpret_cast<const unsigned char *>( m_data ) ),
+	end( reinterpret_cast<const unsigned char *>( m_data ) + m_size ),
+	scaledSamples() {}
+
+
+/* returns true if the data starts like a PPM image this can decode
+ */
+bool PPMDecoder::isPPM( const char * data, size_t size )
+{
+	return ( size >= 3 ) && ( data[ 0 ] == 'P' ) && ( ( data[ 1 ] == '3' ) || ( data[ 1 ] == '6' ) ) && isWhiteSpace( data[ 2 ] );
+}
+
+
+/* fills in the full sized level of the image ( its mipmaps aren't built ),
+ * throws an IOError if the data isn't a PPM image or ends early
+ */
+void PPMDecoder::decode( TextureImage & image ) throw( IOError & )
+{
+	if( !isPPM( reinterpret_cast<const char *>( position ), end - position ) )
+	{
+		throw IOError();
+	}
+	bool isText = ( position[ 1 ] == '3' );
+	position += 2;
+
+	int width = readHeaderNumber();
+	int height = readHeaderNumber();
+	int maximumSample = readHeaderNumber();
+	if( ( width <= 0 ) || ( height <= 0 ) || ( maximumSample <= 0 ) || ( maximumSample > max_maximum_sample ) )
+	{
+		throw IOError();
+	}
+
+	//work out once what every possible sample turns into
+	scaledSamples.resize( maximumSample + 1 );
+	for( int sample = 0; sample <= maximumSample; sample++ )
+	{
+		scaledSamples[ sample ] = ( unsigned char ) ( ( ( sample * 255 ) + ( maximumSample / 2 ) ) / maximumSample );
+	}
+
+	//every text sample takes at least a digit and the white space in front of it, so make sure
+	//the data could hold the whole image before making room for it
+	size_t bytesPerPixel = ( size_t ) samples_per_pixel * ( isText ? 2 : ( ( maximumSample < 256 ) ? 1 : 2 ) );
+	if( ( size_t ) width > ( ( size_t ) ( end - position ) / bytesPerPixel ) / height )
+	{
+		throw IOError();
+	}
+
+	image.resize( width, height );
+	if( isText )
+	{
+		decodeText( image, maximumSample );
+	}
+	else
+	{
+		//exactly one white space character separates the header from the samples
+		if( ( position == end ) || !isWhiteSpace( *position ) )
+		{
+			throw IOError();
+		}
+		position++;
+		decodeBinary( image, maximumSample );
+	}
+}
+
+
+/* skips white space, and comments which run from a '#' to the end of their line
+ */
+void PPMDecoder::skipWhiteSpaceAndComments()
+{
+	while( position < end )
+	{
+		if( *position == '#' )
+		{
+			while( ( position < end ) && ( *position != '\n' ) && ( *position != '\r' ) )
+			{
+				position++;
+			}
+		}
+		else if( isWhiteSpace( *position ) )
+		{
+			position++;
+		}
+		else
+		{
+			break;
+		}
+	}
+}
+
+
+int PPMDecoder::readHeaderNumber() throw( IOError & )
+{
+	skipWhiteSpaceAndComments();
+	if( ( position == end ) || !isDigit( *position ) )
+	{
+		throw IOError();
+	}
+
+	int value = 0;
+	while( ( position < end ) && isDigit( *position ) )
+	{
+		value = ( value * 10 ) + ( *position - '0' );
+		if( value > ( 1 << 24 ) )
+		{
+			throw IOError();
+		}
+		position++;
+	}
+	return value;
+}
+
+
+/* samples are written out in decimal, separated by white space ( and maybe comments ),
+ * they're picked out by hand through a local pointer the compiler can keep in a register,
+ * and turned into bytes through the table of scaled samples
+ */
+void PPMDecoder::decodeText( TextureImage & image, int maximumSample ) throw( IOError & )
+{
+	int width = image.getWidth();
+	int height = image.getHeight();
+	const unsigned char * scaled = &scaledSamples[ 0 ];
+	const unsigned char * next = position;
+
+	//the first row of the file is the top of the image, and the image is stored bottom row first
+	for( int y = height - 1; y >= 0; y-- )
+	{
+		unsigned char * pixel = image.getLevel( 0 ) + ( ( size_t ) y * width * TextureImage::bytes_per_pixel );
+		for( int x = 0; x < width; x++ )
+		{
+			for( int channel = 0; channel < samples_per_pixel; channel++ )
+			{
+				//skip the white space before the sample, usually just a space or two
+				while( ( next < end ) && !isDigit( *next ) )
+				{
+					if( *next == '#' )
+					{
+						position = next;
+						skipWhiteSpaceAndComments();
+						next = position;
+					}
+					else if( isWhiteSpace( *next ) )
+					{
+						next++;
+					}
+					else
+					{
+						throw IOError();
+					}
+				}
+				if( next == end )
+				{
+					throw IOError();
+				}
+
+				int sample = 0;
+				do
+				{
+					sample = ( sample * 10 ) + ( *next++ - '0' );
+					if( sample > maximumSample )
+					{
+						throw IOError();
+					}
+				}
+				while( ( next < end ) && isDigit( *next ) );
+				*pixel++ = scaled[ sample ];
+			}
+			*pixel++ = 255;
+		}
+	}
+
+	position = next;
+}
+
+
+void PPMDecoder::decodeBinary( TextureImage & image, int maximumSample ) throw( IOError & )
+{
+	int width = image.getWidth();
+	int height = image.getHeight();
+	int bytesPerSample = ( maximumSample < 256 ) ? 1 : 2;
+	size_t bytesPerRow = ( size_t ) width * samples_per_pixel * bytesPerSample;
+	if( ( size_t ) ( end - position ) < ( bytesPerRow * height ) )
+	{
+		throw IOError();
+	}
+
+	const unsigned char * scaled = &scaledSamples[ 0 ];
+	for( int y = height - 1; y >= 0; y-- )
+	{
+		unsigned char * pixel = image.getLevel( 0 ) + ( ( size_t ) y * width * TextureImage::bytes_per_pixel );
+		const unsigned char * sample = position;
+		for( int x = 0; x < width; x++ )
+		{
+			for( int channel = 0; channel < samples_per_pixel; channel++ )
+			{
+				//two byte samples are written most significant byte first
+				int value = ( bytesPerSample == 1 ) ? sample[ 0 ] : ( ( sample[ 0 ] << 8 ) | sample[ 1 ] );
+				if( value > maximumSample )
+				{
+					throw IOError();
+				}
+				*pixel++ = scaled[ value ];
+				sample += bytesPerSample;
+			}
+			*pixel++ = 255;
+		}
+		position += bytesPerRow;
+	}
+}
@@ -0,0 +1,57 @@
+/*
+   Project     : 3DMaze
+   File        : PPMDecoder.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Decodes PPM images, in both their text ( P3 ) and binary ( P6 )
+   				 forms, straight out of memory into a texture image
+*/
+
+
+#ifndef PPMDECODER_H_
+#define PPMDECODER_H_
+
+#include <vector>
+#include <cstddef>
+
+#include "TextureImage.h"
+#include "IOError.h"
+
+class PPMDecoder
+{
+	public:
+		/* the data has to stay around for as long as this decoder does,
+		 * it doesn't need to end with a null character
+		 */
+		PPMDecoder( const char * m_data, std::size_t m_size );
+
+		/* fills in the full sized level of the image ( its mipmaps aren't built ),
+		 * throws an IOError if the data isn't a PPM image or ends early
+		 */
+		void decode( TextureImage & image ) throw( IOError & );
+
+		/* returns true if the data starts like a PPM image this can decode
+		 */
+		static bool isPPM( const char * data, std::size_t size );
+
+	private:
+		const unsigned char * position;
+		const unsigned char * end;
+
+		// the value every sample is turned into, so samples can be any size
+		std::vector<unsigned char> scaledSamples;
+
+		/* skips white space, and comments which run from a '#' to the end of their line
+		 */
+		void skipWhiteSpaceAndComments();
+
+		int readHeaderNumber() throw( IOError & );
+
+		void decodeText( TextureImage & image, int maximumSample ) throw( IOError & );
+		void decodeBinary( TextureImage & image, int maximumSample ) throw( IOError & );
+
+		// the largest sample value a PPM image can have
+		static const int max_maximum_sample = 65535;
+};
+
+#endif /*PPMDECODER_H_*/
@@ -0,0 +1,184 @@
+/*
+   Project     : 3DMaze
+   File        : TextureCache.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps every texture that's been decoded, mipmaps and all,
+   				 in a directory of binary files named after a hash of the
+   				 image they were decoded from, so decoding the same image
+   				 again is just a matter of reading one file back in
+*/
+
+
+#include "TextureCache.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+
+#include "PPMDecoder.h"
+#include "MappedFile.h"
+#include "DurableFile.h"
+
+using namespace std;
+
+const char TextureCache::magic_number[ TextureCache::magic_number_length ] = { '3', 'D', 'T', 'e', 'x', 'C', '\x1a', '\0' };
+
+namespace
+{
+	// starting value and multiplier of the 64 bit FNV-1a hash
+	const uint64_t hash_offset_basis = 14695981039346656037ULL;
+	const uint64_t hash_prime = 1099511628211ULL;
+}
+
+/* the directory has to exist already, nothing is cached if it can't be written to
+ */
+TextureCache::TextureCache( const string & m_directory ) :
+	directory( m_directory ),
+	lastWasCached( false ) {}
+
+
+/* decodes the PPM image in the data and builds its mipmaps, or reads back
+ * what decoding it gave last time, throws an IOError if it isn't a PPM image
+ */
+void TextureCache::load( const char * data, size_t size, TextureImage & image ) throw( IOError & )
+{
+	uint64_t hashOfSource = hashOf( data, size );
+	lastWasCached = readFromCache( hashOfSource, size, image );
+	if( lastWasCached )
+	{
+		return;
+	}
+
+	PPMDecoder decoder( data, size );
+	decoder.decode( image );
+	image.buildMipmaps();
+	writeToCache( hashOfSource, size, image );
+}
+
+
+/* the file the texture decoded from an image with the given hash is kept in
+ */
+string TextureCache::cacheFileNameFor( uint64_t hashOfSource ) const
+{
+	ostringstream fileName;
+	fileName << directory << '/' << hex << setfill( '0' ) << setw( 16 ) << hashOfSource << ".texture";
+	return fileName.str();
+}
+
+
+/* a hash of the bytes, taken eight at a time
+ */
+uint64_t TextureCache::hashOf( const char * data, size_t size )
+{
+	uint64_t hash = hash_offset_basis ^ size;
+	size_t i = 0;
+	for( ; ( i + sizeof( uint64_t ) ) <= size; i += sizeof( uint64_t ) )
+	{
+		uint64_t eightBytes;
+		memcpy( &eightBytes, data + i, sizeof( eightBytes ) );
+		hash = ( hash ^ eightBytes ) * hash_prime;
+	}
+	for( ; i < size; i++ )
+	{
+		hash = ( hash ^ ( unsigned char ) data[ i ] ) * hash_prime;
+	}
+	//mix the high bits, which the multiplications filled the most, back into the low ones
+	return hash ^ ( hash >> 29 );
+}
+
+
+/* returns false if there's no cached texture for the image
+ */
+bool TextureCache::readFromCache( uint64_t hashOfSource, size_t sizeOfSource, TextureImage & image )
+{
+	string fileName = cacheFileNameFor( hashOfSource );
+	long long sizeOfCacheFile, modified;
+	if( !DurableFile::getStamp( fileName, sizeOfCacheFile, modified ) || ( sizeOfCacheFile < ( long long ) sizeof( TextureCacheHeader ) ) )
+	{
+		return false;
+	}
+
+	try
+	{
+		MappedFile mapping( fileName );
+		TextureCacheHeader header;
+		memcpy( &header, mapping.getData(), sizeof( header ) );
+		if( ( memcmp( header.magicNumber, magic_number, magic_number_length ) != 0 ) ||
+			( header.byteOrderMark != TextureCacheHeader::byte_order_mark ) ||
+			( header.version != TextureCacheHeader::current_version ) ||
+			( header.hashOfSource != hashOfSource ) || ( header.sizeOfSource != sizeOfSource ) ||
+			( header.width <= 0 ) || ( header.height <= 0 ) || ( header.numberOfLevels == 0 ) || ( header.numberOfLevels > 32 ) )
+		{
+			return false;
+		}
+
+		//make sure the file holds every level before making room for them, a bad header
+		//could otherwise ask for more memory than there is
+		size_t sizeOfPixels = mapping.getSize() - sizeof( header );
+		if( ( size_t ) header.width > ( sizeOfPixels / TextureImage::bytes_per_pixel ) / header.height )
+		{
+			return false;
+		}
+		size_t sizeOfLevels = 0;
+		for( unsigned int level = 0; level < header.numberOfLevels; level++ )
+		{
+			sizeOfLevels += ( size_t ) max( 1, header.width >> level ) * max( 1, header.height >> level ) * TextureImage::bytes_per_pixel;
+		}
+		if( sizeOfPixels != sizeOfLevels )
+		{
+			return false;
+		}
+
+		image.setPixels( header.width, header.height, header.numberOfLevels, reinterpret_cast<const unsigned char *>( mapping.getData() + sizeof( header ) ) );
+		return true;
+	}
+	catch( IOError & ioe )
+	{
+		return false;
+	}
+}
+
+
+/* writing the cache is best effort, if it fails the texture is just decoded again next time
+ */
+void TextureCache::writeToCache( uint64_t hashOfSource, size_t sizeOfSource, const TextureImage & image )
+{
+	TextureCacheHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magicNumber, magic_number, sizeof( header.magicNumber ) );
+	header.byteOrderMark = TextureCacheHeader::byte_order_mark;
+	header.version = TextureCacheHeader::current_version;
+	header.hashOfSource = hashOfSource;
+	header.sizeOfSource = sizeOfSource;
+	header.width = image.getWidth();
+	header.height = image.getHeight();
+	header.numberOfLevels = image.numberOfLevels();
+
+	//written under another name first, so nobody ever reads a half written file
+	string fileName = cacheFileNameFor( hashOfSource );
+	string temporaryFileName = fileName + ".writing";
+	{
+		ofstream outFile( temporaryFileName.c_str(), ios::out | ios::binary );
+		outFile.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+		outFile.write( reinterpret_cast<const char *>( image.getAllLevels() ), image.sizeOfAllLevels() );
+		outFile.close();
+		if( !outFile )
+		{
+			remove( temporaryFileName.c_str() );
+			return;
+		}
+	}
+
+	try
+	{
+		DurableFile::replace( temporaryFileName, fileName );
+	}
+	catch( IOError & ioe )
+	{
+		remove( temporaryFileName.c_str() );
+	}
+}
@@ -0,0 +1,83 @@
+/*
+   Project     : 3DMaze
+   File        : TextureCache.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps every texture that's been decoded, mipmaps and all,
+   				 in a directory of binary files named after a hash of the
+   				 image they were decoded from, so decoding the same image
+   				 again is just a matter of reading one file back in
+*/
+
+
+#ifndef TEXTURECACHE_H_
+#define TEXTURECACHE_H_
+
+#include <string>
+#include <cstddef>
+#include <stdint.h>
+
+#include "TextureImage.h"
+#include "IOError.h"
+
+/* the start of every file in the cache, followed by every level of the texture
+ */
+class TextureCacheHeader
+{
+	public:
+		char magicNumber[ 8 ];
+		uint32_t byteOrderMark;		// written as byte_order_mark, so files from machines with a different byte order are recognized
+		uint32_t version;
+		uint64_t hashOfSource;
+		uint64_t sizeOfSource;
+		int32_t width;
+		int32_t height;
+		uint32_t numberOfLevels;
+		uint32_t padding;
+
+		static const uint32_t byte_order_mark = 0x01020304;
+		static const uint32_t current_version = 1;
+};
+
+class TextureCache
+{
+	public:
+		/* the directory has to exist already, nothing is cached if it can't be written to
+		 */
+		TextureCache( const std::string & m_directory );
+
+		/* decodes the PPM image in the data and builds its mipmaps, or reads back
+		 * what decoding it gave last time, throws an IOError if it isn't a PPM image
+		 */
+		void load( const char * data, std::size_t size, TextureImage & image ) throw( IOError & );
+
+		/* true if the last image loaded came out of the cache
+		 */
+		bool lastLoadWasCached() const { return lastWasCached; }
+
+		/* the file the texture decoded from an image with the given hash is kept in
+		 */
+		std::string cacheFileNameFor( uint64_t hashOfSource ) const;
+
+		/* a hash of the bytes, taken eight at a time
+		 */
+		static uint64_t hashOf( const char * data, std::size_t size );
+
+		// every cache file starts with these bytes
+		static const int magic_number_length = 8;
+		static const char magic_number[ magic_number_length ];
+
+	private:
+		std::string directory;
+		bool lastWasCached;
+
+		/* returns false if there's no cached texture for the image
+		 */
+		bool readFromCache( uint64_t hashOfSource, std::size_t sizeOfSource, TextureImage & image );
+
+		/* writing the cache is best effort, if it fails the texture is just decoded again next time
+		 */
+		void writeToCache( uint64_t hashOfSource, std::size_t sizeOfSource, const TextureImage & image );
+};
+
+#endif /*TEXTURECACHE_H_*/
@@ -0,0 +1,203 @@
+/*
+   Project     : 3DMaze
+   File        : TextureImage.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : An image ready to be used as a texture, 8 bits each of red,
+   				 green, blue and alpha for every pixel, stored bottom row first
+   				 the way openGL wants it, along with every smaller mipmap level
+   				 down to a single pixel
+*/
+
+
+#include "TextureImage.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+
+TextureImage::TextureImage() :
+	width( 0 ),
+	height( 0 ),
+	pixels(),
+	levelOffsets() {}
+
+
+/* makes room for an image of the given size, with just its full sized level,
+ * the pixels are left for the caller to fill in
+ */
+void TextureImage::resize( int m_width, int m_height )
+{
+	width = m_width;
+	height = m_height;
+	layOutLevels( 1 );
+}
+
+
+/* copies the pixels of the image, and builds its mipmaps
+ */
+void TextureImage::fitToImage( const QImage & image )
+{
+	resize( image.width(), image.height() );
+	unsigned char * pixel = getLevel( 0 );
+	for( int y = height - 1; y >= 0; y-- )
+	{
+		for( int x = 0; x < width; x++ )
+		{
+			QRgb color = image.pixel( x, y );
+			*pixel++ = qRed( color );
+			*pixel++ = qGreen( color );
+			*pixel++ = qBlue( color );
+			*pixel++ = qAlpha( color );
+		}
+	}
+	buildMipmaps();
+}
+
+
+/* makes every pixel of every level the given color, for standing in
+ * for a texture that isn't ready yet
+ */
+void TextureImage::fillWithColor( int m_width, int m_height, const QColor & color )
+{
+	resize( m_width, m_height );
+	buildMipmaps();
+	unsigned char channels[ bytes_per_pixel ] = { ( unsigned char ) color.red(), ( unsigned char ) color.green(),
+												  ( unsigned char ) color.blue(), ( unsigned char ) color.alpha() };
+	for( size_t i = 0; i < pixels.size(); i++ )
+	{
+		pixels[ i ] = channels[ i % bytes_per_pixel ];
+	}
+}
+
+
+/* replaces the smaller levels with ones shrunk from the full sized level
+ */
+void TextureImage::buildMipmaps()
+{
+	if( isNull() )
+	{
+		return;
+	}
+
+	int levels = 1;
+	for( int size = max( width, height ); size > 1; size /= 2 )
+	{
+		levels++;
+	}
+	layOutLevels( levels );
+
+	//each pixel of a level is the average of the 2x2 pixels under it in the level above,
+	//an odd row or column at the edge of a level is folded into the pixels next to it
+	for( int level = 1; level < levels; level++ )
+	{
+		int aboveWidth = levelWidth( level - 1 );
+		int aboveHeight = levelHeight( level - 1 );
+		const unsigned char * above = getLevel( level - 1 );
+		unsigned char * pixel = getLevel( level );
+		for( int y = 0; y < levelHeight( level ); y++ )
+		{
+			int firstRow = min( y * 2, aboveHeight - 1 );
+			int lastRow = ( y == levelHeight( level ) - 1 ) ? aboveHeight - 1 : min( ( y * 2 ) + 1, aboveHeight - 1 );
+			for( int x = 0; x < levelWidth( level ); x++ )
+			{
+				int firstColumn = min( x * 2, aboveWidth - 1 );
+				int lastColumn = ( x == levelWidth( level ) - 1 ) ? aboveWidth - 1 : min( ( x * 2 ) + 1, aboveWidth - 1 );
+				int numberAdded = ( lastRow - firstRow + 1 ) * ( lastColumn - firstColumn + 1 );
+				for( int channel = 0; channel < bytes_per_pixel; channel++ )
+				{
+					int sum = 0;
+					for( int row = firstRow; row <= lastRow; row++ )
+					{
+						for( int column = firstColumn; column <= lastColumn; column++ )
+						{
+							sum += above[ ( ( ( row * aboveWidth ) + column ) * bytes_per_pixel ) + channel ];
+						}
+					}
+					*pixel++ = ( unsigned char ) ( ( sum + ( numberAdded / 2 ) ) / numberAdded );
+				}
+			}
+		}
+	}
+}
+
+
+/* uses levels that were built earlier ( by buildMipmaps ), laid out after
+ * each other just as getLevel lays them out
+ */
+void TextureImage::setPixels( int m_width, int m_height, int m_numberOfLevels, const unsigned char * allLevels )
+{
+	width = m_width;
+	height = m_height;
+	layOutLevels( m_numberOfLevels );
+	memcpy( &pixels[ 0 ], allLevels, pixels.size() );
+}
+
+
+int TextureImage::levelWidth( int level ) const
+{
+	return max( 1, width >> level );
+}
+
+int TextureImage::levelHeight( int level ) const
+{
+	return max( 1, height >> level );
+}
+
+
+/* the average color of the whole image, which is the one pixel of the smallest level
+ */
+QColor TextureImage::averageColor() const
+{
+	if( isNull() )
+	{
+		return QColor();
+	}
+	const unsigned char * pixel = getLevel( numberOfLevels() - 1 );
+	return QColor( pixel[ 0 ], pixel[ 1 ], pixel[ 2 ], pixel[ 3 ] );
+}
+
+
+/* creates an openGL texture holding every level, which the caller must delete
+ */
+GLuint TextureImage::upload() const
+{
+	GLuint texture = 0;
+	glGenTextures( 1, &texture );
+	glBindTexture( GL_TEXTURE_2D, texture );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	for( int level = 0; level < numberOfLevels(); level++ )
+	{
+		glTexImage2D( GL_TEXTURE_2D, level, GL_RGBA, levelWidth( level ), levelHeight( level ), 0, GL_RGBA, GL_UNSIGNED_BYTE, getLevel( level ) );
+	}
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, ( numberOfLevels() > 1 ) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	return texture;
+}
+
+
+/* trades pixels with the other image, without copying them
+ */
+void TextureImage::swap( TextureImage & other )
+{
+	std::swap( width, other.width );
+	std::swap( height, other.height );
+	pixels.swap( other.pixels );
+	levelOffsets.swap( other.levelOffsets );
+}
+
+
+/* lays out room for every level of an image of the current size
+ */
+void TextureImage::layOutLevels( int numberOfLevelsWanted )
+{
+	levelOffsets.clear();
+	size_t offset = 0;
+	for( int level = 0; level < numberOfLevelsWanted; level++ )
+	{
+		levelOffsets.push_back( offset );
+		offset += ( size_t ) levelWidth( level ) * levelHeight( level ) * bytes_per_pixel;
+	}
+	pixels.resize( offset );
+}
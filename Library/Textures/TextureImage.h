@@ -0,0 +1,87 @@
+/*
+   Project     : 3DMaze
+   File        : TextureImage.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : An image ready to be used as a texture, 8 bits each of red,
+   				 green, blue and alpha for every pixel, stored bottom row first
+   				 the way openGL wants it, along with every smaller mipmap level
+   				 down to a single pixel
+*/
+
+
+#ifndef TEXTUREIMAGE_H_
+#define TEXTUREIMAGE_H_
+
+#include <vector>
+#include <cstddef>
+#include <QtOpenGL>
+
+class TextureImage
+{
+	public:
+		TextureImage();
+
+		/* makes room for an image of the given size, with just its full sized level,
+		 * the pixels are left for the caller to fill in
+		 */
+		void resize( int m_width, int m_height );
+
+		/* copies the pixels of the image, and builds its mipmaps
+		 */
+		void fitToImage( const QImage & image );
+
+		/* makes every pixel of every level the given color, for standing in
+		 * for a texture that isn't ready yet
+		 */
+		void fillWithColor( int m_width, int m_height, const QColor & color );
+
+		/* replaces the smaller levels with ones shrunk from the full sized level
+		 */
+		void buildMipmaps();
+
+		/* uses levels that were built earlier ( by buildMipmaps ), laid out after
+		 * each other just as getLevel lays them out
+		 */
+		void setPixels( int m_width, int m_height, int m_numberOfLevels, const unsigned char * allLevels );
+
+		bool isNull() const { return pixels.empty(); }
+		int getWidth() const { return width; }
+		int getHeight() const { return height; }
+
+		int numberOfLevels() const { return levelOffsets.size(); }
+		int levelWidth( int level ) const;
+		int levelHeight( int level ) const;
+		unsigned char * getLevel( int level ) { return &pixels[ levelOffsets[ level ] ]; }
+		const unsigned char * getLevel( int level ) const { return &pixels[ levelOffsets[ level ] ]; }
+
+		/* every level, one after another
+		 */
+		const unsigned char * getAllLevels() const { return &pixels[ 0 ]; }
+		std::size_t sizeOfAllLevels() const { return pixels.size(); }
+
+		/* the average color of the whole image, which is the one pixel of the smallest level
+		 */
+		QColor averageColor() const;
+
+		/* creates an openGL texture holding every level, which the caller must delete
+		 */
+		GLuint upload() const;
+
+		/* trades pixels with the other image, without copying them
+		 */
+		void swap( TextureImage & other );
+
+		static const int bytes_per_pixel = 4;
+
+	private:
+		int width, height;
+		std::vector<unsigned char> pixels;
+		std::vector<std::size_t> levelOffsets;
+
+		/* lays out room for every level of an image of the current size
+		 */
+		void layOutLevels( int numberOfLevelsWanted );
+};
+
+#endif /*TEXTUREIMAGE_H_*/
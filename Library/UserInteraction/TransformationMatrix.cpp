@@ -26,7 +26,7 @@ TransformationMatrix::TransformationMatrix( const TransformationMatrix & rhs )
  */
 void TransformationMatrix::init( const TransformationMatrix & rhs )
 {
-	const GLdouble * const rhsData = rhs.getData();
+	const GeometryScalar * const rhsData = rhs.getData();
 	for( int i = 0; i < ( dimension * dimension ); i++ )
 	{
 		matrix[ i ] = rhsData[ i ];
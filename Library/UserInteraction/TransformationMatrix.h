@@ -14,6 +14,8 @@
 #include <math.h>
 #include <QtOpenGL>
 
+#include "GeometryScalar.h"
+
 class TransformationMatrix
 {	
 	public:
@@ -48,7 +50,7 @@ class TransformationMatrix
 		 * array (COLUMN major ordering)
 		 * this is the format for transformations that openGL can best deal with
 		 */
-		const GLdouble * const getData() const { return matrix; }
+		const GeometryScalar * const getData() const { return matrix; }
 		
 		/* sets a specific value of this matrix
 		 * ( while protecting against writing outside of the matrix due to bounds )
@@ -67,7 +69,7 @@ class TransformationMatrix
 		static int getIndex( int row, int column )
 			{	return ( dimension * ( column ) ) + row; }
 		
-		GLdouble matrix[ dimension * dimension ];
+		GeometryScalar matrix[ dimension * dimension ];
 		
 		/* common copying algorithm used for the copy operator and copy constructor
 		 */
@@ -78,4 +80,10 @@ class TransformationMatrix
 		void setToAllZeros();
 };
 
+/* multiplies openGL's current matrix by the given one ( in COLUMN major ordering ),
+ * whichever precision it's in
+ */
+inline void multiplyCurrentMatrix( const GLfloat * matrix ) { glMultMatrixf( matrix ); }
+inline void multiplyCurrentMatrix( const GLdouble * matrix ) { glMultMatrixd( matrix ); }
+
 #endif /*TRANSFORMATIONMATRIX_H_*/
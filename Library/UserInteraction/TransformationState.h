@@ -66,7 +66,7 @@ class TransformationState
 		double getYTranslation() const { return yTranslation.getValue(); }
 		double getZTranslation() const { return zTranslation.getValue(); }
 	
-		const GLdouble * const getRotationMatrix() const { return rotation.getData(); }
+		const GeometryScalar * const getRotationMatrix() const { return rotation.getData(); }
 		
 	private:
 		BoundsCheckingContainer<double> xScale;
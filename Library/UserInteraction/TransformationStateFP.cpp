@@ -33,7 +33,8 @@ TransformationStateFP::TransformationStateFP( GLdouble m_walkForwardVelocity,
 	spinAngleDegrees( m_spinAngleDegrees ),
 	xPositionOffset( m_xPositionOffset ),
 	yPositionOffset( m_yPositionOffset ),
-	zPositionOffset( m_zPositionOffset ) {}
+	zPositionOffset( m_zPositionOffset ),
+	wallDistances( NULL ) {}
 
 void TransformationStateFP::lookUp( GLdouble degrees )
 {
@@ -62,6 +63,16 @@ void TransformationStateFP::lookLeft( GLdouble degrees )
 }
 
 
+/* spins the player round to look straight at the point on the floor,
+ * the floor's y-axis runs along the world's negative z-axis
+ */
+void TransformationStateFP::faceToward( const Point2D & point )
+{
+	//walking forward moves sin( spin ) along x and cos( spin ) along the floor's y-axis
+	spinAngleDegrees = toDegrees( atan2( point.getX() - xPositionOffset, point.getY() + zPositionOffset ) );
+}
+
+
 
 /* the user will jump into the air
  * the speed of his fall will depend on gravity settings
@@ -134,7 +145,7 @@ void TransformationStateFP::updatePosition( const Maze3D & maze, const UserInter
 	const Point2D destination( xPositionOffset + bufferAdditionX + additionToX, -( zPositionOffset + bufferAdditionZ + additionToZ ) );
 	
 	//get the resolved direction
-	Vector2D resolvedDirection = resolveCollision( source, destination, maze );
+	Vector2D resolvedDirection = resolveCollision( source, destination, maze, wallDistances );
 	
 	//now update the player's position based on the resolvedDirection
 	xPositionOffset += resolvedDirection.getX();
@@ -147,9 +158,17 @@ void TransformationStateFP::updatePosition( const Maze3D & maze, const UserInter
  * should take after possibly colliding with a wall in "maze" while traveling
  * the path from point "source" to "destination"
  * ( this takes in account the fact that collision with more than one wall is possible )
+ * when given distances to the walls, they're only looked through if the destination is close to one
  */ 
-const Vector2D TransformationStateFP::resolveCollision( const Point2D & source, const Point2D & destination, const Maze3D & maze )
+const Vector2D TransformationStateFP::resolveCollision( const Point2D & source, const Point2D & destination, const Maze3D & maze,
+														const WallDistanceField * wallDistances )
 {
+	//nowhere near a wall there's nothing to collide with, and no need to look through the walls
+	if( ( wallDistances != NULL ) && wallDistances->isClear( destination ) )
+	{
+		return Vector2D( destination.getX() - source.getX(), destination.getY() - source.getY()  );
+	}
+
 	Vector2D resultantDirection;
 	try
 	{
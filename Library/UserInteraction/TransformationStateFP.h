@@ -20,6 +20,8 @@
 #include <iostream>
 
 #include "Maze3D.h"
+#include "WallDistanceField.h"
+#include "Point2D.h"
 #include "Vector2D.h"
 #include "UserInteractionStateFP.h"
 #include "ConversionFunctions.h"
@@ -49,6 +51,15 @@ class TransformationStateFP
 		void lookDown( GLdouble degrees );
 		void lookRight( GLdouble degrees );
 		void lookLeft( GLdouble degrees );
+
+		/* spins the player round to look straight at the point on the floor,
+		 * the floor's y-axis runs along the world's negative z-axis
+		 */
+		void faceToward( const Point2D & point );
+
+		/* where the player is standing, in the floor's coordinates
+		 */
+		Point2D getPositionOnFloor() const { return Point2D( xPositionOffset, -zPositionOffset ); }
 		
 		/* the user will jump into the air
 		 * the speed of his fall will depend on gravity settings
@@ -60,6 +71,11 @@ class TransformationStateFP
 		 * This function uses the given Maze3D to find and resolve possible physical collisions
 		 */
 		void updatePosition( const Maze3D & maze, const UserInteractionStateFP & state );
+
+		/* how far the maze's walls are, so the player only has to be checked against them when close to one,
+		 * the field has to outlast this, and NULL checks against the walls every time
+		 */
+		void setWallDistanceField( const WallDistanceField * m_wallDistances ) { wallDistances = m_wallDistances; }
 								
 	private:
 		const GLdouble walkForwardVelocity;
@@ -75,6 +91,8 @@ class TransformationStateFP
 		GLdouble xPositionOffset;
 		GLdouble yPositionOffset;
 		GLdouble zPositionOffset;
+
+		const WallDistanceField * wallDistances;
 		
 		static GLdouble minTiltAngle()	{	return -90.0; }
 		static GLdouble maxTiltAngle()	{	return 90.0; }
@@ -84,8 +102,10 @@ class TransformationStateFP
 		 * should take after possibly colliding with a wall in "maze" while traveling
 		 * the path from point "source" to "destination"
 		 * ( this takes in account the fact that collision with more than one wall is possible )
+		 * when given distances to the walls, they're only looked through if the destination is close to one
 		 */ 
-		static const Vector2D resolveCollision( const Point2D & source, const Point2D & destination, const Maze3D & maze );
+		static const Vector2D resolveCollision( const Point2D & source, const Point2D & destination, const Maze3D & maze,
+												const WallDistanceField * wallDistances );
 };
 
 #endif /*TRANSFORMATIONSTATEFP_H_*/
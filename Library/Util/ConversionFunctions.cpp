@@ -10,6 +10,12 @@
 
 #include "ConversionFunctions.h"
 
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+
+using namespace std;
+
 double toRadians( double degrees )	
 {	
 	return ( 2 * pi * degrees ) / degrees_in_circle; 
@@ -19,3 +25,104 @@ double toDegrees( double radians )
 {	
 	return ( degrees_in_circle * radians )/ ( 2 * pi );
 }
+
+
+/* writes the value into the destination as plain decimal text, with the same six
+ * significant digits an ostream writes by default but never in exponent form
+ * ( values with more than 16 zeros after the point come out as 0 ),
+ * and returns the number of characters written ( no terminating null character is written )
+ */
+int formatDecimal( double value, char * destination )
+{
+	const int significant_digits = 6;
+	const double largest_fast_value = 1000000000.0;
+
+	//values smaller than this many zeros after the point come out as 0
+	const int max_leading_zeros = 16;
+
+	//huge values ( and values that aren't numbers ) are left to the standard library
+	if( !( fabs( value ) < largest_fast_value ) )
+	{
+		return sprintf( destination, "%.17g", value );
+	}
+
+	int length = 0;
+	if( value < 0.0 )
+	{
+		destination[ length++ ] = '-';
+		value = -value;
+	}
+
+	double wholePart = floor( value );
+	unsigned int whole = ( unsigned int ) wholePart;
+
+	//the digits of the whole part come out backwards, so write them to the end of a scratch space first
+	char wholeDigits[ 10 ];
+	int numberOfWholeDigits = 0;
+	do
+	{
+		wholeDigits[ numberOfWholeDigits++ ] = '0' + ( whole % 10 );
+		whole /= 10;
+	} while( whole != 0 );
+
+	//below one the zeros right after the point aren't significant, so they're written on top of the six digits
+	int digitsAfterPoint = max( 0, significant_digits - numberOfWholeDigits );
+	if( wholePart == 0.0 )
+	{
+		digitsAfterPoint = significant_digits;
+		for( double shifted = value * 10.0; ( shifted < 1.0 ) && ( digitsAfterPoint < ( significant_digits + max_leading_zeros ) ); shifted *= 10.0 )
+		{
+			digitsAfterPoint++;
+		}
+	}
+
+	//powers of ten this small are exact as doubles
+	double scale = 1.0;
+	for( int i = 0; i < digitsAfterPoint; i++ )
+	{
+		scale *= 10.0;
+	}
+	double fraction = floor( ( ( value - wholePart ) * scale ) + 0.5 );
+
+	//rounding the fraction up can carry into the whole part
+	if( fraction >= scale )
+	{
+		return length + formatDecimal( wholePart + 1.0, destination + length );
+	}
+
+	//don't write "-0"
+	if( ( wholePart == 0.0 ) && ( fraction == 0.0 ) )
+	{
+		destination[ 0 ] = '0';
+		return 1;
+	}
+
+	while( numberOfWholeDigits > 0 )
+	{
+		destination[ length++ ] = wholeDigits[ --numberOfWholeDigits ];
+	}
+
+	if( fraction != 0.0 )
+	{
+		//the fraction has at most seven digits that aren't leading zeros, so it fits in an unsigned int
+		unsigned int remaining = ( unsigned int ) fraction;
+		destination[ length++ ] = '.';
+		char fractionDigits[ significant_digits + max_leading_zeros ];
+		for( int i = digitsAfterPoint - 1; i >= 0; i-- )
+		{
+			fractionDigits[ i ] = '0' + ( remaining % 10 );
+			remaining /= 10;
+		}
+		int lastDigit = digitsAfterPoint - 1;
+		while( fractionDigits[ lastDigit ] == '0' )
+		{
+			lastDigit--;
+		}
+		for( int i = 0; i <= lastDigit; i++ )
+		{
+			destination[ length++ ] = fractionDigits[ i ];
+		}
+	}
+
+	return length;
+}
@@ -18,5 +18,15 @@ double toRadians( double degrees );
 
 double toDegrees( double radians );
 
+// the most characters formatDecimal will ever write
+const int max_formatted_decimal_length = 32;
+
+/* writes the value into the destination as plain decimal text, with the same six
+ * significant digits an ostream writes by default but never in exponent form
+ * ( values with more than 16 zeros after the point come out as 0 ),
+ * and returns the number of characters written ( no terminating null character is written )
+ */
+int formatDecimal( double value, char * destination );
+
 
 #endif /*CONVERSIONFUNCTIONS_H_*/
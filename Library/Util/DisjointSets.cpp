@@ -0,0 +1,91 @@
+/*
+   Project     : 3DMaze
+   File        : DisjointSets.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps track of which of a number of elements have been
+   				 joined together into the same set ( a union-find structure ),
+   				 joining sets and finding an element's set both take
+   				 very nearly constant time
+*/
+
+
+#include "DisjointSets.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/* every element starts out in a set of its own
+ */
+DisjointSets::DisjointSets( int m_numberOfElements /* = 0 */ ) :
+	parents(),
+	sizes(),
+	sets( 0 )
+{
+	reset( m_numberOfElements );
+}
+
+
+/* puts every element back in a set of its own, with room for the given number of elements
+ */
+void DisjointSets::reset( int m_numberOfElements )
+{
+	parents.resize( m_numberOfElements );
+	sizes.assign( m_numberOfElements, 1 );
+	for( int i = 0; i < m_numberOfElements; i++ )
+	{
+		parents[ i ] = i;
+	}
+	sets = m_numberOfElements;
+}
+
+
+/* adds another element, in a set of its own, and returns it
+ */
+int DisjointSets::addAnElement()
+{
+	int element = parents.size();
+	parents.push_back( element );
+	sizes.push_back( 1 );
+	sets++;
+	return element;
+}
+
+
+/* returns the element standing for the set holding the given element,
+ * elements are in the same set exactly when this gives the same element for both
+ */
+int DisjointSets::find( int element )
+{
+	//every element on the way up is pointed at its grandparent, which keeps the trees flat
+	while( parents[ element ] != element )
+	{
+		parents[ element ] = parents[ parents[ element ] ];
+		element = parents[ element ];
+	}
+	return element;
+}
+
+
+/* joins the sets holding the two elements, returning false if they were already the same set
+ */
+bool DisjointSets::join( int first, int second )
+{
+	first = find( first );
+	second = find( second );
+	if( first == second )
+	{
+		return false;
+	}
+
+	//the smaller set goes under the bigger one
+	if( sizes[ first ] < sizes[ second ] )
+	{
+		swap( first, second );
+	}
+	parents[ second ] = first;
+	sizes[ first ] += sizes[ second ];
+	sets--;
+	return true;
+}
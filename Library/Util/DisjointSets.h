@@ -0,0 +1,53 @@
+/*
+   Project     : 3DMaze
+   File        : DisjointSets.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : Keeps track of which of a number of elements have been
+   				 joined together into the same set ( a union-find structure ),
+   				 joining sets and finding an element's set both take
+   				 very nearly constant time
+*/
+
+
+#ifndef DISJOINTSETS_H_
+#define DISJOINTSETS_H_
+
+#include <vector>
+
+class DisjointSets
+{
+	public:
+		/* every element starts out in a set of its own
+		 */
+		DisjointSets( int m_numberOfElements = 0 );
+
+		/* puts every element back in a set of its own, with room for the given number of elements
+		 */
+		void reset( int m_numberOfElements );
+
+		/* adds another element, in a set of its own, and returns it
+		 */
+		int addAnElement();
+
+		/* returns the element standing for the set holding the given element,
+		 * elements are in the same set exactly when this gives the same element for both
+		 */
+		int find( int element );
+
+		/* joins the sets holding the two elements, returning false if they were already the same set
+		 */
+		bool join( int first, int second );
+
+		bool inSameSet( int first, int second ) { return find( first ) == find( second ); }
+
+		int numberOfElements() const { return parents.size(); }
+		int numberOfSets() const { return sets; }
+
+	private:
+		std::vector<int> parents;
+		std::vector<int> sizes;		// only kept up to date for elements standing for their sets
+		int sets;
+};
+
+#endif /*DISJOINTSETS_H_*/
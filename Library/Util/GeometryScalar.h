@@ -0,0 +1,23 @@
+/*
+   Project     : 3DMaze
+   File        : GeometryScalar.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : The type every coordinate of the maze's geometry is stored as.
+   				 Mazes are small enough that single precision is plenty, so
+   				 defining MAZE_SINGLE_PRECISION when building ( qmake CONFIG+=single_precision )
+   				 stores geometry as floats. The point classes keep their vtable pointer,
+   				 so that saves about a third of the memory, not half of it
+*/
+
+
+#ifndef GEOMETRYSCALAR_H_
+#define GEOMETRYSCALAR_H_
+
+#ifdef MAZE_SINGLE_PRECISION
+typedef float GeometryScalar;
+#else
+typedef double GeometryScalar;
+#endif
+
+#endif /*GEOMETRYSCALAR_H_*/
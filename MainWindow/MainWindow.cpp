@@ -9,11 +9,17 @@
 
 
 #include <algorithm>
+#include <iostream>
 
 #include "MainWindow.h"
 #include "../Edit/edit2DMaze.h"
 #include "../View/view3DMaze.h"
 #include "../Explore/explore3DMaze.h"
+#include "Maze3DExporter.h"
+#include "WallDistanceField.h"
+#include "MazeFileTask.h"
+#include "MazeBuildTask.h"
+#include "TextureLoadTask.h"
 
 const int MainWindow::min_wall_width = 8;	// walls any smaller than this and the collision detection code will have to be revisited
 const int MainWindow::max_wall_width = 20;
@@ -23,10 +29,20 @@ const int MainWindow::max_wall_height = 100;
 const int MainWindow::default_wall_width = qBound( min_wall_width, max_wall_width, 10 );
 const int MainWindow::default_wall_height = qBound( min_wall_height, max_wall_height, 50 );
 
+const int MainWindow::status_message_timeout = 10000;
+const int MainWindow::progress_dialog_delay = 500;
+const int MainWindow::wall_width_settle_delay = 250;
+const int MainWindow::maze_rebuild_delay = 500;
+
 const QString MainWindow::mazeFileExtension = "maze";
+const QString MainWindow::exported3DMazeFileExtension = "obj";
 const QString MainWindow::default_floor_texture_file_name = ":/defaultFloorTexture.ppm";
 const QString MainWindow::default_walls_texture_file_name = ":/defaultWallsTexture.ppm";
 
+const int MainWindow::placeholder_texture_size = 64;
+const QColor MainWindow::placeholder_floor_color( 96, 96, 96 );
+const QColor MainWindow::placeholder_walls_color( 160, 160, 160 );
+
 
 /* construct a mainwindow with the edit and view widgets along with a few controls
  */
@@ -34,17 +50,44 @@ MainWindow::MainWindow() :
 	editWidget( NULL ),
 	wallWidth( default_wall_width ),
 	wallHeight( default_wall_height ),
-	floorTexture( default_floor_texture_file_name ),
-	wallsTexture( default_walls_texture_file_name )
+	wallWidthTimer( NULL ),
+	rebuildTimer( NULL ),
+	buildTask( NULL ),
+	mazeVersion( 0 ),
+	builtVersion( 0 ),
+	textureCache( textureCacheDirectory().toStdString() ),
+	floorTexture(),
+	wallsTexture(),
+	defaultTexturesTask( NULL ),
+	floorTextureReplaced( false ),
+	wallsTextureReplaced( false ),
+	startupTimer( NULL ),
+	firstFrameTime( -1 ),
+	texturesReadyTime( -1 )
 {
 	setCurrentFileName( "" );
 
+	// show plain colors until the default textures have been read on a thread of their own, so the window shows up right away
+	floorTexture.fillWithColor( placeholder_texture_size, placeholder_texture_size, placeholder_floor_color );
+	wallsTexture.fillWithColor( placeholder_texture_size, placeholder_texture_size, placeholder_walls_color );
+	defaultTexturesTask = new TextureLoadTask( default_floor_texture_file_name, default_walls_texture_file_name, textureCacheDirectory(), this );
+	connect( defaultTexturesTask, SIGNAL( finished() ), this, SLOT( defaultTexturesLoaded() ) );
+	defaultTexturesTask->start();
+
+	// merging all the walls together again takes too long to do at every edit, so it's done on another thread once the edits stop
+	rebuildTimer = new QTimer( this );
+	rebuildTimer->setSingleShot( true );
+	rebuildTimer->setInterval( maze_rebuild_delay );
+	connect( rebuildTimer, SIGNAL( timeout() ), this, SLOT( startBuilding3DMaze() ) );
+
 	// create an editWidget along with a few actions that wil be available in the editWidget's context menu
 	editWidget = new EditWidget;
+	editWidget->setPathClearance( pathClearance() );
 	QAction * newMazeAction = new QAction( tr( "New" ), this );
 	QAction * openMazeAction = new QAction( tr( "Open" ), this );
 	QAction * saveAction = new QAction( tr( "Save" ), this );
 	QAction * saveAsAction = new QAction( tr( "Save As..." ), this );
+	QAction * export3DMazeAction = new QAction( tr( "Export 3D Maze..." ), this );
 	QAction * clearMazeAction = new QAction( tr( "Clear Maze" ), this );
 	newMazeAction->setShortcut( QKeySequence::New );
 	openMazeAction->setShortcut( QKeySequence::Open );
@@ -55,6 +98,7 @@ MainWindow::MainWindow() :
 	connect( openMazeAction, SIGNAL( triggered() ), this, SLOT( openFile() ) );
 	connect( saveAction, SIGNAL( triggered() ), this, SLOT( saveFile() ) );
 	connect( saveAsAction, SIGNAL( triggered() ), this, SLOT( saveAsFile() ) );
+	connect( export3DMazeAction, SIGNAL( triggered() ), this, SLOT( export3DMaze() ) );
 	connect( clearMazeAction, SIGNAL( triggered() ), editWidget, SLOT( setMazeToDefault() ) );
 	editWidget->addAction( clearMazeAction );
 
@@ -79,10 +123,16 @@ MainWindow::MainWindow() :
 
 	// make sure that this main window knows when the maze is edited in the editWidget, and tells the viewWidget about this when it happens
 	connect( editWidget, SIGNAL( mazeEdited( const Maze2D & ) ), this, SLOT( respondToMazeChange( const Maze2D & ) ) );
-	connect( this, SIGNAL( maze3DChanged( const Maze3D *, const QImage &, const QImage & ) ), viewWidget, SLOT( displayMaze3D( const Maze3D *, const QImage &, const QImage & ) ) );
-
-	// respond to the initial maze having been created in the editWidget
-	update3DMaze( editWidget->getMaze() );
+	connect( editWidget, SIGNAL( lineAdded( const LineSegment2D & ) ), this, SLOT( journalAddedLine( const LineSegment2D & ) ) );
+	connect( editWidget, SIGNAL( lineAdded( const LineSegment2D & ) ), this, SLOT( add3DWall( const LineSegment2D & ) ) );
+	connect( editWidget, SIGNAL( mazeCleared() ), this, SLOT( journalClear() ) );
+	connect( this, SIGNAL( maze3DChanged( const Maze3D *, const TextureImage &, const TextureImage & ) ), viewWidget, SLOT( displayMaze3D( const Maze3D *, const TextureImage &, const TextureImage & ) ) );
+	connect( this, SIGNAL( maze3DUpdated() ), viewWidget, SLOT( updateGL() ) );
+	connect( viewWidget, SIGNAL( firstFramePainted() ), this, SLOT( viewPaintedFirstFrame() ) );
+
+	// respond to the initial maze having been created in the editWidget ( it's small enough to build right away )
+	currentMazeBuilder().build( editWidget->getMaze(), maze3D );
+	emit maze3DChanged( &maze3D, floorTexture, wallsTexture );
 
 	QSplitter * splitter = new QSplitter;
 	splitter->addWidget( editWidget );
@@ -98,6 +148,12 @@ MainWindow::MainWindow() :
 		wallsWidthSlider->setSliderPosition( wallWidth );
 		wallControls->addWidget( wallsWidthSlider, 0, 1 );
 		connect( wallsWidthSlider, SIGNAL( valueChanged( int ) ), this, SLOT( wallWidthChanged( int ) ) );
+
+		// the path grid and the 3D maze are only rebuilt once the slider settles, rather than at every step it's dragged through
+		wallWidthTimer = new QTimer( this );
+		wallWidthTimer->setSingleShot( true );
+		wallWidthTimer->setInterval( wall_width_settle_delay );
+		connect( wallWidthTimer, SIGNAL( timeout() ), this, SLOT( applyWallWidth() ) );
 	}
 	{
 		QSlider * wallsHeightSlider = new QSlider( Qt::Horizontal );
@@ -121,6 +177,8 @@ MainWindow::MainWindow() :
 	fileMenu->addSeparator();
 	fileMenu->addAction( saveAction );
 	fileMenu->addAction( saveAsAction );
+	fileMenu->addSeparator();
+	fileMenu->addAction( export3DMazeAction );
 
 	QMenu * editMenu = menuBar()->addMenu( tr( "&Edit" ) );
 	editMenu->addAction( clearMazeAction );
@@ -133,12 +191,36 @@ MainWindow::MainWindow() :
 }
 
 
+/* the default textures may still be loading
+ */
+MainWindow::~MainWindow()
+{
+	defaultTexturesTask->wait();
+	if ( buildTask != NULL )
+	{
+		buildTask->cancel();
+		buildTask->wait();
+	}
+}
+
+
+/* print how long it took, timed from when the application started, for the first frame
+ * to be drawn and for the default textures to be ready, then quit once both have happened
+ */
+void MainWindow::measureStartup( const QElapsedTimer & m_startupTimer )
+{
+	startupTimer = &m_startupTimer;
+	reportStartupTime();
+}
+
+
 /* create a new maze that's empty and untitled
  */
 void MainWindow::newMaze()
 {
 	if ( okToLoseChangesThatExist() )
 	{
+		closeJournal();
 		editWidget->setMazeToDefault();
 		setCurrentFileName( "" );	// must do this is after clearing the maze ( which marks the maze as modified ),
 									// instead of before, so in the end the application knows the maze is unmodified now
@@ -155,11 +237,52 @@ void MainWindow::openFile()
 		QString fileTypes = QString( tr( "Maze Files (*.%1)" ) ).arg( mazeFileExtension );
 		QString newFileName = QFileDialog::getOpenFileName( this, tr( "Open 2D Maze File" ), QDir::currentPath(), fileTypes );
 		if ( !newFileName.isEmpty() ) {
-			bool openSucceeded = editWidget->openMaze( newFileName );
+			// the maze is read and built on another thread, and only swapped into place once it's all done
+			MazeFileTask openTask( newFileName, currentMazeBuilder(), pathClearance() );
+			bool openSucceeded = runFileTask( openTask, tr( "Opening '%1'..." ).arg( QFileInfo( newFileName ).fileName() ), true );
 			if ( openSucceeded )
 			{
+				closeJournal();
+				editWidget->replaceMaze( openTask.getOpenedMaze(), openTask.getOpenedPathGrid(), openTask.getOpenedReachability() );
+				if ( openTask.getPathClearance() != pathClearance() )
+				{
+					editWidget->setPathClearance( pathClearance() );
+				}
+				stopBuilding3DMaze();	// the opened maze was built along with it, whatever was being built for the old maze is out of date
+				maze3D.swap( openTask.getOpened3DMaze() );
+				journal.swap( openTask.getOpenedJournal() );
 				setCurrentFileName( newFileName );
-				update3DMaze( editWidget->getMaze() );
+				emit maze3DChanged( &maze3D, floorTexture, wallsTexture );
+				if ( openTask.getBuilder() != currentMazeBuilder() )
+				{
+					// the default textures were swapped in while the maze was being built, so rebuild it with the ones in use now
+					update3DMaze();
+				}
+
+				// the maze is cleaned up as it's read in, let the user know if that changed anything
+				const NormalizationReport & cleanUp = editWidget->getMaze().getLastNormalization();
+				if ( cleanUp.changedAnything() )
+				{
+					setWindowModified( true );
+					statusBar()->showMessage( QString::fromStdString( cleanUp.describe() ), status_message_timeout );
+				}
+
+				// edits that were journaled but never saved ( the program must have stopped early ) are recovered
+				if ( journal.numberOfUncommittedEdits() > 0 )
+				{
+					setWindowModified( true );
+					statusBar()->showMessage( tr( "Recovered %1 unsaved edits" ).arg( journal.numberOfUncommittedEdits() ), status_message_timeout );
+				}
+			}
+			else if ( openTask.wasCanceled() )
+			{
+				statusBar()->showMessage( tr( "Opening '%1' was canceled" ).arg( newFileName ), status_message_timeout );
+			}
+			else
+			{
+				QMessageBox::warning( this, tr( "3DMaze" ),
+											tr( "An error occured while trying to open '%1'" ).arg( newFileName ),
+											QMessageBox::Ok );
 			}
 		}
 	}
@@ -176,11 +299,48 @@ bool MainWindow::saveFile()
 	}
 	else
 	{
-		bool saveSucceeded = editWidget->saveMaze( currentFileName );
+		// while the file's journal is small, saving only has to mark the edits in it as saved
+		if ( journal.isOpen() && ( journal.getMazeFileName() == currentFileName.toStdString() ) && !journal.needsCompaction() )
+		{
+			try
+			{
+				journal.commit();
+				setWindowModified( false );
+				return true;
+			}
+			catch ( IOError & ioe )
+			{
+				journal.close();
+			}
+		}
+
+		// otherwise the whole maze is written out, the file is only replaced once it's all written so saving can be canceled
+		MazeFileTask saveTask( currentFileName, editWidget->getMaze() );
+		bool saveSucceeded = runFileTask( saveTask, tr( "Saving '%1'..." ).arg( QFileInfo( currentFileName ).fileName() ), true );
 		if ( saveSucceeded )
 		{
+			// the file now holds every edit, so its journal starts over
+			closeJournal();
+			try
+			{
+				journal.restart( currentFileName.toStdString() );
+			}
+			catch ( IOError & ioe )
+			{
+				journal.close();
+			}
 			setWindowModified( false );
 		}
+		else if ( saveTask.wasCanceled() )
+		{
+			statusBar()->showMessage( tr( "Saving '%1' was canceled" ).arg( currentFileName ), status_message_timeout );
+		}
+		else
+		{
+			QMessageBox::warning( this, tr( "3DMaze" ),
+										tr( "An error occured while trying to save '%1'" ).arg( currentFileName ),
+										QMessageBox::Ok );
+		}
 		return saveSucceeded;
 	}
 }
@@ -205,21 +365,109 @@ bool MainWindow::saveAsFile()
 }
 
 
+/* write the geometry of the 3D maze out to a file the user picks
+ */
+void MainWindow::export3DMaze()
+{
+	QString fileTypes = QString( tr( "Wavefront OBJ Files (*.%1)" ) ).arg( exported3DMazeFileExtension );
+	QFileDialog fileDialog( this, "Export 3D Maze" );
+	fileDialog.setAcceptMode( QFileDialog::AcceptSave );
+	fileDialog.setFileMode( QFileDialog::AnyFile );
+	fileDialog.setNameFilter( fileTypes );
+	fileDialog.setDefaultSuffix( exported3DMazeFileExtension );
+	if ( !fileDialog.exec() )
+	{
+		return;
+	}
+
+	QString fileName = fileDialog.selectedFiles().first();
+	finishBuilding3DMaze();
+	try
+	{
+		Maze3DExporter exporter;
+		exporter.exportMaze( maze3D, fileName.toStdString() );
+		statusBar()->showMessage( tr( "Exported %1 positions, %2 texture coordinates and %3 quads to '%4'" ).arg( exporter.numberOfPositionsWritten() )
+																											 .arg( exporter.numberOfTextureCoordinatesWritten() )
+																											 .arg( exporter.numberOfQuadsWritten() )
+																											 .arg( fileName ),
+								  status_message_timeout );
+	}
+	catch ( IOError & ioe )
+	{
+		QMessageBox::warning( this, tr( "3DMaze" ),
+									tr( "An error occured while trying to export '%1'" ).arg( fileName ),
+									QMessageBox::Ok );
+	}
+}
+
+
 /* update the 3D maze when the 2D maze is edited
  */
-void MainWindow::respondToMazeChange( const Maze2D & maze2D )
+void MainWindow::respondToMazeChange( const Maze2D & )
 {
 	setWindowModified( true );
-	update3DMaze( maze2D );
+	update3DMaze();
+}
+
+
+/* add the edit to the open file's journal, so it can be saved without writing the whole maze
+ */
+void MainWindow::journalAddedLine( const LineSegment2D & line )
+{
+	if ( journal.isOpen() )
+	{
+		try
+		{
+			journal.recordAddedLine( line );
+		}
+		catch ( IOError & ioe )
+		{
+			journalFailed();
+		}
+	}
+}
+
+void MainWindow::journalClear()
+{
+	if ( journal.isOpen() )
+	{
+		try
+		{
+			journal.recordClear();
+		}
+		catch ( IOError & ioe )
+		{
+			journalFailed();
+		}
+	}
 }
 
 
-/* respond to a wall width change
+/* respond to a wall width change, once the slider settles
  */
 void MainWindow::wallWidthChanged( int newWidth )
 {
 	wallWidth = newWidth;
-	update3DMaze( editWidget->getMaze() );
+	wallWidthTimer->start();
+}
+
+
+/* rebuild what depends on the wall width, once it stops changing
+ */
+void MainWindow::applyWallWidth()
+{
+	editWidget->setPathClearance( pathClearance() );
+	update3DMaze();
+}
+
+
+/* put up the wall for a line added in the editWidget right away, changing nothing but the chunk it's in
+ * ( the wall mesh and impostor take it in once the maze is built again )
+ */
+void MainWindow::add3DWall( const LineSegment2D & line )
+{
+	currentMazeBuilder().addALine( line, maze3D );
+	emit maze3DUpdated();
 }
 
 
@@ -228,7 +476,7 @@ void MainWindow::wallWidthChanged( int newWidth )
 void MainWindow::wallHeightChanged( int newHeight )
 {
 	wallHeight = newHeight;
-	update3DMaze( editWidget->getMaze() );
+	update3DMaze();
 }
 
 
@@ -239,9 +487,9 @@ void MainWindow::replaceFloorTexture()
 	QString newFloorTextureFileName = getOpenImageFileName( this );
 	if ( !newFloorTextureFileName.isEmpty() ) {
 
-		QImage newFloorTexture( newFloorTextureFileName );
+		TextureImage newFloorTexture;
 
-		if ( newFloorTexture.isNull() )
+		if ( !TextureLoadTask::loadTexture( newFloorTextureFileName, textureCache, newFloorTexture ) )
 		{
 			QMessageBox::warning( this, tr( "3DMaze" ),
 										tr( "An error occured while trying to open '%1'" ).arg( newFloorTextureFileName ),
@@ -249,8 +497,12 @@ void MainWindow::replaceFloorTexture()
 		}
 		else
 		{
-			floorTexture = newFloorTexture;
-			update3DMaze( editWidget->getMaze() );
+			floorTexture.swap( newFloorTexture );
+			floorTextureReplaced = true;
+
+			// the new texture is shown right away, its texture coordinates catch up once the maze is built again
+			emit maze3DChanged( &maze3D, floorTexture, wallsTexture );
+			update3DMaze();
 		}
 	}
 }
@@ -263,9 +515,9 @@ void MainWindow::replaceWallTexture()
 	QString newWallsTextureFileName = getOpenImageFileName( this );
 	if ( !newWallsTextureFileName.isEmpty() ) {
 
-		QImage newWallsTexture( newWallsTextureFileName );
+		TextureImage newWallsTexture;
 
-		if ( newWallsTexture.isNull() )
+		if ( !TextureLoadTask::loadTexture( newWallsTextureFileName, textureCache, newWallsTexture ) )
 		{
 			QMessageBox::warning( this, tr( "3DMaze" ),
 										tr( "An error occured while trying to open '%1'" ).arg( newWallsTextureFileName ),
@@ -273,8 +525,12 @@ void MainWindow::replaceWallTexture()
 		}
 		else
 		{
-			wallsTexture = newWallsTexture;
-			update3DMaze( editWidget->getMaze() );
+			wallsTexture.swap( newWallsTexture );
+			wallsTextureReplaced = true;
+
+			// the new texture is shown right away, its texture coordinates catch up once the maze is built again
+			emit maze3DChanged( &maze3D, floorTexture, wallsTexture );
+			update3DMaze();
 		}
 	}
 }
@@ -284,11 +540,25 @@ void MainWindow::replaceWallTexture()
  */
 void MainWindow::exploreMazeInFirstPerson()
 {
+	// a wall width that's still settling is applied first, so the walls the player bumps into are the ones shown
+	if ( wallWidthTimer->isActive() )
+	{
+		wallWidthTimer->stop();
+		applyWallWidth();
+	}
+	finishBuilding3DMaze();
+
+	// the walls' distances are sampled once up front, so the player is only checked against the walls when close to one
+	WallDistanceField wallDistances;
+	wallDistances.build( editWidget->getMaze(), wallWidth );
+
 	QDialog exploreDialog( this, Qt::WindowMaximizeButtonHint );
 	exploreDialog.setWindowTitle( "First-Person Preview" );
 
 	QVBoxLayout * layout = new QVBoxLayout;
 	ExploreWidget * exploreWidget = new ExploreWidget( maze3D, floorTexture, wallsTexture );
+	exploreWidget->setPathToFollow( editWidget->getPath() );
+	exploreWidget->setWallDistanceField( &wallDistances );
 	layout->addWidget( exploreWidget );
 	layout->setContentsMargins( 0, 0, 0, 0 );
 	exploreDialog.setLayout( layout );
@@ -308,6 +578,7 @@ void MainWindow::closeEvent( QCloseEvent * event )
 {
 	if ( okToLoseChangesThatExist() )
 	{
+		closeJournal();
 		event->accept();
 	}
 	else
@@ -333,40 +604,180 @@ void MainWindow::setCurrentFileName( const QString & fileName )
 }
 
 
-/* update the 3D maze based on the 2D maze and other maze settings
+/* update the 3D maze based on the 2D maze and other maze settings,
+ * it's built again on another thread once they stop changing for a moment
+ */
+void MainWindow::update3DMaze()
+{
+	mazeVersion++;
+	if ( buildTask != NULL )
+	{
+		buildTask->cancel();	// what it's building is already out of date
+	}
+	rebuildTimer->start();
+}
+
+
+/* start building the 3D maze again on another thread, once the maze has stopped changing for a moment
  */
-void MainWindow::update3DMaze( const Maze2D & maze2D )
+void MainWindow::startBuilding3DMaze()
+{
+	// a build that's still stopping starts the next one once it has
+	if ( ( buildTask != NULL ) || ( builtVersion == mazeVersion ) )
+	{
+		return;
+	}
+
+	buildTask = new MazeBuildTask( editWidget->getMaze(), currentMazeBuilder(), mazeVersion, this );
+	connect( buildTask, SIGNAL( finished() ), this, SLOT( building3DMazeFinished() ) );
+	buildTask->start();
+}
+
+
+/* swap in the 3D maze that was built on another thread, unless the maze has changed since
+ */
+void MainWindow::building3DMazeFinished()
+{
+	// the task may have been waited for and taken already
+	if ( ( buildTask == NULL ) || !buildTask->isFinished() )
+	{
+		return;
+	}
+
+	takeBuilt3DMaze();
+	if ( !rebuildTimer->isActive() )
+	{
+		startBuilding3DMaze();
+	}
+}
+
+
+/* make sure the 3D maze matches the 2D maze and settings, building it right away if it has to
+ */
+void MainWindow::finishBuilding3DMaze()
+{
+	rebuildTimer->stop();
+	if ( buildTask != NULL )
+	{
+		// a build of the maze as it is now is worth waiting for, one of an older maze isn't
+		if ( buildTask->getVersion() != mazeVersion )
+		{
+			buildTask->cancel();
+		}
+		buildTask->wait();
+		takeBuilt3DMaze();
+	}
+
+	if ( builtVersion != mazeVersion )
+	{
+		currentMazeBuilder().build( editWidget->getMaze(), maze3D );
+		builtVersion = mazeVersion;
+		emit maze3DUpdated();
+	}
+}
+
+
+/* forget any 3D maze that's waiting to be built or being built, the 3D maze in place is up to date
+ */
+void MainWindow::stopBuilding3DMaze()
+{
+	rebuildTimer->stop();
+	if ( buildTask != NULL )
+	{
+		buildTask->cancel();
+	}
+	mazeVersion++;
+	builtVersion = mazeVersion;
+}
+
+
+/* swap in the 3D maze the finished build task built, if the maze hasn't changed since it started, and let the task go
+ */
+void MainWindow::takeBuilt3DMaze()
+{
+	if ( buildTask->succeeded() && ( buildTask->getVersion() == mazeVersion ) )
+	{
+		maze3D.swap( buildTask->getBuilt3DMaze() );
+		builtVersion = mazeVersion;
+		emit maze3DUpdated();
+	}
+	buildTask->deleteLater();
+	buildTask = NULL;
+}
+
+
+/* something that builds 3D mazes with the current wall sizes and textures
+ */
+Maze3DBuilder MainWindow::currentMazeBuilder() const
 {
 	// assume a 2::1 ratio between texel size and units in world distance
 	// so a 1x1 grid in the world will contain 4 texels
-	const int floorTextureWidth = floorTexture.width() / 2;
-	const int floorTextureHeight = floorTexture.height() / 2;
-	const int wallsTextureWidth = wallsTexture.width() / 2;
-	const int wallsTextureHeight = wallsTexture.height() / 2;
+	const int floorTextureWidth = floorTexture.getWidth() / 2;
+	const int floorTextureHeight = floorTexture.getHeight() / 2;
+	const int wallsTextureWidth = wallsTexture.getWidth() / 2;
+	const int wallsTextureHeight = wallsTexture.getHeight() / 2;
+
+	return Maze3DBuilder( wallWidth, wallHeight, wallsTextureWidth, wallsTextureHeight, floorTextureWidth, floorTextureHeight );
+}
+
+
+/* how far the paths shown in the editWidget keep from the walls, so the player can follow them without bumping into one
+ */
+double MainWindow::pathClearance() const
+{
+	return ( wallWidth / 2.0 ) + ExploreWidget::getBufferDistance();
+}
 
-	maze3D.clearWalls();
 
-	//iterate through the lines in the 2D maze and create 3D walls out of them
-	//and add these walls to the 3D maze;
-	Wall wall;
-	for( int i = 0; i < maze2D.numberOfLines(); i++ )
+/* runs the task on its own thread, showing its progress until it's finished
+ * returns true only if the task succeeded
+ */
+bool MainWindow::runFileTask( MazeFileTask & task, const QString & description, bool cancelable )
+{
+	// a null cancel button text leaves the dialog without a cancel button
+	QProgressDialog progressDialog( description, cancelable ? tr( "Cancel" ) : QString(), 0, 100, this );
+	progressDialog.setWindowModality( Qt::WindowModal );
+	progressDialog.setMinimumDuration( progress_dialog_delay );
+	connect( &task, SIGNAL( progressChanged( int ) ), &progressDialog, SLOT( setValue( int ) ) );
+	if ( cancelable )
 	{
-		wall.fitToLine( maze2D.getALine( i ), wallWidth, wallHeight, wallsTextureWidth, wallsTextureHeight );
-		maze3D.addAWall( wall );
+		connect( &progressDialog, SIGNAL( canceled() ), &task, SLOT( cancel() ), Qt::DirectConnection );
 	}
 
-	//add the floor
-	Point3D bottomLeft( -( maze2D.getWidth() / 2.0 ), -( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
-	Point3D topLeft( -( maze2D.getWidth() / 2.0 ), ( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
-	Point3D topRight( ( maze2D.getWidth() / 2.0 ), ( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
-	Point3D bottomRight( ( maze2D.getWidth() / 2.0 ), -( maze2D.getHeight() / 2.0 ), -wallHeight / 2.0 );
+	// keep handling events ( and drawing ) while the task runs, the dialog keeps the user from editing the maze meanwhile
+	QEventLoop waitForTask;
+	connect( &task, SIGNAL( finished() ), &waitForTask, SLOT( quit() ) );
+	task.start();
+	waitForTask.exec();
+	task.wait();
 
-	Quad floor( bottomLeft, topLeft, topRight, bottomRight );
-	TexturedQuad tFloor( floor, floorTextureWidth, floorTextureHeight );
+	return task.succeeded();
+}
 
-	maze3D.setFloor( tFloor );
 
-	emit maze3DChanged( &maze3D, floorTexture, wallsTexture );
+/* stops journaling edits, forgetting the ones that weren't saved
+ */
+void MainWindow::closeJournal()
+{
+	try
+	{
+		journal.discardUncommitted();
+	}
+	catch ( IOError & ioe )
+	{
+		// the unsaved edits stay in the journal, to be recovered the next time the file is opened
+	}
+	journal.close();
+}
+
+
+/* called when an edit can't be added to the journal
+ * the journal is dropped, and the next save writes the whole maze instead
+ */
+void MainWindow::journalFailed()
+{
+	closeJournal();
+	statusBar()->showMessage( tr( "Edits can't be journaled anymore, the next save will write out the whole maze" ), status_message_timeout );
 }
 
 
@@ -411,3 +822,70 @@ QString MainWindow::getOpenImageFileName( QWidget * parent /*= NULL*/ )
 	QString fileTypes = QString( "Image Files (%1)" ).arg( listOfTypes );
 	return QFileDialog::getOpenFileName( parent, tr( "Open Image File" ), QDir::currentPath(), fileTypes );
 }
+
+
+/* where decoded textures are kept between runs
+ */
+QString MainWindow::textureCacheDirectory()
+{
+	QString directory = QDesktopServices::storageLocation( QDesktopServices::CacheLocation ) + "/textures";
+	QDir().mkpath( directory );
+	return directory;
+}
+
+
+/* swap in the default textures once they've been read, in place of the plain colors shown until then
+ * a texture that can't be read leaves its plain color in place
+ */
+void MainWindow::defaultTexturesLoaded()
+{
+	bool texturesChanged = false;
+	if ( !floorTextureReplaced && defaultTexturesTask->floorTextureLoaded() )
+	{
+		floorTexture.swap( defaultTexturesTask->getFloorTexture() );
+		texturesChanged = true;
+	}
+	if ( !wallsTextureReplaced && defaultTexturesTask->wallsTextureLoaded() )
+	{
+		wallsTexture.swap( defaultTexturesTask->getWallsTexture() );
+		texturesChanged = true;
+	}
+
+	// the texture sizes decide the texture coordinates, so the 3D maze is built over again
+	if ( texturesChanged )
+	{
+		emit maze3DChanged( &maze3D, floorTexture, wallsTexture );
+		update3DMaze();
+	}
+
+	if ( startupTimer != NULL )
+	{
+		texturesReadyTime = startupTimer->elapsed();
+		reportStartupTime();
+	}
+}
+
+
+/* called once the 3D maze has been drawn for the first time
+ */
+void MainWindow::viewPaintedFirstFrame()
+{
+	if ( startupTimer != NULL )
+	{
+		firstFrameTime = startupTimer->elapsed();
+		reportStartupTime();
+	}
+}
+
+
+/* prints the startup times once everything being timed has happened
+ */
+void MainWindow::reportStartupTime()
+{
+	if ( ( firstFrameTime >= 0 ) && ( texturesReadyTime >= 0 ) )
+	{
+		std::cout << "First frame painted after " << firstFrameTime << " ms" << std::endl;
+		std::cout << "Default textures ready after " << texturesReadyTime << " ms" << std::endl;
+		qApp->quit();
+	}
+}
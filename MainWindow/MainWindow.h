@@ -12,16 +12,31 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QElapsedTimer>
 #include "Maze2D.h"
 #include "Maze3D.h"
+#include "Maze3DBuilder.h"
+#include "MazeJournal.h"
+#include "TextureImage.h"
+#include "TextureCache.h"
 #include "../Edit/edit2DMaze.h"
 
+class MazeFileTask;
+class MazeBuildTask;
+class TextureLoadTask;
+class QTimer;
+
 class MainWindow : public QMainWindow
 {
 	Q_OBJECT
 
 	public:
 		MainWindow();
+		virtual ~MainWindow();
+
+		// print how long it took, timed from when the application started, for the first frame
+		// to be drawn and for the default textures to be ready, then quit once both have happened
+		void measureStartup( const QElapsedTimer & m_startupTimer );
 
 	public slots:
 		// create a new maze that's empty and untitled
@@ -36,10 +51,17 @@ class MainWindow : public QMainWindow
 		// returns true only if the file was actually saved
 		bool saveAsFile();
 
+		// write the geometry of the 3D maze out to a file the user picks
+		void export3DMaze();
+
 		// update the 3D maze when the 2D maze is edited
 		void respondToMazeChange( const Maze2D & maze2D );
 
-		// respond to a change in the wall width
+		// add the edit to the open file's journal, so it can be saved without writing the whole maze
+		void journalAddedLine( const LineSegment2D & line );
+		void journalClear();
+
+		// respond to a change in the wall width, once the slider settles
 		void wallWidthChanged( int newWidth );
 
 		// respond to a chanad in the wall height
@@ -54,9 +76,31 @@ class MainWindow : public QMainWindow
 		// open up a dialog that lets the user explore the maze in first person
 		void exploreMazeInFirstPerson();
 
+	private slots:
+		// rebuild what depends on the wall width, once it stops changing
+		void applyWallWidth();
+
+		// put up the wall for a line added in the editWidget right away, changing nothing but the chunk it's in
+		void add3DWall( const LineSegment2D & line );
+
+		// start building the 3D maze again on another thread, once the maze has stopped changing for a moment
+		void startBuilding3DMaze();
+
+		// swap in the 3D maze that was built on another thread, unless the maze has changed since
+		void building3DMazeFinished();
+
+		// swap in the default textures once they've been read, in place of the plain colors shown until then
+		void defaultTexturesLoaded();
+
+		// called once the 3D maze has been drawn for the first time
+		void viewPaintedFirstFrame();
+
 	signals:
 		// emitted wheneve the 3D maze changes
-		void maze3DChanged( const Maze3D * maze3D, const QImage & floorTexture, const QImage & wallTexture );
+		void maze3DChanged( const Maze3D * maze3D, const TextureImage & floorTexture, const TextureImage & wallTexture );
+
+		// emitted when the 3D maze changes in place, with the same textures
+		void maze3DUpdated();
 
 	protected:
 		virtual void closeEvent( QCloseEvent * event );
@@ -66,8 +110,34 @@ class MainWindow : public QMainWindow
 		// update the application's title bar to match
 		void setCurrentFileName( const QString & fileName );
 
-		// update the 3D maze based on the 2D maze and other maze settings
-		void update3DMaze( const Maze2D & maze2D );
+		// update the 3D maze based on the 2D maze and other maze settings,
+		// it's built again on another thread once they stop changing for a moment
+		void update3DMaze();
+
+		// make sure the 3D maze matches the 2D maze and settings, building it right away if it has to
+		void finishBuilding3DMaze();
+
+		// forget any 3D maze that's waiting to be built or being built, the 3D maze in place is up to date
+		void stopBuilding3DMaze();
+
+		// swap in the 3D maze the finished build task built, if the maze hasn't changed since it started, and let the task go
+		void takeBuilt3DMaze();
+
+		// something that builds 3D mazes with the current wall sizes and textures
+		Maze3DBuilder currentMazeBuilder() const;
+
+		// how far the paths shown in the editWidget keep from the walls, so the player can follow them without bumping into one
+		double pathClearance() const;
+
+		// runs the task on its own thread, showing its progress until it's finished
+		// returns true only if the task succeeded
+		bool runFileTask( MazeFileTask & task, const QString & description, bool cancelable );
+
+		// stops journaling edits, forgetting the ones that weren't saved
+		void closeJournal();
+
+		// called when an edit can't be added to the journal
+		void journalFailed();
 
 		// returns true if either there are not modifications to the current maze
 		// or the user doesn't mind losing the modifications that exist
@@ -76,14 +146,38 @@ class MainWindow : public QMainWindow
 		// allows the user to select an image file to open, permitting any file formats that QImageReader supports
 		static QString getOpenImageFileName( QWidget * parent = NULL );
 
+		// where decoded textures are kept between runs
+		static QString textureCacheDirectory();
+
+		// prints the startup times once everything being timed has happened
+		void reportStartupTime();
+
 		EditWidget * editWidget;
 		Maze3D maze3D;
+		MazeJournal journal;	// edits made since the current file was last written in full
 
 		int wallWidth;
 		int wallHeight;
+		QTimer * wallWidthTimer;	// restarted each time the wall width changes, so dragging the slider only rebuilds once
+
+		// the 3D maze is built again on another thread once the 2D maze and settings stop changing,
+		// each change counts up the version, so a build that started before it is never swapped in
+		QTimer * rebuildTimer;
+		MazeBuildTask * buildTask;	// NULL unless a build is going
+		int mazeVersion;
+		int builtVersion;	// the version of the 3D maze in place
+
+		TextureCache textureCache;
+		TextureImage floorTexture;
+		TextureImage wallsTexture;
 
-		QImage floorTexture;
-		QImage wallsTexture;
+		TextureLoadTask * defaultTexturesTask;
+		bool floorTextureReplaced;	// true once the user picks a texture, which the default mustn't replace
+		bool wallsTextureReplaced;
+
+		const QElapsedTimer * startupTimer;	// NULL unless startup is being measured
+		qint64 firstFrameTime;		// in milliseconds since startup, -1 until it happens
+		qint64 texturesReadyTime;
 
 		QString currentFileName;
 
@@ -96,9 +190,19 @@ class MainWindow : public QMainWindow
 		static const int default_wall_width;
 		static const int default_wall_height;
 
+		static const int status_message_timeout;	// in milliseconds
+		static const int progress_dialog_delay;	// in milliseconds, tasks quicker than this don't show their progress
+		static const int wall_width_settle_delay;	// in milliseconds
+		static const int maze_rebuild_delay;	// in milliseconds
+
 		static const QString mazeFileExtension;
+		static const QString exported3DMazeFileExtension;
 		static const QString default_floor_texture_file_name;
 		static const QString default_walls_texture_file_name;
+
+		static const int placeholder_texture_size;
+		static const QColor placeholder_floor_color;
+		static const QColor placeholder_walls_color;
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,64 @@
+/*
+   Project     : 3DMaze
+   File        : MazeBuildTask.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : contains the definition for MazeBuildTask, which builds
+				 a 3D maze on a thread of its own so the 2D maze can go on
+				 being edited while the walls are merged together again
+*/
+
+
+#include <new>
+
+#include "MazeBuildTask.h"
+#include "OperationCanceled.h"
+#include "IOError.h"
+
+/* build a 3D maze with the builder out of a copy of the 2D maze, so the 2D maze can be edited meanwhile,
+ * the version is whatever the caller uses to tell whether the maze has changed since
+ */
+MazeBuildTask::MazeBuildTask( const Maze2D & m_maze2D, const Maze3DBuilder & m_builder, int m_version, QObject * parent /* = NULL */ ) :
+	QThread( parent ),
+	maze2D( m_maze2D ),
+	builder( m_builder ),
+	version( m_version ),
+	built3DMaze(),
+	success( false ),
+	canceled( 0 ) {}
+
+
+bool MazeBuildTask::wasCanceled() const
+{
+	return canceled != 0;
+}
+
+
+/* ask the task to stop as soon as it can, it can be called from any thread
+ */
+void MazeBuildTask::cancel()
+{
+	canceled.fetchAndStoreOrdered( 1 );
+}
+
+
+void MazeBuildTask::run()
+{
+	success = false;
+	try
+	{
+		builder.build( maze2D, built3DMaze, this );
+		success = true;
+	}
+	catch ( OperationCanceled & oc )
+	{
+		// the half built maze is never swapped into place
+	}
+	catch ( IOError & ioe )
+	{
+	}
+	catch ( std::bad_alloc & ba )
+	{
+		// the maze that was built before stays in place
+	}
+}
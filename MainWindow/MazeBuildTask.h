@@ -0,0 +1,66 @@
+/*
+   Project     : 3DMaze
+   File        : MazeBuildTask.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : contains the declaration for MazeBuildTask, which builds
+				 a 3D maze on a thread of its own so the 2D maze can go on
+				 being edited while the walls are merged together again
+*/
+
+
+#ifndef MAZEBUILDTASK_H
+#define MAZEBUILDTASK_H
+
+#include <QThread>
+#include <QAtomicInt>
+
+#include "Maze2D.h"
+#include "Maze3D.h"
+#include "Maze3DBuilder.h"
+#include "ProgressMonitor.h"
+
+class MazeBuildTask : public QThread, public ProgressMonitor
+{
+	Q_OBJECT
+
+	public:
+		// build a 3D maze with the builder out of a copy of the 2D maze, so the 2D maze can be edited meanwhile,
+		// the version is whatever the caller uses to tell whether the maze has changed since
+		MazeBuildTask( const Maze2D & m_maze2D, const Maze3DBuilder & m_builder, int m_version, QObject * parent = NULL );
+
+		// once the task is finished, true if it wasn't canceled
+		bool succeeded() const { return success; }
+
+		// once the task succeeds, this holds the maze that was built, ready to be swapped into place
+		Maze3D & getBuilt3DMaze() { return built3DMaze; }
+
+		int getVersion() const { return version; }
+
+		// inherited from ProgressMonitor, nothing shows how far along building is
+		void reportProgress( double ) {}
+		bool wasCanceled() const;
+
+	public slots:
+		// ask the task to stop as soon as it can, it can be called from any thread
+		void cancel();
+
+	protected:
+		virtual void run();
+
+	private:
+		Maze2D maze2D;
+		Maze3DBuilder builder;
+		int version;
+
+		Maze3D built3DMaze;
+
+		bool success;
+		QAtomicInt canceled;
+
+		// disable copying
+		MazeBuildTask( const MazeBuildTask & );
+		const MazeBuildTask & operator=( const MazeBuildTask & );
+};
+
+#endif // MAZEBUILDTASK_H
@@ -0,0 +1,144 @@
+/*
+   Project     : 3DMaze
+   File        : MazeFileTask.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : contains the definition for MazeFileTask, which opens or saves
+				 a maze file on a thread of its own so the application doesn't freeze
+				 while a big maze is read, built or written
+*/
+
+
+#include <new>
+
+#include "MazeFileTask.h"
+#include "../Edit/edit2DMaze.h"
+#include "FileHandler.h"
+#include "OperationCanceled.h"
+#include "IOError.h"
+
+/* open the maze in the file, build a 3D maze out of it with the builder,
+ * and build the editor's path grid for it with paths keeping the given clearance from the walls
+ */
+MazeFileTask::MazeFileTask( const QString & m_fileName, const Maze3DBuilder & m_builder, double m_pathClearance, QObject * parent /* = NULL */ ) :
+	QThread( parent ),
+	operation( opening ),
+	fileName( m_fileName ),
+	builder( m_builder ),
+	pathClearance( m_pathClearance ),
+	mazeToSave( NULL ),
+	success( false ),
+	canceled( 0 ),
+	percentReported( -1 ) {}
+
+
+/* save the maze to the file, keeping a file that's in binary form in binary form
+ * ( the maze must be left alone until the task is finished )
+ */
+MazeFileTask::MazeFileTask( const QString & m_fileName, const Maze2D & m_mazeToSave, QObject * parent /* = NULL */ ) :
+	QThread( parent ),
+	operation( saving ),
+	fileName( m_fileName ),
+	builder( 0, 0, 0, 0, 0, 0 ),
+	pathClearance( 0.0 ),
+	mazeToSave( &m_mazeToSave ),
+	success( false ),
+	canceled( 0 ),
+	percentReported( -1 ) {}
+
+
+/* only emits when the whole percent done changes, so a quick task doesn't flood the event loop
+ */
+void MazeFileTask::reportProgress( double fractionDone )
+{
+	int percentDone = qBound( 0, ( int ) ( fractionDone * 100 ), 100 );
+	if ( percentDone != percentReported )
+	{
+		percentReported = percentDone;
+		emit progressChanged( percentDone );
+	}
+}
+
+
+bool MazeFileTask::wasCanceled() const
+{
+	return canceled != 0;
+}
+
+
+/* ask the task to stop as soon as it can, it can be called from any thread
+ */
+void MazeFileTask::cancel()
+{
+	canceled.fetchAndStoreOrdered( 1 );
+}
+
+
+void MazeFileTask::run()
+{
+	success = false;
+	try
+	{
+		if ( operation == opening )
+		{
+			open();
+		}
+		else
+		{
+			save();
+		}
+		success = true;
+	}
+	catch ( OperationCanceled & oc )
+	{
+		// the opened mazes are left half built, but they're never swapped into place
+	}
+	catch ( IOError & ioe )
+	{
+	}
+	catch ( std::bad_alloc & ba )
+	{
+		// a maze too big for memory is just a file that couldn't be opened
+	}
+}
+
+
+/* reading ( and replaying the edits in the file's journal ) is the first part of opening,
+ * then building the 3D maze, and last building the editor's path grid
+ */
+void MazeFileTask::open()
+{
+	ProgressRange reading( this, 0.0, 0.4 );
+	FileHandler File( fileName.toStdString() );
+	File.ReadFromFile( openedMaze, &reading );
+
+	ProgressRange replaying( this, 0.4, 0.45 );
+	try
+	{
+		openedJournal.open( fileName.toStdString(), openedMaze, &replaying );
+	}
+	catch ( OperationCanceled & oc )
+	{
+		throw;
+	}
+	catch ( IOError & ioe )
+	{
+		// the maze can still be opened, its edits just can't be journaled ( saving writes the whole file instead )
+		openedJournal.close();
+	}
+
+	ProgressRange building( this, 0.45, 0.85 );
+	builder.build( openedMaze, opened3DMaze, &building );
+
+	// rasterizing a big maze and finding what can be reached in it would freeze the editor if it were done once the maze was swapped in
+	ProgressRange findingPaths( this, 0.85, 1.0 );
+	EditWidget::buildPathGrid( openedMaze, pathClearance, openedPathGrid, openedReachability, &findingPaths );
+}
+
+
+void MazeFileTask::save()
+{
+	// keep a file that's in binary form in binary form
+	FileHandler File( fileName.toStdString() );
+	File.WriteToFile( *mazeToSave, File.IsBinary(), this );
+}
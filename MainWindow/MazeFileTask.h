@@ -0,0 +1,97 @@
+/*
+   Project     : 3DMaze
+   File        : MazeFileTask.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : contains the declaration for MazeFileTask, which opens or saves
+				 a maze file on a thread of its own so the application doesn't freeze
+				 while a big maze is read, built or written
+*/
+
+
+#ifndef MAZEFILETASK_H
+#define MAZEFILETASK_H
+
+#include <QThread>
+#include <QAtomicInt>
+#include <QString>
+
+#include "Maze2D.h"
+#include "Maze3D.h"
+#include "Maze3DBuilder.h"
+#include "MazeJournal.h"
+#include "OccupancyGrid.h"
+#include "ReachabilityMap.h"
+#include "ProgressMonitor.h"
+
+class MazeFileTask : public QThread, public ProgressMonitor
+{
+	Q_OBJECT
+
+	public:
+		// open the maze in the file, build a 3D maze out of it with the builder,
+		// and build the editor's path grid for it with paths keeping the given clearance from the walls
+		MazeFileTask( const QString & m_fileName, const Maze3DBuilder & m_builder, double m_pathClearance, QObject * parent = NULL );
+
+		// save the maze to the file, keeping a file that's in binary form in binary form
+		// ( the maze must be left alone until the task is finished )
+		MazeFileTask( const QString & m_fileName, const Maze2D & m_mazeToSave, QObject * parent = NULL );
+
+		// once the task is finished, true if it did everything it set out to
+		bool succeeded() const { return success; }
+
+		// once an open task succeeds, these hold what was opened, ready to be swapped into place
+		// ( the journal isn't open if the file's journal couldn't be opened for recording edits )
+		Maze2D & getOpenedMaze() { return openedMaze; }
+		Maze3D & getOpened3DMaze() { return opened3DMaze; }
+		MazeJournal & getOpenedJournal() { return openedJournal; }
+		OccupancyGrid & getOpenedPathGrid() { return openedPathGrid; }
+		ReachabilityMap & getOpenedReachability() { return openedReachability; }
+
+		const QString & getFileName() const { return fileName; }
+		const Maze3DBuilder & getBuilder() const { return builder; }
+		double getPathClearance() const { return pathClearance; }
+
+		// inherited from ProgressMonitor, called on the task's own thread
+		void reportProgress( double fractionDone );
+		bool wasCanceled() const;
+
+	public slots:
+		// ask the task to stop as soon as it can, it can be called from any thread
+		void cancel();
+
+	signals:
+		// emitted ( from the task's thread ) each time another percent of the task is done
+		void progressChanged( int percentDone );
+
+	protected:
+		virtual void run();
+
+	private:
+		void open();
+		void save();
+
+		enum Operation { opening, saving };
+
+		Operation operation;
+		QString fileName;
+		Maze3DBuilder builder;
+		double pathClearance;
+		const Maze2D * mazeToSave;
+
+		Maze2D openedMaze;
+		Maze3D opened3DMaze;
+		MazeJournal openedJournal;
+		OccupancyGrid openedPathGrid;
+		ReachabilityMap openedReachability;
+
+		bool success;
+		QAtomicInt canceled;
+		int percentReported;
+
+		// disable copying
+		MazeFileTask( const MazeFileTask & );
+		const MazeFileTask & operator=( const MazeFileTask & );
+};
+
+#endif // MAZEFILETASK_H
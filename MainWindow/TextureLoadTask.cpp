@@ -0,0 +1,73 @@
+/*
+   Project     : 3DMaze
+   File        : TextureLoadTask.cpp
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : contains the definition for TextureLoadTask, which reads
+				 the floor and walls textures on a thread of its own so the
+				 application can show itself before they're ready
+*/
+
+
+#include <QFile>
+#include <QByteArray>
+#include <QImage>
+
+#include "TextureLoadTask.h"
+#include "PPMDecoder.h"
+#include "IOError.h"
+
+/* load the textures in the two files, going through the texture cache kept in the directory
+ */
+TextureLoadTask::TextureLoadTask( const QString & m_floorFileName, const QString & m_wallsFileName, const QString & cacheDirectory, QObject * parent /* = NULL */ ) :
+	QThread( parent ),
+	floorFileName( m_floorFileName ),
+	wallsFileName( m_wallsFileName ),
+	cache( cacheDirectory.toStdString() ),
+	floorTexture(),
+	wallsTexture(),
+	floorLoaded( false ),
+	wallsLoaded( false ) {}
+
+
+void TextureLoadTask::run()
+{
+	floorLoaded = loadTexture( floorFileName, cache, floorTexture );
+	wallsLoaded = loadTexture( wallsFileName, cache, wallsTexture );
+}
+
+
+/* reads the image in the file into the texture, returning true only if it could be read
+ * PPM images go through the texture cache, anything else through QImage
+ */
+bool TextureLoadTask::loadTexture( const QString & fileName, TextureCache & cache, TextureImage & texture )
+{
+	// this works for images in the application's resources too
+	QFile file( fileName );
+	if ( !file.open( QIODevice::ReadOnly ) )
+	{
+		return false;
+	}
+	QByteArray contents = file.readAll();
+
+	if ( PPMDecoder::isPPM( contents.constData(), contents.size() ) )
+	{
+		try
+		{
+			cache.load( contents.constData(), contents.size(), texture );
+			return true;
+		}
+		catch ( IOError & ioe )
+		{
+			return false;
+		}
+	}
+
+	QImage image;
+	if ( !image.loadFromData( contents ) )
+	{
+		return false;
+	}
+	texture.fitToImage( image );
+	return true;
+}
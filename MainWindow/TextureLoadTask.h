@@ -0,0 +1,59 @@
+/*
+   Project     : 3DMaze
+   File        : TextureLoadTask.h
+   Author      : Jacob Enget  (jacob.enget@gmail.com)
+
+   Description : contains the declaration for TextureLoadTask, which reads
+				 the floor and walls textures on a thread of its own so the
+				 application can show itself before they're ready
+*/
+
+
+#ifndef TEXTURELOADTASK_H
+#define TEXTURELOADTASK_H
+
+#include <QThread>
+#include <QString>
+
+#include "TextureImage.h"
+#include "TextureCache.h"
+
+class TextureLoadTask : public QThread
+{
+	Q_OBJECT
+
+	public:
+		// load the textures in the two files, going through the texture cache kept in the directory
+		TextureLoadTask( const QString & m_floorFileName, const QString & m_wallsFileName, const QString & cacheDirectory, QObject * parent = NULL );
+
+		// once the task is finished, true for each texture that could be read
+		bool floorTextureLoaded() const { return floorLoaded; }
+		bool wallsTextureLoaded() const { return wallsLoaded; }
+
+		// once the task is finished, these hold the textures that were read, ready to be swapped into place
+		TextureImage & getFloorTexture() { return floorTexture; }
+		TextureImage & getWallsTexture() { return wallsTexture; }
+
+		// reads the image in the file into the texture, returning true only if it could be read
+		// PPM images go through the texture cache, anything else through QImage
+		static bool loadTexture( const QString & fileName, TextureCache & cache, TextureImage & texture );
+
+	protected:
+		virtual void run();
+
+	private:
+		QString floorFileName;
+		QString wallsFileName;
+		TextureCache cache;	// a cache of its own, caches aren't shared between threads
+
+		TextureImage floorTexture;
+		TextureImage wallsTexture;
+		bool floorLoaded;
+		bool wallsLoaded;
+
+		// disable copying
+		TextureLoadTask( const TextureLoadTask & );
+		const TextureLoadTask & operator=( const TextureLoadTask & );
+};
+
+#endif // TEXTURELOADTASK_H
@@ -39,7 +39,9 @@ ViewWidget::ViewWidget( QWidget * parent /* = NULL */ ) :
 	QGLWidget( QGLFormat( QGL::DoubleBuffer | QGL::Rgba | QGL::DepthBuffer ), parent ),
 	floorTextureNumber( 0 ),
 	wallsTextureNumber( 0 ),
+	paintedAFrame( false ),
 	maze( NULL ),
+	chunkBuffers(),
 	stateOfProjection(	initial_fovy_angle,
 						initial_z_coord_of_camera,
 						z_value_of_far_clipping_plane,
@@ -64,6 +66,17 @@ ViewWidget::ViewWidget( QWidget * parent /* = NULL */ ) :
 }
 
 
+/* free the chunk buffers and textures while this widget's context is still around
+ */
+ViewWidget::~ViewWidget()
+{
+	makeCurrent();
+	chunkBuffers.releaseAllBuffers();
+	glDeleteTextures( 1, &floorTextureNumber );
+	glDeleteTextures( 1, &wallsTextureNumber );
+}
+
+
 void ViewWidget::initializeGL()
 {
 	glEnable( GL_DEPTH_TEST );
@@ -84,7 +97,7 @@ void ViewWidget::paintGL()
 				  stateOfTransformation.getYTranslation(),
 				  stateOfTransformation.getZTranslation() );
 
-	glMultMatrixd( stateOfTransformation.getRotationMatrix() );
+	multiplyCurrentMatrix( stateOfTransformation.getRotationMatrix() );
 
 	glScalef( stateOfTransformation.getXScale(),
 			  stateOfTransformation.getYScale(),
@@ -92,10 +105,16 @@ void ViewWidget::paintGL()
 
 	if ( maze != NULL )
 	{
-		maze->Draw( floorTextureNumber, wallsTextureNumber );
+		maze->Draw( floorTextureNumber, wallsTextureNumber, &chunkBuffers );
 	}
 	
 	glFlush();
+
+	if ( !paintedAFrame )
+	{
+		paintedAFrame = true;
+		emit firstFramePainted();
+	}
 }
 
 
@@ -305,7 +324,7 @@ void ViewWidget::initializeTransformation()
 
 /* update to display the given maze with the images speficifed
  */
-void ViewWidget::displayMaze3D( const Maze3D * maze3D, const QImage & floorTexture, const QImage & wallsTexture )
+void ViewWidget::displayMaze3D( const Maze3D * maze3D, const TextureImage & floorTexture, const TextureImage & wallsTexture )
 {
 	assert( !floorTexture.isNull() );
 	assert( !wallsTexture.isNull() );
@@ -314,11 +333,15 @@ void ViewWidget::displayMaze3D( const Maze3D * maze3D, const QImage & floorTextu
 
 	maze = maze3D;
 
-	// bind the wall and floor textures
-	deleteTexture( floorTextureNumber );
-	floorTextureNumber = bindTexture( floorTexture, GL_TEXTURE_2D );
-	deleteTexture( wallsTextureNumber );
-	wallsTextureNumber = bindTexture( wallsTexture, GL_TEXTURE_2D );
+	// upload the wall and floor textures, mipmaps and all
+	glDeleteTextures( 1, &floorTextureNumber );
+	floorTextureNumber = floorTexture.upload();
+	glDeleteTextures( 1, &wallsTextureNumber );
+	wallsTextureNumber = wallsTexture.upload();
+
+	// from far away the walls are drawn untextured, in the average color of their texture
+	QColor wallsColor = wallsTexture.averageColor();
+	chunkBuffers.useLevelsOfDetail( wallsColor.redF(), wallsColor.greenF(), wallsColor.blueF() );
 
 	updateGL();
 }
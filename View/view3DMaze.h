@@ -19,6 +19,8 @@
 #include <math.h>
 
 #include "Maze3D.h"
+#include "ChunkBufferCache.h"
+#include "TextureImage.h"
 #include "ProjectionState.h"
 #include "UserInteractionState.h"
 #include "TransformationState.h"
@@ -30,6 +32,7 @@ class ViewWidget : public QGLWidget
 
 	public:
 		ViewWidget( QWidget * parent = NULL );
+		virtual ~ViewWidget();
 
 	protected:
 		virtual void initializeGL();
@@ -55,11 +58,15 @@ class ViewWidget : public QGLWidget
 
 	public slots:
 		// update to display the given maze with the images speficifed
-		void displayMaze3D( const Maze3D * maze3D, const QImage & floorTexture, const QImage & wallsTexture );
+		void displayMaze3D( const Maze3D * maze3D, const TextureImage & floorTexture, const TextureImage & wallsTexture );
 
 		// resets the transformation and projection of the model
 		void reinitializeView();
 
+	signals:
+		// emitted once, after the first frame has been drawn
+		void firstFramePainted();
+
 	private:
 		// computes the viewing frustum
 		// given the current state of affairs
@@ -71,7 +78,10 @@ class ViewWidget : public QGLWidget
 		GLuint floorTextureNumber;
 		GLuint wallsTextureNumber;
 
+		bool paintedAFrame;
+
 		const Maze3D * maze;
+		ChunkBufferCache chunkBuffers;
 		ProjectionState stateOfProjection;
 		TransformationState stateOfTransformation;
 		UserInteractionState stateOfUserInteraction;
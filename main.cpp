@@ -2,9 +2,241 @@
 
 #include <QtGui/QApplication>
 #include <QErrorMessage>
+#include <QElapsedTimer>
+#include <iostream>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <memory>
 #include "MainWindow/MainWindow.h"
+#include "MazeFileConverter.h"
+#include "MazeReadBenchmark.h"
+#include "Maze3DReadBenchmark.h"
+#include "MazeGenerator.h"
+#include "MazeGenerationBenchmark.h"
+#include "MazeAnalyzer.h"
+#include "EllerGenerator.h"
+#include "ParallelTiledGenerator.h"
+#include "TiledMazeWriter.h"
+#include "BinaryMazeWriter.h"
+#include "FileHandler.h"
 
 int main( int argc, char * argv[] ) {
+	// startup is timed from here
+	QElapsedTimer startupTimer;
+	startupTimer.start();
+
+	// "--convert input output" converts a maze file between text and binary form, without opening a window
+	if ( ( argc == 4 ) && ( strcmp( argv[ 1 ], "--convert" ) == 0 ) )
+	{
+		try
+		{
+			MazeFileConverter::convert( argv[ 2 ], argv[ 3 ] );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to convert '" << argv[ 2 ] << "' to '" << argv[ 3 ] << "'" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--tile input output [tile size]" writes a maze file out as a tiled maze, for mazes too big to hold in memory
+	if ( ( ( argc == 4 ) || ( argc == 5 ) ) && ( strcmp( argv[ 1 ], "--tile" ) == 0 ) )
+	{
+		double tileSize = TiledMazeWriter::default_tile_size;
+		if ( argc == 5 )
+		{
+			char * afterTileSize;
+			tileSize = strtod( argv[ 4 ], &afterTileSize );
+			if ( ( afterTileSize == argv[ 4 ] ) || ( *afterTileSize != '\0' ) || !( tileSize > 0.0 ) )
+			{
+				std::cerr << "The tile size has to be a number greater than zero, not '" << argv[ 4 ] << "'" << std::endl;
+				return 1;
+			}
+		}
+		try
+		{
+			MazeFileConverter::convertToTiled( argv[ 2 ], argv[ 3 ], tileSize );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to tile '" << argv[ 2 ] << "' into '" << argv[ 3 ] << "'" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--benchmark-read file" times reading a text maze file through input streams and with the faster reader
+	if ( ( argc == 3 ) && ( strcmp( argv[ 1 ], "--benchmark-read" ) == 0 ) )
+	{
+		try
+		{
+			MazeReadBenchmark::run( argv[ 2 ], std::cout );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to read '" << argv[ 2 ] << "'" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--benchmark-read-3d file" times reading a text 3D maze file through an input stream and on more and more threads
+	if ( ( argc == 3 ) && ( strcmp( argv[ 1 ], "--benchmark-read-3d" ) == 0 ) )
+	{
+		try
+		{
+			Maze3DReadBenchmark::run( argv[ 2 ], std::cout );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to read '" << argv[ 2 ] << "'" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--generate algorithm columns rows seed output" writes out a newly generated maze, the same one every time for the same seed
+	if ( ( argc == 7 ) && ( strcmp( argv[ 1 ], "--generate" ) == 0 ) )
+	{
+		MazeGenerator * generator = MazeGenerator::create( argv[ 2 ], strtoul( argv[ 5 ], NULL, 10 ) );
+		if ( generator == NULL )
+		{
+			std::cerr << "There's no maze generator called '" << argv[ 2 ] << "', try one of: " << MazeGenerator::names << std::endl;
+			return 1;
+		}
+		try
+		{
+			Maze2D maze;
+			generator->generate( atoi( argv[ 3 ] ), atoi( argv[ 4 ] ), MazeGenerator::default_cell_size, maze );
+			FileHandler( argv[ 6 ] ).WriteToFile( maze );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to write '" << argv[ 6 ] << "'" << std::endl;
+			delete generator;
+			return 1;
+		}
+		delete generator;
+		return 0;
+	}
+
+	// "--generate-tiled algorithm tiles columns rows seed output" writes out a maze carved in tiles across and up, each on a core of its own,
+	// the same one every time for the same seed and number of tiles
+	if ( ( argc == 8 ) && ( strcmp( argv[ 1 ], "--generate-tiled" ) == 0 ) )
+	{
+		std::auto_ptr<MazeGenerator> check( MazeGenerator::create( argv[ 2 ], 0 ) );
+		if ( check.get() == NULL )
+		{
+			std::cerr << "There's no maze generator called '" << argv[ 2 ] << "', try one of: " << MazeGenerator::names << std::endl;
+			return 1;
+		}
+		try
+		{
+			int tiles = atoi( argv[ 3 ] );
+			ParallelTiledGenerator generator( strtoul( argv[ 6 ], NULL, 10 ), argv[ 2 ], tiles, tiles );
+			Maze2D maze;
+			generator.generate( atoi( argv[ 4 ] ), atoi( argv[ 5 ] ), MazeGenerator::default_cell_size, maze );
+			FileHandler( argv[ 7 ] ).WriteToFile( maze );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to write '" << argv[ 7 ] << "'" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--generate-streaming columns rows seed output [binary]" carves a maze with Eller's algorithm a row at a time, writing its walls
+	// straight out to a tiled maze file ( or a binary one ) as they're carved, for mazes far too big to hold in memory
+	if ( ( ( argc == 6 ) || ( argc == 7 ) ) && ( strcmp( argv[ 1 ], "--generate-streaming" ) == 0 ) )
+	{
+		int columns = atoi( argv[ 2 ] );
+		int rows = atoi( argv[ 3 ] );
+		int cellSize = MazeGenerator::default_cell_size;
+		EllerGenerator generator( strtoul( argv[ 4 ], NULL, 10 ) );
+		try
+		{
+			if ( ( argc == 7 ) && ( strcmp( argv[ 6 ], "binary" ) == 0 ) )
+			{
+				BinaryMazeWriter writer( argv[ 5 ], columns * cellSize, rows * cellSize );
+				generator.stream( columns, rows, cellSize, writer );
+				writer.finish();
+			}
+			else
+			{
+				// tiles 64 cells across keep the index small for even the biggest mazes, while a row of them still fits easily in memory
+				double tileSize = std::max( TiledMazeWriter::default_tile_size, 64.0 * cellSize );
+				TiledMazeWriter writer( argv[ 5 ], columns * cellSize, rows * cellSize, tileSize,
+										TiledMazeWriter::default_memory_budget, TiledMazeWriter::bottom_to_top );
+				generator.stream( columns, rows, cellSize, writer );
+				writer.finish();
+			}
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to write '" << argv[ 5 ] << "'" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--benchmark-generation columns rows [seed]" times how many cells a second each maze generator carves, and tiled generation on more and more threads
+	if ( ( ( argc == 4 ) || ( argc == 5 ) ) && ( strcmp( argv[ 1 ], "--benchmark-generation" ) == 0 ) )
+	{
+		try
+		{
+			unsigned long seed = ( argc == 5 ) ? strtoul( argv[ 4 ], NULL, 10 ) : 0;
+			MazeGenerationBenchmark::run( atoi( argv[ 2 ] ), atoi( argv[ 3 ] ), seed, std::cout );
+			MazeGenerationBenchmark::runTiled( atoi( argv[ 2 ] ), atoi( argv[ 3 ] ), seed, "backtracker", ParallelTiledGenerator::default_tiles_across, std::cout );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "A maze generator didn't carve a perfect maze, or carved a different one for the same seed" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--analyze file [cell size]" measures a maze file's pieces, dead ends, loops, solution and diameter, without opening a window
+	if ( ( ( argc == 3 ) || ( argc == 4 ) ) && ( strcmp( argv[ 1 ], "--analyze" ) == 0 ) )
+	{
+		try
+		{
+			int cellSize = ( argc == 4 ) ? atoi( argv[ 3 ] ) : MazeGenerator::default_cell_size;
+			Maze2D maze;
+			FileHandler( argv[ 2 ] ).ReadFromFile( maze );
+			MazeAnalyzer analyzer;
+			analyzer.analyze( maze, std::max( 1, cellSize ) );
+			analyzer.report( std::cout );
+		}
+		catch ( IOError & ioe )
+		{
+			std::cerr << "An error occured while trying to read '" << argv[ 2 ] << "'" << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	// "--analyze-generated algorithm columns rows seed" carves a maze and measures it the same way, straight from its cells,
+	// so mazes far bigger than could be held as lines can be graded
+	if ( ( argc == 6 ) && ( strcmp( argv[ 1 ], "--analyze-generated" ) == 0 ) )
+	{
+		std::auto_ptr<MazeGenerator> generator( MazeGenerator::create( argv[ 2 ], strtoul( argv[ 5 ], NULL, 10 ) ) );
+		if ( generator.get() == NULL )
+		{
+			std::cerr << "There's no maze generator called '" << argv[ 2 ] << "', try one of: " << MazeGenerator::names << std::endl;
+			return 1;
+		}
+		MazeGrid grid( atoi( argv[ 3 ] ), atoi( argv[ 4 ] ) );
+		generator->carve( grid );
+		MazeAnalyzer analyzer;
+		analyzer.analyze( grid );
+		analyzer.report( std::cout );
+		return 0;
+	}
+
 	QApplication application( argc, argv );
 
 	// set up a message handler
@@ -12,6 +244,12 @@ int main( int argc, char * argv[] ) {
 
 	MainWindow window;
 
+	// "--measure-startup" prints how long the window took to draw its first frame and to get its textures, then quits
+	if ( ( argc == 2 ) && ( strcmp( argv[ 1 ], "--measure-startup" ) == 0 ) )
+	{
+		window.measureStartup( startupTimer );
+	}
+
 	window.resize( 900, 600 );
 	window.show();
 